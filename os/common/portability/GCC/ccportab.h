@@ -134,6 +134,20 @@
  * @param[in] x         a valid expression
  */
 #define CC_UNLIKELY(x)      __builtin_expect(!!(x), 0)
+
+/**
+ * @brief   Counts the trailing zero bits of a 32 bits word.
+ * @note    The result is undefined if the word is zero.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ */
+#define CC_CTZ32(x)         ((unsigned)__builtin_ctzl((unsigned long)(x)))
+
+/**
+ * @brief   Return address of the current function.
+ * @note    Can be left undefined if not supported by the compiler.
+ */
+#define CC_RETURN_ADDRESS() __builtin_return_address(0)
 /** @} */
 
 /*===========================================================================*/
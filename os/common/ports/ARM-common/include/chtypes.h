@@ -128,6 +128,16 @@ typedef uint64_t            port_stkline_t;
 #define PORT_UNLIKELY(x)    x
 #endif
 
+/**
+ * @brief   Counts the trailing zero bits of a 32 bits word.
+ * @note    The result is undefined if the word is zero.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ */
+#if defined(CC_CTZ32) || defined(__DOXYGEN__)
+#define PORT_CTZ32(x)       CC_CTZ32(x)
+#endif
+
 #endif /* CHTYPES_H */
 
 /** @} */
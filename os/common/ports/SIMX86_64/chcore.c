@@ -24,7 +24,7 @@
  * @{
  */
 
-#include <sys/time.h>
+#include <time.h>
 
 #include "ch.h"
 
@@ -120,10 +120,11 @@ void _port_thread_start(msg_t (*pf)(void *), void *p) {
  * @return              The realtime counter value.
  */
 rtcnt_t port_rt_get_counter_value(void) {
-  struct timeval tv;
+  struct timespec ts;
 
-  gettimeofday(&tv, NULL);
-  return ((rtcnt_t)tv.tv_sec * (rtcnt_t)1000000) + (rtcnt_t)tv.tv_usec;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((rtcnt_t)ts.tv_sec * (rtcnt_t)1000000) +
+         ((rtcnt_t)ts.tv_nsec / (rtcnt_t)1000);
 }
 
 /** @} */
@@ -105,6 +105,14 @@ typedef uint32_t            ucnt_t;         /**< Generic unsigned counter.  */
  */
 #define REVERSE_ORDER       1
 
+/**
+ * @brief   Counts the trailing zero bits of a 32 bits word.
+ * @note    The result is undefined if the word is zero.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ */
+#define PORT_CTZ32(x)       ((unsigned)__builtin_ctzl((unsigned long)(x)))
+
 #endif /* CHTYPES_H */
 
 /** @} */
@@ -0,0 +1,115 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    lz4block.h
+ * @brief   LZ4 block codec header file.
+ *
+ * @addtogroup UTILS_LZ4BLOCK
+ * @{
+ */
+
+#ifndef LZ4BLOCK_H
+#define LZ4BLOCK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Minimum match length.
+ */
+#define LZ4BLOCK_MATCH_MIN              4U
+
+/**
+ * @brief   Maximum match distance.
+ */
+#define LZ4BLOCK_DISTANCE_MAX           65535U
+
+/**
+ * @brief   Maximum size of a block accepted by the encoder.
+ */
+#define LZ4BLOCK_ENCODE_SIZE_MAX        65536U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the encoder hash table as a power of two.
+ * @note    The encoder workspace is two bytes per hash table entry.
+ */
+#if !defined(LZ4BLOCK_HASH_BITS) || defined(__DOXYGEN__)
+#define LZ4BLOCK_HASH_BITS              10U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (LZ4BLOCK_HASH_BITS < 8U) || (LZ4BLOCK_HASH_BITS > 16U)
+#error "invalid LZ4BLOCK_HASH_BITS value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an encoder workspace.
+ */
+typedef struct lz4block_workspace {
+  /**
+   * @brief   Last positions of hashed sequences.
+   */
+  uint16_t                  table[1U << LZ4BLOCK_HASH_BITS];
+} lz4block_workspace_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  size_t lz4block_encode_bound(size_t src_size);
+  bool lz4block_encode(const uint8_t *src, size_t src_size,
+                       uint8_t *dst, size_t dst_size,
+                       size_t *encoded_sizep,
+                       lz4block_workspace_t *wsp);
+  bool lz4block_decode(const uint8_t *src, size_t src_size,
+                       uint8_t *dst, size_t dst_size);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* LZ4BLOCK_H */
+
+/** @} */
@@ -0,0 +1,349 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    lz4block.c
+ * @brief   LZ4 block codec code.
+ * @details Byte-aligned LZ77 codec using the LZ4 block format, blocks are
+ *          made of sequences of literals followed by a back reference,
+ *          the last sequence only has literals.
+ *
+ * @addtogroup UTILS_LZ4BLOCK
+ * @{
+ */
+
+#include <string.h>
+
+#include "lz4block.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   The last literals of a block are never part of a match.
+ */
+#define LAST_LITERALS                   5U
+
+/**
+ * @brief   No match can start in the last bytes of a block.
+ */
+#define MATCH_LIMIT                     12U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static uint32_t read32(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static size_t hash32(uint32_t sequence) {
+
+  return (size_t)((sequence * 2654435761U) >> (32U - LZ4BLOCK_HASH_BITS));
+}
+
+static bool put_length(uint8_t *dst, size_t dst_size, size_t *outposp,
+                       size_t length) {
+
+  while (length >= 255U) {
+    if (*outposp >= dst_size) {
+      return false;
+    }
+    dst[(*outposp)++] = 255U;
+    length -= 255U;
+  }
+
+  if (*outposp >= dst_size) {
+    return false;
+  }
+  dst[(*outposp)++] = (uint8_t)length;
+
+  return true;
+}
+
+static bool put_sequence(uint8_t *dst, size_t dst_size, size_t *outposp,
+                         const uint8_t *literals, size_t literal_size,
+                         size_t offset, size_t match_size) {
+  size_t token_match;
+  uint8_t token;
+
+  token_match = match_size >= LZ4BLOCK_MATCH_MIN ?
+                match_size - LZ4BLOCK_MATCH_MIN : 0U;
+  token = (uint8_t)(((literal_size < 15U ? literal_size : 15U) << 4) |
+                    (token_match < 15U ? token_match : 15U));
+
+  if (*outposp >= dst_size) {
+    return false;
+  }
+  dst[(*outposp)++] = token;
+
+  if ((literal_size >= 15U) &&
+      !put_length(dst, dst_size, outposp, literal_size - 15U)) {
+    return false;
+  }
+
+  if (dst_size - *outposp < literal_size) {
+    return false;
+  }
+  memcpy(&dst[*outposp], literals, literal_size);
+  *outposp += literal_size;
+
+  /* The last sequence has no match.*/
+  if (match_size == 0U) {
+    return true;
+  }
+
+  if (dst_size - *outposp < 2U) {
+    return false;
+  }
+  dst[(*outposp)++] = (uint8_t)offset;
+  dst[(*outposp)++] = (uint8_t)(offset >> 8);
+
+  if ((token_match >= 15U) &&
+      !put_length(dst, dst_size, outposp, token_match - 15U)) {
+    return false;
+  }
+
+  return true;
+}
+
+static bool get_length(const uint8_t *src, size_t src_size, size_t *inposp,
+                       size_t *lengthp) {
+  uint8_t b;
+
+  do {
+    if (*inposp >= src_size) {
+      return false;
+    }
+    b = src[(*inposp)++];
+    *lengthp += (size_t)b;
+  } while (b == 255U);
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the worst-case encoded size for a source buffer.
+ *
+ * @param[in] src_size          Source size in bytes.
+ * @return                      Worst-case encoded size.
+ * @retval 0                    Size overflow.
+ */
+size_t lz4block_encode_bound(size_t src_size) {
+  size_t extra;
+
+  extra = (src_size / 255U) + 16U;
+  if (src_size > (SIZE_MAX - extra)) {
+    return 0U;
+  }
+
+  return src_size + extra;
+}
+
+/**
+ * @brief   Encodes a buffer as a single LZ4 block.
+ * @details Greedy encoder using a hash table of the last positions of
+ *          each 4 bytes sequence.
+ *
+ * @param[in] src               Source buffer.
+ * @param[in] src_size          Source size, up to
+ *                              @p LZ4BLOCK_ENCODE_SIZE_MAX bytes.
+ * @param[out] dst              Destination buffer.
+ * @param[in] dst_size          Destination buffer size.
+ * @param[out] encoded_sizep    Written encoded size.
+ * @param[in] wsp               Pointer to the encoder workspace.
+ * @return                      The operation result.
+ * @retval true                 Encoding completed.
+ * @retval false                Invalid arguments or destination overflow.
+ */
+bool lz4block_encode(const uint8_t *src, size_t src_size,
+                     uint8_t *dst, size_t dst_size,
+                     size_t *encoded_sizep,
+                     lz4block_workspace_t *wsp) {
+  size_t inpos, anchor, outpos;
+
+  if ((encoded_sizep == NULL) || (wsp == NULL) ||
+      (src_size > LZ4BLOCK_ENCODE_SIZE_MAX)) {
+    return false;
+  }
+
+  *encoded_sizep = 0U;
+
+  if ((src == NULL) || (dst == NULL)) {
+    return false;
+  }
+
+  memset(wsp->table, 0, sizeof (wsp->table));
+
+  inpos = 0U;
+  anchor = 0U;
+  outpos = 0U;
+  if (src_size > MATCH_LIMIT) {
+    while (inpos <= src_size - MATCH_LIMIT) {
+      uint32_t sequence;
+      size_t h, candidate;
+
+      sequence = read32(&src[inpos]);
+      h = hash32(sequence);
+      candidate = (size_t)wsp->table[h];
+      wsp->table[h] = (uint16_t)inpos;
+
+      if ((candidate < inpos) &&
+          (inpos - candidate <= LZ4BLOCK_DISTANCE_MAX) &&
+          (read32(&src[candidate]) == sequence)) {
+        size_t match_size;
+
+        /* Extending the match up to the last literals.*/
+        match_size = LZ4BLOCK_MATCH_MIN;
+        while ((inpos + match_size < src_size - LAST_LITERALS) &&
+               (src[candidate + match_size] == src[inpos + match_size])) {
+          match_size++;
+        }
+
+        if (!put_sequence(dst, dst_size, &outpos,
+                          &src[anchor], inpos - anchor,
+                          inpos - candidate, match_size)) {
+          return false;
+        }
+
+        inpos += match_size;
+        anchor = inpos;
+      }
+      else {
+        inpos++;
+      }
+    }
+  }
+
+  /* Last literals.*/
+  if (!put_sequence(dst, dst_size, &outpos,
+                    &src[anchor], src_size - anchor, 0U, 0U)) {
+    return false;
+  }
+
+  *encoded_sizep = outpos;
+
+  return true;
+}
+
+/**
+ * @brief   Decodes an LZ4 block into a fixed-size output buffer.
+ *
+ * @param[in] src               Encoded buffer.
+ * @param[in] src_size          Encoded buffer size.
+ * @param[out] dst              Destination buffer.
+ * @param[in] dst_size          Destination size, also the expected decoded
+ *                              size.
+ * @return                      The operation result.
+ * @retval true                 Decoding completed.
+ * @retval false                Malformed stream or destination mismatch.
+ */
+bool lz4block_decode(const uint8_t *src, size_t src_size,
+                     uint8_t *dst, size_t dst_size) {
+  size_t inpos;
+  size_t outpos;
+
+  if ((src == NULL) || ((dst == NULL) && (dst_size > 0U))) {
+    return false;
+  }
+
+  inpos = 0U;
+  outpos = 0U;
+  while (inpos < src_size) {
+    size_t literal_size, match_size, offset;
+    uint8_t token;
+
+    token = src[inpos++];
+
+    /* Literals.*/
+    literal_size = (size_t)(token >> 4);
+    if ((literal_size == 15U) &&
+        !get_length(src, src_size, &inpos, &literal_size)) {
+      return false;
+    }
+    if ((src_size - inpos < literal_size) ||
+        (dst_size - outpos < literal_size)) {
+      return false;
+    }
+    memcpy(&dst[outpos], &src[inpos], literal_size);
+    inpos += literal_size;
+    outpos += literal_size;
+
+    /* The last sequence ends the block.*/
+    if (inpos == src_size) {
+      break;
+    }
+
+    /* Back reference.*/
+    if (src_size - inpos < 2U) {
+      return false;
+    }
+    offset = (size_t)src[inpos] | ((size_t)src[inpos + 1U] << 8);
+    inpos += 2U;
+    if ((offset == 0U) || (offset > outpos)) {
+      return false;
+    }
+
+    match_size = (size_t)(token & 15U);
+    if ((match_size == 15U) &&
+        !get_length(src, src_size, &inpos, &match_size)) {
+      return false;
+    }
+    match_size += LZ4BLOCK_MATCH_MIN;
+    if (dst_size - outpos < match_size) {
+      return false;
+    }
+
+    if (offset >= match_size) {
+      memcpy(&dst[outpos], &dst[outpos - offset], match_size);
+      outpos += match_size;
+    }
+    else {
+      /* Overlapping copy, it repeats the last offset bytes.*/
+      const uint8_t *p = &dst[outpos - offset];
+
+      while (match_size > 0U) {
+        dst[outpos++] = *p++;
+        match_size--;
+      }
+    }
+  }
+
+  return outpos == dst_size;
+}
+
+/** @} */
@@ -14,6 +14,9 @@ ifndef UTILSSRC
     ifneq ($(filter packbits,$(UTILSSELECT)),)
       UTILSSRC += ${CHIBIOS}/os/common/utils/src/packbits.c
     endif
+    ifneq ($(filter lz4block,$(UTILSSELECT)),)
+      UTILSSRC += ${CHIBIOS}/os/common/utils/src/lz4block.c
+    endif
   endif
   ALLCSRC += $(UTILSSRC)
 endif
@@ -0,0 +1,595 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_block_cache.c
+ * @brief   Block Cache Driver code.
+ * @details Set-associative, write-back, block cache layered on top of a
+ *          @p BaseBlockDevice. Single block accesses, typical of file
+ *          system metadata, are served through the cache, multi-block
+ *          accesses, typical of file data, bypass it while keeping cached
+ *          copies coherent. Dirty lines holding consecutive blocks are
+ *          written back using multi-block operations.
+ *
+ * @addtogroup HAL_BLOCK_CACHE
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "hal_block_cache.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define BCACHE_LINE_BUFFER(bcp, l)                                          \
+  (&(bcp)->config->buffer[(size_t)(l) * (size_t)BCACHE_CFG_BLOCK_SIZE])
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static bool bcache_is_inserted(void *instance);
+static bool bcache_is_protected(void *instance);
+
+static const struct BlockCacheDriverVMT bcache_vmt = {
+  (size_t)0,
+  bcache_is_inserted,
+  bcache_is_protected,
+  (bool (*)(void *))bcacheConnect,
+  (bool (*)(void *))bcacheDisconnect,
+  (bool (*)(void *, uint32_t, uint8_t *, uint32_t))bcacheRead,
+  (bool (*)(void *, uint32_t, const uint8_t *, uint32_t))bcacheWrite,
+  (bool (*)(void *))bcacheSync,
+  (bool (*)(void *, BlockDeviceInfo *))bcacheGetInfo
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool bcache_is_inserted(void *instance) {
+  BlockCacheDriver *bcp = (BlockCacheDriver *)instance;
+
+  return blkIsInserted(bcp->config->blkp);
+}
+
+static bool bcache_is_protected(void *instance) {
+  BlockCacheDriver *bcp = (BlockCacheDriver *)instance;
+
+  return blkIsWriteProtected(bcp->config->blkp);
+}
+
+/**
+ * @brief   Searches a block in the cache.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] block     block number
+ * @return              The index of the line caching the block.
+ * @retval -1           if the block is not cached.
+ *
+ * @notapi
+ */
+static int32_t bcache_lookup(BlockCacheDriver *bcp, uint32_t block) {
+  const BlockCacheConfig *cfgp = bcp->config;
+  uint32_t l, w;
+
+  l = block % cfgp->sets;
+  for (w = 0U; w < cfgp->ways; w++) {
+    if (((cfgp->lines[l].flags & BCACHE_LINE_VALID) != 0U) &&
+        (cfgp->lines[l].block == block)) {
+      return (int32_t)l;
+    }
+    l += cfgp->sets;
+  }
+
+  return -1;
+}
+
+/**
+ * @brief   Writes back a dirty line.
+ * @details The run of dirty lines holding consecutive blocks that contains
+ *          the specified line, within the same way, is written back using
+ *          a single multi-block operation.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] l         index of a dirty line
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool bcache_write_back(BlockCacheDriver *bcp, uint32_t l) {
+  const BlockCacheConfig *cfgp = bcp->config;
+  uint32_t first, last, wbase, i;
+
+  /* Lines of a way are consecutive in both the descriptors array and the
+     data buffer, finding the boundaries of the dirty run.*/
+  wbase = l - (l % cfgp->sets);
+  first = l;
+  while ((first > wbase) &&
+         ((cfgp->lines[first - 1U].flags & BCACHE_LINE_DIRTY) != 0U) &&
+         (cfgp->lines[first - 1U].block + 1U == cfgp->lines[first].block)) {
+    first--;
+  }
+  last = l;
+  while ((last + 1U < wbase + cfgp->sets) &&
+         ((cfgp->lines[last + 1U].flags & BCACHE_LINE_DIRTY) != 0U) &&
+         (cfgp->lines[last].block + 1U == cfgp->lines[last + 1U].block)) {
+    last++;
+  }
+
+  bcp->stats.dev_writes++;
+  if (blkWrite(cfgp->blkp, cfgp->lines[first].block,
+               BCACHE_LINE_BUFFER(bcp, first), last - first + 1U)) {
+    return HAL_FAILED;
+  }
+
+  for (i = first; i <= last; i++) {
+    cfgp->lines[i].flags &= ~BCACHE_LINE_DIRTY;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Allocates a line for a block.
+ * @details An invalid line of the block set is used if available else the
+ *          least recently used line is evicted, writing it back if dirty.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] block     block number
+ * @param[out] lp       index of the allocated line
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool bcache_allocate(BlockCacheDriver *bcp, uint32_t block,
+                            uint32_t *lp) {
+  const BlockCacheConfig *cfgp = bcp->config;
+  uint32_t l, w, victim;
+
+  victim = block % cfgp->sets;
+  l = victim;
+  for (w = 0U; w < cfgp->ways; w++) {
+    if ((cfgp->lines[l].flags & BCACHE_LINE_VALID) == 0U) {
+      victim = l;
+      break;
+    }
+    if ((bcp->stamp - cfgp->lines[l].stamp) >
+        (bcp->stamp - cfgp->lines[victim].stamp)) {
+      victim = l;
+    }
+    l += cfgp->sets;
+  }
+
+  if ((cfgp->lines[victim].flags & BCACHE_LINE_DIRTY) != 0U) {
+    if (bcache_write_back(bcp, victim)) {
+      return HAL_FAILED;
+    }
+  }
+
+  cfgp->lines[victim].flags = 0U;
+  cfgp->lines[victim].block = block;
+  *lp = victim;
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Marks a line as recently used.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] l         line index
+ *
+ * @notapi
+ */
+static void bcache_touch(BlockCacheDriver *bcp, uint32_t l) {
+
+  bcp->config->lines[l].stamp = bcp->stamp++;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] bcp      pointer to the @p BlockCacheDriver object
+ *
+ * @init
+ */
+void bcacheObjectInit(BlockCacheDriver *bcp) {
+
+  osalDbgCheck(bcp != NULL);
+
+  bcp->vmt    = &bcache_vmt;
+  bcp->state  = BLK_STOP;
+  bcp->config = NULL;
+}
+
+/**
+ * @brief   Configures and activates the block cache.
+ * @note    If the underlying device is already connected then the block
+ *          cache is put directly in the @p BLK_READY state.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void bcacheStart(BlockCacheDriver *bcp, const BlockCacheConfig *config) {
+
+  osalDbgCheck((bcp != NULL) && (config != NULL) &&
+               (config->blkp != NULL) && (config->sets > 0U) &&
+               (config->ways > 0U) && (config->buffer != NULL) &&
+               (config->lines != NULL));
+  osalDbgAssert(bcp->state == BLK_STOP, "invalid state");
+
+  bcp->config = config;
+  bcacheInvalidate(bcp);
+  if (blkGetDriverState(config->blkp) == BLK_READY) {
+    bcp->state = BLK_READY;
+  }
+  else {
+    bcp->state = BLK_ACTIVE;
+  }
+}
+
+/**
+ * @brief   Deactivates the block cache.
+ * @note    Dirty lines are written back before stopping.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   write back failed, the cache is stopped anyway.
+ *
+ * @api
+ */
+bool bcacheStop(BlockCacheDriver *bcp) {
+  bool result = HAL_SUCCESS;
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert((bcp->state == BLK_STOP) || (bcp->state == BLK_ACTIVE) ||
+                (bcp->state == BLK_READY), "invalid state");
+
+  if (bcp->state == BLK_READY) {
+    result = bcacheFlush(bcp);
+  }
+  bcp->config = NULL;
+  bcp->state  = BLK_STOP;
+
+  return result;
+}
+
+/**
+ * @brief   Connects the underlying device.
+ * @details The cache is invalidated.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheConnect(BlockCacheDriver *bcp) {
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert((bcp->state == BLK_ACTIVE) || (bcp->state == BLK_READY),
+                "invalid state");
+
+  if (bcp->state == BLK_READY) {
+    return HAL_SUCCESS;
+  }
+
+  if (blkConnect(bcp->config->blkp)) {
+    return HAL_FAILED;
+  }
+
+  bcacheInvalidate(bcp);
+  bcp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Disconnects the underlying device.
+ * @details Dirty lines are written back before disconnecting.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheDisconnect(BlockCacheDriver *bcp) {
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert((bcp->state == BLK_ACTIVE) || (bcp->state == BLK_READY),
+                "invalid state");
+
+  if (bcp->state == BLK_ACTIVE) {
+    return HAL_SUCCESS;
+  }
+
+  if (bcacheFlush(bcp)) {
+    return HAL_FAILED;
+  }
+
+  bcp->state = BLK_ACTIVE;
+
+  return blkDisconnect(bcp->config->blkp);
+}
+
+/**
+ * @brief   Reads one or more blocks.
+ * @details Single block reads are served through the cache, multi-block
+ *          reads are performed on the underlying device then overlaid with
+ *          the dirty lines falling in the range.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheRead(BlockCacheDriver *bcp, uint32_t startblk,
+                uint8_t *buf, uint32_t n) {
+  const BlockCacheConfig *cfgp;
+  int32_t found;
+  uint32_t l, i;
+
+  osalDbgCheck((bcp != NULL) && (buf != NULL) && (n > 0U));
+  osalDbgAssert(bcp->state == BLK_READY, "invalid state");
+
+  cfgp = bcp->config;
+
+  if (n == 1U) {
+    found = bcache_lookup(bcp, startblk);
+    if (found >= 0) {
+      l = (uint32_t)found;
+      bcp->stats.hits++;
+    }
+    else {
+      bcp->stats.misses++;
+      if (bcache_allocate(bcp, startblk, &l)) {
+        return HAL_FAILED;
+      }
+      bcp->stats.dev_reads++;
+      if (blkRead(cfgp->blkp, startblk, BCACHE_LINE_BUFFER(bcp, l), 1U)) {
+        return HAL_FAILED;
+      }
+      cfgp->lines[l].flags = BCACHE_LINE_VALID;
+    }
+    bcache_touch(bcp, l);
+    memcpy(buf, BCACHE_LINE_BUFFER(bcp, l), BCACHE_CFG_BLOCK_SIZE);
+
+    return HAL_SUCCESS;
+  }
+
+  bcp->stats.dev_reads++;
+  if (blkRead(cfgp->blkp, startblk, buf, n)) {
+    return HAL_FAILED;
+  }
+
+  /* Clean lines match the device content, only dirty lines need to be
+     copied over the data just read.*/
+  for (i = 0U; i < n; i++) {
+    found = bcache_lookup(bcp, startblk + i);
+    if ((found >= 0) &&
+        ((cfgp->lines[found].flags & BCACHE_LINE_DIRTY) != 0U)) {
+      memcpy(&buf[(size_t)i * (size_t)BCACHE_CFG_BLOCK_SIZE],
+             BCACHE_LINE_BUFFER(bcp, found), BCACHE_CFG_BLOCK_SIZE);
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Writes one or more blocks.
+ * @details Single block writes are cached and written back later,
+ *          multi-block writes are written through to the underlying device
+ *          and refresh the lines falling in the range.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] buf       pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheWrite(BlockCacheDriver *bcp, uint32_t startblk,
+                 const uint8_t *buf, uint32_t n) {
+  const BlockCacheConfig *cfgp;
+  int32_t found;
+  uint32_t l, i;
+
+  osalDbgCheck((bcp != NULL) && (buf != NULL) && (n > 0U));
+  osalDbgAssert(bcp->state == BLK_READY, "invalid state");
+
+  cfgp = bcp->config;
+
+  if (n == 1U) {
+    found = bcache_lookup(bcp, startblk);
+    if (found >= 0) {
+      l = (uint32_t)found;
+      bcp->stats.hits++;
+    }
+    else {
+      /* The whole block is overwritten, no need to read it.*/
+      bcp->stats.misses++;
+      if (bcache_allocate(bcp, startblk, &l)) {
+        return HAL_FAILED;
+      }
+    }
+    bcache_touch(bcp, l);
+    memcpy(BCACHE_LINE_BUFFER(bcp, l), buf, BCACHE_CFG_BLOCK_SIZE);
+    cfgp->lines[l].flags = BCACHE_LINE_VALID | BCACHE_LINE_DIRTY;
+
+    return HAL_SUCCESS;
+  }
+
+  bcp->stats.dev_writes++;
+  if (blkWrite(cfgp->blkp, startblk, buf, n)) {
+    return HAL_FAILED;
+  }
+
+  /* Cached copies are refreshed, the device content is now the same.*/
+  for (i = 0U; i < n; i++) {
+    found = bcache_lookup(bcp, startblk + i);
+    if (found >= 0) {
+      memcpy(BCACHE_LINE_BUFFER(bcp, found),
+             &buf[(size_t)i * (size_t)BCACHE_CFG_BLOCK_SIZE],
+             BCACHE_CFG_BLOCK_SIZE);
+      cfgp->lines[found].flags = BCACHE_LINE_VALID;
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Writes back all dirty lines and synchronizes the device.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheSync(BlockCacheDriver *bcp) {
+
+  osalDbgCheck(bcp != NULL);
+
+  if (bcp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  if (bcacheFlush(bcp)) {
+    return HAL_FAILED;
+  }
+
+  return blkSync(bcp->config->blkp);
+}
+
+/**
+ * @brief   Writes back all dirty lines.
+ * @details Dirty lines holding consecutive blocks in the same way are
+ *          merged into multi-block write operations.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheFlush(BlockCacheDriver *bcp) {
+  const BlockCacheConfig *cfgp;
+  uint32_t l, nlines;
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert(bcp->state == BLK_READY, "invalid state");
+
+  cfgp = bcp->config;
+  nlines = cfgp->sets * cfgp->ways;
+  for (l = 0U; l < nlines; l++) {
+    if ((cfgp->lines[l].flags & BCACHE_LINE_DIRTY) != 0U) {
+      if (bcache_write_back(bcp, l)) {
+        return HAL_FAILED;
+      }
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Invalidates the whole cache.
+ * @note    Dirty lines are discarded.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @api
+ */
+void bcacheInvalidate(BlockCacheDriver *bcp) {
+  const BlockCacheConfig *cfgp;
+  uint32_t l, nlines;
+
+  osalDbgCheck(bcp != NULL);
+
+  cfgp = bcp->config;
+  nlines = cfgp->sets * cfgp->ways;
+  for (l = 0U; l < nlines; l++) {
+    cfgp->lines[l].flags = 0U;
+    cfgp->lines[l].stamp = 0U;
+  }
+  bcp->stamp            = 0U;
+  bcp->stats.hits       = 0U;
+  bcp->stats.misses     = 0U;
+  bcp->stats.dev_reads  = 0U;
+  bcp->stats.dev_writes = 0U;
+}
+
+/**
+ * @brief   Returns the underlying device information.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[out] bdip     pointer to a @p BlockDeviceInfo structure
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcacheGetInfo(BlockCacheDriver *bcp, BlockDeviceInfo *bdip) {
+
+  osalDbgCheck((bcp != NULL) && (bdip != NULL));
+
+  if (bcp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  if (blkGetInfo(bcp->config->blkp, bdip)) {
+    return HAL_FAILED;
+  }
+  osalDbgAssert(bdip->blk_size == BCACHE_CFG_BLOCK_SIZE,
+                "block size mismatch");
+
+  return HAL_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,220 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_block_cache.h
+ * @brief   Block Cache Driver macros and structures.
+ *
+ * @addtogroup HAL_BLOCK_CACHE
+ * @{
+ */
+
+#ifndef HAL_BLOCK_CACHE_H
+#define HAL_BLOCK_CACHE_H
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Cache line flags
+ * @{
+ */
+#define BCACHE_LINE_VALID                   1U
+#define BCACHE_LINE_DIRTY                   2U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the cached blocks.
+ * @note    It must match the block size of the underlying block devices.
+ */
+#if !defined(BCACHE_CFG_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define BCACHE_CFG_BLOCK_SIZE               512U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if BCACHE_CFG_BLOCK_SIZE < 16
+#error "invalid BCACHE_CFG_BLOCK_SIZE value"
+#endif
+
+#if (BCACHE_CFG_BLOCK_SIZE & (BCACHE_CFG_BLOCK_SIZE - 1)) != 0
+#error "BCACHE_CFG_BLOCK_SIZE is not a power of two"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a cache line descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Cached block number.
+   */
+  uint32_t                  block;
+  /**
+   * @brief   Last access stamp, used for LRU replacement within a set.
+   */
+  uint32_t                  stamp;
+  /**
+   * @brief   Line flags.
+   */
+  uint32_t                  flags;
+} bcache_line_t;
+
+/**
+ * @brief   Type of a block cache configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying block device.
+   */
+  BaseBlockDevice           *blkp;
+  /**
+   * @brief   Number of sets.
+   * @note    Block @p b can only be cached in set <tt>b % sets</tt>.
+   */
+  uint32_t                  sets;
+  /**
+   * @brief   Number of ways, lines in each set.
+   */
+  uint32_t                  ways;
+  /**
+   * @brief   Lines data buffer.
+   * @note    It must be <tt>ways * sets * BCACHE_CFG_BLOCK_SIZE</tt> bytes
+   *          large. Lines of the same way are contiguous so consecutive
+   *          blocks cached in the same way can be written back with a single
+   *          multi-block operation.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Array of @p ways * @p sets line descriptors.
+   */
+  bcache_line_t             *lines;
+} BlockCacheConfig;
+
+/**
+ * @brief   Type of cache statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Single block accesses served from the cache.
+   */
+  uint32_t                  hits;
+  /**
+   * @brief   Single block accesses requiring a line allocation.
+   */
+  uint32_t                  misses;
+  /**
+   * @brief   Read operations issued to the underlying device.
+   */
+  uint32_t                  dev_reads;
+  /**
+   * @brief   Write operations issued to the underlying device.
+   */
+  uint32_t                  dev_writes;
+} bcache_stats_t;
+
+/**
+ * @brief   @p BlockCacheDriver specific methods.
+ */
+#define _block_cache_driver_methods                                         \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p BlockCacheDriver virtual methods table.
+ */
+struct BlockCacheDriverVMT {
+  _block_cache_driver_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Block cache driver class.
+ * @details Set-associative, write-back, cache of blocks implementing the
+ *          block device interface on top of another block device.
+ * @note    The driver is not thread safe, accesses must be serialized by
+ *          the user, FatFs does this when reentrancy is enabled.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct BlockCacheDriverVMT *vmt;
+  _base_block_device_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const BlockCacheConfig    *config;
+  /**
+   * @brief   Access counter used as LRU stamp.
+   */
+  uint32_t                  stamp;
+  /**
+   * @brief   Cache statistics.
+   */
+  bcache_stats_t            stats;
+} BlockCacheDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bcacheObjectInit(BlockCacheDriver *bcp);
+  void bcacheStart(BlockCacheDriver *bcp, const BlockCacheConfig *config);
+  bool bcacheStop(BlockCacheDriver *bcp);
+  bool bcacheConnect(BlockCacheDriver *bcp);
+  bool bcacheDisconnect(BlockCacheDriver *bcp);
+  bool bcacheRead(BlockCacheDriver *bcp, uint32_t startblk,
+                  uint8_t *buf, uint32_t n);
+  bool bcacheWrite(BlockCacheDriver *bcp, uint32_t startblk,
+                   const uint8_t *buf, uint32_t n);
+  bool bcacheSync(BlockCacheDriver *bcp);
+  bool bcacheFlush(BlockCacheDriver *bcp);
+  void bcacheInvalidate(BlockCacheDriver *bcp);
+  bool bcacheGetInfo(BlockCacheDriver *bcp, BlockDeviceInfo *bdip);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_BLOCK_CACHE_H */
+
+/** @} */
@@ -0,0 +1,9 @@
+# List of all the block cache driver files.
+BCACHESRC := $(CHIBIOS)/os/hal/lib/complex/block_cache/hal_block_cache.c
+
+# Required include directories
+BCACHEINC := $(CHIBIOS)/os/hal/lib/complex/block_cache
+
+# Shared variables
+ALLCSRC += $(BCACHESRC)
+ALLINC  += $(BCACHEINC)
@@ -42,6 +42,11 @@
 #define MFS_HEADER_MAGIC_1                  0x5FAE45F0U
 #define MFS_HEADER_MAGIC_2                  0xF045AE5FU
 
+/**
+ * @brief   Record identifier reserved to checkpoint records.
+ */
+#define MFS_CHECKPOINT_ID                   0U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -89,6 +94,50 @@
 #define MFS_CFG_STRONG_CHECKING             TRUE
 #endif
 
+/**
+ * @brief   Enables checkpoint records.
+ * @details A checkpoint record contains the location of all records, it is
+ *          written by the garbage collection, by @p mfsStop() and by
+ *          @p mfsWriteCheckpoint(). On mount only the records written after
+ *          the most recent valid checkpoint are scanned, if no valid
+ *          checkpoint is found then the whole bank is scanned.
+ * @note    Records described by a checkpoint are not CRC-checked on mount,
+ *          data errors are detected on read.
+ * @note    The compacted space is reduced by the size of a checkpoint record,
+ *          8 bytes for each record plus an header.
+ */
+#if !defined(MFS_CFG_CHECKPOINTS) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINTS                 FALSE
+#endif
+
+/**
+ * @brief   Enables the incremental garbage collection.
+ * @details The garbage collection is performed in bounded steps by calling
+ *          @p mfsPerformGarbageCollectionStep() periodically, for example
+ *          from a low priority thread. Writes only perform a blocking
+ *          garbage collection if the steps are not able to keep up.
+ */
+#if !defined(MFS_CFG_INCREMENTAL_GC) || defined(__DOXYGEN__)
+#define MFS_CFG_INCREMENTAL_GC              FALSE
+#endif
+
+/**
+ * @brief   Number of records processed in a garbage collection step.
+ */
+#if !defined(MFS_CFG_GC_STEP_RECORDS) || defined(__DOXYGEN__)
+#define MFS_CFG_GC_STEP_RECORDS             4
+#endif
+
+/**
+ * @brief   Garbage collection start threshold.
+ * @details An incremental garbage collection is started when the
+ *          immediately available space falls below this percentage of
+ *          the bank size.
+ */
+#if !defined(MFS_CFG_GC_START_THRESHOLD) || defined(__DOXYGEN__)
+#define MFS_CFG_GC_START_THRESHOLD          50
+#endif
+
 /**
  * @brief   Size of the buffer used for data copying.
  * @note    The buffer size must be a power of two and not smaller than
@@ -111,6 +160,18 @@
 #define MFS_CFG_MEMORY_ALIGNMENT            2
 #endif
 
+/**
+ * @brief   Bytes processed per iteration by the software CRC.
+ * @details Allowed values are 1, 4 and 8, the lookup tables take
+ *          512 bytes for each processed byte. Larger values speed up
+ *          records scanning at mount time and during garbage collection.
+ * @note    Not used for instances having a CRC function specified in their
+ *          configuration.
+ */
+#if !defined(MFS_CFG_CRC_SLICES) || defined(__DOXYGEN__)
+#define MFS_CFG_CRC_SLICES                  1
+#endif
+
 /**
  * @brief   Maximum number of objects writable in a single transaction.
  */
@@ -143,6 +204,22 @@
 #error "invalid MFS_MAX_REPAIR_ATTEMPTS value"
 #endif
 
+#if (MFS_CFG_CHECKPOINTS != FALSE) && (MFS_CFG_CHECKPOINTS != TRUE)
+#error "invalid MFS_CFG_CHECKPOINTS value"
+#endif
+
+#if (MFS_CFG_INCREMENTAL_GC != FALSE) && (MFS_CFG_INCREMENTAL_GC != TRUE)
+#error "invalid MFS_CFG_INCREMENTAL_GC value"
+#endif
+
+#if MFS_CFG_GC_STEP_RECORDS < 1
+#error "invalid MFS_CFG_GC_STEP_RECORDS value"
+#endif
+
+#if (MFS_CFG_GC_START_THRESHOLD < 1) || (MFS_CFG_GC_START_THRESHOLD > 100)
+#error "invalid MFS_CFG_GC_START_THRESHOLD value"
+#endif
+
 #if MFS_CFG_BUFFER_SIZE < 16
 #error "invalid MFS_CFG_BUFFER_SIZE value"
 #endif
@@ -160,6 +237,11 @@
 #error "MFS_CFG_MEMORY_ALIGNMENT is not a power of two"
 #endif
 
+#if (MFS_CFG_CRC_SLICES != 1) && (MFS_CFG_CRC_SLICES != 4) &&               \
+    (MFS_CFG_CRC_SLICES != 8)
+#error "invalid MFS_CFG_CRC_SLICES value"
+#endif
+
 #if (MFS_CFG_TRANSACTION_MAX < 0) ||                                        \
     (MFS_CFG_TRANSACTION_MAX > MFS_CFG_MAX_RECORDS)
 #error "invalid MFS_CFG_TRANSACTION_MAX value"
@@ -188,6 +270,15 @@ typedef enum {
   MFS_ERROR = 4
 } mfs_state_t;
 
+/**
+ * @brief   Type of incremental garbage collection states.
+ */
+typedef enum {
+  MFS_GC_IDLE = 0,
+  MFS_GC_COPYING = 1,
+  MFS_GC_ERASING = 2
+} mfs_gc_state_t;
+
 /**
  * @brief   Type of an MFS error code.
  * @note    Errors are negative integers, informative warnings are positive
@@ -298,6 +389,20 @@ typedef struct {
   uint32_t                  size;
 } mfs_record_descriptor_t;
 
+/**
+ * @brief   Type of a CRC function.
+ * @details The function must compute a CRC16-CCITT (polynomial 0x1021, not
+ *          reflected, no final XOR) continuing from the specified value.
+ *
+ * @param[in] crc       initial or partial CRC value
+ * @param[in] data      pointer to the data buffer
+ * @param[in] n         number of bytes in the buffer
+ * @return              The updated CRC value.
+ */
+typedef uint16_t (*mfs_crc_function_t)(uint16_t crc,
+                                       const uint8_t *data,
+                                       size_t n);
+
 /**
  * @brief   Type of a MFS configuration structure.
  */
@@ -334,6 +439,12 @@ typedef struct {
    *          @p bank_size.
    */
   flash_sector_t            bank1_sectors;
+  /**
+   * @brief   CRC function or @p NULL.
+   * @details Allows to offload checksums to a CRC peripheral, if @p NULL
+   *          then the internal software implementation is used.
+   */
+  mfs_crc_function_t        crcfunc;
 } MFSConfig;
 
 /**
@@ -354,6 +465,24 @@ typedef struct {
   mfs_id_t                  id;
 } mfs_transaction_op_t;
 
+/**
+ * @brief   Type of a record write request for @p mfsWriteRecords().
+ */
+typedef struct {
+  /**
+   * @brief   Record identifier.
+   */
+  mfs_id_t                  id;
+  /**
+   * @brief   Record data size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Record data.
+   */
+  const uint8_t             *buffer;
+} mfs_record_write_t;
+
 /**
  * @brief   Type of an non-cacheable MFS buffer.
  */
@@ -398,6 +527,36 @@ typedef struct {
    * @note    Zero means that there is not a record with that id.
    */
   mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+#if (MFS_CFG_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   End of the bank area described by the last checkpoint.
+   * @note    It is equal to @p next_offset if the last checkpoint is
+   *          up to date, zero if records follow the last valid checkpoint.
+   */
+  flash_offset_t            checkpoint_offset;
+#endif
+#if (MFS_CFG_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Incremental garbage collection state.
+   */
+  mfs_gc_state_t            gc_state;
+  /**
+   * @brief   Next record header to be examined in the current bank.
+   */
+  flash_offset_t            gc_src_offset;
+  /**
+   * @brief   Next write offset in the destination bank.
+   */
+  flash_offset_t            gc_dest_offset;
+  /**
+   * @brief   Value of @p next_offset when the garbage collection started.
+   */
+  flash_offset_t            gc_start_offset;
+  /**
+   * @brief   Next sector to be erased in the old bank.
+   */
+  flash_sector_t            gc_sector;
+#endif
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
   /**
    * @brief   Next write offset for current transaction.
@@ -460,8 +619,16 @@ extern "C" {
                             size_t *np, uint8_t *buffer);
   mfs_error_t mfsWriteRecord(MFSDriver *devp, mfs_id_t id,
                              size_t n, const uint8_t *buffer);
+  mfs_error_t mfsWriteRecords(MFSDriver *mfsp,
+                              const mfs_record_write_t *records, size_t n);
   mfs_error_t mfsEraseRecord(MFSDriver *devp, mfs_id_t id);
   mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp);
+#if MFS_CFG_CHECKPOINTS == TRUE
+  mfs_error_t mfsWriteCheckpoint(MFSDriver *mfsp);
+#endif
+#if MFS_CFG_INCREMENTAL_GC == TRUE
+  mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp);
+#endif
 #if MFS_CFG_TRANSACTION_MAX > 0
   mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size);
   mfs_error_t mfsCommitTransaction(MFSDriver *mfsp);
@@ -79,6 +79,13 @@ static flash_error_t sim_efl_check_program(const uint8_t *dst,
 
 static void sim_efl_program(uint8_t *dst, const uint8_t *src, size_t n) {
   size_t i;
+#if SIM_EFL_PROGRAM_COST > 0
+  volatile unsigned j;
+
+  /* Emulated fixed cost of the operation.*/
+  for (j = 0U; j < SIM_EFL_PROGRAM_COST; j++) {
+  }
+#endif
 
   for (i = 0U; i < n; i++) {
     dst[i] &= src[i];
@@ -259,6 +266,7 @@ flash_error_t efl_lld_start_erase_all(void *instance) {
   }
 
   devp->state = FLASH_ERASE;
+  devp->erase_start = osalOsGetSystemTimeX();
   memset(devp->descriptor->address, 0xFF, devp->descriptor->size);
 
   return FLASH_NO_ERROR;
@@ -293,6 +301,7 @@ flash_error_t efl_lld_start_erase_sector(void *instance,
   }
 
   devp->state = FLASH_ERASE;
+  devp->erase_start = osalOsGetSystemTimeX();
   offset = flashGetSectorOffset(getBaseFlash(devp), sector);
   size = flashGetSectorSize(getBaseFlash(devp), sector);
   memset(devp->descriptor->address + offset, 0xFF, size);
@@ -322,6 +331,18 @@ flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec) {
     *msec = 0U;
   }
 
+#if SIM_EFL_ERASE_TIME > 0
+  /* Emulated erase time.*/
+  if ((devp->state == FLASH_ERASE) &&
+      (osalTimeDiffX(devp->erase_start, osalOsGetSystemTimeX()) <
+       OSAL_MS2I(SIM_EFL_ERASE_TIME))) {
+    if (msec != NULL) {
+      *msec = 1U;
+    }
+    return FLASH_BUSY_ERASING;
+  }
+#endif
+
   if (devp->state == FLASH_ERASE) {
     devp->state = FLASH_READY;
   }
@@ -59,6 +59,23 @@
 #if !defined(SIM_EFL_PAGE_SIZE) || defined(__DOXYGEN__)
 #define SIM_EFL_PAGE_SIZE                   16U
 #endif
+
+/**
+ * @brief   Simulated sector erase time in milliseconds.
+ * @note    Zero means instantaneous erase operations.
+ */
+#if !defined(SIM_EFL_ERASE_TIME) || defined(__DOXYGEN__)
+#define SIM_EFL_ERASE_TIME                  0U
+#endif
+
+/**
+ * @brief   Simulated fixed cost of a program operation.
+ * @details Number of iterations of a busy loop performed on each program
+ *          operation, zero means no emulated cost.
+ */
+#if !defined(SIM_EFL_PROGRAM_COST) || defined(__DOXYGEN__)
+#define SIM_EFL_PROGRAM_COST                0U
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -102,7 +119,8 @@
  */
 #define efl_lld_driver_fields                                               \
   uint8_t                  *memory;                                        \
-  const flash_descriptor_t *descriptor;
+  const flash_descriptor_t *descriptor;                                    \
+  systime_t                 erase_start;
 
 /**
  * @brief   Low level fields of the embedded flash configuration structure.
@@ -22,9 +22,16 @@
  * @{
  */
 
+#if defined(__linux__)
+/* Required for ppoll().*/
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#if defined(__linux__)
+#include <sys/timerfd.h>
+#endif
 
 #include "hal.h"
 
@@ -36,8 +43,12 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static struct timeval nextcnt;
-static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
+#if defined(__linux__) || defined(__DOXYGEN__)
+/**
+ * @brief   Timer file descriptor used for waking up on the next ST event.
+ */
+static int sim_timerfd = -1;
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
@@ -61,15 +72,20 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
-  timeradd(&nextcnt, &tick, &nextcnt);
+
+#if defined(__linux__)
+  sim_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (sim_timerfd == -1) {
+    puts("Unable to create the simulator timer\n");
+    exit(1);
+  }
+#endif
 }
 
 /**
  * @brief   Interrupt simulation.
  */
 void _sim_check_for_interrupts(void) {
-  struct timeval tv;
   bool int_occurred = false;
 
 #if HAL_USE_SERIAL
@@ -78,18 +94,8 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
-  gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
+  if (st_lld_serve_interrupt()) {
     int_occurred = true;
-    timeradd(&nextcnt, &tick, &nextcnt);
-
-    CH_IRQ_PROLOGUE();
-
-    chSysLockFromISR();
-    chSysTimerHandlerI();
-    chSysUnlockFromISR();
-
-    CH_IRQ_EPILOGUE();
   }
 
   if (int_occurred) {
@@ -100,4 +106,38 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Interrupt wait.
+ * @details The host process sleeps until the next ST event or until
+ *          activity on the simulated serial ports, then pending interrupts
+ *          are served.
+ * @note    On hosts without @p timerfd support the function degrades to
+ *          interrupts polling.
+ */
+void _sim_wait_for_interrupts(void) {
+#if defined(__linux__)
+  struct pollfd fds[SIM_MAX_POLL_FDS];
+  struct itimerspec its = {0};
+  nfds_t n;
+
+  /* Arming the timer on the next ST event, a zero time disarms it.*/
+  (void) st_lld_get_deadline(&its.it_value);
+  (void) timerfd_settime(sim_timerfd, TFD_TIMER_ABSTIME, &its, NULL);
+
+  fds[0].fd      = sim_timerfd;
+  fds[0].events  = POLLIN;
+  fds[0].revents = 0;
+  n = 1U;
+#if HAL_USE_SERIAL
+  n += (nfds_t)sd_lld_get_poll_fds(&fds[1]);
+#endif
+
+  /* Sleeping until something happens, conditions already pending make
+     this call return immediately.*/
+  (void) ppoll(fds, n, NULL, NULL);
+#endif
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
@@ -33,6 +33,7 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #endif
 #include <stdio.h>
 
@@ -49,6 +50,12 @@
 #define PLATFORM_NAME   "Posix Simulator"
 #endif
 
+/**
+ * @brief   Maximum number of file descriptors polled while waiting.
+ * @note    The ST timer plus one for each simulated serial port.
+ */
+#define SIM_MAX_POLL_FDS                    3
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -86,6 +93,7 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
 #ifdef __cplusplus
 }
 #endif
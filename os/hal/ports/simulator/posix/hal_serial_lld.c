@@ -190,6 +190,40 @@ static bool inint(SerialDriver *sdp) {
   return false;
 }
 
+static unsigned pollsetup(SerialDriver *sdp, struct pollfd *pfd) {
+
+  if (sdp->com_data != -1) {
+    short events = 0;
+
+    /* Waiting for input only if there is space in the input queue and
+       for output only if there is data to be sent.*/
+    osalSysLock();
+    if (iqGetEmptyI(&sdp->iqueue) > 0U) {
+      events |= POLLIN;
+    }
+    if (!oqIsEmptyI(&sdp->oqueue)) {
+      events |= POLLOUT;
+    }
+    osalSysUnlock();
+
+    pfd->fd      = sdp->com_data;
+    pfd->events  = events;
+    pfd->revents = 0;
+    return 1U;
+  }
+
+  if (sdp->com_listen != -1) {
+
+    /* Waiting for a connection.*/
+    pfd->fd      = sdp->com_listen;
+    pfd->events  = POLLIN;
+    pfd->revents = 0;
+    return 1U;
+  }
+
+  return 0U;
+}
+
 static bool outint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
@@ -308,6 +342,27 @@ bool sd_lld_interrupt_pending(void) {
   return b;
 }
 
+/**
+ * @brief   Returns the descriptors to be polled for serial activity.
+ *
+ * @param[out] pfds     array of @p pollfd structures to be filled, it must
+ *                      have space for one descriptor for each port
+ * @return              The number of filled descriptors.
+ */
+unsigned sd_lld_get_poll_fds(struct pollfd *pfds) {
+  unsigned n = 0U;
+
+#if USE_SIM_SERIAL1
+  n += pollsetup(&SD1, &pfds[n]);
+#endif
+
+#if USE_SIM_SERIAL2
+  n += pollsetup(&SD2, &pfds[n]);
+#endif
+
+  return n;
+}
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
@@ -0,0 +1,304 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_st_lld.c
+ * @brief   Posix simulator ST subsystem low level driver source.
+ * @details The system counter is derived from @p CLOCK_MONOTONIC scaled
+ *          to @p OSAL_ST_FREQUENCY, in free running mode the alarm emulates
+ *          a compare register matching the counter.
+ *
+ * @addtogroup ST
+ * @{
+ */
+
+#include "hal.h"
+
+#if (OSAL_ST_MODE != OSAL_ST_MODE_NONE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Nanoseconds in a second.
+ */
+#define ST_NS_PER_SECOND                    1000000000ULL
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Host monotonic time of counter zero.
+ */
+static struct timespec st_origin;
+
+/**
+ * @brief   Absolute counter value of the next timer event.
+ * @details The next tick in periodic mode, the alarm match in free
+ *          running mode.
+ */
+static uint64_t st_next;
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Alarm enable state.
+ */
+static bool st_alarm_active;
+#endif
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the absolute counter value.
+ *
+ * @return              The counter value, it never wraps.
+ */
+static uint64_t st_get_ticks(void) {
+  struct timespec ts;
+  uint64_t sec;
+  int64_t nsec;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  sec  = (uint64_t)(ts.tv_sec - st_origin.tv_sec);
+  nsec = (int64_t)ts.tv_nsec - (int64_t)st_origin.tv_nsec;
+  if (nsec < 0) {
+    nsec += (int64_t)ST_NS_PER_SECOND;
+    sec--;
+  }
+
+  return (sec * (uint64_t)OSAL_ST_FREQUENCY) +
+         (((uint64_t)nsec * (uint64_t)OSAL_ST_FREQUENCY) / ST_NS_PER_SECOND);
+}
+
+/**
+ * @brief   Converts an absolute counter value in host monotonic time.
+ * @note    The time is rounded up so that the counter has reached the
+ *          specified value at the returned time.
+ *
+ * @param[in] ticks     absolute counter value
+ * @param[out] tsp      pointer to the host time
+ */
+static void st_ticks_to_timespec(uint64_t ticks, struct timespec *tsp) {
+  uint64_t sec, nsec;
+
+  sec  = ticks / (uint64_t)OSAL_ST_FREQUENCY;
+  nsec = (((ticks % (uint64_t)OSAL_ST_FREQUENCY) * ST_NS_PER_SECOND) +
+          ((uint64_t)OSAL_ST_FREQUENCY - 1ULL)) / (uint64_t)OSAL_ST_FREQUENCY;
+  nsec += (uint64_t)st_origin.tv_nsec;
+  if (nsec >= ST_NS_PER_SECOND) {
+    nsec -= ST_NS_PER_SECOND;
+    sec++;
+  }
+
+  tsp->tv_sec  = st_origin.tv_sec + (time_t)sec;
+  tsp->tv_nsec = (long)nsec;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated ST interrupt.
+ * @details Invokes the OS timer handler if the next timer event has been
+ *          reached.
+ *
+ * @return              The interrupt state.
+ * @retval false        if no interrupt occurred.
+ * @retval true         if the interrupt has been served.
+ *
+ * @notapi
+ */
+bool st_lld_serve_interrupt(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  if (st_get_ticks() < st_next) {
+    return false;
+  }
+
+  /* Late ticks are recovered one per call, no tick is lost.*/
+  st_next++;
+#else /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
+  if (!st_alarm_active || (st_get_ticks() < st_next)) {
+    return false;
+  }
+
+  /* Like a compare register, the alarm would match again only after the
+     counter wraps.*/
+#if OSAL_ST_RESOLUTION < 64
+  st_next += (uint64_t)1 << OSAL_ST_RESOLUTION;
+#else
+  st_next = (uint64_t)-1;
+#endif
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
+
+  OSAL_IRQ_PROLOGUE();
+
+  osalSysLockFromISR();
+  osalOsTimerHandlerI();
+  osalSysUnlockFromISR();
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level ST driver initialization.
+ *
+ * @notapi
+ */
+void st_lld_init(void) {
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &st_origin);
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  st_next = 1ULL;
+#else
+  st_next = 0ULL;
+  st_alarm_active = false;
+#endif
+}
+
+/**
+ * @brief   Returns the host time of the next timer event.
+ *
+ * @param[out] tsp      pointer to the host monotonic time of the event
+ * @return              The event state.
+ * @retval false        if there is no pending event.
+ * @retval true         if there is a pending event.
+ *
+ * @notapi
+ */
+bool st_lld_get_deadline(struct timespec *tsp) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  if (!st_alarm_active) {
+    return false;
+  }
+#endif
+
+  st_ticks_to_timespec(st_next, tsp);
+
+  return true;
+}
+
+/**
+ * @brief   Returns the time counter value.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+
+  return (systime_t)st_get_ticks();
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t time) {
+
+  st_lld_set_alarm(time);
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_alarm_active = true;
+#endif
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_alarm_active = false;
+#endif
+}
+
+/**
+ * @brief   Sets the alarm time.
+ * @note    The alarm matches the next time the counter reaches the
+ *          specified value, possibly after a counter wrap.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t time) {
+  uint64_t now = st_get_ticks();
+
+  st_next = now + (uint64_t)(systime_t)(time - (systime_t)now);
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return (systime_t)st_next;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  return st_alarm_active;
+#else
+  return false;
+#endif
+}
+
+#endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
+
+/** @} */
@@ -227,6 +227,19 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   TLSF heaps support.
+ * @details If enabled then heaps initialized with @p chHeapObjectInitTLSF()
+ *          use a two levels segregated fit allocator with constant time
+ *          allocation and release.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF)
+#define CH_CFG_USE_HEAP_TLSF                FALSE
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -271,6 +284,18 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Objects Caches statistics.
+ * @details If enabled then the objects caches keep count of hits, misses
+ *          and collisions lists length for each hash table slot.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_OBJ_CACHES.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_STATISTICS)
+#define CH_CFG_OBJ_CACHES_STATISTICS        FALSE
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -293,6 +318,29 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Jobs Queues priority levels.
+ * @details Number of jobs priority levels, each level is a separate FIFO.
+ *
+ * @note    The default is @p 1.
+ * @note    Requires @p CH_CFG_USE_JOBS.
+ */
+#if !defined(CH_CFG_JOBS_PRIORITIES)
+#define CH_CFG_JOBS_PRIORITIES              1
+#endif
+
+/**
+ * @brief   Jobs Queues statistics.
+ * @details If enabled then the jobs queues keep track of the queue depth
+ *          and of the latency between posting and dispatching of jobs.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_JOBS and @p PORT_SUPPORTS_RT.
+ */
+#if !defined(CH_CFG_JOBS_STATISTICS)
+#define CH_CFG_JOBS_STATISTICS              FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -26,6 +26,8 @@
  *            available jobs.
  *          - <b>Post</b>: A job is posted to the queue, it will be
  *            returned to the pool after execution.
+ *          - <b>Dispatch</b>: A job is taken from the queue, highest
+ *            priority first, and executed.
  *          .
  *
  * @addtogroup oslib_jobs_queues
@@ -46,10 +48,33 @@
  */
 #define MSG_JOB_NULL    ((msg_t)-3)
 
+/**
+ * @brief   Priority of jobs posted without an explicit priority.
+ */
+#define JOB_PRIO_NORMAL 0U
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of jobs priority levels.
+ * @details Each priority level is a separate FIFO, dispatchers always
+ *          take the oldest job of the highest non-empty level.
+ */
+#if !defined(CH_CFG_JOBS_PRIORITIES) || defined(__DOXYGEN__)
+#define CH_CFG_JOBS_PRIORITIES              1
+#endif
+
+/**
+ * @brief   Jobs queues statistics.
+ * @details If enabled then jobs queues keep track of the queue depth and
+ *          of the latency between posting and dispatching of jobs.
+ */
+#if !defined(CH_CFG_JOBS_STATISTICS) || defined(__DOXYGEN__)
+#define CH_CFG_JOBS_STATISTICS              FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -66,10 +91,50 @@
 #error "CH_CFG_USE_JOBS requires CH_CFG_USE_MAILBOXES"
 #endif
 
+#if (CH_CFG_JOBS_PRIORITIES < 1) || (CH_CFG_JOBS_PRIORITIES > 8)
+#error "invalid CH_CFG_JOBS_PRIORITIES value specified"
+#endif
+
+#if (CH_CFG_JOBS_STATISTICS == TRUE) && (PORT_SUPPORTS_RT == FALSE)
+#error "CH_CFG_JOBS_STATISTICS requires PORT_SUPPORTS_RT"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_CFG_JOBS_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a jobs queue statistics.
+ */
+typedef struct ch_jobs_stats {
+  /**
+   * @brief   Jobs currently waiting in the queue.
+   */
+  ucnt_t                    depth;
+  /**
+   * @brief   Highest number of jobs waiting in the queue.
+   */
+  ucnt_t                    maxdepth;
+  /**
+   * @brief   Number of jobs dispatched.
+   */
+  ucnt_t                    dispatched;
+  /**
+   * @brief   Number of jobs dispatched by the workers of other queues.
+   */
+  ucnt_t                    stolen;
+  /**
+   * @brief   Worst posting to dispatching latency.
+   */
+  rtcnt_t                   worst;
+  /**
+   * @brief   Cumulative posting to dispatching latency.
+   */
+  uint64_t                  cumulative;
+} jobs_stats_t;
+#endif
+
 /**
  * @brief   Type of a jobs queue.
  */
@@ -79,9 +144,31 @@ typedef struct ch_jobs_queue {
    */
   guarded_memory_pool_t     free;
   /**
-   * @brief   Mailbox of the sent jobs.
+   * @brief   Counter of the sent jobs.
+   */
+  semaphore_t               sem;
+  /**
+   * @brief   Mailboxes of the sent jobs, one for each priority level.
+   */
+  mailbox_t                 mbx[CH_CFG_JOBS_PRIORITIES];
+  /**
+   * @brief   Queues whose jobs can be stolen or @p NULL.
    */
-  mailbox_t                 mbx;
+  struct ch_jobs_queue      * const *peers;
+  /**
+   * @brief   Number of elements in the @p peers array.
+   */
+  unsigned                  npeers;
+  /**
+   * @brief   Interval between attempts to steal jobs from peers.
+   */
+  sysinterval_t             period;
+#if (CH_CFG_JOBS_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Queue statistics.
+   */
+  jobs_stats_t              stats;
+#endif
 } jobs_queue_t;
 
 /**
@@ -101,12 +188,58 @@ typedef struct ch_job_descriptor {
    * @brief   Argument to be passed to the job function.
    */
   void                      *jobarg;
+#if (CH_CFG_JOBS_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Posting time.
+   */
+  rtcnt_t                   jobtime;
+#endif
 } job_descriptor_t;
 
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a jobs workers pool descriptor.
+ */
+typedef struct ch_jobs_workers_descriptor {
+  /**
+   * @brief   Workers name.
+   */
+  const char                *name;
+  /**
+   * @brief   Pointer to an array of working areas.
+   */
+  stkline_t                 *wbase;
+  /**
+   * @brief   Size of each working area in bytes.
+   */
+  size_t                    wsize;
+  /**
+   * @brief   Number of workers.
+   */
+  unsigned                  n;
+  /**
+   * @brief   Workers priority.
+   */
+  tprio_t                   prio;
+  /**
+   * @brief   OS instance affinity or @p NULL for current one.
+   */
+  os_instance_t             *owner;
+} jobs_workers_descriptor_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Size of the messages buffer of a jobs queue.
+ *
+ * @param[in] jobsn     number of jobs available
+ * @return              The required number of @p msg_t elements.
+ */
+#define JOBS_MSGBUF_SIZE(jobsn) ((jobsn) * CH_CFG_JOBS_PRIORITIES)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -114,7 +247,27 @@ typedef struct ch_job_descriptor {
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+  void chJobObjectInit(jobs_queue_t *jqp,
+                       size_t jobsn,
+                       job_descriptor_t *jobsbuf,
+                       msg_t *msgbuf);
+  void chJobObjectDispose(jobs_queue_t *jqp);
+  void chJobSetPeers(jobs_queue_t *jqp,
+                     jobs_queue_t * const *peers,
+                     unsigned npeers,
+                     sysinterval_t period);
+  void chJobPostPrioI(jobs_queue_t *jqp, job_descriptor_t *jp, unsigned prio);
+  void chJobPostAheadI(jobs_queue_t *jqp, job_descriptor_t *jp);
+  msg_t chJobDispatchTimeout(jobs_queue_t *jqp, sysinterval_t timeout);
+#if defined(__CHIBIOS_RT__)
+  void chJobCreateWorkers(jobs_queue_t *jqp,
+                          const jobs_workers_descriptor_t *wdp,
+                          thread_t **tpp);
+#endif
+#if CH_CFG_JOBS_STATISTICS == TRUE
+  void chJobGetStats(jobs_queue_t *jqp, jobs_stats_t *sp);
+  void chJobResetStats(jobs_queue_t *jqp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -123,53 +276,6 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
-/**
- * @brief   Initializes a jobs queue object.
- *
- * @param[out] jqp      pointer to a @p jobs_queue_t object
- * @param[in] jobsn     number of jobs available
- * @param[in] jobsbuf   pointer to the buffer of jobs, it must be able
- *                      to hold @p jobsn @p job_descriptor_t structures
- * @param[in] msgbuf    pointer to the buffer of messages, it must be able
- *                      to hold @p jobsn @p msg_t messages
- *
- * @init
- */
-static inline void chJobObjectInit(jobs_queue_t *jqp,
-                                   size_t jobsn,
-                                   job_descriptor_t *jobsbuf,
-                                   msg_t *msgbuf) {
-
-  chDbgCheck((jqp != NULL) && (jobsn > 0U) && (jobsbuf != NULL) && (msgbuf != NULL));
-
-  chGuardedPoolObjectInit(&jqp->free, sizeof (job_descriptor_t));
-  chGuardedPoolLoadArray(&jqp->free, (void *)jobsbuf, jobsn);
-  chMBObjectInit(&jqp->mbx, msgbuf, jobsn);
-}
-
-/**
- * @brief   Disposes a jobs queue object.
- * @note    Objects disposing does not involve freeing memory but just
- *          performing checks that make sure that the object is in a
- *          state compatible with operations stop.
- * @note    If the option @p CH_CFG_HARDENING_LEVEL is greater than zero then
- *          the object is also cleared, attempts to use the object would likely
- *          result in a clean memory access violation because dereferencing
- *          of @p NULL pointers rather than dereferencing previously valid
- *          pointers.
- *
- * @param[in] jqp       pointer to a @p jobs_queue_t object
- *
- * @dispose
- */
-static inline void chJobObjectDispose(jobs_queue_t *jqp) {
-
-  chDbgCheck(jqp != NULL);
-
-  chGuardedPoolObjectDispose(&jqp->free);
-  chMBObjectDispose(&jqp->mbx);
-}
-
 /**
  * @brief   Allocates a free job object.
  *
@@ -238,21 +344,42 @@ static inline job_descriptor_t *chJobGetTimeout(jobs_queue_t *jqp,
 }
 
 /**
- * @brief   Posts a job object.
+ * @brief   Posts a job object with the specified priority.
  * @note    By design the object can be always immediately posted.
  *
  * @param[in] jqp       pointer to a @p jobs_queue_t object
  * @param[in] jp        pointer to the job object to be posted
+ * @param[in] prio      job priority, from @p JOB_PRIO_NORMAL to
+ *                      @p CH_CFG_JOBS_PRIORITIES - 1
  *
- * @iclass
+ * @sclass
  */
-static inline void chJobPostI(jobs_queue_t *jqp, job_descriptor_t *jp) {
-  msg_t msg;
+static inline void chJobPostPrioS(jobs_queue_t *jqp,
+                                  job_descriptor_t *jp,
+                                  unsigned prio) {
 
-  chDbgCheck(jp != NULL);
+  chJobPostPrioI(jqp, jp, prio);
+  chSchRescheduleS();
+}
 
-  msg = chMBPostI(&jqp->mbx, (msg_t)jp);
-  chDbgAssert(msg == MSG_OK, "post failed");
+/**
+ * @brief   Posts a job object with the specified priority.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] jp        pointer to the job object to be posted
+ * @param[in] prio      job priority, from @p JOB_PRIO_NORMAL to
+ *                      @p CH_CFG_JOBS_PRIORITIES - 1
+ *
+ * @api
+ */
+static inline void chJobPostPrio(jobs_queue_t *jqp,
+                                 job_descriptor_t *jp,
+                                 unsigned prio) {
+
+  chSysLock();
+  chJobPostPrioS(jqp, jp, prio);
+  chSysUnlock();
 }
 
 /**
@@ -262,15 +389,11 @@ static inline void chJobPostI(jobs_queue_t *jqp, job_descriptor_t *jp) {
  * @param[in] jqp       pointer to a @p jobs_queue_t object
  * @param[in] jp        pointer to the job object to be posted
  *
- * @sclass
+ * @iclass
  */
-static inline void chJobPostS(jobs_queue_t *jqp, job_descriptor_t *jp) {
-  msg_t msg;
-
-  chDbgCheck(jp != NULL);
+static inline void chJobPostI(jobs_queue_t *jqp, job_descriptor_t *jp) {
 
-  msg = chMBPostTimeoutS(&jqp->mbx, (msg_t)jp, TIME_IMMEDIATE);
-  chDbgAssert(msg == MSG_OK, "post failed");
+  chJobPostPrioI(jqp, jp, JOB_PRIO_NORMAL);
 }
 
 /**
@@ -280,33 +403,25 @@ static inline void chJobPostS(jobs_queue_t *jqp, job_descriptor_t *jp) {
  * @param[in] jqp       pointer to a @p jobs_queue_t object
  * @param[in] jp        pointer to the job object to be posted
  *
- * @api
+ * @sclass
  */
-static inline void chJobPost(jobs_queue_t *jqp, job_descriptor_t *jp) {
-  msg_t msg;
-
-  chDbgCheck(jp != NULL);
+static inline void chJobPostS(jobs_queue_t *jqp, job_descriptor_t *jp) {
 
-  msg = chMBPostTimeout(&jqp->mbx, (msg_t)jp, TIME_IMMEDIATE);
-  chDbgAssert(msg == MSG_OK, "post failed");
+  chJobPostPrioS(jqp, jp, JOB_PRIO_NORMAL);
 }
 
 /**
- * @brief   Posts an high priority job object.
+ * @brief   Posts a job object.
  * @note    By design the object can be always immediately posted.
  *
  * @param[in] jqp       pointer to a @p jobs_queue_t object
  * @param[in] jp        pointer to the job object to be posted
  *
- * @iclass
+ * @api
  */
-static inline void chJobPostAheadI(jobs_queue_t *jqp, job_descriptor_t *jp) {
-  msg_t msg;
-
-  chDbgCheck(jp != NULL);
+static inline void chJobPost(jobs_queue_t *jqp, job_descriptor_t *jp) {
 
-  msg = chMBPostAheadI(&jqp->mbx, (msg_t)jp);
-  chDbgAssert(msg == MSG_OK, "post failed");
+  chJobPostPrio(jqp, jp, JOB_PRIO_NORMAL);
 }
 
 /**
@@ -319,12 +434,9 @@ static inline void chJobPostAheadI(jobs_queue_t *jqp, job_descriptor_t *jp) {
  * @sclass
  */
 static inline void chJobPostAheadS(jobs_queue_t *jqp, job_descriptor_t *jp) {
-  msg_t msg;
-
-  chDbgCheck(jp != NULL);
 
-  msg = chMBPostAheadTimeoutS(&jqp->mbx, (msg_t)jp, TIME_IMMEDIATE);
-  chDbgAssert(msg == MSG_OK, "post failed");
+  chJobPostAheadI(jqp, jp);
+  chSchRescheduleS();
 }
 
 /**
@@ -337,12 +449,10 @@ static inline void chJobPostAheadS(jobs_queue_t *jqp, job_descriptor_t *jp) {
  * @api
  */
 static inline void chJobPostAhead(jobs_queue_t *jqp, job_descriptor_t *jp) {
-  msg_t msg;
 
-  chDbgCheck(jp != NULL);
-
-  msg = chMBPostAheadTimeout(&jqp->mbx, (msg_t)jp, TIME_IMMEDIATE);
-  chDbgAssert(msg == MSG_OK, "post failed");
+  chSysLock();
+  chJobPostAheadS(jqp, jp);
+  chSysUnlock();
 }
 
 /**
@@ -351,74 +461,30 @@ static inline void chJobPostAhead(jobs_queue_t *jqp, job_descriptor_t *jp) {
  * @param[in] jqp       pointer to a @p jobs_queue_t object
  * @return              The function outcome.
  * @retval MSG_OK       if a job has been executed.
- * @retval MSG_RESET    if the internal mailbox has been reset.
+ * @retval MSG_RESET    if the internal semaphore has been reset.
  * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
  */
 static inline msg_t chJobDispatch(jobs_queue_t *jqp) {
-  msg_t msg, jmsg;
-
-  /* Waiting for a job.*/
-  msg = chMBFetchTimeout(&jqp->mbx, &jmsg, TIME_INFINITE);
-  if (msg == MSG_OK) {
-    job_descriptor_t *jp = (job_descriptor_t *)jmsg;
 
-    chDbgAssert(jp != NULL, "is NULL");
-
-    if (jp->jobfunc != NULL) {
-
-      /* Invoking the job function.*/
-      jp->jobfunc(jp->jobarg);
-    }
-    else {
-      msg = MSG_JOB_NULL;
-    }
-
-    /* Returning the job descriptor object.*/
-    chGuardedPoolFree(&jqp->free, (void *)jp);
-  }
-
-  return msg;
+  return chJobDispatchTimeout(jqp, TIME_INFINITE);
 }
 
 /**
- * @brief   Waits for a job then executes it.
+ * @brief   Returns the number of jobs waiting in a queue.
  *
  * @param[in] jqp       pointer to a @p jobs_queue_t object
- * @param[in] timeout   the number of ticks before the operation timeouts,
- *                      the following special values are allowed:
- *                      - @a TIME_IMMEDIATE immediate timeout.
- *                      - @a TIME_INFINITE no timeout.
- * @return              The function outcome.
- * @retval MSG_OK       if a job has been executed.
- * @retval MSG_TIMEOUT  if a timeout occurred.
- * @retval MSG_RESET    if the internal mailbox has been reset.
- * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ * @return              The number of jobs posted and not yet dispatched.
+ *
+ * @iclass
  */
-static inline msg_t chJobDispatchTimeout(jobs_queue_t *jqp,
-                                         sysinterval_t timeout) {
-  msg_t msg, jmsg;
-
-  /* Waiting for a job or a timeout.*/
-  msg = chMBFetchTimeout(&jqp->mbx, &jmsg, timeout);
-  if (msg == MSG_OK) {
-    job_descriptor_t *jp = (job_descriptor_t *)jmsg;
-
-    chDbgAssert(jp != NULL, "is NULL");
-
-    if (jp->jobfunc != NULL) {
+static inline cnt_t chJobGetPendingI(jobs_queue_t *jqp) {
+  cnt_t cnt;
 
-      /* Invoking the job function.*/
-      jp->jobfunc(jp->jobarg);
-    }
-    else {
-      msg = MSG_JOB_NULL;
-    }
+  chDbgCheckClassI();
 
-    /* Returning the job descriptor object.*/
-    chGuardedPoolFree(&jqp->free, (void *)jp);
-  }
+  cnt = chSemGetCounterI(&jqp->sem);
 
-  return msg;
+  return cnt > (cnt_t)0 ? cnt : (cnt_t)0;
 }
 
 #endif /* CH_CFG_USE_JOBS == TRUE */
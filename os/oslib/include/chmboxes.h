@@ -61,6 +61,35 @@ typedef struct {
   threads_queue_t       qr;             /**< @brief Queued readers.         */
 } mailbox_t;
 
+/**
+ * @brief   Structure representing a single producer single consumer
+ *          mailbox object.
+ * @details Each counter is written by one side only so messages are
+ *          exchanged without entering the critical zone, the kernel is
+ *          only involved when a side has to wait or to wake the other.
+ * @note    The slots and counters accesses are ordered by memory barriers,
+ *          on SMP systems the waiting side is always checked within the
+ *          critical zone. With compilers other than GCC/Clang the port
+ *          must define @p PORT_MEMORY_BARRIER() when the producer and the
+ *          consumer run on different cores.
+ */
+typedef struct {
+  volatile msg_t        *buffer;        /**< @brief Pointer to the mailbox
+                                                    buffer base.            */
+  volatile msg_t        *top;           /**< @brief Pointer to the mailbox
+                                                    buffer top.             */
+  volatile msg_t        *wrptr;         /**< @brief Write pointer, owned by
+                                                    the producer.           */
+  volatile msg_t        *rdptr;         /**< @brief Read pointer, owned by
+                                                    the consumer.           */
+  volatile size_t       wrcnt;          /**< @brief Posted messages
+                                                    counter.                */
+  volatile size_t       rdcnt;          /**< @brief Fetched messages
+                                                    counter.                */
+  thread_reference_t    wtr;            /**< @brief Waiting producer.       */
+  thread_reference_t    rtr;            /**< @brief Waiting consumer.       */
+} spsc_mailbox_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -97,6 +126,38 @@ typedef struct {
 #define MAILBOX_DECL(name, buffer, size)                                    \
   mailbox_t name = __MAILBOX_DATA(name, buffer, size)
 
+/**
+ * @brief   Data part of a static SPSC mailbox initializer.
+ * @details This macro should be used when statically initializing a
+ *          SPSC mailbox that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the SPSC mailbox variable
+ * @param[in] buffer    pointer to the mailbox buffer array of @p msg_t
+ * @param[in] size      number of @p msg_t elements in the buffer array
+ */
+#define __SPSC_MAILBOX_DATA(name, buffer, size) {                           \
+  (volatile msg_t *)(buffer),                                               \
+  (volatile msg_t *)(buffer) + size,                                        \
+  (volatile msg_t *)(buffer),                                               \
+  (volatile msg_t *)(buffer),                                               \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  NULL,                                                                     \
+  NULL                                                                      \
+}
+
+/**
+ * @brief   Static SPSC mailbox initializer.
+ * @details Statically initialized SPSC mailboxes require no explicit
+ *          initialization using @p chSPMBObjectInit().
+ *
+ * @param[in] name      the name of the SPSC mailbox variable
+ * @param[in] buffer    pointer to the mailbox buffer array of @p msg_t
+ * @param[in] size      number of @p msg_t elements in the buffer array
+ */
+#define SPSC_MAILBOX_DECL(name, buffer, size)                               \
+  spsc_mailbox_t name = __SPSC_MAILBOX_DATA(name, buffer, size)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -117,6 +178,17 @@ extern "C" {
   msg_t chMBFetchTimeout(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout);
   msg_t chMBFetchTimeoutS(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout);
   msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp);
+  void chSPMBObjectInit(spsc_mailbox_t *mbp, msg_t *buf, size_t n);
+  msg_t chSPMBPostTimeout(spsc_mailbox_t *mbp, msg_t msg,
+                          sysinterval_t timeout);
+  msg_t chSPMBPostI(spsc_mailbox_t *mbp, msg_t msg);
+  msg_t chSPMBFetchTimeout(spsc_mailbox_t *mbp, msg_t *msgp,
+                           sysinterval_t timeout);
+  msg_t chSPMBFetchI(spsc_mailbox_t *mbp, msg_t *msgp);
+#if CH_PORT_SUPPORTS_RECURSIVE_LOCKS == TRUE
+  msg_t chSPMBPostX(spsc_mailbox_t *mbp, msg_t msg);
+  msg_t chSPMBFetchX(spsc_mailbox_t *mbp, msg_t *msgp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -202,6 +274,53 @@ static inline void chMBResumeX(mailbox_t *mbp) {
   mbp->reset = false;
 }
 
+/**
+ * @brief   Returns the SPSC mailbox buffer size as number of messages.
+ *
+ * @param[in] mbp       the pointer to an initialized @p spsc_mailbox_t object
+ * @return              The size of the mailbox.
+ *
+ * @xclass
+ */
+static inline size_t chSPMBGetSizeX(const spsc_mailbox_t *mbp) {
+
+  /*lint -save -e9033 [10.8] Perfectly safe pointers
+    arithmetic.*/
+  return (size_t)(mbp->top - mbp->buffer);
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Returns the number of used message slots into a SPSC mailbox.
+ * @note    The value is exact only if invoked by the producer or by the
+ *          consumer.
+ *
+ * @param[in] mbp       the pointer to an initialized @p spsc_mailbox_t object
+ * @return              The number of queued messages.
+ *
+ * @xclass
+ */
+static inline size_t chSPMBGetUsedCountX(const spsc_mailbox_t *mbp) {
+  size_t rdcnt = mbp->rdcnt;
+
+  return mbp->wrcnt - rdcnt;
+}
+
+/**
+ * @brief   Returns the number of free message slots into a SPSC mailbox.
+ * @note    The value is exact only if invoked by the producer or by the
+ *          consumer.
+ *
+ * @param[in] mbp       the pointer to an initialized @p spsc_mailbox_t object
+ * @return              The number of empty message slots.
+ *
+ * @xclass
+ */
+static inline size_t chSPMBGetFreeCountX(const spsc_mailbox_t *mbp) {
+
+  return chSPMBGetSizeX(mbp) - chSPMBGetUsedCountX(mbp);
+}
+
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
 #endif /* CHMBOXES_H */
@@ -47,10 +47,33 @@
 #error "unsupported pointer size"
 #endif
 
+/**
+ * @brief   Number of bits used for the TLSF second level index.
+ * @details Each first level power of two range is split in
+ *          @p CH_HEAP_TLSF_SL_COUNT linearly spaced free lists.
+ */
+#define CH_HEAP_TLSF_SL_BITS        3U
+
+/**
+ * @brief   Number of TLSF second level free lists.
+ */
+#define CH_HEAP_TLSF_SL_COUNT       (1U << CH_HEAP_TLSF_SL_BITS)
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   TLSF heaps support.
+ * @details If enabled then heaps can be initialized with
+ *          @p chHeapObjectInitTLSF() in order to use a two levels
+ *          segregated fit allocator with constant time allocation and
+ *          release instead of the default first-fit allocator.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF) || defined(__DOXYGEN__)
+#define CH_CFG_USE_HEAP_TLSF        FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -109,6 +132,83 @@ union heap_header {
   } used;
 };
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a TLSF heap block.
+ */
+typedef struct heap_tlsf_block heap_tlsf_block_t;
+
+/**
+ * @brief   TLSF heap block.
+ * @details Blocks are made of a tag page followed by the block pages, the
+ *          first block page is the usual heap header for used blocks or
+ *          the free list links for free blocks.
+ */
+struct heap_tlsf_block {
+  /**
+   * @brief   Physically previous block or @p NULL.
+   */
+  heap_tlsf_block_t     *prev;
+  /**
+   * @brief   Size of the block in pages shifted by one, bit zero is the
+   *          free block flag.
+   */
+  size_t                info;
+  union {
+    /**
+     * @brief   Header for used blocks.
+     */
+    heap_header_t       header;
+    /**
+     * @brief   Links for free blocks.
+     */
+    struct {
+      /**
+       * @brief   Next block in the free list.
+       */
+      heap_tlsf_block_t *next;
+      /**
+       * @brief   Previous block in the free list.
+       */
+      heap_tlsf_block_t *prev;
+    } free;
+  } u;
+};
+
+/**
+ * @brief   TLSF heap control structure.
+ * @note    The structure and its arrays are allocated at the beginning
+ *          of the heap buffer.
+ */
+typedef struct {
+  /**
+   * @brief   Free lists heads, @p fl_count groups of
+   *          @p CH_HEAP_TLSF_SL_COUNT lists.
+   */
+  heap_tlsf_block_t     **heads;
+  /**
+   * @brief   Second level bitmaps, one for each first level.
+   */
+  uint32_t              *sl_bitmap;
+  /**
+   * @brief   First block in the heap area.
+   */
+  heap_tlsf_block_t     *first;
+  /**
+   * @brief   End of the heap area.
+   */
+  heap_tlsf_block_t     *end;
+  /**
+   * @brief   First level bitmap.
+   */
+  uint32_t              fl_bitmap;
+  /**
+   * @brief   Number of first levels.
+   */
+  unsigned              fl_count;
+} heap_tlsf_t;
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /**
  * @brief   Structure describing a memory heap.
  */
@@ -125,6 +225,12 @@ struct memory_heap {
    * @brief   Free blocks list header.
    */
   heap_header_t         header;
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   TLSF control structure or @p NULL for first-fit heaps.
+   */
+  heap_tlsf_t           *tlsf;
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Heap access mutex.
@@ -158,6 +264,9 @@ extern "C" {
 #endif
   void __heap_init(void);
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  void chHeapObjectInitTLSF(memory_heap_t *heapp, void *buf, size_t size);
+#endif
   void chHeapObjectDispose(memory_heap_t *heapp);
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
@@ -172,8 +281,8 @@ extern "C" {
 /*===========================================================================*/
 
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
+ * @brief   Allocates a block of memory from the heap by using the heap
+ *          allocation algorithm.
  * @details The allocated block is guaranteed to be properly aligned for a
  *          pointer data type.
  *
@@ -69,6 +69,24 @@ typedef struct {
                                                     for this pool.          */
 } memory_pool_t;
 
+/**
+ * @brief   Memory pool magazine descriptor.
+ * @details A magazine is a small stash of objects in front of a memory
+ *          pool, objects are taken from and returned to the pool in
+ *          batches so that most allocations and releases do not enter
+ *          a critical zone.
+ * @note    A magazine is not thread safe, it must be owned by a single
+ *          thread.
+ */
+typedef struct {
+  memory_pool_t         *pool;          /**< @brief Associated memory
+                                                    pool.                   */
+  void                  **objects;      /**< @brief Objects stack.          */
+  size_t                size;           /**< @brief Magazine capacity.      */
+  size_t                count;          /**< @brief Objects in the
+                                                    magazine.               */
+} pool_magazine_t;
+
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Guarded memory pool descriptor.
@@ -154,6 +172,13 @@ extern "C" {
   void *chPoolAlloc(memory_pool_t *mp);
   void chPoolFreeI(memory_pool_t *mp, void *objp);
   void chPoolFree(memory_pool_t *mp, void *objp);
+  size_t chPoolAllocBatch(memory_pool_t *mp, void **objpp, size_t n);
+  void chPoolFreeBatch(memory_pool_t *mp, void **objpp, size_t n);
+  void chPoolMagazineObjectInit(pool_magazine_t *mgp, memory_pool_t *mp,
+                                void **objpp, size_t size);
+  void *chPoolMagazineAlloc(pool_magazine_t *mgp);
+  void chPoolMagazineFree(pool_magazine_t *mgp, void *objp);
+  void chPoolMagazineFlush(pool_magazine_t *mgp);
 #if CH_CFG_USE_SEMAPHORES == TRUE
   void chGuardedPoolObjectInitAligned(guarded_memory_pool_t *gmp,
                                       size_t size,
@@ -232,6 +257,19 @@ static inline void chPoolAddI(memory_pool_t *mp, void *objp) {
   chPoolFreeI(mp, objp);
 }
 
+/**
+ * @brief   Returns the number of objects in a magazine.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t object
+ * @return              The number of objects.
+ *
+ * @xclass
+ */
+static inline size_t chPoolMagazineGetCountX(pool_magazine_t *mgp) {
+
+  return mgp->count;
+}
+
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Initializes an empty guarded memory pool.
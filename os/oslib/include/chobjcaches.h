@@ -49,6 +49,17 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Objects caches statistics.
+ * @details If enabled then each hash table slot keeps count of hits, misses
+ *          and of the length of its collisions list.
+ * @note    The counters are also allocated in each object header because
+ *          objects and hash table slots share the same element type.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_STATISTICS) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_STATISTICS        FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -124,6 +135,20 @@ struct oc_hash_element {
    * @brief   Previous in the collisions list.
    */
   oc_hash_element_t     *prev;
+#if (CH_CFG_OBJ_CACHES_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Hits in this hash slot.
+   */
+  ucnt_t                hits;
+  /**
+   * @brief   Misses in this hash slot.
+   */
+  ucnt_t                misses;
+  /**
+   * @brief   Current length of the collisions list.
+   */
+  ucnt_t                chain;
+#endif
 };
 
 /**
@@ -176,6 +201,30 @@ struct oc_object {
   void                  *dptr;
 };
 
+#if (CH_CFG_OBJ_CACHES_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a cache statistics summary.
+ */
+typedef struct {
+  /**
+   * @brief   Total cache hits.
+   */
+  ucnt_t                hits;
+  /**
+   * @brief   Total cache misses.
+   */
+  ucnt_t                misses;
+  /**
+   * @brief   Number of hash slots holding at least one object.
+   */
+  ucnt_t                used;
+  /**
+   * @brief   Longest collisions list.
+   */
+  ucnt_t                longest;
+} oc_stats_t;
+#endif
+
 /**
  * @brief   Structure representing a cache object.
  */
@@ -248,6 +297,14 @@ extern "C" {
   bool chCacheWriteObject(objects_cache_t *ocp,
                           oc_object_t *objp,
                           bool async);
+  bool chCacheFlushRange(objects_cache_t *ocp,
+                         void *owner,
+                         uint32_t first,
+                         uint32_t last);
+#if CH_CFG_OBJ_CACHES_STATISTICS == TRUE
+  void chCacheGetStats(objects_cache_t *ocp, oc_stats_t *sp);
+  void chCacheResetStats(objects_cache_t *ocp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -281,6 +338,23 @@ static inline void chCacheReleaseObject(objects_cache_t *ocp,
   chSysUnlock();
 }
 
+/**
+ * @brief   Writes back all the lazy-write objects of an owner.
+ * @details Objects are written in ascending key order.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t object
+ * @param[in] owner     object owner pointer
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if a write operation failed.
+ *
+ * @api
+ */
+static inline bool chCacheFlushOwner(objects_cache_t *ocp, void *owner) {
+
+  return chCacheFlushRange(ocp, owner, 0U, 0xFFFFFFFFU);
+}
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 #endif /* CHOBJCACHES_H */
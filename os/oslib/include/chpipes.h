@@ -138,6 +138,12 @@ extern "C" {
                             size_t n, sysinterval_t timeout);
   size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
                            size_t n, sysinterval_t timeout);
+  uint8_t *chPipeWriteReserveTimeout(pipe_t *pp, size_t *np,
+                                     sysinterval_t timeout);
+  void chPipeWriteCommit(pipe_t *pp, size_t n);
+  const uint8_t *chPipeReadPeekTimeout(pipe_t *pp, size_t *np,
+                                       sysinterval_t timeout);
+  void chPipeReadConsume(pipe_t *pp, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_OBJ_CACHES TRUE,$(CHLIBCONF)),)
 OSLIBSRC += $(CHIBIOS)/os/oslib/src/chobjcaches.c
 endif
+ifneq ($(findstring CH_CFG_USE_JOBS TRUE,$(CHLIBCONF)),)
+OSLIBSRC += $(CHIBIOS)/os/oslib/src/chjobs.c
+endif
 ifneq ($(findstring CH_CFG_USE_DELEGATES TRUE,$(CHLIBCONF)),)
 OSLIBSRC += $(CHIBIOS)/os/oslib/src/chdelegates.c
 endif
@@ -46,6 +49,7 @@ OSLIBSRC := $(CHIBIOS)/os/oslib/src/chmemchecks.c \
             $(CHIBIOS)/os/oslib/src/chpipes.c \
             $(CHIBIOS)/os/oslib/src/chobjcaches.c \
             $(CHIBIOS)/os/oslib/src/chdelegates.c \
+            $(CHIBIOS)/os/oslib/src/chjobs.c \
             $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
 
@@ -0,0 +1,548 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chjobs.c
+ * @brief   Jobs Queues code.
+ * @details Jobs Queues.
+ *          <h2>Operation mode</h2>
+ *          Jobs are posted in one of @p CH_CFG_JOBS_PRIORITIES FIFOs, a
+ *          counting semaphore keeps track of the jobs waiting in all the
+ *          FIFOs so that dispatchers wait on a single object and then
+ *          take the oldest job of the highest non-empty FIFO.<br>
+ *          Any number of dispatcher threads can serve the same queue, on
+ *          RT a pool of workers can be created using
+ *          @p chJobCreateWorkers().<br>
+ *          A queue can optionally be associated to a set of peer queues,
+ *          when its own FIFOs are empty a dispatcher takes jobs from the
+ *          peers, this allows to balance the load between workers having
+ *          affinity with different cores.
+ * @pre     In order to use the jobs APIs the @p CH_CFG_USE_JOBS option
+ *          must be enabled in @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_jobs_queues
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Takes the highest priority job from a queue.
+ * @pre     A job counter token has already been taken from the queue
+ *          semaphore, so there is at least one job in the FIFOs.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @return              The pointer to the job object.
+ *
+ * @notapi
+ */
+static job_descriptor_t *job_fetch_s(jobs_queue_t *jqp) {
+  unsigned prio = (unsigned)CH_CFG_JOBS_PRIORITIES;
+  msg_t msg, jmsg;
+
+  do {
+    prio--;
+    msg = chMBFetchI(&jqp->mbx[prio], &jmsg);
+  } while ((msg != MSG_OK) && (prio > 0U));
+
+  chDbgAssert(msg == MSG_OK, "no job");
+
+#if CH_CFG_JOBS_STATISTICS == TRUE
+  {
+    job_descriptor_t *jp = (job_descriptor_t *)jmsg;
+    rtcnt_t latency = chSysGetRealtimeCounterX() - jp->jobtime;
+
+    jqp->stats.depth--;
+    jqp->stats.dispatched++;
+    jqp->stats.cumulative += (uint64_t)latency;
+    if (latency > jqp->stats.worst) {
+      jqp->stats.worst = latency;
+    }
+  }
+#endif
+
+  return (job_descriptor_t *)jmsg;
+}
+
+/**
+ * @brief   Updates the queue statistics after a job has been posted.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] jp        pointer to the posted job object
+ *
+ * @notapi
+ */
+static void job_posted_i(jobs_queue_t *jqp, job_descriptor_t *jp) {
+
+#if CH_CFG_JOBS_STATISTICS == TRUE
+  jp->jobtime = chSysGetRealtimeCounterX();
+  jqp->stats.depth++;
+  if (jqp->stats.depth > jqp->stats.maxdepth) {
+    jqp->stats.maxdepth = jqp->stats.depth;
+  }
+#else
+  (void)jp;
+#endif
+
+  chSemSignalI(&jqp->sem);
+}
+
+/**
+ * @brief   Takes a job from a peer queue, if any.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[out] srcpp    pointer to the queue owning the stolen job
+ * @return              The pointer to the job object.
+ * @retval NULL         if all the peers queues are empty.
+ *
+ * @notapi
+ */
+static job_descriptor_t *job_steal_s(jobs_queue_t *jqp,
+                                     jobs_queue_t **srcpp) {
+  unsigned i;
+
+  for (i = 0U; i < jqp->npeers; i++) {
+    jobs_queue_t *pqp = jqp->peers[i];
+
+    if ((pqp != jqp) && (chSemGetCounterI(&pqp->sem) > (cnt_t)0)) {
+      job_descriptor_t *jp;
+
+      chSemFastWaitI(&pqp->sem);
+      jp = job_fetch_s(pqp);
+#if CH_CFG_JOBS_STATISTICS == TRUE
+      pqp->stats.stolen++;
+#endif
+      *srcpp = pqp;
+      return jp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Waits for a job from a queue or from its peers.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @param[out] jpp      pointer to the taken job object
+ * @param[out] srcpp    pointer to the queue owning the job
+ * @return              The wait outcome.
+ * @retval MSG_OK       if a job has been taken.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_RESET    if the queue semaphore has been reset.
+ *
+ * @sclass
+ */
+static msg_t job_wait_s(jobs_queue_t *jqp, sysinterval_t timeout,
+                        job_descriptor_t **jpp, jobs_queue_t **srcpp) {
+  systime_t start = chVTGetSystemTimeX();
+  msg_t msg;
+
+  while (true) {
+    sysinterval_t slice;
+
+    /* Own jobs first.*/
+    if (chSemGetCounterI(&jqp->sem) > (cnt_t)0) {
+      chSemFastWaitI(&jqp->sem);
+      *jpp   = job_fetch_s(jqp);
+      *srcpp = jqp;
+      return MSG_OK;
+    }
+
+    /* Then jobs from peers, if any.*/
+    *jpp = job_steal_s(jqp, srcpp);
+    if (*jpp != NULL) {
+      return MSG_OK;
+    }
+
+    /* Without peers there is no need to wake up periodically.*/
+    slice = timeout;
+    if ((jqp->npeers > 0U) && (timeout != TIME_IMMEDIATE)) {
+      if (timeout != TIME_INFINITE) {
+        sysinterval_t elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+
+        if (elapsed >= timeout) {
+          return MSG_TIMEOUT;
+        }
+        slice = timeout - elapsed;
+      }
+      if (slice > jqp->period) {
+        slice = jqp->period;
+      }
+    }
+
+    msg = chSemWaitTimeoutS(&jqp->sem, slice);
+    if (msg == MSG_OK) {
+      *jpp   = job_fetch_s(jqp);
+      *srcpp = jqp;
+      return MSG_OK;
+    }
+
+    /* A timeout on a slice shorter than the requested timeout is just an
+       occasion to look at peers again.*/
+    if ((msg != MSG_TIMEOUT) || (slice == timeout)) {
+      return msg;
+    }
+  }
+}
+
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @brief   Worker thread function.
+ *
+ * @param[in] arg       pointer to the served @p jobs_queue_t object
+ */
+static THD_FUNCTION(job_worker, arg) {
+  jobs_queue_t *jqp = (jobs_queue_t *)arg;
+
+  while (chJobDispatch(jqp) == MSG_OK) {
+  }
+
+  chThdExit(MSG_OK);
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a jobs queue object.
+ *
+ * @param[out] jqp      pointer to a @p jobs_queue_t structure
+ * @param[in] jobsn     number of jobs available
+ * @param[in] jobsbuf   pointer to the buffer of jobs, it must be able
+ *                      to hold @p jobsn @p job_descriptor_t structures
+ * @param[in] msgbuf    pointer to the buffer of messages, it must be able
+ *                      to hold @p JOBS_MSGBUF_SIZE(jobsn) @p msg_t messages
+ *
+ * @init
+ */
+void chJobObjectInit(jobs_queue_t *jqp,
+                     size_t jobsn,
+                     job_descriptor_t *jobsbuf,
+                     msg_t *msgbuf) {
+  unsigned i;
+
+  chDbgCheck((jqp != NULL) && (jobsn > 0U) && (jobsbuf != NULL) && (msgbuf != NULL));
+
+  chGuardedPoolObjectInit(&jqp->free, sizeof (job_descriptor_t));
+  chGuardedPoolLoadArray(&jqp->free, (void *)jobsbuf, jobsn);
+  chSemObjectInit(&jqp->sem, (cnt_t)0);
+
+  /* Each FIFO is able to hold all the jobs so posting never fails.*/
+  for (i = 0U; i < (unsigned)CH_CFG_JOBS_PRIORITIES; i++) {
+    chMBObjectInit(&jqp->mbx[i], msgbuf, jobsn);
+    msgbuf += jobsn;
+  }
+
+  jqp->peers  = NULL;
+  jqp->npeers = 0U;
+  jqp->period = TIME_INFINITE;
+#if CH_CFG_JOBS_STATISTICS == TRUE
+  jqp->stats.depth      = (ucnt_t)0;
+  jqp->stats.maxdepth   = (ucnt_t)0;
+  jqp->stats.dispatched = (ucnt_t)0;
+  jqp->stats.stolen     = (ucnt_t)0;
+  jqp->stats.worst      = (rtcnt_t)0;
+  jqp->stats.cumulative = (uint64_t)0;
+#endif
+}
+
+/**
+ * @brief   Disposes a jobs queue object.
+ * @note    Objects disposing does not involve freeing memory but just
+ *          performing checks that make sure that the object is in a
+ *          state compatible with operations stop.
+ * @note    If the option @p CH_CFG_HARDENING_LEVEL is greater than zero then
+ *          the object is also cleared, attempts to use the object would likely
+ *          result in a clean memory access violation because dereferencing
+ *          of @p NULL pointers rather than dereferencing previously valid
+ *          pointers.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ *
+ * @dispose
+ */
+void chJobObjectDispose(jobs_queue_t *jqp) {
+  unsigned i;
+
+  chDbgCheck(jqp != NULL);
+
+  chGuardedPoolObjectDispose(&jqp->free);
+  for (i = 0U; i < (unsigned)CH_CFG_JOBS_PRIORITIES; i++) {
+    chMBObjectDispose(&jqp->mbx[i]);
+  }
+  jqp->peers  = NULL;
+  jqp->npeers = 0U;
+}
+
+/**
+ * @brief   Associates a jobs queue to a set of peer queues.
+ * @details When its own FIFOs are empty, a dispatcher of the queue takes
+ *          the jobs waiting in the peer queues, the peers are scanned in
+ *          array order.
+ * @note    Jobs posted to peers do not wake up the dispatchers of this
+ *          queue, waiting dispatchers look at peers every @p period.
+ * @note    A @p JOB_NULL taken from a peer terminates the dispatcher
+ *          taking it, peers should be stopped together.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] peers     array of peers queues or @p NULL, the array can
+ *                      contain @p jqp itself
+ * @param[in] npeers    number of elements in the @p peers array
+ * @param[in] period    interval between attempts to take jobs from peers
+ *                      while waiting, it must not be @p TIME_IMMEDIATE
+ *
+ * @api
+ */
+void chJobSetPeers(jobs_queue_t *jqp,
+                   jobs_queue_t * const *peers,
+                   unsigned npeers,
+                   sysinterval_t period) {
+
+  chDbgCheck((jqp != NULL) &&
+             ((peers != NULL) || (npeers == 0U)) &&
+             (period != TIME_IMMEDIATE));
+
+  chSysLock();
+  jqp->peers  = peers;
+  jqp->npeers = peers != NULL ? npeers : 0U;
+  jqp->period = period;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Posts a job object with the specified priority.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] jp        pointer to the job object to be posted
+ * @param[in] prio      job priority, from @p JOB_PRIO_NORMAL to
+ *                      @p CH_CFG_JOBS_PRIORITIES - 1
+ *
+ * @iclass
+ */
+void chJobPostPrioI(jobs_queue_t *jqp, job_descriptor_t *jp, unsigned prio) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck((jqp != NULL) && (jp != NULL) &&
+             (prio < (unsigned)CH_CFG_JOBS_PRIORITIES));
+
+  msg = chMBPostI(&jqp->mbx[prio], (msg_t)jp);
+  chDbgAssert(msg == MSG_OK, "post failed");
+
+  job_posted_i(jqp, jp);
+}
+
+/**
+ * @brief   Posts an high priority job object.
+ * @details The job is placed ahead of all the jobs waiting in the highest
+ *          priority FIFO.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @iclass
+ */
+void chJobPostAheadI(jobs_queue_t *jqp, job_descriptor_t *jp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck((jqp != NULL) && (jp != NULL));
+
+  msg = chMBPostAheadI(&jqp->mbx[CH_CFG_JOBS_PRIORITIES - 1], (msg_t)jp);
+  chDbgAssert(msg == MSG_OK, "post failed");
+
+  job_posted_i(jqp, jp);
+}
+
+/**
+ * @brief   Waits for a job then executes it.
+ * @details The oldest job of the highest priority non-empty FIFO is
+ *          executed, if the queue is empty then jobs are taken from the
+ *          peer queues, if any.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The function outcome.
+ * @retval MSG_OK       if a job has been executed.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_RESET    if the internal semaphore has been reset.
+ * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ *
+ * @api
+ */
+msg_t chJobDispatchTimeout(jobs_queue_t *jqp, sysinterval_t timeout) {
+  job_descriptor_t *jp;
+  jobs_queue_t *srcp;
+  msg_t msg;
+
+  chDbgCheck(jqp != NULL);
+
+  /* The owner queue is only written when a job is returned.*/
+  srcp = jqp;
+
+  /* Waiting for a job or a timeout.*/
+  chSysLock();
+  msg = job_wait_s(jqp, timeout, &jp, &srcp);
+  chSysUnlock();
+
+  if (msg == MSG_OK) {
+
+    chDbgAssert(jp != NULL, "is NULL");
+
+    if (jp->jobfunc != NULL) {
+
+      /* Invoking the job function.*/
+      jp->jobfunc(jp->jobarg);
+    }
+    else {
+      msg = MSG_JOB_NULL;
+    }
+
+    /* Returning the job descriptor object to its owner queue.*/
+    chGuardedPoolFree(&srcp->free, (void *)jp);
+  }
+
+  return msg;
+}
+
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @brief   Creates a pool of workers serving a jobs queue.
+ * @details Each worker dispatches jobs until a @p JOB_NULL is received,
+ *          the pool can be stopped by posting a @p JOB_NULL for each
+ *          worker then waiting for the workers termination.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[in] wdp       pointer to a @p jobs_workers_descriptor_t structure
+ * @param[out] tpp      array of @p wdp->n pointers receiving the created
+ *                      threads or @p NULL
+ *
+ * @api
+ */
+void chJobCreateWorkers(jobs_queue_t *jqp,
+                        const jobs_workers_descriptor_t *wdp,
+                        thread_t **tpp) {
+  stkline_t *wbase;
+  unsigned i;
+
+  chDbgCheck((jqp != NULL) && (wdp != NULL) && (wdp->wbase != NULL) &&
+             (wdp->n > 0U) && (wdp->wsize >= THD_WORKING_AREA_SIZE(0)) &&
+             ((wdp->wsize % sizeof (stkline_t)) == 0U));
+
+  wbase = wdp->wbase;
+  for (i = 0U; i < wdp->n; i++) {
+    thread_descriptor_t td = {
+      .name   = wdp->name,
+      .wbase  = wbase,
+      .wend   = wbase + (wdp->wsize / sizeof (stkline_t)),
+      .prio   = wdp->prio,
+      .funcp  = job_worker,
+      .arg    = (void *)jqp,
+      .owner  = wdp->owner
+    };
+    thread_t *tp = chThdCreate(&td);
+
+    if (tpp != NULL) {
+      tpp[i] = tp;
+    }
+    wbase += wdp->wsize / sizeof (stkline_t);
+  }
+}
+#endif
+
+#if (CH_CFG_JOBS_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the queue statistics.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ * @param[out] sp       pointer to a @p jobs_stats_t structure
+ *
+ * @api
+ */
+void chJobGetStats(jobs_queue_t *jqp, jobs_stats_t *sp) {
+
+  chDbgCheck((jqp != NULL) && (sp != NULL));
+
+  chSysLock();
+  *sp = jqp->stats;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the queue statistics.
+ * @note    The current depth is preserved.
+ *
+ * @param[in] jqp       pointer to a @p jobs_queue_t object
+ *
+ * @api
+ */
+void chJobResetStats(jobs_queue_t *jqp) {
+  ucnt_t depth;
+
+  chDbgCheck(jqp != NULL);
+
+  chSysLock();
+  depth = (ucnt_t)chJobGetPendingI(jqp);
+  jqp->stats.depth      = depth;
+  jqp->stats.maxdepth   = depth;
+  jqp->stats.dispatched = (ucnt_t)0;
+  jqp->stats.stolen     = (ucnt_t)0;
+  jqp->stats.worst      = (rtcnt_t)0;
+  jqp->stats.cumulative = (uint64_t)0;
+  chSysUnlock();
+}
+#endif
+
+#endif /* CH_CFG_USE_JOBS == TRUE */
+
+/** @} */
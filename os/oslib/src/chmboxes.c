@@ -42,7 +42,13 @@
  *          possible approach is to allocate memory (from a memory pool for
  *          example) from the posting side and free it on the fetching side.
  *          Another approach is to set a "done" flag into the structure pointed
- *          by the message.
+ *          by the message.<br>
+ *          SPSC mailboxes are a variant for a single producer and a single
+ *          consumer, messages are exchanged without entering the critical
+ *          zone as long as the mailbox is neither full nor empty, the kernel
+ *          is involved only in order to suspend or wake a side. The producer
+ *          and the consumer can be a thread or an ISR, blocking operations
+ *          are thread-only.
  * @pre     In order to use the mailboxes APIs the @p CH_CFG_USE_MAILBOXES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -55,6 +61,40 @@
 
 #if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns @p true if the other side of a SPSC mailbox could be
+ *          waiting.
+ * @details On single core systems the thread reference is read outside
+ *          the critical zone. On SMP systems the other side could be
+ *          suspending on another core so the reference is always checked
+ *          within the critical zone.
+ */
+#if !defined(CH_CFG_SMP_MODE) || (CH_CFG_SMP_MODE == FALSE) ||              \
+    defined(__DOXYGEN__)
+#define spmb_waiting(r) (*(thread_reference_t volatile *)&(r) != NULL)
+#else
+#define spmb_waiting(r) true
+#endif
+
+/**
+ * @brief   Memory barrier between the SPSC mailbox slots and counters.
+ * @details Orders the message slot accesses against the counters updates,
+ *          this is required when the two sides run on different cores.
+ *          Ports can provide their own barrier by defining
+ *          @p PORT_MEMORY_BARRIER().
+ */
+#if defined(PORT_MEMORY_BARRIER) || defined(__DOXYGEN__)
+#define spmb_barrier()  PORT_MEMORY_BARRIER()
+#elif defined(__GNUC__)
+#define spmb_barrier()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define spmb_barrier()
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -71,6 +111,75 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Non-blocking SPSC mailbox post.
+ * @note    The message is stored before the counter is updated so the
+ *          consumer never sees a counter ahead of the buffer contents.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[in] msg       message to be posted on the mailbox
+ * @return              The operation status.
+ * @retval false        if the mailbox is full.
+ * @retval true         if the message has been posted.
+ *
+ * @notapi
+ */
+static bool spmb_post(spsc_mailbox_t *mbp, msg_t msg) {
+  size_t wrcnt = mbp->wrcnt;
+
+  if ((wrcnt - mbp->rdcnt) >= chSPMBGetSizeX(mbp)) {
+    return false;
+  }
+
+  /* The slot is written after the consumer released it.*/
+  spmb_barrier();
+  *mbp->wrptr = msg;
+  if (++mbp->wrptr >= mbp->top) {
+    mbp->wrptr = mbp->buffer;
+  }
+
+  /* The message is published after being stored.*/
+  spmb_barrier();
+  mbp->wrcnt = wrcnt + (size_t)1;
+
+  return true;
+}
+
+/**
+ * @brief   Non-blocking SPSC mailbox fetch.
+ * @note    The message is loaded before the counter is updated so the
+ *          producer never overwrites a slot still being read.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval false        if the mailbox is empty.
+ * @retval true         if a message has been fetched.
+ *
+ * @notapi
+ */
+static bool spmb_fetch(spsc_mailbox_t *mbp, msg_t *msgp) {
+  size_t rdcnt = mbp->rdcnt;
+
+  if (mbp->wrcnt == rdcnt) {
+    return false;
+  }
+
+  /* The slot is read after the producer published it.*/
+  spmb_barrier();
+  *msgp = *mbp->rdptr;
+  if (++mbp->rdptr >= mbp->top) {
+    mbp->rdptr = mbp->buffer;
+  }
+
+  /* The slot is released after being read.*/
+  spmb_barrier();
+  mbp->rdcnt = rdcnt + (size_t)1;
+
+  return true;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -540,6 +649,277 @@ msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp) {
   /* No message, immediate timeout.*/
   return MSG_TIMEOUT;
 }
+
+/**
+ * @brief   Initializes a @p spsc_mailbox_t object.
+ *
+ * @param[out] mbp      pointer to the @p spsc_mailbox_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the messages buffer as an array of @p msg_t
+ * @param[in] n         number of elements in the buffer array
+ *
+ * @init
+ */
+void chSPMBObjectInit(spsc_mailbox_t *mbp, msg_t *buf, size_t n) {
+
+  chDbgCheck((mbp != NULL) && (buf != NULL) && (n > (size_t)0));
+
+  mbp->buffer = buf;
+  mbp->top    = &buf[n];
+  mbp->wrptr  = buf;
+  mbp->rdptr  = buf;
+  mbp->wrcnt  = (size_t)0;
+  mbp->rdcnt  = (size_t)0;
+  mbp->wtr    = NULL;
+  mbp->rtr    = NULL;
+}
+
+/**
+ * @brief   Posts a message into a SPSC mailbox.
+ * @details The invoking thread waits until an empty slot in the mailbox
+ *          becomes available or the specified time runs out.
+ * @note    Must be invoked by the producer only.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[in] msg       message to be posted on the mailbox
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chSPMBPostTimeout(spsc_mailbox_t *mbp, msg_t msg,
+                        sysinterval_t timeout) {
+
+  chDbgCheck(mbp != NULL);
+
+  while (!spmb_post(mbp, msg)) {
+    msg_t rdymsg;
+
+    /* Checking again within the critical zone, the consumer could have
+       fetched a message meanwhile.*/
+    chSysLock();
+    if (chSPMBGetFreeCountX(mbp) == (size_t)0) {
+      rdymsg = chThdSuspendTimeoutS(&mbp->wtr, timeout);
+    }
+    else {
+      rdymsg = MSG_OK;
+    }
+    chSysUnlock();
+
+    if (rdymsg != MSG_OK) {
+      return rdymsg;
+    }
+  }
+
+  /* If the consumer is waiting then makes it ready, on single core
+     systems the reference is checked outside the critical zone because
+     the consumer checks the mailbox again within the critical zone
+     before suspending.*/
+  if (spmb_waiting(mbp->rtr)) {
+    chThdResume(&mbp->rtr, MSG_OK);
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts a message into a SPSC mailbox.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is full.
+ * @note    Must be invoked by the producer only.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[in] msg       message to be posted on the mailbox
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the mailbox is full and the message cannot be
+ *                      posted.
+ *
+ * @iclass
+ */
+msg_t chSPMBPostI(spsc_mailbox_t *mbp, msg_t msg) {
+
+  chDbgCheckClassI();
+  chDbgCheck(mbp != NULL);
+
+  if (!spmb_post(mbp, msg)) {
+    return MSG_TIMEOUT;
+  }
+
+  /* If the consumer is waiting then makes it ready.*/
+  chThdResumeI(&mbp->rtr, MSG_OK);
+
+  return MSG_OK;
+}
+
+#if (CH_PORT_SUPPORTS_RECURSIVE_LOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Posts a message into a SPSC mailbox.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is full. The critical zone is entered
+ *          only if the consumer has to be woken.
+ * @note    Must be invoked by the producer only, from thread or ISR
+ *          context.
+ * @note    This function is only available if the underlying port supports
+ *          recursive locks.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[in] msg       message to be posted on the mailbox
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the mailbox is full and the message cannot be
+ *                      posted.
+ *
+ * @xclass
+ */
+msg_t chSPMBPostX(spsc_mailbox_t *mbp, msg_t msg) {
+
+  chDbgCheck(mbp != NULL);
+
+  if (!spmb_post(mbp, msg)) {
+    return MSG_TIMEOUT;
+  }
+
+  /* If the consumer is waiting then makes it ready.*/
+  if (spmb_waiting(mbp->rtr)) {
+    syssts_t sts = chSysGetStatusAndLockX();
+    chThdResumeI(&mbp->rtr, MSG_OK);
+    chSysRestoreStatusX(sts);
+  }
+
+  return MSG_OK;
+}
+#endif /* CH_PORT_SUPPORTS_RECURSIVE_LOCKS == TRUE */
+
+/**
+ * @brief   Retrieves a message from a SPSC mailbox.
+ * @details The invoking thread waits until a message is posted in the
+ *          mailbox or the specified time runs out.
+ * @note    Must be invoked by the consumer only.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chSPMBFetchTimeout(spsc_mailbox_t *mbp, msg_t *msgp,
+                         sysinterval_t timeout) {
+
+  chDbgCheck((mbp != NULL) && (msgp != NULL));
+
+  while (!spmb_fetch(mbp, msgp)) {
+    msg_t rdymsg;
+
+    /* Checking again within the critical zone, the producer could have
+       posted a message meanwhile.*/
+    chSysLock();
+    if (chSPMBGetUsedCountX(mbp) == (size_t)0) {
+      rdymsg = chThdSuspendTimeoutS(&mbp->rtr, timeout);
+    }
+    else {
+      rdymsg = MSG_OK;
+    }
+    chSysUnlock();
+
+    if (rdymsg != MSG_OK) {
+      return rdymsg;
+    }
+  }
+
+  /* If the producer is waiting then makes it ready, on single core
+     systems the reference is checked outside the critical zone because
+     the producer checks the mailbox again within the critical zone
+     before suspending.*/
+  if (spmb_waiting(mbp->wtr)) {
+    chThdResume(&mbp->wtr, MSG_OK);
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Retrieves a message from a SPSC mailbox.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is empty.
+ * @note    Must be invoked by the consumer only.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the mailbox is empty and a message cannot be
+ *                      fetched.
+ *
+ * @iclass
+ */
+msg_t chSPMBFetchI(spsc_mailbox_t *mbp, msg_t *msgp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mbp != NULL) && (msgp != NULL));
+
+  if (!spmb_fetch(mbp, msgp)) {
+    return MSG_TIMEOUT;
+  }
+
+  /* If the producer is waiting then makes it ready.*/
+  chThdResumeI(&mbp->wtr, MSG_OK);
+
+  return MSG_OK;
+}
+
+#if (CH_PORT_SUPPORTS_RECURSIVE_LOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Retrieves a message from a SPSC mailbox.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is empty. The critical zone is entered
+ *          only if the producer has to be woken.
+ * @note    Must be invoked by the consumer only, from thread or ISR
+ *          context.
+ * @note    This function is only available if the underlying port supports
+ *          recursive locks.
+ *
+ * @param[in] mbp       pointer to a @p spsc_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the mailbox is empty and a message cannot be
+ *                      fetched.
+ *
+ * @xclass
+ */
+msg_t chSPMBFetchX(spsc_mailbox_t *mbp, msg_t *msgp) {
+
+  chDbgCheck((mbp != NULL) && (msgp != NULL));
+
+  if (!spmb_fetch(mbp, msgp)) {
+    return MSG_TIMEOUT;
+  }
+
+  /* If the producer is waiting then makes it ready.*/
+  if (spmb_waiting(mbp->wtr)) {
+    syssts_t sts = chSysGetStatusAndLockX();
+    chThdResumeI(&mbp->wtr, MSG_OK);
+    chSysRestoreStatusX(sts);
+  }
+
+  return MSG_OK;
+}
+#endif /* CH_PORT_SUPPORTS_RECURSIVE_LOCKS == TRUE */
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
 /** @} */
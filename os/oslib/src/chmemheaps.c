@@ -28,6 +28,10 @@
  *          library functions. The main difference is that the OS heap APIs
  *          are guaranteed to be thread safe and there is the ability to
  *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          Optionally, heaps initialized using @p chHeapObjectInitTLSF()
+ *          use a two levels segregated fit (TLSF) strategy instead, free
+ *          blocks are kept in size-indexed lists found using bitmaps so
+ *          that allocation and release take constant time.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -77,6 +81,31 @@
   ((size_t)((p1) - (p2)))                                                   \
   /*lint -restore*/
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/*
+ * TLSF blocks accessors, sizes are in pages and do not include the tag.
+ */
+#define T_PAGES(bp)         ((bp)->info >> 1)
+
+#define T_IS_FREE(bp)       (((bp)->info & 1U) != 0U)
+
+#define T_SET_FREE(bp, n)   ((bp)->info = ((n) << 1) | 1U)
+
+#define T_SET_USED(bp, n)   ((bp)->info = ((n) << 1))
+
+#define T_AT(hp)            ((heap_tlsf_block_t *)(void *)(hp))
+
+#define T_TAG(bp)           ((heap_header_t *)(void *)(bp))
+
+#define T_NEXT(bp)          T_AT(T_TAG(bp) + 1U + T_PAGES(bp))
+
+/*
+ * Maximum number of pages in a TLSF heap, it keeps the indexes within
+ * the 32 bits bitmaps.
+ */
+#define T_MAX_PAGES         ((size_t)0x7FFFFFFFU)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -98,6 +127,373 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Index of the most significant bit set in a word.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ * @return              The bit index.
+ */
+static unsigned tlsf_fls(uint32_t x) {
+  unsigned n = 0U;
+
+  if ((x & 0xFFFF0000U) != 0U) {
+    n += 16U;
+    x >>= 16U;
+  }
+  if ((x & 0x0000FF00U) != 0U) {
+    n += 8U;
+    x >>= 8U;
+  }
+  if ((x & 0x000000F0U) != 0U) {
+    n += 4U;
+    x >>= 4U;
+  }
+  if ((x & 0x0000000CU) != 0U) {
+    n += 2U;
+    x >>= 2U;
+  }
+  if ((x & 0x00000002U) != 0U) {
+    n += 1U;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Index of the least significant bit set in a word.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ * @return              The bit index.
+ */
+static unsigned tlsf_ffs(uint32_t x) {
+
+#if defined(PORT_CTZ32)
+  return PORT_CTZ32(x);
+#else
+  return tlsf_fls(x & (~x + 1U));
+#endif
+}
+
+/**
+ * @brief   Free list indexes of a block size.
+ *
+ * @param[in] pages     size in pages
+ * @param[out] flp      first level index
+ * @param[out] slp      second level index
+ */
+static void tlsf_mapping(size_t pages, unsigned *flp, unsigned *slp) {
+
+  if (pages < (size_t)CH_HEAP_TLSF_SL_COUNT) {
+    *flp = 0U;
+    *slp = (unsigned)pages;
+  }
+  else {
+    unsigned msb = tlsf_fls((uint32_t)pages);
+
+    *flp = (msb - CH_HEAP_TLSF_SL_BITS) + 1U;
+    *slp = (unsigned)(pages >> (msb - CH_HEAP_TLSF_SL_BITS)) -
+           CH_HEAP_TLSF_SL_COUNT;
+  }
+}
+
+/**
+ * @brief   Inserts a free block in its free list.
+ *
+ * @param[in] tp        pointer to the TLSF control structure
+ * @param[in] bp        pointer to the block, size and flag already set
+ */
+static void tlsf_insert(heap_tlsf_t *tp, heap_tlsf_block_t *bp) {
+  heap_tlsf_block_t **headp;
+  unsigned fl, sl;
+
+  tlsf_mapping(T_PAGES(bp), &fl, &sl);
+  headp = &tp->heads[(fl * CH_HEAP_TLSF_SL_COUNT) + sl];
+
+  bp->u.free.prev = NULL;
+  bp->u.free.next = *headp;
+  if (*headp != NULL) {
+    (*headp)->u.free.prev = bp;
+  }
+  *headp = bp;
+
+  tp->fl_bitmap     |= (uint32_t)1U << fl;
+  tp->sl_bitmap[fl] |= (uint32_t)1U << sl;
+}
+
+/**
+ * @brief   Removes a free block from its free list.
+ *
+ * @param[in] tp        pointer to the TLSF control structure
+ * @param[in] bp        pointer to the block
+ */
+static void tlsf_remove(heap_tlsf_t *tp, heap_tlsf_block_t *bp) {
+  heap_tlsf_block_t **headp;
+  unsigned fl, sl;
+
+  tlsf_mapping(T_PAGES(bp), &fl, &sl);
+  headp = &tp->heads[(fl * CH_HEAP_TLSF_SL_COUNT) + sl];
+
+  if (bp->u.free.next != NULL) {
+    bp->u.free.next->u.free.prev = bp->u.free.prev;
+  }
+  if (bp->u.free.prev != NULL) {
+    bp->u.free.prev->u.free.next = bp->u.free.next;
+  }
+  else {
+    *headp = bp->u.free.next;
+    if (*headp == NULL) {
+      tp->sl_bitmap[fl] &= ~((uint32_t)1U << sl);
+      if (tp->sl_bitmap[fl] == 0U) {
+        tp->fl_bitmap &= ~((uint32_t)1U << fl);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Finds a free block of at least the specified size.
+ * @details The search starts from the list following the one containing
+ *          the specified size so that any block found is large enough,
+ *          if nothing is found then the first block in the list of the
+ *          specified size is returned, it could still be large enough.
+ *
+ * @param[in] tp        pointer to the TLSF control structure
+ * @param[in] pages     size in pages
+ * @return              A free block, its size must be verified.
+ * @retval NULL         if there are no suitable free blocks.
+ */
+static heap_tlsf_block_t *tlsf_find(heap_tlsf_t *tp, size_t pages) {
+  size_t rpages = pages;
+  uint32_t map;
+  unsigned fl, sl;
+
+  /* Rounding the size up to the next list size.*/
+  if (rpages >= (size_t)CH_HEAP_TLSF_SL_COUNT) {
+    rpages += ((size_t)1U << (tlsf_fls((uint32_t)rpages) -
+                              CH_HEAP_TLSF_SL_BITS)) - 1U;
+  }
+
+  if (rpages <= T_MAX_PAGES) {
+    tlsf_mapping(rpages, &fl, &sl);
+    if (fl < tp->fl_count) {
+      map = tp->sl_bitmap[fl] & ((uint32_t)0xFFFFFFFFU << sl);
+      if (map == 0U) {
+        map = tp->fl_bitmap & ((uint32_t)0xFFFFFFFFU << (fl + 1U));
+        if (map != 0U) {
+          fl  = tlsf_ffs(map);
+          map = tp->sl_bitmap[fl];
+        }
+      }
+      if (map != 0U) {
+        return tp->heads[(fl * CH_HEAP_TLSF_SL_COUNT) + tlsf_ffs(map)];
+      }
+    }
+  }
+
+  /* Falling back to the list containing the requested size.*/
+  tlsf_mapping(pages, &fl, &sl);
+  if (fl < tp->fl_count) {
+    return tp->heads[(fl * CH_HEAP_TLSF_SL_COUNT) + sl];
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Allocates a block from a TLSF heap.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] size      size of the block in bytes
+ * @param[in] pages     size of the block in pages
+ * @param[in] align     desired memory alignment
+ * @return              A pointer to the aligned allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ */
+static void *tlsf_alloc(memory_heap_t *heapp, size_t size,
+                        size_t pages, unsigned align) {
+  heap_tlsf_t *tp = heapp->tlsf;
+  heap_tlsf_block_t *bp, *fp;
+  size_t bpages, apages, spages, gap;
+
+  /* Pages required by the block including the header, alignments larger
+     than a page require space for a leading fragment, it is either
+     zero or at least two pages long in order to hold a free block.*/
+  bpages = pages + 1U;
+  apages = (size_t)align / CH_HEAP_ALIGNMENT;
+  spages = bpages;
+  if (apages > 1U) {
+    spages += apages + 1U;
+  }
+  if ((bpages > T_MAX_PAGES) || (spages < bpages)) {
+    return NULL;
+  }
+
+  bp = tlsf_find(tp, spages);
+  if ((bp == NULL) && (spages > bpages)) {
+    bp = tlsf_find(tp, bpages);
+  }
+  if (bp == NULL) {
+    return NULL;
+  }
+
+  /* Leading fragment size.*/
+  gap = NPAGES((heap_header_t *)MEM_ALIGN_NEXT(H_BLOCK(&bp->u.header), align),
+               H_BLOCK(&bp->u.header));
+  if (gap == 1U) {
+    gap += apages;
+  }
+  if (T_PAGES(bp) < (gap + bpages)) {
+    return NULL;
+  }
+  tlsf_remove(tp, bp);
+
+  if (gap > 0U) {
+    /* Splitting the leading fragment and returning it to the free lists,
+       the physically previous block is not free so no merging.*/
+    fp = bp;
+    bp = T_AT(T_TAG(fp) + gap);
+    bp->prev = fp;
+    T_SET_USED(bp, T_PAGES(fp) - gap);
+    T_SET_FREE(fp, gap - 1U);
+    tlsf_insert(tp, fp);
+    if (T_NEXT(bp) < tp->end) {
+      T_NEXT(bp)->prev = bp;
+    }
+  }
+
+  if (T_PAGES(bp) >= (bpages + 2U)) {
+    /* Splitting the excess, the physically next block is not free so
+       no merging.*/
+    fp = T_AT(T_TAG(bp) + 1U + bpages);
+    fp->prev = bp;
+    T_SET_FREE(fp, (T_PAGES(bp) - bpages) - 1U);
+    tlsf_insert(tp, fp);
+    if (T_NEXT(fp) < tp->end) {
+      T_NEXT(fp)->prev = fp;
+    }
+    T_SET_USED(bp, bpages);
+  }
+  else {
+    T_SET_USED(bp, T_PAGES(bp));
+  }
+
+  /* Setting in the block owner heap and size.*/
+  H_USED_HEAP(&bp->u.header) = heapp;
+  H_USED_SIZE(&bp->u.header) = size;
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  return (void *)H_BLOCK(&bp->u.header);
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Returns a block to a TLSF heap.
+ *
+ * @param[in] tp        pointer to the TLSF control structure
+ * @param[in] hp        pointer to the block header
+ */
+static void tlsf_free(heap_tlsf_t *tp, heap_header_t *hp) {
+  heap_tlsf_block_t *bp, *np;
+  size_t pages;
+
+  bp = T_AT(hp - 1U);
+  chDbgAssert(!T_IS_FREE(bp), "not allocated");
+  pages = T_PAGES(bp);
+
+  /* Merging with the physically next block.*/
+  np = T_NEXT(bp);
+  if ((np < tp->end) && T_IS_FREE(np)) {
+    tlsf_remove(tp, np);
+    pages += T_PAGES(np) + 1U;
+  }
+
+  /* Merging with the physically previous block.*/
+  if ((bp->prev != NULL) && T_IS_FREE(bp->prev)) {
+    bp = bp->prev;
+    tlsf_remove(tp, bp);
+    pages += T_PAGES(bp) + 1U;
+  }
+
+  T_SET_FREE(bp, pages);
+  np = T_NEXT(bp);
+  if (np < tp->end) {
+    np->prev = bp;
+  }
+  tlsf_insert(tp, bp);
+}
+
+/**
+ * @brief   TLSF heap integrity check.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @return              The test result.
+ * @retval false        The test succeeded.
+ * @retval true         Test failed.
+ */
+static bool tlsf_integrity_check(memory_heap_t *heapp) {
+  heap_tlsf_t *tp = heapp->tlsf;
+  heap_tlsf_block_t *bp, *prevbp;
+  size_t nfree;
+  unsigned i;
+
+  /* Physical blocks chain, free blocks must be merged.*/
+  nfree = 0U;
+  prevbp = NULL;
+  bp = tp->first;
+  while (bp < tp->end) {
+    if ((bp->prev != prevbp) || (T_PAGES(bp) == 0U)) {
+      return true;
+    }
+    if (T_IS_FREE(bp)) {
+      if ((prevbp != NULL) && T_IS_FREE(prevbp)) {
+        return true;
+      }
+      nfree++;
+    }
+    else if (H_USED_HEAP(&bp->u.header) != heapp) {
+      return true;
+    }
+    prevbp = bp;
+    bp = T_NEXT(bp);
+  }
+  if (bp != tp->end) {
+    return true;
+  }
+
+  /* Free lists, all free blocks must be found in the right list.*/
+  for (i = 0U; i < (tp->fl_count * CH_HEAP_TLSF_SL_COUNT); i++) {
+    unsigned fl = i / CH_HEAP_TLSF_SL_COUNT, sl = i % CH_HEAP_TLSF_SL_COUNT;
+    bool mapped = (tp->sl_bitmap[fl] & ((uint32_t)1U << sl)) != 0U;
+
+    if (mapped != (tp->heads[i] != NULL)) {
+      return true;
+    }
+
+    prevbp = NULL;
+    for (bp = tp->heads[i]; bp != NULL; bp = bp->u.free.next) {
+      unsigned bfl, bsl;
+
+      if ((nfree == 0U) ||
+          !MEM_IS_ALIGNED(bp, CH_HEAP_ALIGNMENT) ||
+          !chMemIsSpaceWithinX(&heapp->area, (void *)bp,
+                               (T_PAGES(bp) + 1U) * CH_HEAP_ALIGNMENT) ||
+          !T_IS_FREE(bp) || (bp->u.free.prev != prevbp)) {
+        return true;
+      }
+      tlsf_mapping(T_PAGES(bp), &bfl, &bsl);
+      if ((bfl != fl) || (bsl != sl)) {
+        return true;
+      }
+      nfree--;
+      prevbp = bp;
+    }
+  }
+
+  return nfree != 0U;
+}
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -113,6 +509,9 @@ void __heap_init(void) {
   chCoreGetStatusX(&default_heap.area);
   H_FREE_NEXT(&default_heap.header) = NULL;
   H_FREE_PAGES(&default_heap.header) = 0;
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  default_heap.tlsf = NULL;
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&default_heap.mtx);
 #else
@@ -157,6 +556,9 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
   H_FREE_PAGES(&heapp->header) = 0;
   heapp->area.base = NULL;
   heapp->area.size = 0U;
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  heapp->tlsf = NULL;
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&heapp->mtx);
 #else
@@ -183,6 +585,83 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
   heapp->area.size = H_FREE_FULLSIZE(hp);
 }
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a TLSF memory heap from a static memory area.
+ * @details The heap uses a two levels segregated fit allocator, both
+ *          allocation and release are performed in constant time.
+ * @note    The TLSF control structure is allocated at the beginning of the
+ *          buffer, its size depends on the buffer size.
+ * @note    Blocks allocated from a TLSF heap have an extra page of
+ *          overhead compared to first-fit heaps.
+ * @note    The heap buffer base and size are adjusted if the passed buffer
+ *          is not aligned to @p CH_HEAP_ALIGNMENT. This mean that the
+ *          effective heap size can be less than @p size.
+ *
+ * @param[out] heapp    pointer to the memory heap descriptor to be initialized
+ * @param[in] buf       heap buffer base
+ * @param[in] size      heap size
+ *
+ * @init
+ */
+void chHeapObjectInitTLSF(memory_heap_t *heapp, void *buf, size_t size) {
+  heap_header_t *hp;
+  heap_tlsf_t *tp;
+  size_t pages, cpages;
+  unsigned fl, sl, i;
+
+  /* Common initialization, the area is then reused for the TLSF
+     structures.*/
+  chHeapObjectInit(heapp, buf, size);
+  if (heapp->area.base == NULL) {
+    return;
+  }
+  H_FREE_NEXT(&heapp->header) = NULL;
+  hp = (heap_header_t *)(void *)heapp->area.base;
+  pages = heapp->area.size / CH_HEAP_ALIGNMENT;
+  if (pages > T_MAX_PAGES) {
+    pages = T_MAX_PAGES;
+    heapp->area.size = pages * CH_HEAP_ALIGNMENT;
+  }
+
+  /* Control structure size, the number of first levels is enough for a
+     block as large as the whole area.*/
+  tlsf_mapping(pages, &fl, &sl);
+  fl = fl + 1U;
+  cpages = (sizeof (heap_tlsf_t) +
+            (fl * CH_HEAP_TLSF_SL_COUNT * sizeof (heap_tlsf_block_t *)) +
+            (fl * sizeof (uint32_t)) + (CH_HEAP_ALIGNMENT - 1U)) /
+           CH_HEAP_ALIGNMENT;
+  if (pages < (cpages + 2U)) {
+    chDbgAssert(false, "heap buffer too small for TLSF");
+    return;
+  }
+
+  /* Control structure.*/
+  tp = (heap_tlsf_t *)(void *)hp;
+  tp->heads     = (heap_tlsf_block_t **)(void *)(tp + 1);
+  tp->sl_bitmap = (uint32_t *)(void *)(tp->heads +
+                                       (fl * CH_HEAP_TLSF_SL_COUNT));
+  tp->fl_bitmap = 0U;
+  tp->fl_count  = fl;
+  for (i = 0U; i < (fl * CH_HEAP_TLSF_SL_COUNT); i++) {
+    tp->heads[i] = NULL;
+  }
+  for (i = 0U; i < fl; i++) {
+    tp->sl_bitmap[i] = 0U;
+  }
+
+  /* Single free block spanning the rest of the area.*/
+  tp->first = T_AT(hp + cpages);
+  tp->end   = T_AT(hp + pages);
+  tp->first->prev = NULL;
+  T_SET_FREE(tp->first, (pages - cpages) - 1U);
+  tlsf_insert(tp, tp->first);
+
+  heapp->tlsf = tp;
+}
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /**
  * @brief   Disposes a memory heap object.
  * @note    Objects disposing does not involve freeing memory but just
@@ -212,6 +691,7 @@ void chHeapObjectDispose(memory_heap_t *heapp) {
  *          algorithm.
  * @details The allocated block is guaranteed to be properly aligned to the
  *          specified alignment.
+ * @note    TLSF heaps use the segregated fit algorithm instead.
  *
  * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
  *                      access the default heap.
@@ -253,6 +733,17 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
   /* Taking heap mutex.*/
   H_LOCK(heapp);
 
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    void *p = tlsf_alloc(heapp, size, pages, align);
+
+    /* Releasing heap mutex.*/
+    H_UNLOCK(heapp);
+
+    return p;
+  }
+#endif
+
   /* Start of the free blocks list.*/
   qp = &heapp->header;
   while (H_FREE_NEXT(qp) != NULL) {
@@ -368,6 +859,15 @@ void chHeapFree(void *p) {
   memset((void *)p, 0, MEM_ALIGN_NEXT(H_USED_SIZE(hp), CH_HEAP_ALIGNMENT));
 #endif
 
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    H_LOCK(heapp);
+    tlsf_free(heapp->tlsf, hp);
+    H_UNLOCK(heapp);
+    return;
+  }
+#endif
+
   /* Size is converted in number of elementary allocation units.*/
   H_FREE_PAGES(hp) = MEM_ALIGN_NEXT(H_USED_SIZE(hp),
                                     CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
@@ -430,6 +930,28 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
   tpages = 0U;
   lpages = 0U;
   n = 0U;
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    heap_tlsf_t *tp = heapp->tlsf;
+    unsigned i;
+
+    /* Scanning all free lists, the reported size of each block is the
+       space available for an allocation.*/
+    for (i = 0U; i < (tp->fl_count * CH_HEAP_TLSF_SL_COUNT); i++) {
+      heap_tlsf_block_t *bp;
+
+      for (bp = tp->heads[i]; bp != NULL; bp = bp->u.free.next) {
+        size_t pages = T_PAGES(bp) - 1U;
+
+        n++;
+        tpages += pages;
+        if (pages > lpages) {
+          lpages = pages;
+        }
+      }
+    }
+  }
+#endif
   qp = &heapp->header;
   while (H_FREE_NEXT(qp) != NULL) {
     size_t pages = H_FREE_PAGES(H_FREE_NEXT(qp));
@@ -489,6 +1011,12 @@ bool chHeapIntegrityCheck(memory_heap_t *heapp) {
   /* Taking heap mutex.*/
   H_LOCK(heapp);
 
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    result = tlsf_integrity_check(heapp);
+  }
+#endif
+
   prevhp = NULL;
   hp = &heapp->header;
   while ((hp = H_FREE_NEXT(hp)) != NULL) {
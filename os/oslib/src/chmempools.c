@@ -29,6 +29,11 @@
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
  *          to contain a pointer to void.
+ *          Objects can also be allocated and released in batches, a
+ *          single critical zone is entered for each batch. Magazines are
+ *          per-thread stashes of objects built on the batch APIs, most
+ *          allocations and releases through a magazine do not enter a
+ *          critical zone at all.
  * @pre     In order to use the memory pools APIs the @p CH_CFG_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -236,6 +241,173 @@ void chPoolFree(memory_pool_t *mp, void *objp) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Allocates multiple objects from a memory pool.
+ * @details The objects are taken from the pool within a single critical
+ *          zone.
+ * @pre     The memory pool must already be initialized.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t object
+ * @param[out] objpp    array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects, it is less than
+ *                      @p n if the pool has been emptied.
+ *
+ * @api
+ */
+size_t chPoolAllocBatch(memory_pool_t *mp, void **objpp, size_t n) {
+  size_t i;
+
+  chDbgCheck((mp != NULL) && (objpp != NULL));
+
+  chSysLock();
+  for (i = 0U; i < n; i++) {
+    objpp[i] = chPoolAllocI(mp);
+    if (objpp[i] == NULL) {
+      break;
+    }
+  }
+  chSysUnlock();
+
+  return i;
+}
+
+/**
+ * @brief   Releases multiple objects into a memory pool.
+ * @details The objects are chained outside the critical zone then the
+ *          whole chain is returned to the pool in constant time.
+ * @pre     The memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t object
+ * @param[in] objpp     array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @api
+ */
+void chPoolFreeBatch(memory_pool_t *mp, void **objpp, size_t n) {
+  struct pool_header *first, *last;
+  size_t i;
+
+  chDbgCheck((mp != NULL) && (objpp != NULL));
+
+  if (n == 0U) {
+    return;
+  }
+
+  /* Chaining the objects.*/
+  first = objpp[0];
+  last  = first;
+  chDbgCheck((last != NULL) && MEM_IS_ALIGNED(last, mp->align));
+  for (i = 1U; i < n; i++) {
+    chDbgCheck((objpp[i] != NULL) && MEM_IS_ALIGNED(objpp[i], mp->align));
+    last->next = objpp[i];
+    last = last->next;
+  }
+
+  chSysLock();
+  last->next = mp->next;
+  mp->next = first;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a memory pool magazine.
+ * @details The magazine is initially empty, objects are taken from the
+ *          pool on the first allocation.
+ *
+ * @param[out] mgp      pointer to a @p pool_magazine_t object
+ * @param[in] mp        pointer to the associated @p memory_pool_t object
+ * @param[in] objpp     pointer to an array of @p size pointers used as
+ *                      objects storage
+ * @param[in] size      magazine capacity
+ *
+ * @init
+ */
+void chPoolMagazineObjectInit(pool_magazine_t *mgp, memory_pool_t *mp,
+                              void **objpp, size_t size) {
+
+  chDbgCheck((mgp != NULL) && (mp != NULL) &&
+             (objpp != NULL) && (size > 0U));
+
+  mgp->pool    = mp;
+  mgp->objects = objpp;
+  mgp->size    = size;
+  mgp->count   = 0U;
+}
+
+/**
+ * @brief   Allocates an object using a magazine.
+ * @details If the magazine is empty then it is refilled with half its
+ *          capacity from the associated pool.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t object
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if both the magazine and the pool are empty.
+ *
+ * @api
+ */
+void *chPoolMagazineAlloc(pool_magazine_t *mgp) {
+
+  chDbgCheck(mgp != NULL);
+
+  if (mgp->count == 0U) {
+    mgp->count = chPoolAllocBatch(mgp->pool, mgp->objects,
+                                  (mgp->size + 1U) / 2U);
+    if (mgp->count == 0U) {
+      return NULL;
+    }
+  }
+
+  mgp->count--;
+
+  return mgp->objects[mgp->count];
+}
+
+/**
+ * @brief   Releases an object using a magazine.
+ * @details If the magazine is full then half its capacity is returned
+ *          to the associated pool.
+ * @pre     The freed object must be of the right size for the associated
+ *          memory pool.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t object
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chPoolMagazineFree(pool_magazine_t *mgp, void *objp) {
+
+  chDbgCheck((mgp != NULL) && (objp != NULL));
+
+  if (mgp->count >= mgp->size) {
+    size_t n = (mgp->size + 1U) / 2U;
+
+    mgp->count -= n;
+    chPoolFreeBatch(mgp->pool, &mgp->objects[mgp->count], n);
+  }
+
+  mgp->objects[mgp->count] = objp;
+  mgp->count++;
+}
+
+/**
+ * @brief   Returns all the objects in a magazine to the associated pool.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t object
+ *
+ * @api
+ */
+void chPoolMagazineFlush(pool_magazine_t *mgp) {
+
+  chDbgCheck(mgp != NULL);
+
+  chPoolFreeBatch(mgp->pool, mgp->objects, mgp->count);
+  mgp->count = 0U;
+}
+
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Initializes an empty guarded memory pool.
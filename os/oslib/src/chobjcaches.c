@@ -41,6 +41,8 @@
  *            media.
  *          - <b>Release Object</b>: Releases an object to the cache handling
  *            the media update, if required.
+ *          - <b>Flush</b>: Writes back the lazy-write objects of an owner in
+ *            ascending key order.
  *          .
  * @pre     In order to use the objects caches APIs the @p CH_CFG_USE_OBJ_CACHES
  *          option must be enabled in @p chconf.h.
@@ -58,26 +60,41 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
-/* Default hash function.*/
+/* Default hash function, owner and key are mixed so that sequential keys
+   of different owners do not cluster on the same slots.*/
 #if !defined(OC_HASH_FUNCTION) || defined(__DOXYGEN__)
 #define OC_HASH_FUNCTION(ocp, owner, key)                                   \
-  (((uintptr_t)(owner) + (uintptr_t)(key)) & ((uintptr_t)(ocp)->hashn - 1U))
+  (hash_mix(((uint32_t)(uintptr_t)(owner) * 0x9E3779B1U) ^ (uint32_t)(key)) \
+   & ((uint32_t)(ocp)->hashn - 1U))
+#endif
+
+/* Hash slot of an owner/key pair.*/
+#define HASH_SLOT(ocp, owner, key)                                          \
+  (&(ocp)->hashp[OC_HASH_FUNCTION(ocp, owner, key)])
+
+/* Statistics counters update.*/
+#if CH_CFG_OBJ_CACHES_STATISTICS == TRUE
+#define STATS_INC(hep, field)       ((hep)->field++)
+#define STATS_DEC(hep, field)       ((hep)->field--)
+#else
+#define STATS_INC(hep, field)
+#define STATS_DEC(hep, field)
 #endif
 
 /* Insertion into an hash slot list.*/
-#define HASH_INSERT(ocp, objp, group, key) {                                \
-  oc_hash_element_t *hep;                                                   \
-  hep = &(ocp)->hashp[OC_HASH_FUNCTION(ocp, group, key)];                   \
-  (objp)->list.h.next = hep->next;                                          \
-  (objp)->list.h.prev = hep;                                                \
-  hep->next->prev = &(objp)->list.h;                                        \
-  hep->next = &(objp)->list.h;                                              \
+#define HASH_INSERT(hep, objp) {                                            \
+  (objp)->list.h.next = (hep)->next;                                        \
+  (objp)->list.h.prev = (hep);                                              \
+  (hep)->next->prev = &(objp)->list.h;                                      \
+  (hep)->next = &(objp)->list.h;                                            \
+  STATS_INC(hep, chain);                                                    \
 }
 
 /* Removal of an object from the hash.*/
-#define HASH_REMOVE(objp) {                                                 \
+#define HASH_REMOVE(ocp, objp) {                                            \
   (objp)->list.h.prev->next = (objp)->list.h.next;                          \
   (objp)->list.h.next->prev = (objp)->list.h.prev;                          \
+  STATS_DEC(HASH_SLOT(ocp, (objp)->obj_owner, (objp)->obj_key), chain);     \
 }
 
 /* Insertion on LRU list head (newer objects).*/
@@ -119,24 +136,41 @@
 /*===========================================================================*/
 
 /**
- * @brief   Returns an object pointer from the cache, if present.
+ * @brief   Mixes the bits of an hash value.
+ * @details Finalizer of MurmurHash3, each input bit affects all the output
+ *          bits so the low order bits can be used as slot index.
  *
- * @param[out] ocp      pointer to the @p objects_cache_t object to be
+ * @param[in] h         value to be mixed
+ * @return              The mixed value.
+ *
+ * @notapi
+ */
+static inline uint32_t hash_mix(uint32_t h) {
+
+  h ^= h >> 16;
+  h *= 0x85EBCA6BU;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35U;
+  h ^= h >> 16;
+
+  return h;
+}
+
+/**
+ * @brief   Returns an object pointer from an hash slot, if present.
+ *
+ * @param[in] hep       pointer to the hash slot
  * @param[in] owner     object owner pointer
  * @param[in] key       object identifier within the group
- *                      initialized
  * @return              The pointer to the retrieved object.
  * @retval NULL         if the object is not in cache.
  *
  * @notapi
  */
-static oc_object_t *hash_get_s(objects_cache_t *ocp,
+static oc_object_t *hash_get_s(oc_hash_element_t *hep,
                                void *owner,
                                uint32_t key) {
-  oc_hash_element_t *hep, *p;
-
-  /* Hash slot where to search for an hit.*/
-  hep  = &ocp->hashp[OC_HASH_FUNCTION(ocp, owner, key)];
+  oc_hash_element_t *p;
 
   /* Scanning the siblings collision list.*/
   p = hep->next;
@@ -190,7 +224,7 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
 
       /* Removing from hash table if required.*/
       if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
-        HASH_REMOVE(objp);
+        HASH_REMOVE(ocp, objp);
       }
 
       /* Removing all flags, it is "new" now.*/
@@ -213,6 +247,31 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
   }
 }
 
+/**
+ * @brief   Checks if an object has to be written back by a flush.
+ *
+ * @param[in] objp      pointer to the @p oc_object_t object
+ * @param[in] owner     object owner pointer
+ * @param[in] first     first key of the range
+ * @param[in] last      last key of the range, inclusive
+ * @return              The check result.
+ * @retval false        if the object is not to be written.
+ * @retval true         if the object is an idle lazy-write object of the
+ *                      owner within the keys range.
+ *
+ * @notapi
+ */
+static bool flush_candidate_s(const oc_object_t *objp,
+                              void *owner,
+                              uint32_t first,
+                              uint32_t last) {
+
+  return ((objp->obj_flags & (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE)) ==
+          (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE)) &&
+         (objp->obj_owner == owner) &&
+         (objp->obj_key >= first) && (objp->obj_key <= last);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -268,6 +327,11 @@ void chCacheObjectInit(objects_cache_t *ocp,
   do {
     hashp->next = hashp;
     hashp->prev = hashp;
+#if CH_CFG_OBJ_CACHES_STATISTICS == TRUE
+    hashp->hits   = (ucnt_t)0;
+    hashp->misses = (ucnt_t)0;
+    hashp->chain  = (ucnt_t)0;
+#endif
     hashp++;
   } while (hashp < &ocp->hashp[ocp->hashn]);
 
@@ -302,18 +366,24 @@ void chCacheObjectInit(objects_cache_t *ocp,
 oc_object_t *chCacheGetObject(objects_cache_t *ocp,
                               void *owner,
                               uint32_t key) {
+  oc_hash_element_t *hep;
   oc_object_t *objp;
 
+  /* Hash slot where to search for an hit.*/
+  hep = HASH_SLOT(ocp, owner, key);
+
   /* Critical section enter, the hash check operation is fast.*/
   chSysLock();
 
   /* Checking the cache for a hit.*/
-  objp = hash_get_s(ocp, owner, key);
+  objp = hash_get_s(hep, owner, key);
   if (objp != NULL) {
 
     chDbgAssert((objp->obj_flags & OC_FLAG_INHASH) == OC_FLAG_INHASH,
                 "not in hash");
 
+    STATS_INC(hep, hits);
+
     /* Cache hit, checking if the buffer is owned by some
        other thread.*/
     if (chSemGetCounterI(&objp->obj_sem) > (cnt_t)0) {
@@ -346,6 +416,8 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     }
   }
   else {
+    STATS_INC(hep, misses);
+
     /* Cache miss, getting an object buffer from the LRU list.*/
     objp = lru_get_last_s(ocp);
 
@@ -353,7 +425,7 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     objp->obj_owner = owner;
     objp->obj_key   = key;
     objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
-    HASH_INSERT(ocp, objp, owner, key);
+    HASH_INSERT(hep, objp);
   }
 
   /* Out of critical section and returning the object.*/
@@ -403,7 +475,7 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
   /* If the object specifies OC_FLAG_NOTSYNC then it must be invalidated
      and removed from the hash table.*/
   if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
-    HASH_REMOVE(objp);
+    HASH_REMOVE(ocp, objp);
     LRU_INSERT_TAIL(ocp, objp);
     objp->obj_owner = NULL;
     objp->obj_key   = 0U;
@@ -488,6 +560,151 @@ bool chCacheWriteObject(objects_cache_t *ocp,
   return ocp->writef(ocp, objp, async);
 }
 
+/**
+ * @brief   Writes back the lazy-write objects of an owner within a keys range.
+ * @details Objects are written synchronously in ascending key order, so
+ *          that the storage receives a sequential stream of writes, and are
+ *          kept in cache.
+ * @note    Objects currently owned by a thread are not written, they will be
+ *          written when released and evicted from the LRU list or by
+ *          another flush.
+ * @note    The objects table is scanned once for each object to be written,
+ *          the critical zone is entered for each scanned object.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t object
+ * @param[in] owner     object owner pointer
+ * @param[in] first     first key of the range
+ * @param[in] last      last key of the range, inclusive
+ * @return              The operation status. The flush stops on the first
+ *                      failed write, the object remains marked for lazy
+ *                      write.
+ * @retval false        if the operation succeeded.
+ * @retval true         if a write operation failed.
+ *
+ * @api
+ */
+bool chCacheFlushRange(objects_cache_t *ocp,
+                       void *owner,
+                       uint32_t first,
+                       uint32_t last) {
+  bool error = false;
+
+  chDbgCheck((ocp != NULL) && (first <= last));
+
+  while (true) {
+    oc_object_t *objp = NULL;
+    uint8_t *p = (uint8_t *)ocp->objvp;
+    ucnt_t n;
+    uint32_t key = 0U;
+
+    /* Searching the idle lazy-write object with the lowest key in range,
+       the critical zone is entered for each object so that the latency
+       does not depend on the cache size.*/
+    for (n = ocp->objn; n > (ucnt_t)0; n--) {
+      oc_object_t *op = (oc_object_t *)(void *)p;
+
+      chSysLock();
+      if (flush_candidate_s(op, owner, first, last) &&
+          ((objp == NULL) || (op->obj_key < key))) {
+        objp = op;
+        key  = op->obj_key;
+      }
+      chSysUnlock();
+      p += ocp->objsz;
+    }
+
+    if (objp == NULL) {
+      break;
+    }
+
+    chSysLock();
+
+    /* The object could have been taken or reused during the search, the
+       search is repeated in that case.*/
+    if (!flush_candidate_s(objp, owner, first, last) ||
+        (objp->obj_key != key)) {
+      chSysUnlock();
+      continue;
+    }
+
+    /* Taking the object out of the LRU list as a cache hit would do.*/
+    LRU_REMOVE(objp);
+    objp->obj_flags &= ~OC_FLAG_INLRU;
+    chSemFastWaitI(&ocp->lru_sem);
+    chSemFastWaitI(&objp->obj_sem);
+
+    chSysUnlock();
+
+    error = chCacheWriteObject(ocp, objp, false);
+    if (error) {
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+    }
+    chCacheReleaseObject(ocp, objp);
+
+    if (error || (key == last)) {
+      break;
+    }
+    first = key + 1U;
+  }
+
+  return error;
+}
+
+#if (CH_CFG_OBJ_CACHES_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a summary of the cache statistics.
+ * @note    The counters are sampled outside the critical zone, the summary
+ *          is not an atomic snapshot.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t object
+ * @param[out] sp       pointer to the @p oc_stats_t structure to be filled
+ *
+ * @api
+ */
+void chCacheGetStats(objects_cache_t *ocp, oc_stats_t *sp) {
+  const oc_hash_element_t *hep;
+
+  chDbgCheck((ocp != NULL) && (sp != NULL));
+
+  sp->hits    = (ucnt_t)0;
+  sp->misses  = (ucnt_t)0;
+  sp->used    = (ucnt_t)0;
+  sp->longest = (ucnt_t)0;
+  for (hep = ocp->hashp; hep < &ocp->hashp[ocp->hashn]; hep++) {
+    ucnt_t chain = hep->chain;
+
+    sp->hits   += hep->hits;
+    sp->misses += hep->misses;
+    if (chain > (ucnt_t)0) {
+      sp->used++;
+    }
+    if (chain > sp->longest) {
+      sp->longest = chain;
+    }
+  }
+}
+
+/**
+ * @brief   Clears the hits and misses counters.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t object
+ *
+ * @api
+ */
+void chCacheResetStats(objects_cache_t *ocp) {
+  oc_hash_element_t *hep;
+
+  chDbgCheck(ocp != NULL);
+
+  for (hep = ocp->hashp; hep < &ocp->hashp[ocp->hashn]; hep++) {
+    chSysLock();
+    hep->hits   = (ucnt_t)0;
+    hep->misses = (ucnt_t)0;
+    chSysUnlock();
+  }
+}
+#endif /* CH_CFG_OBJ_CACHES_STATISTICS == TRUE */
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 /** @} */
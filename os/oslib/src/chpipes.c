@@ -25,6 +25,10 @@
  *          Operations defined for pipes:
  *          - <b>Write</b>: Writes a buffer of data in the pipe in FIFO order.
  *          - <b>Read</b>: A buffer of data is read from the pipe and removed.
+ *          - <b>Reserve/Commit</b>: A span of the pipe buffer is filled
+ *            in place then made available to readers.
+ *          - <b>Peek/Consume</b>: A span of the pipe buffer is accessed
+ *            in place then removed from the pipe.
  *          - <b>Reset</b>: The pipe is emptied and all the stored data
  *            is lost.
  *          .
@@ -380,6 +384,247 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Reserves a contiguous span of free space into a pipe.
+ * @details The function returns a pointer to the free space following the
+ *          pipe write pointer, the span does not wrap around the buffer
+ *          boundary so it could be smaller than the total free space.
+ *          The caller can fill the span directly then make the data
+ *          visible to readers using @p chPipeWriteCommit().
+ * @note    The write side of the pipe is owned by the caller until
+ *          @p chPipeWriteCommit() is invoked, other writers are blocked
+ *          meanwhile. The reservation must be committed by the same thread.
+ *
+ * @param[in] pp        pointer to an initialized @p pipe_t object
+ * @param[out] np       pointer to a variable receiving the size of the
+ *                      reserved span
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              Pointer to the reserved span.
+ * @retval NULL         if a timeout occurred or the pipe went in reset state,
+ *                      in this case there is nothing to commit.
+ *
+ * @api
+ */
+uint8_t *chPipeWriteReserveTimeout(pipe_t *pp, size_t *np,
+                                   sysinterval_t timeout) {
+
+  chDbgCheck((pp != NULL) && (np != NULL));
+
+  *np = (size_t)0;
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return NULL;
+  }
+
+  PW_LOCK(pp);
+
+  while (true) {
+    size_t n;
+    msg_t msg;
+
+    PC_LOCK(pp);
+
+    /* Contiguous free space after the write pointer.*/
+    n = chPipeGetFreeCount(pp);
+    /*lint -save -e9033 [10.8] Checked to be safe.*/
+    if (n > (size_t)(pp->top - pp->wrptr)) {
+      n = (size_t)(pp->top - pp->wrptr);
+    }
+    /*lint -restore*/
+
+    PC_UNLOCK(pp);
+
+    if (n > (size_t)0) {
+      *np = n;
+      return pp->wrptr;
+    }
+
+    chSysLock();
+    msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+    chSysUnlock();
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+
+  PW_UNLOCK(pp);
+
+  return NULL;
+}
+
+/**
+ * @brief   Commits data written into a reserved span.
+ * @details The first @p n bytes of the span returned by
+ *          @p chPipeWriteReserveTimeout() are made available to readers
+ *          and the write side of the pipe is released. The remaining part
+ *          of the span is returned to the free space.
+ * @note    If the pipe has been reset meanwhile then the data is discarded.
+ *
+ * @param[in] pp        pointer to an initialized @p pipe_t object
+ * @param[in] n         number of bytes to be committed, it cannot exceed the
+ *                      reserved span size, zero cancels the reservation
+ *
+ * @api
+ */
+void chPipeWriteCommit(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  PC_LOCK(pp);
+
+  if (!pp->reset) {
+    /*lint -save -e9033 [10.8] Checked to be safe.*/
+    chDbgAssert((n <= chPipeGetFreeCount(pp)) &&
+                (n <= (size_t)(pp->top - pp->wrptr)),
+                "out of reservation");
+    /*lint -restore*/
+
+    pp->cnt   += n;
+    pp->wrptr += n;
+    if (pp->wrptr >= pp->top) {
+      pp->wrptr = pp->buffer;
+    }
+  }
+  else {
+    n = (size_t)0;
+  }
+
+  PC_UNLOCK(pp);
+
+  /* Resuming the reader, if present.*/
+  if (n > (size_t)0) {
+    chThdResume(&pp->rtr, MSG_OK);
+  }
+
+  PW_UNLOCK(pp);
+}
+
+/**
+ * @brief   Peeks a contiguous span of data from a pipe.
+ * @details The function returns a pointer to the data following the
+ *          pipe read pointer, the span does not wrap around the buffer
+ *          boundary so it could be smaller than the total queued data.
+ *          The caller can access the data in place then release it using
+ *          @p chPipeReadConsume().
+ * @note    The read side of the pipe is owned by the caller until
+ *          @p chPipeReadConsume() is invoked, other readers are blocked
+ *          meanwhile. The data must be consumed by the same thread.
+ *
+ * @param[in] pp        pointer to an initialized @p pipe_t object
+ * @param[out] np       pointer to a variable receiving the size of the
+ *                      available span
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              Pointer to the available span.
+ * @retval NULL         if a timeout occurred or the pipe went in reset state,
+ *                      in this case there is nothing to consume.
+ *
+ * @api
+ */
+const uint8_t *chPipeReadPeekTimeout(pipe_t *pp, size_t *np,
+                                     sysinterval_t timeout) {
+
+  chDbgCheck((pp != NULL) && (np != NULL));
+
+  *np = (size_t)0;
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return NULL;
+  }
+
+  PR_LOCK(pp);
+
+  while (true) {
+    size_t n;
+    msg_t msg;
+
+    PC_LOCK(pp);
+
+    /* Contiguous data after the read pointer.*/
+    n = chPipeGetUsedCount(pp);
+    /*lint -save -e9033 [10.8] Checked to be safe.*/
+    if (n > (size_t)(pp->top - pp->rdptr)) {
+      n = (size_t)(pp->top - pp->rdptr);
+    }
+    /*lint -restore*/
+
+    PC_UNLOCK(pp);
+
+    if (n > (size_t)0) {
+      *np = n;
+      return pp->rdptr;
+    }
+
+    chSysLock();
+    msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+    chSysUnlock();
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+
+  PR_UNLOCK(pp);
+
+  return NULL;
+}
+
+/**
+ * @brief   Consumes data from a peeked span.
+ * @details The first @p n bytes of the span returned by
+ *          @p chPipeReadPeekTimeout() are removed from the pipe and the
+ *          read side of the pipe is released.
+ * @note    If the pipe has been reset meanwhile then nothing is removed.
+ *
+ * @param[in] pp        pointer to an initialized @p pipe_t object
+ * @param[in] n         number of bytes to be consumed, it cannot exceed the
+ *                      peeked span size, zero leaves the data in the pipe
+ *
+ * @api
+ */
+void chPipeReadConsume(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  PC_LOCK(pp);
+
+  if (!pp->reset) {
+    /*lint -save -e9033 [10.8] Checked to be safe.*/
+    chDbgAssert((n <= chPipeGetUsedCount(pp)) &&
+                (n <= (size_t)(pp->top - pp->rdptr)),
+                "out of span");
+    /*lint -restore*/
+
+    pp->cnt   -= n;
+    pp->rdptr += n;
+    if (pp->rdptr >= pp->top) {
+      pp->rdptr = pp->buffer;
+    }
+  }
+  else {
+    n = (size_t)0;
+  }
+
+  PC_UNLOCK(pp);
+
+  /* Resuming the writer, if present.*/
+  if (n > (size_t)0) {
+    chThdResume(&pp->wtr, MSG_OK);
+  }
+
+  PR_UNLOCK(pp);
+}
+
 #endif /* CH_CFG_USE_PIPES == TRUE */
 
 /** @} */
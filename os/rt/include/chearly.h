@@ -206,6 +206,21 @@ typedef struct ch_os_instance os_instance_t;
 #define unlikely(x)     x
 #endif
 
+/**
+ * @brief   Counts the trailing zero bits of a 32 bits word.
+ * @note    The result is undefined if the word is zero.
+ * @note    Ports can provide an optimized implementation by defining
+ *          @p PORT_CTZ32(), a portable implementation is used otherwise.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ * @return              The number of trailing zero bits.
+ */
+#if defined(PORT_CTZ32) || defined(__DOXYGEN__)
+#define __CH_CTZ32(x)   PORT_CTZ32(x)
+#else
+#define __CH_CTZ32(x)   __ch_ctz32(x)
+#endif
+
 /**
  * @brief   Safe cast of a queue pointer to a thread pointer.
  * @note    Casting to a thread pointer should always be performed using
@@ -235,6 +250,43 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+#if !defined(PORT_CTZ32) || defined(__DOXYGEN__)
+/**
+ * @brief   Portable trailing zero bits count.
+ * @note    The result is undefined if the word is zero.
+ *
+ * @param[in] x         a non-zero 32 bits word
+ * @return              The number of trailing zero bits.
+ *
+ * @notapi
+ */
+static inline unsigned __ch_ctz32(uint32_t x) {
+  unsigned n = 0U;
+
+  if ((x & 0x0000FFFFU) == 0U) {
+    n += 16U;
+    x >>= 16U;
+  }
+  if ((x & 0x000000FFU) == 0U) {
+    n += 8U;
+    x >>= 8U;
+  }
+  if ((x & 0x0000000FU) == 0U) {
+    n += 4U;
+    x >>= 4U;
+  }
+  if ((x & 0x00000003U) == 0U) {
+    n += 2U;
+    x >>= 2U;
+  }
+  if ((x & 0x00000001U) == 0U) {
+    n += 1U;
+  }
+
+  return n;
+}
+#endif
+
 #endif /* CHEARLY_H */
 
 /** @} */
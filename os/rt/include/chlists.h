@@ -31,6 +31,16 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of priority levels tracked by a priority queue index.
+ */
+#define CH_PQUEUE_INDEX_LEVELS          256U
+
+/**
+ * @brief   Number of 32 bits words in a priority queue index bitmap.
+ */
+#define CH_PQUEUE_INDEX_WORDS           (CH_PQUEUE_INDEX_LEVELS / 32U)
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -87,6 +97,34 @@ struct ch_priority_queue {
   tprio_t               prio;       /**< @brief Priority of this element.   */
 };
 
+/**
+ * @brief   Type of a priority queue index.
+ */
+typedef struct ch_pqueue_index ch_pqueue_index_t;
+
+/**
+ * @brief   Structure representing a priority queue index.
+ * @details The index allows constant time insertions in a priority queue.
+ *          Elements with the same priority are contiguous in the queue so
+ *          each priority level is a FIFO bucket, the index keeps a pointer
+ *          to the last element of each level and a two levels bitmap of
+ *          the non-empty levels.
+ */
+struct ch_pqueue_index {
+  /**
+   * @brief   Mask of the non-zero words in @p levels.
+   */
+  uint32_t              summary;
+  /**
+   * @brief   Mask of the non-empty priority levels.
+   */
+  uint32_t              levels[CH_PQUEUE_INDEX_WORDS];
+  /**
+   * @brief   Last element of each priority level.
+   */
+  ch_priority_queue_t   *tails[CH_PQUEUE_INDEX_LEVELS];
+};
+
 /**
  * @brief   Type of a generic bidirectional linked delta list
  *          header and element.
@@ -496,6 +534,245 @@ static inline ch_priority_queue_t *ch_pqueue_insert_ahead(ch_priority_queue_t *p
   return p;
 }
 
+/**
+ * @brief   Priority queue index initialization.
+ *
+ * @param[out] pqip     pointer to the priority queue index
+ *
+ * @notapi
+ */
+static inline void ch_pqueue_index_init(ch_pqueue_index_t *pqip) {
+  unsigned i;
+
+  pqip->summary = 0U;
+  for (i = 0U; i < CH_PQUEUE_INDEX_WORDS; i++) {
+    pqip->levels[i] = 0U;
+  }
+  for (i = 0U; i < CH_PQUEUE_INDEX_LEVELS; i++) {
+    pqip->tails[i] = NULL;
+  }
+}
+
+/**
+ * @brief   Marks a priority level as non-empty in the index.
+ *
+ * @param[in] pqip      pointer to the priority queue index
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static inline void ch_pqueue_index_set(ch_pqueue_index_t *pqip,
+                                       tprio_t prio) {
+  unsigned w = (unsigned)prio >> 5U;
+
+  pqip->levels[w] |= (uint32_t)1U << ((unsigned)prio & 31U);
+  pqip->summary   |= (uint32_t)1U << w;
+}
+
+/**
+ * @brief   Marks a priority level as empty in the index.
+ *
+ * @param[in] pqip      pointer to the priority queue index
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static inline void ch_pqueue_index_clear(ch_pqueue_index_t *pqip,
+                                         tprio_t prio) {
+  unsigned w = (unsigned)prio >> 5U;
+
+  pqip->tails[prio] = NULL;
+  pqip->levels[w] &= ~((uint32_t)1U << ((unsigned)prio & 31U));
+  if (pqip->levels[w] == 0U) {
+    pqip->summary &= ~((uint32_t)1U << w);
+  }
+}
+
+/**
+ * @brief   Returns the insertion point ahead of a priority level.
+ * @details The returned element is the last element of the nearest
+ *          non-empty level with priority greater than @p prio or the
+ *          queue header if there are no such levels.
+ *
+ * @param[in] pqp       the pointer to the priority queue list header
+ * @param[in] pqip      pointer to the priority queue index
+ * @param[in] prio      the priority level
+ * @return              The element after which to insert.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *ch_pqueue_index_above(ch_priority_queue_t *pqp,
+                                                         ch_pqueue_index_t *pqip,
+                                                         tprio_t prio) {
+  unsigned w = (unsigned)prio >> 5U;
+  uint32_t mask;
+
+  /* Higher levels in the same word first.*/
+  mask = pqip->levels[w] &
+         ~(((uint32_t)2U << ((unsigned)prio & 31U)) - (uint32_t)1U);
+  if (mask == 0U) {
+
+    /* Nearest non-empty word above, if any.*/
+    mask = pqip->summary & ~(((uint32_t)2U << w) - (uint32_t)1U);
+    if (mask == 0U) {
+      return pqp;
+    }
+    w = __CH_CTZ32(mask);
+    mask = pqip->levels[w];
+  }
+
+  return pqip->tails[(w << 5U) + __CH_CTZ32(mask)];
+}
+
+/**
+ * @brief   Inserts an element after another element.
+ *
+ * @param[in] prev      the pointer to the element preceding the insertion
+ *                      point
+ * @param[in] p         the pointer to the element to be inserted
+ *
+ * @notapi
+ */
+static inline void ch_pqueue_insert_after(ch_priority_queue_t *prev,
+                                          ch_priority_queue_t *p) {
+
+  /* Safety checks.*/
+  chSftValidateDataPointerX(3, prev->next);
+  chSftAssert(2, prev->next->prev == prev, "link back");
+
+  p->prev       = prev;
+  p->next       = prev->next;
+  p->next->prev = p;
+  prev->next    = p;
+}
+
+/**
+ * @brief   Removes the highest priority element from an indexed priority
+ *          queue and returns it.
+ *
+ * @param[in] pqp       the pointer to the priority queue list header
+ * @param[in] pqip      pointer to the priority queue index
+ * @return              The removed element pointer.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *ch_pqueue_remove_highest_indexed(ch_priority_queue_t *pqp,
+                                                                    ch_pqueue_index_t *pqip) {
+  ch_priority_queue_t *p = pqp->next;
+
+  /* If the element was the only one in its level then the level is
+     marked as empty.*/
+  if (pqip->tails[p->prio] == p) {
+    ch_pqueue_index_clear(pqip, p->prio);
+  }
+
+  pqp->next       = p->next;
+  pqp->next->prev = pqp;
+
+  return p;
+}
+
+/**
+ * @brief   Inserts an element in an indexed priority queue placing it
+ *          behind its peers.
+ * @details The element is positioned behind all elements with higher or
+ *          equal priority, the operation is performed in constant time.
+ *
+ * @param[in] pqp       the pointer to the priority queue list header
+ * @param[in] pqip      pointer to the priority queue index
+ * @param[in] p         the pointer to the element to be inserted in the queue
+ * @return              The inserted element pointer.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *ch_pqueue_insert_behind_indexed(ch_priority_queue_t *pqp,
+                                                                   ch_pqueue_index_t *pqip,
+                                                                   ch_priority_queue_t *p) {
+  ch_priority_queue_t *prev;
+
+  chDbgAssert((p->prio > (tprio_t)0) &&
+              ((unsigned)p->prio < CH_PQUEUE_INDEX_LEVELS),
+              "priority out of range");
+
+  /* Behind the last element of the same level, if the level is empty
+     then behind the nearest higher level.*/
+  prev = pqip->tails[p->prio];
+  if (prev == NULL) {
+    prev = ch_pqueue_index_above(pqp, pqip, p->prio);
+    ch_pqueue_index_set(pqip, p->prio);
+  }
+  pqip->tails[p->prio] = p;
+  ch_pqueue_insert_after(prev, p);
+
+  return p;
+}
+
+/**
+ * @brief   Inserts an element in an indexed priority queue placing it
+ *          ahead of its peers.
+ * @details The element is positioned ahead of all elements with equal
+ *          priority, the operation is performed in constant time.
+ *
+ * @param[in] pqp       the pointer to the priority queue list header
+ * @param[in] pqip      pointer to the priority queue index
+ * @param[in] p         the pointer to the element to be inserted in the queue
+ * @return              The inserted element pointer.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *ch_pqueue_insert_ahead_indexed(ch_priority_queue_t *pqp,
+                                                                  ch_pqueue_index_t *pqip,
+                                                                  ch_priority_queue_t *p) {
+
+  chDbgAssert((p->prio > (tprio_t)0) &&
+              ((unsigned)p->prio < CH_PQUEUE_INDEX_LEVELS),
+              "priority out of range");
+
+  /* If the level is empty then the element also becomes its last one.*/
+  if (pqip->tails[p->prio] == NULL) {
+    pqip->tails[p->prio] = p;
+    ch_pqueue_index_set(pqip, p->prio);
+  }
+  ch_pqueue_insert_after(ch_pqueue_index_above(pqp, pqip, p->prio), p);
+
+  return p;
+}
+
+/**
+ * @brief   Removes an element from an indexed priority queue and returns it.
+ * @details The element is removed from the queue regardless of its relative
+ *          position.
+ * @note    The priority level is passed explicitly because the element
+ *          priority could have been already modified by the caller.
+ *
+ * @param[in] pqip      pointer to the priority queue index
+ * @param[in] p         the pointer to the element to be removed from the queue
+ * @param[in] prio      the priority level the element has been inserted with
+ * @return              The removed element pointer.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *ch_pqueue_dequeue_indexed(ch_pqueue_index_t *pqip,
+                                                             ch_priority_queue_t *p,
+                                                             tprio_t prio) {
+
+  /* If the element is the last one of its level then the previous element
+     becomes the last one, if it is in the same level.*/
+  if (pqip->tails[prio] == p) {
+    if (p->prev->prio == prio) {
+      pqip->tails[prio] = p->prev;
+    }
+    else {
+      ch_pqueue_index_clear(pqip, prio);
+    }
+  }
+
+  p->prev->next = p->next;
+  p->next->prev = p->prev;
+
+  return p;
+}
+
 /**
  * @brief   Delta list initialization.
  *
@@ -108,6 +108,9 @@ extern "C" {
   void chMtxUnlockS(mutex_t *mp);
   void chMtxUnlockAll(void);
   void chMtxUnlockAllS(void);
+#if CH_CFG_USE_CONDVARS == TRUE
+  bool __mtx_lock_for_i(mutex_t *mp, thread_t *tp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -31,14 +31,104 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Virtual timers backends
+ * @{
+ */
+#define CH_VT_BACKEND_DLIST                 0   /**< @brief Delta list.     */
+#define CH_VT_BACKEND_WHEEL                 1   /**< @brief Hierarchical
+                                                     timing wheel.          */
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Indexed ready list.
+ * @details If enabled then the ready list is indexed by priority using a
+ *          bitmap and per-level pointers, threads insertion in the ready
+ *          list is performed in constant time regardless of the number of
+ *          ready threads.
+ * @note    The index requires about one pointer of RAM for each priority
+ *          level in each OS instance.
+ */
+#if !defined(CH_CFG_READY_LIST_BITMAP) || defined(__DOXYGEN__)
+#define CH_CFG_READY_LIST_BITMAP            FALSE
+#endif
+
+/**
+ * @brief   Earliest deadline first band.
+ * @details If enabled then the threads at priority @p CH_CFG_EDF_PRIORITY
+ *          are scheduled by absolute deadline rather than in FIFO order,
+ *          threads at other priorities are not affected.
+ */
+#if !defined(CH_CFG_USE_EDF) || defined(__DOXYGEN__)
+#define CH_CFG_USE_EDF                      FALSE
+#endif
+
+/**
+ * @brief   Priority level of the earliest deadline first band.
+ * @note    The value must be a plain number in the range 2..255, it is
+ *          checked by the preprocessor. The default is @p NORMALPRIO + 1.
+ */
+#if !defined(CH_CFG_EDF_PRIORITY) || defined(__DOXYGEN__)
+#define CH_CFG_EDF_PRIORITY                 129
+#endif
+
+/**
+ * @brief   Virtual timers backend.
+ * @details Selects the data structure used for armed virtual timers:
+ *          - @p CH_VT_BACKEND_DLIST, delta list, timers insertion is linear
+ *            with the number of armed timers, minimal RAM usage.
+ *          - @p CH_VT_BACKEND_WHEEL, hierarchical timing wheel, timers
+ *            insertion and removal are constant time regardless of the
+ *            number of armed timers.
+ *          .
+ * @note    The timing wheel requires about 32 list headers for each 5 bits
+ *          of @p CH_CFG_INTERVALS_SIZE in each OS instance.
+ */
+#if !defined(CH_CFG_VT_BACKEND) || defined(__DOXYGEN__)
+#define CH_CFG_VT_BACKEND                   CH_VT_BACKEND_DLIST
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_VT_BACKEND != CH_VT_BACKEND_DLIST) &&                           \
+    (CH_CFG_VT_BACKEND != CH_VT_BACKEND_WHEEL)
+#error "invalid CH_CFG_VT_BACKEND value"
+#endif
+
+#if (CH_CFG_USE_EDF != FALSE) && (CH_CFG_USE_EDF != TRUE)
+#error "invalid CH_CFG_USE_EDF value"
+#endif
+
+/* The band must be above IDLEPRIO (1) and not above HIGHPRIO (255), the
+   priority constants include casts so their values are used here.*/
+#if (CH_CFG_USE_EDF == TRUE) &&                                             \
+    ((CH_CFG_EDF_PRIORITY <= 1) || (CH_CFG_EDF_PRIORITY > 255))
+#error "invalid CH_CFG_EDF_PRIORITY value"
+#endif
+
+/**
+ * @brief   Number of bits of time resolved by each timing wheel level.
+ */
+#define CH_VT_WHEEL_BITS                    5U
+
+/**
+ * @brief   Number of slots in each timing wheel level.
+ */
+#define CH_VT_WHEEL_SLOTS                   (1U << CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Number of timing wheel levels.
+ */
+#define CH_VT_WHEEL_LEVELS                  ((CH_CFG_INTERVALS_SIZE +        \
+                                              CH_VT_WHEEL_BITS - 1U) /      \
+                                             CH_VT_WHEEL_BITS)
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -88,6 +178,37 @@ struct ch_virtual_timer {
   sysinterval_t                 reload;
 };
 
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a virtual timers hierarchical timing wheel.
+ * @details Each level resolves @p CH_VT_WHEEL_BITS bits of the timers
+ *          expiration time, timers are placed in the level of the most
+ *          significant digit where their expiration time differs from the
+ *          wheel base time. Timers in upper levels are cascaded toward
+ *          lower levels when the base time reaches their slot.
+ * @note    In this backend the @p delta field of a timer holds its
+ *          expiration time in wheel time rather than a delta.
+ */
+typedef struct ch_vt_wheel {
+  /**
+   * @brief   Wheel base time.
+   */
+  sysinterval_t                 base;
+  /**
+   * @brief   Mask of the non-empty levels.
+   */
+  uint32_t                      summary;
+  /**
+   * @brief   Masks of the non-empty slots in each level.
+   */
+  uint32_t                      levels[CH_VT_WHEEL_LEVELS];
+  /**
+   * @brief   Slots lists headers.
+   */
+  ch_delta_list_t               slots[CH_VT_WHEEL_LEVELS][CH_VT_WHEEL_SLOTS];
+} vt_wheel_t;
+#endif
+
 /**
  * @brief   Type of virtual timers list header.
  * @note    The timers list is implemented as a double link bidirectional list
@@ -95,21 +216,26 @@ struct ch_virtual_timer {
  *          timer is often used in the code.
  */
 typedef struct ch_virtual_timers_list {
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
   /**
    * @brief   Delta list header.
    */
   ch_delta_list_t               dlist;
+#endif
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   /**
    * @brief   System Time counter.
    */
   volatile systime_t            systime;
 #endif
-#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+#if (CH_CFG_ST_TIMEDELTA > 0) ||                                            \
+    (CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL) || defined(__DOXYGEN__)
   /**
    * @brief   System time of the last tick event.
    */
   systime_t                     lasttime;
+#endif
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
   /**
    * @brief   Current delta parameter.
    * @note    This value is initially set to @p CH_CFG_ST_TIMEDELTA and,
@@ -240,6 +366,25 @@ struct ch_thread {
    */
   tslices_t                     ticks;
 #endif
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Absolute deadline of the current job.
+   * @note    This field is only valid if @p reldeadline is not zero.
+   */
+  systime_t                     deadline;
+  /**
+   * @brief   Release time of the current job.
+   */
+  systime_t                     release;
+  /**
+   * @brief   Relative deadline, zero if the thread has no deadline.
+   */
+  sysinterval_t                 reldeadline;
+  /**
+   * @brief   Number of deadlines missed by the thread.
+   */
+  ucnt_t                        dlmisses;
+#endif
 #if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Thread consumed time in ticks.
@@ -355,6 +500,16 @@ struct ch_thread {
    */
   tprio_t                       realprio;
 #endif
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex to be re-acquired when leaving a condition variable.
+   * @note    This field is only valid while the thread is in the
+   *          @p CH_STATE_WTCOND state. It is @p NULL for waits with a
+   *          timeout, those threads are made ready by a broadcast instead
+   *          of being moved on the mutex queue.
+   */
+  struct ch_mutex               *cvmtxp;
+#endif
 #if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Thread statistics.
@@ -440,6 +595,22 @@ struct ch_os_instance {
    * @note    This field is present only if the SMP mode is disabled.
    */
   rfcu_t                        rfcu;
+#endif
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Priority levels index of the ready list.
+   * @note    It is placed after the fields exported in @p ch_debug, their
+   *          offsets must fit in 8 bits.
+   */
+  ch_pqueue_index_t             rlindex;
+#endif
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL) || defined(__DOXYGEN__)
+  /**
+   * @brief   Virtual timers timing wheel.
+   * @note    It is placed after the fields exported in @p ch_debug, their
+   *          offsets must fit in 8 bits.
+   */
+  vt_wheel_t                    vtwheel;
 #endif
   /**
    * @brief   Pointer to the instance configuration data.
@@ -67,7 +67,8 @@ typedef struct {
   uint8_t   off_refs;               /**< @brief Offset of @p refs field.    */
   uint8_t   off_preempt;            /**< @brief Offset of @p ticks field.   */
   uint8_t   off_time;               /**< @brief Offset of @p time field.    */
-  uint8_t   off_reserved[4];
+  uint8_t   off_dlmisses;           /**< @brief Offset of @p dlmisses field.*/
+  uint8_t   off_reserved[3];
   uint8_t   intctxsize;             /**< @brief Size of a @p port_intctx.   */
   uint8_t   intervalsize;           /**< @brief Size of a @p sysinterval_t. */
   uint8_t   instancesnum;           /**< @brief Number of instances.        */
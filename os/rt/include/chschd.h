@@ -143,6 +143,8 @@ extern "C" {
   thread_t *chSchReadyI(thread_t *tp);
   void chSchGoSleepS(tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout);
+  msg_t chSchGoSleepTimeoutSlackS(tstate_t newstate, sysinterval_t timeout,
+                                  sysinterval_t slack);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
   void chSchRescheduleS(void);
   bool chSchIsPreemptionRequired(void);
@@ -161,6 +163,74 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+/**
+ * @brief   Removes a thread from the ready list.
+ * @note    The priority is passed explicitly because the thread priority
+ *          could have been already modified by the caller.
+ *
+ * @param[in] tp        the pointer to the thread to be removed
+ * @param[in] prio      the priority the thread has been made ready with
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *ch_sch_ready_dequeue(thread_t *tp, tprio_t prio) {
+
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  return threadref(ch_pqueue_dequeue_indexed(&tp->owner->rlindex,
+                                             &tp->hdr.pqueue, prio));
+#else
+  (void)prio;
+
+  return threadref(ch_queue_dequeue(&tp->hdr.queue));
+#endif
+}
+
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns @p true if a system time strictly precedes another.
+ * @note    The two system times must be within half the system time
+ *          numeric range from each other.
+ *
+ * @param[in] t1        the first system time
+ * @param[in] t2        the second system time
+ * @return              The comparison result.
+ *
+ * @notapi
+ */
+static inline bool ch_sch_edf_earlier(systime_t t1, systime_t t2) {
+  sysinterval_t diff = chTimeDiffX(t1, t2);
+
+  return (diff > (sysinterval_t)0) &&
+         (diff <= (sysinterval_t)(TIME_MAX_SYSTIME / 2U));
+}
+
+/**
+ * @brief   Returns @p true if a thread precedes another in deadline order.
+ * @details Threads without a deadline precede threads with a deadline, this
+ *          way threads raised to the EDF priority by priority inheritance
+ *          are not delayed behind the deadlines.
+ *
+ * @param[in] tp1       the first thread
+ * @param[in] tp2       the second thread
+ * @return              The comparison result.
+ *
+ * @notapi
+ */
+static inline bool ch_sch_edf_precedes(const thread_t *tp1,
+                                       const thread_t *tp2) {
+
+  if (tp1->reldeadline == (sysinterval_t)0) {
+    return tp2->reldeadline != (sysinterval_t)0;
+  }
+  if (tp2->reldeadline == (sysinterval_t)0) {
+    return false;
+  }
+
+  return ch_sch_edf_earlier(tp1->deadline, tp2->deadline);
+}
+#endif /* CH_CFG_USE_EDF == TRUE */
+
 /* If the performance code path has been chosen then all the following
    functions are inlined into the various kernel modules.*/
 #if CH_CFG_OPTIMIZE_SPEED == TRUE
@@ -33,32 +33,105 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of buckets in the critical zones latency histograms.
+ * @details Bucket @p k counts the zones lasting less than <tt>2^k</tt>
+ *          realtime counter cycles and not less than <tt>2^(k-1)</tt>,
+ *          the last bucket also collects all the longer zones.
+ */
+#define CH_STATS_CRIT_BUCKETS               32
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
-#if CH_CFG_USE_TM == FALSE
-#error "CH_DBG_STATISTICS requires CH_CFG_USE_TM"
+/**
+ * @brief   Critical zones profiling.
+ * @details If enabled the kernel also records the return address of the
+ *          lock site of each critical zone, keeps a logarithmic histogram
+ *          of the zones duration and a table of the call sites producing
+ *          the longest zones.
+ * @note    This option adds overhead to each critical zone, it is meant
+ *          for locating lock-hold regressions.
+ */
+#if !defined(CH_DBG_STATISTICS_CRIT_SITES) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_CRIT_SITES        FALSE
+#endif
+
+/**
+ * @brief   Number of entries in the worst call sites table.
+ */
+#if !defined(CH_DBG_STATISTICS_CRIT_TOP) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_CRIT_TOP          8
 #endif
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_USE_TM == FALSE
+#error "CH_DBG_STATISTICS requires CH_CFG_USE_TM"
+#endif
+
+#if (CH_DBG_STATISTICS_CRIT_SITES != FALSE) &&                              \
+    (CH_DBG_STATISTICS_CRIT_SITES != TRUE)
+#error "invalid CH_DBG_STATISTICS_CRIT_SITES value"
+#endif
+
+#if CH_DBG_STATISTICS_CRIT_TOP < 1
+#error "invalid CH_DBG_STATISTICS_CRIT_TOP value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_CRIT_SITES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a critical zone call site record.
+ */
+typedef struct {
+  const void            *site;      /**< @brief Return address of the lock
+                                                site or @p NULL.            */
+  rtcnt_t               worst;      /**< @brief Longest zone entered from
+                                                this site.                  */
+} crit_site_t;
+
+/**
+ * @brief   Type of a critical zones profile.
+ */
+typedef struct {
+  ucnt_t                hist[CH_STATS_CRIT_BUCKETS];
+                                    /**< @brief Duration histogram.         */
+  crit_site_t           top[CH_DBG_STATISTICS_CRIT_TOP];
+                                    /**< @brief Worst call sites, unsorted. */
+  rtcnt_t               threshold;  /**< @brief Shortest duration in the
+                                                worst call sites table.     */
+  const void            *site;      /**< @brief Lock site of the zone in
+                                                progress.                   */
+} crit_profile_t;
+#endif
+
 /**
  * @brief   Type of a kernel statistics structure.
  */
 typedef struct {
   ucnt_t                n_irq;      /**< @brief Number of IRQs.             */
   ucnt_t                n_ctxswc;   /**< @brief Number of context switches. */
+  ucnt_t                n_vt_alarms;/**< @brief Number of alarms programmed
+                                                by the virtual timers.      */
+  ucnt_t                n_vt_fired; /**< @brief Number of virtual timers
+                                                fired.                      */
   time_measurement_t    m_crit_thd; /**< @brief Measurement of threads
                                                 critical zones duration.    */
   time_measurement_t    m_crit_isr; /**< @brief Measurement of ISRs critical
                                                 zones duration.             */
+#if (CH_DBG_STATISTICS_CRIT_SITES == TRUE) || defined(__DOXYGEN__)
+  crit_profile_t        p_crit_thd; /**< @brief Profile of threads critical
+                                                zones.                      */
+  crit_profile_t        p_crit_isr; /**< @brief Profile of ISRs critical
+                                                zones.                      */
+#endif
 } kernel_stats_t;
 
 /*===========================================================================*/
@@ -75,10 +148,17 @@ extern "C" {
   void __stats_init(void);
   void __stats_increase_irq(void);
   void __stats_ctxswc(thread_t *ntp, thread_t *otp);
+  void __stats_increase_vt_alarms(void);
+  void __stats_increase_vt_fired(void);
   void __stats_start_measure_crit_thd(void);
   void __stats_stop_measure_crit_thd(void);
   void __stats_start_measure_crit_isr(void);
   void __stats_stop_measure_crit_isr(void);
+#if CH_DBG_STATISTICS_CRIT_SITES == TRUE
+  void __stats_crit_profile_init(crit_profile_t *cpp);
+  void chStatsGetCritProfiles(crit_profile_t *thdp, crit_profile_t *isrp);
+  void chStatsResetCritProfiles(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -97,10 +177,16 @@ extern "C" {
  */
 static inline void __stats_object_init(kernel_stats_t *ksp) {
 
-  ksp->n_irq    = (ucnt_t)0;
-  ksp->n_ctxswc = (ucnt_t)0;
+  ksp->n_irq       = (ucnt_t)0;
+  ksp->n_ctxswc    = (ucnt_t)0;
+  ksp->n_vt_alarms = (ucnt_t)0;
+  ksp->n_vt_fired  = (ucnt_t)0;
   chTMObjectInit(&ksp->m_crit_thd);
   chTMObjectInit(&ksp->m_crit_isr);
+#if CH_DBG_STATISTICS_CRIT_SITES == TRUE
+  __stats_crit_profile_init(&ksp->p_crit_thd);
+  __stats_crit_profile_init(&ksp->p_crit_isr);
+#endif
 
   /* The initialization code will stop the measurement on the final call
      to chSysUnlock().*/
@@ -112,6 +198,8 @@ static inline void __stats_object_init(kernel_stats_t *ksp) {
 /* Stub functions for when the statistics module is disabled. */
 #define __stats_increase_irq()
 #define __stats_ctxswc(old, new)
+#define __stats_increase_vt_alarms()
+#define __stats_increase_vt_fired()
 #define __stats_start_measure_crit_thd()
 #define __stats_stop_measure_crit_thd()
 #define __stats_start_measure_crit_isr()
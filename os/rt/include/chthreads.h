@@ -473,8 +473,13 @@ extern "C" {
   void chThdDequeueNextI(threads_queue_t *tqp, msg_t msg);
   void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg);
   void chThdSleep(sysinterval_t time);
+  void chThdSleepSlack(sysinterval_t time, sysinterval_t slack);
   void chThdSleepUntil(systime_t time);
   systime_t chThdSleepUntilWindowed(systime_t prev, systime_t next);
+#if CH_CFG_USE_EDF == TRUE
+  void chThdSetDeadline(sysinterval_t deadline);
+  bool chThdSleepUntilNextPeriod(sysinterval_t period);
+#endif
   void chThdYield(void);
 #ifdef __cplusplus
 }
@@ -558,6 +563,40 @@ static inline systime_t chThdGetTicksX(thread_t *tp) {
 }
 #endif
 
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the absolute deadline of the specified thread.
+ * @note    This function is only available when the
+ *          @p CH_CFG_USE_EDF configuration option is enabled.
+ * @note    The value is only meaningful after the thread set a deadline
+ *          using @p chThdSetDeadline().
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The absolute deadline of the current job.
+ *
+ * @xclass
+ */
+static inline systime_t chThdGetDeadlineX(thread_t *tp) {
+
+  return tp->deadline;
+}
+
+/**
+ * @brief   Returns the number of deadlines missed by the specified thread.
+ * @note    This function is only available when the
+ *          @p CH_CFG_USE_EDF configuration option is enabled.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The number of missed deadlines.
+ *
+ * @xclass
+ */
+static inline ucnt_t chThdGetDeadlineMissesX(thread_t *tp) {
+
+  return tp->dlmisses;
+}
+#endif
+
 /**
  * @brief   Returns the working area base of the specified thread.
  *
@@ -632,6 +671,29 @@ static inline void chThdSleepS(sysinterval_t ticks) {
   (void) chSchGoSleepTimeoutS(CH_STATE_SLEEPING, ticks);
 }
 
+/**
+ * @brief   Suspends the invoking thread for the specified number of ticks
+ *          with slack.
+ * @details The thread is awakened after a number of ticks within the window
+ *          <tt>[ticks, ticks + slack]</tt>, the wakeup is aligned with other
+ *          timers within the window in order to reduce wakeups.
+ *
+ * @param[in] ticks     the minimum delay in system ticks, the special values
+ *                      are handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ * @param[in] slack     the number of ticks the wakeup can be delayed
+ *
+ * @sclass
+ */
+static inline void chThdSleepSlackS(sysinterval_t ticks, sysinterval_t slack) {
+
+  chDbgCheck(ticks != TIME_IMMEDIATE);
+
+  (void) chSchGoSleepTimeoutSlackS(CH_STATE_SLEEPING, ticks, slack);
+}
+
 /**
  * @brief   Evaluates to @p true if the specified queue is empty.
  *
@@ -44,6 +44,23 @@
 #define CH_TRACE_TYPE_USER                  6U
 /** @} */
 
+/**
+ * @name    Trace stream only record types
+ * @{
+ */
+#define CH_TRACE_TYPE_TIME                  16U
+#define CH_TRACE_TYPE_NAME                  17U
+#define CH_TRACE_TYPE_LOST                  18U
+/** @} */
+
+/**
+ * @name    Trace stream special identifiers
+ * @{
+ */
+#define CH_TRACE_ID_NONE                    0U
+#define CH_TRACE_ID_OVERFLOW                0xFFFFU
+/** @} */
+
 /**
  * @name    Events to trace
  * @{
@@ -89,12 +106,57 @@
 #if !defined(CH_DBG_TRACE_BUFFER_SIZE) || defined(__DOXYGEN__)
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
+
+/**
+ * @brief   Trace stream.
+ * @details If enabled, each trace event is also queued as a compact binary
+ *          record in a FIFO that can be drained by a low priority thread,
+ *          events are no more overwritten but dropped and counted when the
+ *          FIFO is full.
+ * @note    The trace stream is only allocated if @p CH_DBG_TRACE_MASK is
+ *          different from @p CH_DBG_TRACE_MASK_DISABLED.
+ */
+#if !defined(CH_DBG_TRACE_STREAM) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_STREAM                 FALSE
+#endif
+
+/**
+ * @brief   Trace stream FIFO entries.
+ * @note    Must be a power of two.
+ */
+#if !defined(CH_DBG_TRACE_STREAM_SIZE) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_STREAM_SIZE            256
+#endif
+
+/**
+ * @brief   Trace stream names table entries.
+ * @details Threads, ISRs and halt reasons are identified in the stream
+ *          records by small identifiers, each new identifier is announced
+ *          by a name record.
+ */
+#if !defined(CH_DBG_TRACE_STREAM_NAMES) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_STREAM_NAMES           32
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_DBG_TRACE_STREAM != FALSE) && (CH_DBG_TRACE_STREAM != TRUE)
+#error "invalid CH_DBG_TRACE_STREAM value"
+#endif
+
+#if (CH_DBG_TRACE_STREAM_SIZE < 4) ||                                      \
+    ((CH_DBG_TRACE_STREAM_SIZE & (CH_DBG_TRACE_STREAM_SIZE - 1)) != 0)
+#error "invalid CH_DBG_TRACE_STREAM_SIZE value"
+#endif
+
+#if (CH_DBG_TRACE_STREAM_NAMES < 1) ||                                     \
+    (CH_DBG_TRACE_STREAM_NAMES >= CH_TRACE_ID_OVERFLOW)
+#error "invalid CH_DBG_TRACE_STREAM_NAMES value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -191,6 +253,102 @@ typedef struct {
 } trace_event_t;
 /*lint -restore*/
 
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Trace stream record.
+ * @details Fixed size record in target byte order, pointers are replaced
+ *          by identifiers announced by @p CH_TRACE_TYPE_NAME records.
+ */
+typedef struct {
+  /**
+   * @brief   Record type.
+   */
+  uint8_t               type;
+  /**
+   * @brief   Thread state or name kind.
+   */
+  uint8_t               state;
+  /**
+   * @brief   Thread, ISR or halt reason identifier.
+   */
+  uint16_t              id;
+  /**
+   * @brief   First record argument.
+   */
+  uint32_t              arg1;
+  /**
+   * @brief   Second record argument.
+   */
+  uint32_t              arg2;
+  /**
+   * @brief   Low 32 bits of the extended time stamp.
+   * @note    The high 32 bits are announced by @p CH_TRACE_TYPE_TIME
+   *          records when they change.
+   */
+  uint32_t              stamp;
+} trace_record_t;
+
+/**
+ * @brief   Trace stream names table entry.
+ */
+typedef struct {
+  /**
+   * @brief   Named object.
+   */
+  const void            *objp;
+  /**
+   * @brief   Object name.
+   */
+  const char            *name;
+  /**
+   * @brief   Name record still to be queued.
+   */
+  bool                  pending;
+} trace_name_t;
+
+/**
+ * @brief   Trace stream.
+ */
+typedef struct {
+  /**
+   * @brief   Time stamp of the last event, extended to 64 bits.
+   */
+  uint64_t              stamp;
+  /**
+   * @brief   High 32 bits of the time stamp last announced.
+   */
+  uint32_t              high;
+  /**
+   * @brief   Events dropped since the last queued record.
+   */
+  uint32_t              lost;
+  /**
+   * @brief   Total dropped events.
+   */
+  ucnt_t                drops;
+  /**
+   * @brief   Read index, free running.
+   */
+  unsigned              rdidx;
+  /**
+   * @brief   Write index, free running.
+   */
+  unsigned              wridx;
+  /**
+   * @brief   Used names table entries.
+   */
+  unsigned              nnames;
+  /**
+   * @brief   Names table.
+   */
+  trace_name_t          names[CH_DBG_TRACE_STREAM_NAMES];
+  /**
+   * @brief   Records FIFO.
+   */
+  trace_record_t        records[CH_DBG_TRACE_STREAM_SIZE];
+} trace_stream_t;
+#endif
+
 /**
  * @brief   Trace buffer header.
  */
@@ -214,6 +372,12 @@ typedef struct {
    * @brief   Ring buffer.
    */
   trace_event_t         buffer[CH_DBG_TRACE_BUFFER_SIZE];
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Trace stream.
+   */
+  trace_stream_t        stream;
+#endif
 } trace_buffer_t;
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
@@ -275,6 +439,12 @@ extern "C" {
   void chTraceSuspend(uint16_t mask);
   void chTraceResumeI(uint16_t mask);
   void chTraceResume(uint16_t mask);
+#if CH_DBG_TRACE_STREAM == TRUE
+  size_t chTraceStreamReadI(trace_record_t *rp, size_t n);
+  size_t chTraceStreamRead(trace_record_t *rp, size_t n);
+  const char *chTraceStreamGetName(uint16_t id);
+  ucnt_t chTraceStreamGetDropsX(void);
+#endif
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 #ifdef __cplusplus
 }
@@ -103,6 +103,8 @@ extern "C" {
                   vtfunc_t vtfunc, void *par);
   void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
                             vtfunc_t vtfunc, void *par);
+  void chVTDoSetWithSlackI(virtual_timer_t *vtp, sysinterval_t delay,
+                           sysinterval_t slack, vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
   sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp);
   void chVTDoTickI(void);
@@ -118,6 +120,70 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the timing wheel of a virtual timers list.
+ * @note    The wheel is stored in the OS instance owning the list, after
+ *          the fields exported in @p ch_debug.
+ *
+ * @param[in] vtlp      pointer to a @p virtual_timers_list_t structure
+ * @return              Pointer to the timing wheel.
+ *
+ * @notapi
+ */
+static inline vt_wheel_t *__vt_get_wheel(virtual_timers_list_t *vtlp) {
+
+  return &(__CH_OWNEROF(vtlp, os_instance_t, vtlist))->vtwheel;
+}
+
+/**
+ * @brief   Returns the next event of a timing wheel.
+ * @details The next event is the first non-empty slot of the lowest
+ *          non-empty level, level zero slots are timers expirations while
+ *          slots in upper levels are cascades. Slots in a level always
+ *          precede slots in upper levels.
+ * @pre     The wheel must not be empty.
+ *
+ * @param[in] wp        pointer to a @p vt_wheel_t structure
+ * @param[out] lvlp     pointer to the level of the event slot
+ * @param[out] slotp    pointer to the event slot within its level
+ * @return              The interval between the wheel base time and the
+ *                      event.
+ *
+ * @notapi
+ */
+static inline sysinterval_t __vt_wheel_next(const vt_wheel_t *wp,
+                                            unsigned *lvlp,
+                                            unsigned *slotp) {
+  unsigned lvl, shift, digit, slot;
+  uint32_t map, above;
+  sysinterval_t low;
+
+  lvl   = __CH_CTZ32(wp->summary);
+  shift = lvl * CH_VT_WHEEL_BITS;
+  digit = (unsigned)(wp->base >> shift) & (CH_VT_WHEEL_SLOTS - 1U);
+  map   = wp->levels[lvl];
+
+  /* Searching the first slot following the base time digit, in level zero
+     the digit slot itself is due. Only the top level can wrap around.*/
+  above = map & ((uint32_t)0xFFFFFFFFU << digit);
+  if (lvl > 0U) {
+    above &= ~((uint32_t)1U << digit);
+  }
+  slot = __CH_CTZ32(above != 0U ? above : map);
+
+  *lvlp  = lvl;
+  *slotp = slot;
+
+  /* Interval from the base time to the slot start, modulo arithmetic takes
+     care of the top level wrap around.*/
+  low = wp->base & (sysinterval_t)(((sysinterval_t)1 << shift) - (sysinterval_t)1);
+  return (sysinterval_t)((sysinterval_t)((sysinterval_t)((slot - digit) &
+                                         (CH_VT_WHEEL_SLOTS - 1U)) << shift) -
+                         low);
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+
 /**
  * @brief   Current system time.
  * @details Returns the number of system ticks since the @p chSysInit()
@@ -227,6 +293,7 @@ static inline bool chVTIsSystemTimeWithin(systime_t start, systime_t end) {
  */
 static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
+#if CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST
   ch_delta_list_t *dlp = &vtlp->dlist;
 
   chDbgCheckClassI();
@@ -243,6 +310,27 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
              chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
 #endif
   }
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+
+  chDbgCheckClassI();
+
+  if (__vt_get_wheel(vtlp)->summary == 0U) {
+    return false;
+  }
+
+  /* Note, the next wheel event could be a cascade rather than a timer
+     expiration, the returned value is a lower bound.*/
+  if (timep != NULL) {
+    unsigned lvl, slot;
+    sysinterval_t offset = __vt_wheel_next(__vt_get_wheel(vtlp), &lvl, &slot);
+#if CH_CFG_ST_TIMEDELTA == 0
+    *timep = offset;
+#else
+    *timep = (offset + (sysinterval_t)CH_CFG_ST_TIMEDELTA) -
+             chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
+#endif
+  }
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
 
   return true;
 }
@@ -535,7 +623,24 @@ static inline sysinterval_t chVTGetCurrentDelta(void) {
  */
 static inline void __vt_object_init(virtual_timers_list_t *vtlp) {
 
+#if CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST
   ch_dlist_init(&vtlp->dlist);
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+  {
+    vt_wheel_t *wp = __vt_get_wheel(vtlp);
+    unsigned lvl, slot;
+
+    wp->base    = (sysinterval_t)0;
+    wp->summary = 0U;
+    for (lvl = 0U; lvl < CH_VT_WHEEL_LEVELS; lvl++) {
+      wp->levels[lvl] = 0U;
+      for (slot = 0U; slot < CH_VT_WHEEL_SLOTS; slot++) {
+        ch_dlist_init(&wp->slots[lvl][slot]);
+      }
+    }
+  }
+  vtlp->lasttime = (systime_t)0;
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
 #if CH_CFG_ST_TIMEDELTA == 0
   vtlp->systime = (systime_t)0;
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
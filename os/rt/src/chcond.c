@@ -152,6 +152,9 @@ void chCondSignalI(condition_variable_t *cp) {
 
 /**
  * @brief   Signals all threads that are waiting on the condition variable.
+ * @note    Threads waiting without a timeout are moved directly on the
+ *          queue of their mutex, only the thread acquiring the mutex is
+ *          made ready.
  *
  * @param[in] cp        pointer to a @p condition_variable_t object
  *
@@ -167,6 +170,9 @@ void chCondBroadcast(condition_variable_t *cp) {
 
 /**
  * @brief   Signals all threads that are waiting on the condition variable.
+ * @note    Threads waiting without a timeout are moved directly on the
+ *          queue of their mutex, only the thread acquiring the mutex is
+ *          made ready.
  * @post    This function does not reschedule so a call to a rescheduling
  *          function must be performed before unlocking the kernel. Note that
  *          interrupt handlers always reschedule on exit so an explicit
@@ -181,11 +187,18 @@ void chCondBroadcastI(condition_variable_t *cp) {
   chDbgCheckClassI();
   chDbgCheck(cp != NULL);
 
-  /* Empties the condition variable queue and inserts all the threads into the
-     ready list in FIFO order. The wakeup message is set to @p MSG_RESET in
-     order to make a chCondBroadcast() detectable from a chCondSignal().*/
+  /* Empties the condition variable queue in priority order. Wait morphing,
+     threads are moved directly on the queue of the mutex they have to
+     re-acquire, only the thread getting the mutex is made ready. Threads
+     waiting with a timeout are made ready instead. The wakeup message is
+     set to @p MSG_RESET in order to make a chCondBroadcast() detectable
+     from a chCondSignal().*/
   while (ch_queue_notempty(&cp->queue)) {
-    chSchReadyI(threadref(ch_queue_fifo_remove(&cp->queue)))->u.rdymsg = MSG_RESET;
+    thread_t *tp = threadref(ch_queue_fifo_remove(&cp->queue));
+
+    if ((tp->cvmtxp == NULL) || __mtx_lock_for_i(tp->cvmtxp, tp)) {
+      chSchReadyI(tp)->u.rdymsg = MSG_RESET;
+    }
   }
 }
 
@@ -244,11 +257,23 @@ msg_t chCondWaitS(condition_variable_t *cp) {
   /* Releasing "current" mutex.*/
   chMtxUnlockS(mp);
 
+  /* The mutex can be re-acquired on our behalf by chCondBroadcastI() only
+     if it has been actually released, it could still be owned if it is
+     recursive.*/
+  currtp->cvmtxp = (mp->owner != currtp) ? mp : NULL;
+
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
   currtp->u.wtobjp = cp;
   ch_sch_prio_insert(&cp->queue, &currtp->hdr.queue);
   chSchGoSleepS(CH_STATE_WTCOND);
+  if ((currtp->cvmtxp != NULL) && (mp->owner == currtp)) {
+    /* Woken by a broadcast, the mutex has already been assigned to this
+       thread.*/
+    chDbgAssert(currtp->mtxlist == mp, "not owned");
+
+    return MSG_RESET;
+  }
   msg = currtp->u.rdymsg;
   chMtxLockS(mp);
 
@@ -333,7 +358,9 @@ msg_t chCondWaitTimeoutS(condition_variable_t *cp, sysinterval_t timeout) {
   chMtxUnlockS(mp);
 
   /* Start waiting on the condition variable, on exit the mutex is taken
-     again.*/
+     again. No wait morphing because the timeout could expire while
+     waiting on the mutex.*/
+  currtp->cvmtxp = NULL;
   currtp->u.wtobjp = cp;
   ch_sch_prio_insert(&cp->queue, &currtp->hdr.queue);
   msg = chSchGoSleepTimeoutS(CH_STATE_WTCOND, timeout);
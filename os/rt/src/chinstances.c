@@ -109,6 +109,9 @@ void chInstanceObjectInit(os_instance_t *oip,
 
   /* Ready list initialization.*/
   ch_pqueue_init(&oip->rlist.pqueue);
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  ch_pqueue_index_init(&oip->rlindex);
+#endif
 
 #if (CH_CFG_USE_REGISTRY == TRUE) && (CH_CFG_SMP_MODE == FALSE)
   /* Registry initialization when SMP mode is disabled.*/
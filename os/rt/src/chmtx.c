@@ -90,6 +90,75 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Priority inheritance protocol.
+ * @details Explores the thread-mutex dependencies boosting the priority of
+ *          all the affected threads to equal the priority of the thread
+ *          requesting the mutex.
+ *
+ * @param[in] tp        the mutex owner thread
+ * @param[in] prio      priority of the thread requesting the mutex
+ *
+ * @notapi
+ */
+static void mtx_inherit_priority(thread_t *tp, tprio_t prio) {
+
+  /* Does the requesting thread have higher priority than the mutex
+     owning thread? */
+  while (tp->hdr.pqueue.prio < prio) {
+    tprio_t oldprio = tp->hdr.pqueue.prio;
+
+    /* Make priority of thread tp match the requesting thread's priority.*/
+    tp->hdr.pqueue.prio = prio;
+
+    /* The following states need priority queues reordering.*/
+    switch (tp->state) {
+    case CH_STATE_WTMTX:
+      /* Re-enqueues the mutex owner with its new priority.*/
+      ch_sch_prio_insert(&tp->u.wtmtxp->queue,
+                         ch_queue_dequeue(&tp->hdr.queue));
+      tp = tp->u.wtmtxp->owner;
+      /*lint -e{9042} [16.1] Continues the while.*/
+      continue;
+#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
+    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
+     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE))
+#if CH_CFG_USE_CONDVARS == TRUE
+    case CH_STATE_WTCOND:
+#endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
+    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
+    case CH_STATE_WTSEM:
+#endif
+      /* Re-enqueues tp with its new priority on the queue.*/
+      ch_sch_prio_insert(&tp->u.wtmtxp->queue,
+                         ch_queue_dequeue(&tp->hdr.queue));
+      break;
+#endif
+#if (CH_CFG_USE_MESSAGES == TRUE) &&                                        \
+    (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
+    case CH_STATE_SNDMSGQ:
+      /* Re-enqueues tp using the receiver message queue back-pointer. */
+      ch_sch_prio_insert((ch_queue_t *)tp->u.wtobjp,
+                         ch_queue_dequeue(&tp->hdr.queue));
+      break;
+#endif
+    case CH_STATE_READY:
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+      /* Prevents an assertion in chSchReadyI().*/
+      tp->state = CH_STATE_CURRENT;
+#endif
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      (void) chSchReadyI(ch_sch_ready_dequeue(tp, oldprio));
+      break;
+    default:
+      /* Nothing to do for other states.*/
+      break;
+    }
+    break;
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -188,63 +257,8 @@ void chMtxLockS(mutex_t *mp) {
     }
     else {
 #endif
-      /* Priority inheritance protocol; explores the thread-mutex dependencies
-         boosting the priority of all the affected threads to equal the
-         priority of the running thread requesting the mutex.*/
-      thread_t *tp = mp->owner;
-
-      /* Does the running thread have higher priority than the mutex
-         owning thread? */
-      while (tp->hdr.pqueue.prio < currtp->hdr.pqueue.prio) {
-        /* Make priority of thread tp match the running thread's priority.*/
-        tp->hdr.pqueue.prio = currtp->hdr.pqueue.prio;
-
-        /* The following states need priority queues reordering.*/
-        switch (tp->state) {
-        case CH_STATE_WTMTX:
-          /* Re-enqueues the mutex owner with its new priority.*/
-          ch_sch_prio_insert(&tp->u.wtmtxp->queue,
-                             ch_queue_dequeue(&tp->hdr.queue));
-          tp = tp->u.wtmtxp->owner;
-          /*lint -e{9042} [16.1] Continues the while.*/
-          continue;
-#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
-    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
-     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE))
-#if CH_CFG_USE_CONDVARS == TRUE
-        case CH_STATE_WTCOND:
-#endif
-#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
-    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
-        case CH_STATE_WTSEM:
-#endif
-          /* Re-enqueues tp with its new priority on the queue.*/
-          ch_sch_prio_insert(&tp->u.wtmtxp->queue,
-                             ch_queue_dequeue(&tp->hdr.queue));
-          break;
-#endif
-#if (CH_CFG_USE_MESSAGES == TRUE) &&                                        \
-    (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
-        case CH_STATE_SNDMSGQ:
-          /* Re-enqueues tp using the receiver message queue back-pointer. */
-          ch_sch_prio_insert((ch_queue_t *)tp->u.wtobjp,
-                             ch_queue_dequeue(&tp->hdr.queue));
-          break;
-#endif
-        case CH_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS == TRUE
-          /* Prevents an assertion in chSchReadyI().*/
-          tp->state = CH_STATE_CURRENT;
-#endif
-          /* Re-enqueues tp with its new priority on the ready list.*/
-          (void) chSchReadyI(threadref(ch_queue_dequeue(&tp->hdr.queue)));
-          break;
-        default:
-          /* Nothing to do for other states.*/
-          break;
-        }
-        break;
-      }
+      /* Priority inheritance protocol.*/
+      mtx_inherit_priority(mp->owner, currtp->hdr.pqueue.prio);
 
       /* Sleep on the mutex.*/
       ch_sch_prio_insert(&mp->queue, &currtp->hdr.queue);
@@ -571,6 +585,58 @@ void chMtxUnlockAll(void) {
   chSysUnlock();
 }
 
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Locks a mutex on behalf of a sleeping thread.
+ * @details If the mutex is not owned then the thread becomes its owner,
+ *          else the thread is inserted in the mutex queue in the
+ *          @p CH_STATE_WTMTX state, applying the priority inheritance
+ *          protocol, and the mutex is assigned to it when unlocked.
+ * @note    This function is used by the condition variables in order to
+ *          move waiting threads directly on the mutex queue.
+ *
+ * @param[in] mp        pointer to the @p mutex_t object
+ * @param[in] tp        pointer to the sleeping thread
+ * @return              The lock status.
+ * @retval false        if the thread has been enqueued on the mutex.
+ * @retval true         if the thread is now the mutex owner, it must be
+ *                      made ready by the caller.
+ *
+ * @notapi
+ */
+bool __mtx_lock_for_i(mutex_t *mp, thread_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (tp != NULL));
+  chDbgAssert(mp->owner != tp, "already owner");
+
+  if (mp->owner != NULL) {
+
+    /* Priority inheritance protocol.*/
+    mtx_inherit_priority(mp->owner, tp->hdr.pqueue.prio);
+
+    /* The thread sleeps on the mutex, the thread performing the unlock
+       operation assigns the mutex to it.*/
+    ch_sch_prio_insert(&mp->queue, &tp->hdr.queue);
+    tp->u.wtmtxp = mp;
+    tp->state = CH_STATE_WTMTX;
+
+    return false;
+  }
+
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+  chDbgAssert(mp->cnt == (cnt_t)0, "counter is not zero");
+
+  mp->cnt++;
+#endif
+  mp->owner = tp;
+  mp->next = tp->mtxlist;
+  tp->mtxlist = mp;
+
+  return true;
+}
+#endif /* CH_CFG_USE_CONDVARS == TRUE */
+
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
 /** @} */
@@ -58,6 +58,27 @@
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+/*
+ * Debuggers locate the fields using the 8 bits offsets exported in
+ * ch_debug, the build fails with a negative array size if an offset does
+ * not fit.
+ */
+#define REG_OFFSET_CHECK(name, st, m)                                       \
+  typedef uint8_t reg_##name##_check_t[                                     \
+    (offsetof(st, m) <= 255U) ? 1 : -1]
+
+#if CH_CFG_USE_EDF == TRUE
+REG_OFFSET_CHECK(thd_dlmisses, thread_t, dlmisses);
+#endif
+REG_OFFSET_CHECK(inst_rlist_current, os_instance_t, rlist.current);
+REG_OFFSET_CHECK(inst_rlist, os_instance_t, rlist);
+REG_OFFSET_CHECK(inst_vtlist, os_instance_t, vtlist);
+#if CH_CFG_SMP_MODE == FALSE
+REG_OFFSET_CHECK(inst_reglist, os_instance_t, reglist);
+REG_OFFSET_CHECK(inst_rfcu, os_instance_t, rfcu);
+#endif
+REG_OFFSET_CHECK(inst_core_id, os_instance_t, core_id);
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
@@ -112,7 +133,12 @@ ROMCONST chdebug_t ch_debug = {
 #else
   .off_time                 = (uint8_t)0,
 #endif
-  .off_reserved             = {(uint8_t)0, (uint8_t)0, (uint8_t)0, (uint8_t)0},
+#if CH_CFG_USE_EDF == TRUE
+  .off_dlmisses             = (uint8_t)__CH_OFFSETOF(thread_t, dlmisses),
+#else
+  .off_dlmisses             = (uint8_t)0,
+#endif
+  .off_reserved             = {(uint8_t)0, (uint8_t)0, (uint8_t)0},
   .instancesnum             = (uint8_t)PORT_CORES_NUMBER,
   .off_sys_state            = (uint8_t)__CH_OFFSETOF(ch_system_t, state),
   .off_sys_instances        = (uint8_t)__CH_OFFSETOF(ch_system_t, instances[0]),
@@ -167,12 +167,20 @@ void chSftIntegrityCheckI(unsigned testmask) {
       next = current->next;
       chSftValidateDataPointerX(2, next);
       chSftAssert(0, next->prev == current, "invalid backward pointer");
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+      /* Checking the index on priority level boundaries.*/
+      if ((current != &oip->rlist.pqueue) && (next->prio != current->prio)) {
+        chSftAssert(0, oip->rlindex.tails[current->prio] == current,
+                    "invalid ready list index");
+      }
+#endif
       current = next;
     } while (current != &oip->rlist.pqueue);
   }
 
   /* Timers list integrity check.*/
   if ((testmask & CH_INTEGRITY_VTLIST) != 0U) {
+#if CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST
 
     /* Scanning the timers list forward.*/
     ch_delta_list_t *current = &oip->vtlist.dlist;
@@ -185,6 +193,31 @@ void chSftIntegrityCheckI(unsigned testmask) {
       chSftAssert(0, next->prev == current, "invalid backward pointer");
       current = next;
     } while (current != &oip->vtlist.dlist);
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+    unsigned lvl, slot;
+
+    /* Scanning all the wheel slots forward.*/
+    for (lvl = 0U; lvl < CH_VT_WHEEL_LEVELS; lvl++) {
+      for (slot = 0U; slot < CH_VT_WHEEL_SLOTS; slot++) {
+        ch_delta_list_t *hdrp = &oip->vtwheel.slots[lvl][slot];
+        ch_delta_list_t *current = hdrp;
+
+        /* Checking the slot mask.*/
+        chSftAssert(0, ((oip->vtwheel.levels[lvl] >> slot) & 1U) ==
+                       (hdrp->next != hdrp ? 1U : 0U),
+                    "invalid slot mask");
+        do {
+          ch_delta_list_t *next;
+
+          /* Checking the backward link.*/
+          next = current->next;
+          chSftValidateDataPointerX(2, next);
+          chSftAssert(0, next->prev == current, "invalid backward pointer");
+          current = next;
+        } while (current != hdrp);
+      }
+    }
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
   }
 
 #if CH_CFG_USE_REGISTRY == TRUE
@@ -31,6 +31,43 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    Ready list access macros
+ * @{
+ */
+#define __rlist_index(rlp)                                                  \
+  (&(__CH_OWNEROF(rlp, os_instance_t, rlist))->rlindex)
+#define __rlist_insert_behind(rlp, p)                                       \
+  ch_pqueue_insert_behind_indexed(&(rlp)->pqueue, __rlist_index(rlp), p)
+#define __rlist_insert_ahead(rlp, p)                                        \
+  ch_pqueue_insert_ahead_indexed(&(rlp)->pqueue, __rlist_index(rlp), p)
+#define __rlist_remove_highest(rlp)                                         \
+  ch_pqueue_remove_highest_indexed(&(rlp)->pqueue, __rlist_index(rlp))
+/** @} */
+#else
+#define __rlist_insert_behind(rlp, p)                                       \
+  ch_pqueue_insert_behind(&(rlp)->pqueue, p)
+#define __rlist_insert_ahead(rlp, p)                                        \
+  ch_pqueue_insert_ahead(&(rlp)->pqueue, p)
+#define __rlist_remove_highest(rlp)                                         \
+  ch_pqueue_remove_highest(&(rlp)->pqueue)
+#endif
+
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns @p true if a thread precedes another within the EDF band.
+ * @details Both threads must be at @p CH_CFG_EDF_PRIORITY, the deadlines are
+ *          compared.
+ */
+#define __sch_edf_band_precedes(tp1, tp2)                                   \
+  (((tp1)->hdr.pqueue.prio == CH_CFG_EDF_PRIORITY) &&                       \
+   ((tp2)->hdr.pqueue.prio == CH_CFG_EDF_PRIORITY) &&                       \
+   ch_sch_edf_precedes(tp1, tp2))
+#else
+#define __sch_edf_band_precedes(tp1, tp2)   false
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -47,6 +84,68 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Inserts a thread in the EDF band of the Ready List.
+ * @details The thread is positioned in deadline order among the threads
+ *          at @p CH_CFG_EDF_PRIORITY, behind or ahead of the threads
+ *          having the same deadline.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] tp        the thread to be inserted
+ * @param[in] ahead     @p true if the thread goes ahead of its peers
+ * @return              The inserted element pointer.
+ *
+ * @notapi
+ */
+static ch_priority_queue_t *__sch_edf_insert(ready_list_t *rlp,
+                                             thread_t *tp,
+                                             bool ahead) {
+  tprio_t prio = tp->hdr.pqueue.prio;
+  ch_priority_queue_t *prev;
+
+  /* The band starts after the last thread with higher priority.*/
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  prev = ch_pqueue_index_above(&rlp->pqueue, __rlist_index(rlp), prio);
+#else
+  prev = &rlp->pqueue;
+  while (prev->next->prio > prio) {
+    prev = prev->next;
+  }
+#endif
+
+  /* Scanning the band in deadline order, the header priority is zero so
+     the scan ends on the header at most.*/
+  while (prev->next->prio == prio) {
+    thread_t *ctp = threadref(prev->next);
+
+    if (ahead ? !ch_sch_edf_precedes(ctp, tp) : ch_sch_edf_precedes(tp, ctp)) {
+      break;
+    }
+    prev = prev->next;
+  }
+
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  /* The thread could become the last one of the band.*/
+  {
+    ch_pqueue_index_t *pqip = __rlist_index(rlp);
+
+    if (pqip->tails[prio] == NULL) {
+      ch_pqueue_index_set(pqip, prio);
+      pqip->tails[prio] = &tp->hdr.pqueue;
+    }
+    else if (pqip->tails[prio] == prev) {
+      pqip->tails[prio] = &tp->hdr.pqueue;
+    }
+  }
+#endif
+
+  ch_pqueue_insert_after(prev, &tp->hdr.pqueue);
+
+  return &tp->hdr.pqueue;
+}
+#endif /* CH_CFG_USE_EDF == TRUE */
+
 /**
  * @brief   Inserts a thread in the Ready List placing it behind its peers.
  * @details The thread is positioned behind all threads with higher or equal
@@ -75,9 +174,16 @@ static thread_t *__sch_ready_behind(thread_t *tp) {
   /* The thread is marked ready.*/
   tp->state = CH_STATE_READY;
 
+#if CH_CFG_USE_EDF == TRUE
+  /* Threads in the EDF band are inserted in deadline order.*/
+  if (tp->hdr.pqueue.prio == CH_CFG_EDF_PRIORITY) {
+    return threadref(__sch_edf_insert(&tp->owner->rlist, tp, false));
+  }
+#endif
+
   /* Insertion in the priority queue.*/
-  return threadref(ch_pqueue_insert_behind(&tp->owner->rlist.pqueue,
-                                           &tp->hdr.pqueue));
+  return threadref(__rlist_insert_behind(&tp->owner->rlist,
+                                         &tp->hdr.pqueue));
 }
 
 /**
@@ -108,9 +214,16 @@ static thread_t *__sch_ready_ahead(thread_t *tp) {
   /* The thread is marked ready.*/
   tp->state = CH_STATE_READY;
 
+#if CH_CFG_USE_EDF == TRUE
+  /* Threads in the EDF band are inserted in deadline order.*/
+  if (tp->hdr.pqueue.prio == CH_CFG_EDF_PRIORITY) {
+    return threadref(__sch_edf_insert(&tp->owner->rlist, tp, true));
+  }
+#endif
+
   /* Insertion in the priority queue.*/
-  return threadref(ch_pqueue_insert_ahead(&tp->owner->rlist.pqueue,
-                                          &tp->hdr.pqueue));
+  return threadref(__rlist_insert_ahead(&tp->owner->rlist,
+                                        &tp->hdr.pqueue));
 }
 
 /**
@@ -129,7 +242,7 @@ static void __sch_reschedule_behind(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = threadref(__rlist_remove_highest(&oip->rlist));
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -165,7 +278,7 @@ static void __sch_reschedule_ahead(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = threadref(__rlist_remove_highest(&oip->rlist));
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -327,7 +440,7 @@ void chSchGoSleepS(tstate_t newstate) {
 #endif
 
   /* Next thread in ready list becomes current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = threadref(__rlist_remove_highest(&oip->rlist));
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -381,6 +494,50 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
   return tp->u.rdymsg;
 }
 
+/**
+ * @brief   Puts the current thread to sleep into the specified state with
+ *          timeout and slack specification.
+ * @details The thread goes into a sleeping state, if it is not awakened
+ *          explicitly then it is forcibly awakened with a @p MSG_TIMEOUT
+ *          low level message after a number of ticks within the window
+ *          <tt>[timeout, timeout + slack]</tt>. The timeout is aligned with
+ *          other timers within the window in order to reduce wakeups, see
+ *          @p chVTDoSetWithSlackI().
+ *
+ * @param[in] newstate  the new thread state
+ * @param[in] timeout   the minimum number of ticks before the operation
+ *                      timeouts, the special values are handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state, the slack is ignored.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ * @param[in] slack     the number of ticks the timeout can be delayed
+ * @return              The wakeup message.
+ * @retval MSG_TIMEOUT  if a timeout occurs.
+ *
+ * @sclass
+ */
+msg_t chSchGoSleepTimeoutSlackS(tstate_t newstate, sysinterval_t timeout,
+                                sysinterval_t slack) {
+  thread_t *tp = __instance_get_currthread(currcore);
+
+  chDbgCheckClassS();
+
+  if (TIME_INFINITE != timeout) {
+    virtual_timer_t vt;
+
+    chVTDoSetWithSlackI(&vt, timeout, slack, __sch_wakeup, (void *)tp);
+    chSchGoSleepS(newstate);
+    if (chVTIsArmedI(&vt)) {
+      chVTDoResetI(&vt);
+    }
+  }
+  else {
+    chSchGoSleepS(newstate);
+  }
+
+  return tp->u.rdymsg;
+}
+
 /**
  * @brief   Wakes up a thread.
  * @details The thread is inserted into the ready list or immediately made
@@ -427,8 +584,9 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
      running immediately and the invoking thread goes in the ready
      list instead.
      Note, we are favoring the path where the woken thread has higher
-     priority.*/
-  if (unlikely(ntp->hdr.pqueue.prio <= otp->hdr.pqueue.prio)) {
+     priority. In the EDF band the earlier deadline wins.*/
+  if (unlikely((ntp->hdr.pqueue.prio <= otp->hdr.pqueue.prio) &&
+               !__sch_edf_band_precedes(ntp, otp))) {
     (void) __sch_ready_behind(ntp);
   }
   else {
@@ -467,7 +625,8 @@ void chSchRescheduleS(void) {
 
   /* Note, we are favoring the path where the reschedule is necessary
      because higher priority threads are ready.*/
-  if (likely(firstprio(&oip->rlist.pqueue) > tp->hdr.pqueue.prio)) {
+  if (likely((firstprio(&oip->rlist.pqueue) > tp->hdr.pqueue.prio) ||
+             __sch_edf_band_precedes(threadref(oip->rlist.pqueue.next), tp))) {
     __sch_reschedule_ahead();
   }
 }
@@ -493,6 +652,14 @@ bool chSchIsPreemptionRequired(void) {
   tprio_t p1 = firstprio(&oip->rlist.pqueue);
   tprio_t p2 = tp->hdr.pqueue.prio;
 
+#if CH_CFG_USE_EDF == TRUE
+  /* In the EDF band the deadlines are compared, the time quantum is not
+     considered.*/
+  if ((p1 == CH_CFG_EDF_PRIORITY) && (p2 == CH_CFG_EDF_PRIORITY)) {
+    return ch_sch_edf_precedes(threadref(oip->rlist.pqueue.next), tp);
+  }
+#endif
+
 #if CH_CFG_TIME_QUANTUM > 0
   /* If the running thread has not reached its time quantum, reschedule only
      if the first thread on the ready queue has a higher priority.
@@ -524,7 +691,7 @@ void chSchDoPreemption(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = threadref(__rlist_remove_highest(&oip->rlist));
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -575,6 +742,17 @@ void chSchPreemption(void) {
   tprio_t p1 = firstprio(&oip->rlist.pqueue);
   tprio_t p2 = tp->hdr.pqueue.prio;
 
+#if CH_CFG_USE_EDF == TRUE
+  /* In the EDF band the deadlines are compared, the time quantum is not
+     considered.*/
+  if ((p1 == CH_CFG_EDF_PRIORITY) && (p2 == CH_CFG_EDF_PRIORITY)) {
+    if (ch_sch_edf_precedes(threadref(oip->rlist.pqueue.next), tp)) {
+      __sch_reschedule_ahead();
+    }
+    return;
+  }
+#endif
+
   /* Note, we are favoring the path where preemption is necessary
      because higher priority threads are ready.*/
 #if CH_CFG_TIME_QUANTUM > 0
@@ -610,8 +788,10 @@ void chSchDoYieldS(void) {
   chDbgCheckClassS();
 
   /* If this function has been called then it is likely there are threads
-     at same priority level.*/
-  if (likely(firstprio(&oip->rlist.pqueue) >= tp->hdr.pqueue.prio)) {
+     at same priority level. In the EDF band the thread does not yield to
+     threads with later deadlines.*/
+  if (likely((firstprio(&oip->rlist.pqueue) >= tp->hdr.pqueue.prio) &&
+             !__sch_edf_band_precedes(tp, threadref(oip->rlist.pqueue.next)))) {
     __sch_reschedule_behind();
   }
 }
@@ -634,7 +814,7 @@ thread_t *chSchSelectFirst(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = threadref(__rlist_remove_highest(&oip->rlist));
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -33,6 +33,17 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Return address of the current function.
+ * @note    Compilers not supporting it record all sites as @p NULL, the
+ *          histograms are still meaningful.
+ */
+#if defined(CC_RETURN_ADDRESS) || defined(__DOXYGEN__)
+#define STATS_CALL_SITE()                   CC_RETURN_ADDRESS()
+#else
+#define STATS_CALL_SITE()                   NULL
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -49,6 +60,60 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_CRIT_SITES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts a terminated critical zone in a profile.
+ *
+ * @param[in] cpp       pointer to the @p crit_profile_t structure
+ * @param[in] d         duration of the zone
+ */
+static void stats_crit_record(crit_profile_t *cpp, rtcnt_t d) {
+  unsigned i, k;
+
+  /* Histogram bucket is the number of significant bits in the duration,
+     capped to the last bucket.*/
+  k = 0U;
+  while ((d >> k) != (rtcnt_t)0) {
+    k++;
+    if (k >= (unsigned)(CH_STATS_CRIT_BUCKETS - 1)) {
+      break;
+    }
+  }
+  cpp->hist[k]++;
+
+  /* Fast path, the zone does not enter the worst sites table.*/
+  if (d <= cpp->threshold) {
+    return;
+  }
+
+  /* Searching for the site among the recorded ones, if not found then the
+     entry with the shortest duration is replaced.*/
+  k = 0U;
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_TOP; i++) {
+    if (cpp->top[i].site == cpp->site) {
+      k = i;
+      break;
+    }
+    if (cpp->top[i].worst < cpp->top[k].worst) {
+      k = i;
+    }
+  }
+  if ((cpp->top[k].site == cpp->site) && (d <= cpp->top[k].worst)) {
+    return;
+  }
+  cpp->top[k].site  = cpp->site;
+  cpp->top[k].worst = d;
+
+  /* New threshold.*/
+  cpp->threshold = cpp->top[0].worst;
+  for (i = 1U; i < (unsigned)CH_DBG_STATISTICS_CRIT_TOP; i++) {
+    if (cpp->top[i].worst < cpp->threshold) {
+      cpp->threshold = cpp->top[i].worst;
+    }
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -75,11 +140,34 @@ void __stats_ctxswc(thread_t *ntp, thread_t *otp) {
   chTMChainMeasurementToX(&otp->stats, &ntp->stats);
 }
 
+/**
+ * @brief   Increases the virtual timers alarms counter.
+ * @note    Alarms are only programmed in tick-less mode.
+ */
+void __stats_increase_vt_alarms(void) {
+
+  currcore->kernel_stats.n_vt_alarms++;
+}
+
+/**
+ * @brief   Increases the virtual timers fired counter.
+ */
+void __stats_increase_vt_fired(void) {
+
+  currcore->kernel_stats.n_vt_fired++;
+}
+
 /**
  * @brief   Starts the measurement of a thread critical zone.
+ * @note    The function is not inlined because, when critical zones
+ *          profiling is enabled, its return address identifies the lock
+ *          site.
  */
-void __stats_start_measure_crit_thd(void) {
+NOINLINE void __stats_start_measure_crit_thd(void) {
 
+#if CH_DBG_STATISTICS_CRIT_SITES == TRUE
+  currcore->kernel_stats.p_crit_thd.site = STATS_CALL_SITE();
+#endif
   chTMStartMeasurementX(&currcore->kernel_stats.m_crit_thd);
 }
 
@@ -89,13 +177,23 @@ void __stats_start_measure_crit_thd(void) {
 void __stats_stop_measure_crit_thd(void) {
 
   chTMStopMeasurementX(&currcore->kernel_stats.m_crit_thd);
+#if CH_DBG_STATISTICS_CRIT_SITES == TRUE
+  stats_crit_record(&currcore->kernel_stats.p_crit_thd,
+                    currcore->kernel_stats.m_crit_thd.last);
+#endif
 }
 
 /**
  * @brief   Starts the measurement of an ISR critical zone.
+ * @note    The function is not inlined because, when critical zones
+ *          profiling is enabled, its return address identifies the lock
+ *          site.
  */
-void __stats_start_measure_crit_isr(void) {
+NOINLINE void __stats_start_measure_crit_isr(void) {
 
+#if CH_DBG_STATISTICS_CRIT_SITES == TRUE
+  currcore->kernel_stats.p_crit_isr.site = STATS_CALL_SITE();
+#endif
   chTMStartMeasurementX(&currcore->kernel_stats.m_crit_isr);
 }
 
@@ -105,7 +203,78 @@ void __stats_start_measure_crit_isr(void) {
 void __stats_stop_measure_crit_isr(void) {
 
   chTMStopMeasurementX(&currcore->kernel_stats.m_crit_isr);
+#if CH_DBG_STATISTICS_CRIT_SITES == TRUE
+  stats_crit_record(&currcore->kernel_stats.p_crit_isr,
+                    currcore->kernel_stats.m_crit_isr.last);
+#endif
+}
+
+#if (CH_DBG_STATISTICS_CRIT_SITES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Critical zones profile initialization.
+ * @note    Internal use only.
+ *
+ * @param[out] cpp      pointer to the @p crit_profile_t structure
+ *
+ * @notapi
+ */
+void __stats_crit_profile_init(crit_profile_t *cpp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_STATS_CRIT_BUCKETS; i++) {
+    cpp->hist[i] = (ucnt_t)0;
+  }
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_TOP; i++) {
+    cpp->top[i].site  = NULL;
+    cpp->top[i].worst = (rtcnt_t)0;
+  }
+  cpp->threshold = (rtcnt_t)0;
+  cpp->site      = NULL;
+}
+
+/**
+ * @brief   Returns a snapshot of the critical zones profiles.
+ * @note    The profiles are those of the current core.
+ *
+ * @param[out] thdp     pointer to a @p crit_profile_t structure receiving
+ *                      the threads critical zones profile or @p NULL
+ * @param[out] isrp     pointer to a @p crit_profile_t structure receiving
+ *                      the ISRs critical zones profile or @p NULL
+ *
+ * @api
+ */
+void chStatsGetCritProfiles(crit_profile_t *thdp, crit_profile_t *isrp) {
+
+  chSysLock();
+  if (thdp != NULL) {
+    *thdp = currcore->kernel_stats.p_crit_thd;
+  }
+  if (isrp != NULL) {
+    *isrp = currcore->kernel_stats.p_crit_isr;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Clears the critical zones profiles.
+ * @note    The profiles are those of the current core.
+ *
+ * @api
+ */
+void chStatsResetCritProfiles(void) {
+  const void *site;
+
+  chSysLock();
+
+  /* The lock site of the zone in progress is preserved.*/
+  site = currcore->kernel_stats.p_crit_thd.site;
+  __stats_crit_profile_init(&currcore->kernel_stats.p_crit_thd);
+  __stats_crit_profile_init(&currcore->kernel_stats.p_crit_isr);
+  currcore->kernel_stats.p_crit_thd.site = site;
+
+  chSysUnlock();
 }
+#endif /* CH_DBG_STATISTICS_CRIT_SITES == TRUE */
 
 #endif /* CH_DBG_STATISTICS == TRUE */
 
@@ -154,6 +154,14 @@ thread_t *chThdObjectInit(thread_t *tp,
   tp->epending          = (eventmask_t)0;
 #endif
 
+  /* EDF-related fields.*/
+#if CH_CFG_USE_EDF == TRUE
+  tp->deadline          = (systime_t)0;
+  tp->release           = (systime_t)0;
+  tp->reldeadline       = (sysinterval_t)0;
+  tp->dlmisses          = (ucnt_t)0;
+#endif
+
   /* Debug-related fields.*/
 #if CH_DBG_THREADS_PROFILING == TRUE
   tp->time              = (systime_t)0;
@@ -866,6 +874,29 @@ void chThdSleep(sysinterval_t time) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Suspends the invoking thread for the specified time with slack.
+ * @details The thread is awakened after a delay within the window
+ *          <tt>[time, time + slack]</tt>, the wakeup is aligned with other
+ *          timers within the window in order to reduce wakeups. Use it for
+ *          periodic activities tolerating some jitter.
+ *
+ * @param[in] time      the minimum delay in system ticks, the special values
+ *                      are handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ * @param[in] slack     the number of ticks the wakeup can be delayed
+ *
+ * @api
+ */
+void chThdSleepSlack(sysinterval_t time, sysinterval_t slack) {
+
+  chSysLock();
+  chThdSleepSlackS(time, slack);
+  chSysUnlock();
+}
+
 /**
  * @brief   Suspends the invoking thread until the system time arrives to the
  *          specified value.
@@ -917,6 +948,92 @@ systime_t chThdSleepUntilWindowed(systime_t prev, systime_t next) {
   return next;
 }
 
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the deadline of the running thread.
+ * @details A new job of the thread is released at the current time, its
+ *          absolute deadline is the current time plus the specified
+ *          relative deadline. The relative deadline is also used for the
+ *          jobs released by @p chThdSleepUntilNextPeriod().
+ *          Ready threads at priority @p CH_CFG_EDF_PRIORITY are scheduled
+ *          in absolute deadline order, the earliest first.
+ * @note    Deadlines are not inherited through mutexes, a thread raised to
+ *          @p CH_CFG_EDF_PRIORITY by priority inheritance is scheduled as
+ *          a thread without deadline.
+ *
+ * @param[in] deadline  the relative deadline in system ticks, it must be
+ *                      greater than zero and within half the system time
+ *                      numeric range
+ *
+ * @api
+ */
+void chThdSetDeadline(sysinterval_t deadline) {
+  thread_t *currtp = chThdGetSelfX();
+
+  chDbgCheck((deadline > (sysinterval_t)0) &&
+             (deadline <= (sysinterval_t)(TIME_MAX_SYSTIME / 2U)));
+
+  chSysLock();
+  currtp->release     = chVTGetSystemTimeX();
+  currtp->deadline    = chTimeAddX(currtp->release, deadline);
+  currtp->reldeadline = deadline;
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Completes the current job and waits for the next period.
+ * @details The current job is checked against its deadline, a missed
+ *          deadline is counted in the thread. The next job is released
+ *          one period after the current one, the thread sleeps until then
+ *          and its deadline is moved accordingly.
+ * @pre     The deadline must have been set using @p chThdSetDeadline().
+ * @note    If the next release time is already past, because an overrun,
+ *          then the next job starts immediately, its deadline is still
+ *          relative to its release time.
+ *
+ * @param[in] period    the period in system ticks
+ * @return              The deadline status of the completed job.
+ * @retval false        if the job completed within its deadline.
+ * @retval true         if the job missed its deadline.
+ *
+ * @api
+ */
+bool chThdSleepUntilNextPeriod(sysinterval_t period) {
+  thread_t *currtp = chThdGetSelfX();
+  systime_t now;
+  bool missed;
+
+  chDbgCheck(period > (sysinterval_t)0);
+
+  chSysLock();
+
+  chDbgAssert(currtp->reldeadline > (sysinterval_t)0, "no deadline");
+
+  /* Checking the completed job.*/
+  now = chVTGetSystemTimeX();
+  missed = ch_sch_edf_earlier(currtp->deadline, now);
+  if (missed) {
+    currtp->dlmisses++;
+  }
+
+  /* Next job.*/
+  currtp->release  = chTimeAddX(currtp->release, period);
+  currtp->deadline = chTimeAddX(currtp->release, currtp->reldeadline);
+  if (ch_sch_edf_earlier(now, currtp->release)) {
+    chThdSleepS(chTimeDiffX(now, currtp->release));
+  }
+  else {
+    /* The deadline moved forward, other threads could precede now.*/
+    chSchRescheduleS();
+  }
+
+  chSysUnlock();
+
+  return missed;
+}
+#endif /* CH_CFG_USE_EDF == TRUE */
+
 /**
  * @brief   Yields the time slot.
  * @details Yields the CPU control to the next thread in the ready list with
@@ -48,6 +48,169 @@
 /*===========================================================================*/
 
 #if (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) || defined(__DOXYGEN__)
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the stream identifier of an object.
+ * @details New objects are added to the names table, a changed name, for
+ *          example because a thread has been created where a terminated
+ *          one was, is announced again using the same identifier.
+ *
+ * @param[in] tsp       pointer to the @p trace_stream_t structure
+ * @param[in] objp      pointer to the object
+ * @param[in] name      name of the object, can be @p NULL
+ * @return              The object identifier.
+ * @retval CH_TRACE_ID_OVERFLOW if the names table is full.
+ *
+ * @notapi
+ */
+static uint16_t trace_stream_id(trace_stream_t *tsp,
+                                const void *objp,
+                                const char *name) {
+  unsigned i;
+
+  for (i = 0U; i < tsp->nnames; i++) {
+    if (tsp->names[i].objp == objp) {
+      if (tsp->names[i].name != name) {
+        tsp->names[i].name    = name;
+        tsp->names[i].pending = true;
+      }
+      return (uint16_t)(i + 1U);
+    }
+  }
+
+  if (tsp->nnames >= (unsigned)CH_DBG_TRACE_STREAM_NAMES) {
+    return (uint16_t)CH_TRACE_ID_OVERFLOW;
+  }
+
+  tsp->names[i].objp    = objp;
+  tsp->names[i].name    = name;
+  tsp->names[i].pending = true;
+  tsp->nnames++;
+
+  return (uint16_t)(i + 1U);
+}
+
+/**
+ * @brief   Queues a record in the trace stream.
+ * @note    There must be space in the FIFO.
+ *
+ * @param[in] tsp       pointer to the @p trace_stream_t structure
+ * @param[in] type      record type
+ * @param[in] state     record state field
+ * @param[in] id        record identifier field
+ * @param[in] arg1      first record argument
+ * @param[in] arg2      second record argument
+ *
+ * @notapi
+ */
+static void trace_stream_queue(trace_stream_t *tsp, uint8_t type,
+                               uint8_t state, uint16_t id,
+                               uint32_t arg1, uint32_t arg2) {
+  trace_record_t *rp;
+
+  rp = &tsp->records[tsp->wridx & ((unsigned)CH_DBG_TRACE_STREAM_SIZE - 1U)];
+  rp->type  = type;
+  rp->state = state;
+  rp->id    = id;
+  rp->arg1  = arg1;
+  rp->arg2  = arg2;
+  rp->stamp = (uint32_t)tsp->stamp;
+  tsp->wridx++;
+}
+
+/**
+ * @brief   Converts a trace event in trace stream records.
+ * @details The event is queued together with the lost events, time and
+ *          name records it depends on, if there is not enough space in
+ *          the FIFO for all of them then the event is dropped.
+ *
+ * @param[in] tsp       pointer to the @p trace_stream_t structure
+ * @param[in] tep       pointer to the trace event
+ *
+ * @notapi
+ */
+static void trace_stream_put(trace_stream_t *tsp, const trace_event_t *tep) {
+  uint16_t id = (uint16_t)CH_TRACE_ID_NONE;
+  uint32_t arg1 = 0U, arg2 = 0U;
+  trace_name_t *np = NULL;
+  unsigned needed;
+
+  /* Extending the time stamp to 64 bits, the counter is assumed to not
+     wrap more than once between two events.*/
+#if PORT_SUPPORTS_RT == TRUE
+  rtcnt_t now = chSysGetRealtimeCounterX();
+  tsp->stamp += (uint64_t)(rtcnt_t)(now - (rtcnt_t)tsp->stamp);
+#else
+  systime_t now = chVTGetSystemTimeX();
+  tsp->stamp += (uint64_t)(systime_t)(now - (systime_t)tsp->stamp);
+#endif
+
+  switch (tep->type) {
+  case CH_TRACE_TYPE_READY:
+    id   = trace_stream_id(tsp, tep->u.rdy.tp,
+                           chRegGetThreadNameX(tep->u.rdy.tp));
+    arg1 = (uint32_t)tep->u.rdy.msg;
+    break;
+  case CH_TRACE_TYPE_SWITCH:
+    id   = trace_stream_id(tsp, tep->u.sw.ntp,
+                           chRegGetThreadNameX(tep->u.sw.ntp));
+    arg1 = (uint32_t)(uintptr_t)tep->u.sw.wtobjp;
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    id   = trace_stream_id(tsp, tep->u.isr.name, tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    id   = trace_stream_id(tsp, tep->u.halt.reason, tep->u.halt.reason);
+    break;
+  case CH_TRACE_TYPE_USER:
+    arg1 = (uint32_t)(uintptr_t)tep->u.user.up1;
+    arg2 = (uint32_t)(uintptr_t)tep->u.user.up2;
+    break;
+  default:
+    break;
+  }
+
+  /* Space required by the event and its dependencies.*/
+  needed = 1U;
+  if (tsp->lost > 0U) {
+    needed++;
+  }
+  if ((uint32_t)(tsp->stamp >> 32) != tsp->high) {
+    needed++;
+  }
+  if ((id != (uint16_t)CH_TRACE_ID_NONE) &&
+      (id != (uint16_t)CH_TRACE_ID_OVERFLOW) &&
+      tsp->names[id - 1U].pending) {
+    np = &tsp->names[id - 1U];
+    needed++;
+  }
+  if (needed > (unsigned)CH_DBG_TRACE_STREAM_SIZE - (tsp->wridx - tsp->rdidx)) {
+    tsp->lost++;
+    tsp->drops++;
+    return;
+  }
+
+  if ((uint32_t)(tsp->stamp >> 32) != tsp->high) {
+    tsp->high = (uint32_t)(tsp->stamp >> 32);
+    trace_stream_queue(tsp, (uint8_t)CH_TRACE_TYPE_TIME, 0U,
+                       (uint16_t)CH_TRACE_ID_NONE, tsp->high, 0U);
+  }
+  if (tsp->lost > 0U) {
+    trace_stream_queue(tsp, (uint8_t)CH_TRACE_TYPE_LOST, 0U,
+                       (uint16_t)CH_TRACE_ID_NONE, tsp->lost, 0U);
+    tsp->lost = 0U;
+  }
+  if (np != NULL) {
+    np->pending = false;
+    trace_stream_queue(tsp, (uint8_t)CH_TRACE_TYPE_NAME, (uint8_t)tep->type,
+                       id, (uint32_t)(uintptr_t)np->objp, 0U);
+  }
+  trace_stream_queue(tsp, (uint8_t)tep->type, (uint8_t)tep->state, id,
+                     arg1, arg2);
+}
+#endif /* CH_DBG_TRACE_STREAM == TRUE */
+
 /**
  * @brief   Writes a time stamp and increases the trace buffer pointer.
  * @note    The @p NOINLINE attribute is intentional and load-bearing.
@@ -73,6 +236,10 @@ NOINLINE static void trace_next(os_instance_t *oip) {
   /* Trace hook, useful in order to interface debug tools.*/
   CH_CFG_TRACE_HOOK(oip->trace_buffer.ptr);
 
+#if CH_DBG_TRACE_STREAM == TRUE
+  trace_stream_put(&oip->trace_buffer.stream, oip->trace_buffer.ptr);
+#endif
+
   if (++oip->trace_buffer.ptr >= &oip->trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
     oip->trace_buffer.ptr = &oip->trace_buffer.buffer[0];
   }
@@ -101,6 +268,15 @@ void __trace_object_init(trace_buffer_t *tbp) {
   for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE; i++) {
     tbp->buffer[i].type = CH_TRACE_TYPE_UNUSED;
   }
+#if CH_DBG_TRACE_STREAM == TRUE
+  tbp->stream.stamp  = (uint64_t)0;
+  tbp->stream.high   = 0U;
+  tbp->stream.lost   = 0U;
+  tbp->stream.drops  = (ucnt_t)0;
+  tbp->stream.rdidx  = 0U;
+  tbp->stream.wridx  = 0U;
+  tbp->stream.nnames = 0U;
+#endif
 }
 
 /**
@@ -293,6 +469,86 @@ void chTraceResume(uint16_t mask) {
   chTraceResumeI(mask);
   chSysUnlock();
 }
+
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Fetches records from the trace stream.
+ *
+ * @param[out] rp       pointer to the records buffer
+ * @param[in] n         maximum number of records to fetch
+ * @return              The number of fetched records.
+ *
+ * @iclass
+ */
+size_t chTraceStreamReadI(trace_record_t *rp, size_t n) {
+  trace_stream_t *tsp = &currcore->trace_buffer.stream;
+  size_t i = 0U;
+
+  chDbgCheckClassI();
+
+  while ((i < n) && (tsp->rdidx != tsp->wridx)) {
+    rp[i] = tsp->records[tsp->rdidx & ((unsigned)CH_DBG_TRACE_STREAM_SIZE - 1U)];
+    tsp->rdidx++;
+    i++;
+  }
+
+  return i;
+}
+
+/**
+ * @brief   Fetches records from the trace stream.
+ * @note    The critical zone duration is proportional to @p n.
+ *
+ * @param[out] rp       pointer to the records buffer
+ * @param[in] n         maximum number of records to fetch
+ * @return              The number of fetched records.
+ *
+ * @api
+ */
+size_t chTraceStreamRead(trace_record_t *rp, size_t n) {
+  size_t i;
+
+  chSysLock();
+  i = chTraceStreamReadI(rp, n);
+  chSysUnlock();
+
+  return i;
+}
+
+/**
+ * @brief   Returns the name associated to a trace stream identifier.
+ *
+ * @param[in] id        the identifier
+ * @return              The name or @p NULL if the identifier is not valid
+ *                      or the object has no name.
+ *
+ * @api
+ */
+const char *chTraceStreamGetName(uint16_t id) {
+  trace_stream_t *tsp = &currcore->trace_buffer.stream;
+  const char *name = NULL;
+
+  chSysLock();
+  if ((id != (uint16_t)CH_TRACE_ID_NONE) && ((unsigned)id <= tsp->nnames)) {
+    name = tsp->names[id - 1U].name;
+  }
+  chSysUnlock();
+
+  return name;
+}
+
+/**
+ * @brief   Returns the number of events dropped by the trace stream.
+ *
+ * @return              The total number of dropped events.
+ *
+ * @xclass
+ */
+ucnt_t chTraceStreamGetDropsX(void) {
+
+  return currcore->trace_buffer.stream.drops;
+}
+#endif /* CH_DBG_TRACE_STREAM == TRUE */
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /** @} */
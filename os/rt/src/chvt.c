@@ -87,6 +87,8 @@ static void vt_set_alarm(virtual_timers_list_t *vtlp,
   }
 #endif
 
+  __stats_increase_vt_alarms();
+
   /* Deadline skip detection and correction loop.*/
   while (true) {
     sysinterval_t nowdelta;
@@ -128,25 +130,22 @@ static void vt_set_alarm(virtual_timers_list_t *vtlp,
 }
 
 /**
- * @brief   Inserts a timer as first element in a delta list.
- * @note    This is the special case when the delta list is initially empty.
+ * @brief   Alarm start.
+ * @note    This is the special case when the timers list is initially empty
+ *          and the alarm is not active.
+ * @note    An RFCU fault is registered if the system time skips past
+ *          <tt>(now + delay)</tt>, the deadline is skipped forward
+ *          in order to compensate for the event.
  *
  * @param[in] vtlp      pointer to a @p virtual_timers_list_t structure
- * @param[in] vtp       pointer to a @p virtual_timer_t object
  * @param[in] now       last known system time
  * @param[in] delay     delay over @p now
  */
-static void vt_insert_first(virtual_timers_list_t *vtlp,
-                            virtual_timer_t *vtp,
-                            systime_t now,
-                            sysinterval_t delay) {
+static void vt_start_alarm(virtual_timers_list_t *vtlp,
+                           systime_t now,
+                           sysinterval_t delay) {
   sysinterval_t currdelta;
 
-  /* The delta list is empty, the current time becomes the new
-     delta list base time, the timer is inserted.*/
-  vtlp->lasttime = now;
-  ch_dlist_insert_after(&vtlp->dlist, &vtp->dlist, delay);
-
   /* Initial delta is what is configured statically.*/
   currdelta = vtlp->lastdelta;
 
@@ -167,7 +166,8 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
 
   /* Being the first element inserted in the list the alarm timer
      is started.*/
-  port_timer_start_alarm(chTimeAddX(vtlp->lasttime, delay));
+  port_timer_start_alarm(chTimeAddX(now, delay));
+  __stats_increase_vt_alarms();
 
   /* Deadline skip detection and correction loop.*/
   while (true) {
@@ -206,8 +206,132 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
   chDbgAssert(currdelta <= CH_CFG_ST_TIMEDELTA, "insufficient delta");
 #endif
 }
+
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
+/**
+ * @brief   Inserts a timer as first element in a delta list.
+ * @note    This is the special case when the delta list is initially empty.
+ *
+ * @param[in] vtlp      pointer to a @p virtual_timers_list_t structure
+ * @param[in] vtp       pointer to a @p virtual_timer_t object
+ * @param[in] now       last known system time
+ * @param[in] delay     delay over @p now
+ */
+static void vt_insert_first(virtual_timers_list_t *vtlp,
+                            virtual_timer_t *vtp,
+                            systime_t now,
+                            sysinterval_t delay) {
+
+  /* The delta list is empty, the current time becomes the new
+     delta list base time, the timer is inserted.*/
+  vtlp->lasttime = now;
+  ch_dlist_insert_after(&vtlp->dlist, &vtp->dlist, delay);
+
+  /* Being the first element inserted in the list the alarm timer
+     is started.*/
+  vt_start_alarm(vtlp, now, delay);
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST */
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the wheel slot of an expiration time.
+ * @details The level is the one of the most significant digit where the
+ *          expiration time differs from the wheel base time. Expiration
+ *          times wrapped past the numeric range always go in the top level.
+ *
+ * @param[in] wp        pointer to a @p vt_wheel_t structure
+ * @param[in] expiry    timer expiration time in wheel time
+ * @param[out] lvlp     pointer to the level of the slot
+ * @param[out] slotp    pointer to the slot within its level
+ * @return              Pointer to the slot list header.
+ */
+static ch_delta_list_t *vt_wheel_slot(vt_wheel_t *wp,
+                                      sysinterval_t expiry,
+                                      unsigned *lvlp,
+                                      unsigned *slotp) {
+  sysinterval_t diff;
+  unsigned lvl;
+
+  if (unlikely(expiry < wp->base)) {
+    lvl = CH_VT_WHEEL_LEVELS - 1U;
+  }
+  else {
+    diff = expiry ^ wp->base;
+    lvl  = 0U;
+    while (diff >= (sysinterval_t)CH_VT_WHEEL_SLOTS) {
+      diff >>= CH_VT_WHEEL_BITS;
+      lvl++;
+    }
+  }
+
+  *lvlp  = lvl;
+  *slotp = (unsigned)(expiry >> (lvl * CH_VT_WHEEL_BITS)) &
+           (CH_VT_WHEEL_SLOTS - 1U);
+
+  return &wp->slots[lvl][*slotp];
+}
+
+/**
+ * @brief   Marks a wheel slot as empty.
+ *
+ * @param[in] wp        pointer to a @p vt_wheel_t structure
+ * @param[in] lvl       level of the slot
+ * @param[in] slot      slot within its level
+ */
+static void vt_wheel_clear(vt_wheel_t *wp, unsigned lvl, unsigned slot) {
+
+  wp->levels[lvl] &= ~((uint32_t)1U << slot);
+  if (wp->levels[lvl] == 0U) {
+    wp->summary &= ~((uint32_t)1U << lvl);
+  }
+}
+
+/**
+ * @brief   Inserts a timer in a timing wheel.
+ * @note    The timer expiration time must be already stored in its
+ *          @p delta field.
+ *
+ * @param[in] wp        pointer to a @p vt_wheel_t structure
+ * @param[in] vtp       pointer to a @p virtual_timer_t object
+ */
+static void vt_wheel_insert(vt_wheel_t *wp, virtual_timer_t *vtp) {
+  ch_delta_list_t *hdrp;
+  unsigned lvl, slot;
+
+  hdrp = vt_wheel_slot(wp, vtp->dlist.delta, &lvl, &slot);
+
+  /* Timers in the same slot are kept in FIFO order.*/
+  ch_dlist_insert_before(hdrp, &vtp->dlist, vtp->dlist.delta);
+  wp->levels[lvl] |= (uint32_t)1U << slot;
+  wp->summary     |= (uint32_t)1U << lvl;
+}
+
+/**
+ * @brief   Removes a timer from a timing wheel.
+ *
+ * @param[in] wp        pointer to a @p vt_wheel_t structure
+ * @param[in] vtp       pointer to a @p virtual_timer_t object
+ */
+static void vt_wheel_remove(vt_wheel_t *wp, virtual_timer_t *vtp) {
+  ch_delta_list_t *hdrp;
+  unsigned lvl, slot;
+
+  /* Removing the element from its slot, marking it as not armed.*/
+  (void) ch_dlist_dequeue(&vtp->dlist);
+  vtp->dlist.next = NULL;
+
+  /* Note, the timer could be in the list of timers being fired by
+     chVTDoTickI() rather than in the wheel, the slot is checked for
+     emptiness rather than assumed empty.*/
+  hdrp = vt_wheel_slot(wp, vtp->dlist.delta, &lvl, &slot);
+  if (ch_dlist_isempty(hdrp)) {
+    vt_wheel_clear(wp, lvl, slot);
+  }
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+
 /**
  * @brief   Enqueues a virtual timer in a virtual timers list.
  *
@@ -215,6 +339,7 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
  * @param[in] vtp       pointer to a @p virtual_timer_t object
  * @param[in] delay     delay over current system time
  */
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
 static void vt_enqueue(virtual_timers_list_t *vtlp,
                        virtual_timer_t *vtp,
                        sysinterval_t delay) {
@@ -260,6 +385,206 @@ static void vt_enqueue(virtual_timers_list_t *vtlp,
 
   ch_dlist_insert(&vtlp->dlist, &vtp->dlist, delta);
 }
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+static void vt_enqueue(virtual_timers_list_t *vtlp,
+                       virtual_timer_t *vtp,
+                       sysinterval_t delay) {
+  vt_wheel_t *wp = __vt_get_wheel(vtlp);
+  sysinterval_t nowdelta, delta;
+  systime_t now = chVTGetSystemTimeX();
+
+  nowdelta = chTimeDiffX(vtlp->lasttime, now);
+
+  /* Special case where the wheel is empty, the current time becomes the
+     new wheel base time.*/
+  if (wp->summary == 0U) {
+    wp->base      += nowdelta;
+    vtlp->lasttime = now;
+    vtp->dlist.delta = wp->base + delay;
+    vt_wheel_insert(wp, vtp);
+
+#if CH_CFG_ST_TIMEDELTA > 0
+    vt_start_alarm(vtlp, now, delay);
+#endif
+
+    return;
+  }
+
+  /* Delay as delta from 'lasttime'. Note, it can overflow and the value
+     becomes lower than 'nowdelta', in that case the delta is shortened
+     and the timer will be triggered "nowdelta" cycles earlier.*/
+  delta = nowdelta + delay;
+  if (delta < nowdelta) {
+    delta = delay;
+  }
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    unsigned lvl, slot;
+
+    /* Checking if this timer would precede the next wheel event, this
+       requires changing the current alarm setting.*/
+    if (delta < __vt_wheel_next(wp, &lvl, &slot)) {
+
+      vt_set_alarm(vtlp, now, delay);
+    }
+  }
+#endif
+
+  vtp->dlist.delta = wp->base + delta;
+  vt_wheel_insert(wp, vtp);
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+
+/**
+ * @brief   Chooses a delay within a timer window.
+ * @details The first expiration already scheduled within the window
+ *          <tt>[delay, delay + slack]</tt> is chosen, the timer is then
+ *          fired together with the already scheduled event without
+ *          requiring a further alarm. If there is no scheduled expiration
+ *          within the window then its end is chosen, this gives timers set
+ *          later a chance to be aligned with this one.
+ * @note    The cost is proportional to the number of timers expiring
+ *          before the window end.
+ *
+ * @param[in] vtlp      pointer to a @p virtual_timers_list_t structure
+ * @param[in] delay     window start as delay over current system time
+ * @param[in] slack     window length
+ * @return              The chosen delay over current system time.
+ */
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
+static sysinterval_t vt_coalesce(virtual_timers_list_t *vtlp,
+                                 sysinterval_t delay,
+                                 sysinterval_t slack) {
+  sysinterval_t end, nowdelta, first, last, delta;
+  ch_delta_list_t *dlp;
+
+  /* Window end, saturated to the numeric range.*/
+  end = delay + slack;
+  if (end < delay) {
+    end = (sysinterval_t)-1;
+  }
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  if (ch_dlist_isempty(&vtlp->dlist)) {
+    return end;
+  }
+
+  /* Deltas in the list are relative to 'lasttime'.*/
+  nowdelta = chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
+#else
+  /* Deltas in the list are relative to the current tick.*/
+  nowdelta = (sysinterval_t)0;
+#endif
+
+  /* Window as deltas from the list base time, no alignment is attempted
+     if it exceeds the numeric range.*/
+  first = nowdelta + delay;
+  if (first < nowdelta) {
+    return end;
+  }
+  last = nowdelta + end;
+  if (last < nowdelta) {
+    last = (sysinterval_t)-1;
+  }
+
+  /* Searching the first expiration within the window, the scan stops at
+     the first expiration past the window end.*/
+  delta = (sysinterval_t)0;
+  dlp = vtlp->dlist.next;
+  while (dlp != &vtlp->dlist) {
+    delta += dlp->delta;
+    if (delta > last) {
+      break;
+    }
+    if (delta >= first) {
+      return delta - nowdelta;
+    }
+    dlp = dlp->next;
+  }
+
+  return end;
+}
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+static sysinterval_t vt_coalesce(virtual_timers_list_t *vtlp,
+                                 sysinterval_t delay,
+                                 sysinterval_t slack) {
+  vt_wheel_t *wp = __vt_get_wheel(vtlp);
+  sysinterval_t end, nowdelta, first, last;
+  unsigned lvl;
+
+  /* Window end, saturated to the numeric range.*/
+  end = delay + slack;
+  if (end < delay) {
+    end = (sysinterval_t)-1;
+  }
+
+  if (wp->summary == 0U) {
+    return end;
+  }
+
+  /* Window as offsets from the wheel base time, no alignment is attempted
+     if it exceeds the numeric range.*/
+  nowdelta = chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
+  first = nowdelta + delay;
+  if (first < nowdelta) {
+    return end;
+  }
+  last = nowdelta + end;
+  if (last < nowdelta) {
+    last = (sysinterval_t)-1;
+  }
+
+  /* Scanning the wheel in time order, levels from the lowest and slots
+     following the base time digit, the first slot containing expirations
+     within the window gives the earliest one.*/
+  for (lvl = 0U; lvl < CH_VT_WHEEL_LEVELS; lvl++) {
+    unsigned shift, digit, i;
+    sysinterval_t low;
+
+    if (wp->levels[lvl] == 0U) {
+      continue;
+    }
+
+    shift = lvl * CH_VT_WHEEL_BITS;
+    digit = (unsigned)(wp->base >> shift) & (CH_VT_WHEEL_SLOTS - 1U);
+    low   = wp->base & (sysinterval_t)(((sysinterval_t)1 << shift) - (sysinterval_t)1);
+
+    /* In level zero the digit slot itself is due.*/
+    for (i = lvl > 0U ? 1U : 0U; i < CH_VT_WHEEL_SLOTS; i++) {
+      ch_delta_list_t *hdrp, *dlp;
+      sysinterval_t start, offset, best;
+      unsigned slot = (digit + i) & (CH_VT_WHEEL_SLOTS - 1U);
+
+      if ((wp->levels[lvl] & ((uint32_t)1U << slot)) == 0U) {
+        continue;
+      }
+
+      /* Slots starting past the window end terminate the search, the
+         following slots and levels are later.*/
+      start = (sysinterval_t)((sysinterval_t)i << shift) - low;
+      if (start > last) {
+        return end;
+      }
+
+      /* Timers in the slot are not ordered.*/
+      hdrp = &wp->slots[lvl][slot];
+      best = (sysinterval_t)-1;
+      for (dlp = hdrp->next; dlp != hdrp; dlp = dlp->next) {
+        offset = dlp->delta - wp->base;
+        if ((offset >= first) && (offset <= last) && (offset < best)) {
+          best = offset;
+        }
+      }
+      if (best != (sysinterval_t)-1) {
+        return best - nowdelta;
+      }
+    }
+  }
+
+  return end;
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
 
 /*===========================================================================*/
 /* Module exported functions.                                                */
@@ -383,6 +708,48 @@ void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
   vt_enqueue(vtlp, vtp, delay);
 }
 
+/**
+ * @brief   Enables a one-shot virtual timer with slack.
+ * @details The timer is enabled and programmed to trigger after a delay
+ *          within the window <tt>[delay, delay + slack]</tt>. The delay is
+ *          chosen in order to fire the timer together with an already
+ *          scheduled timer, this reduces the number of alarms and wakeups.
+ *          If no scheduled timer falls within the window then the timer is
+ *          programmed at the window end.
+ * @pre     The timer must not be already armed before calling this function.
+ * @note    The callback function is invoked from interrupt context.
+ *
+ * @param[out] vtp      pointer to a @p virtual_timer_t object
+ * @param[in] delay     the minimum number of ticks before the operation
+ *                      timeouts, the special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ * @param[in] slack     the number of ticks the timer can be delayed
+ * @param[in] vtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chVTDoSetWithSlackI(virtual_timer_t *vtp, sysinterval_t delay,
+                         sysinterval_t slack, vtfunc_t vtfunc, void *par) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+
+  chDbgCheckClassI();
+  chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
+
+  /* Timer initialization.*/
+  vtp->par     = par;
+  vtp->func    = vtfunc;
+  vtp->reload  = (sysinterval_t)0;
+
+  /* Inserting the timer in the delta list.*/
+  vt_enqueue(vtlp, vtp, vt_coalesce(vtlp, delay, slack));
+}
+
 /**
  * @brief   Disables a Virtual Timer.
  * @pre     The timer must be in armed state before calling this function.
@@ -391,6 +758,7 @@ void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
  *
  * @iclass
  */
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
 void chVTDoResetI(virtual_timer_t *vtp) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
 
@@ -467,6 +835,60 @@ void chVTDoResetI(virtual_timer_t *vtp) {
   vt_set_alarm(vtlp, now, delta);
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+void chVTDoResetI(virtual_timer_t *vtp) {
+  vt_wheel_t *wp = &currcore->vtwheel;
+#if CH_CFG_ST_TIMEDELTA > 0
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+  sysinterval_t prevnext, next, nowdelta;
+  unsigned lvl, slot;
+  systime_t now;
+#endif
+
+  chDbgCheckClassI();
+  chDbgCheck(vtp != NULL);
+  chDbgAssert(chVTIsArmedI(vtp), "timer not armed");
+
+#if CH_CFG_ST_TIMEDELTA == 0
+  vt_wheel_remove(wp, vtp);
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  /* Next wheel event before removing the timer.*/
+  prevnext = (sysinterval_t)0;
+  if (wp->summary != 0U) {
+    prevnext = __vt_wheel_next(wp, &lvl, &slot);
+  }
+
+  vt_wheel_remove(wp, vtp);
+
+  /* If the wheel become empty then the alarm timer is stopped and done.*/
+  if (wp->summary == 0U) {
+
+    port_timer_stop_alarm();
+
+    return;
+  }
+
+  /* If the next wheel event is unchanged then the alarm is still valid.*/
+  next = __vt_wheel_next(wp, &lvl, &slot);
+  if (next == prevnext) {
+    return;
+  }
+
+  /* Distance in ticks between the wheel base time and current time.*/
+  now = chVTGetSystemTimeX();
+  nowdelta = chTimeDiffX(vtlp->lasttime, now);
+
+  /* If the current time surpassed the time of the next wheel event then
+     the event interrupt is already pending, just return.*/
+  if (nowdelta >= next) {
+    return;
+  }
+
+  /* Setting up the alarm.*/
+  vt_set_alarm(vtlp, now, next - nowdelta);
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
 
 /**
  * @brief   Returns the remaining time interval before next timer trigger.
@@ -477,6 +899,7 @@ void chVTDoResetI(virtual_timer_t *vtp) {
  *
  * @iclass
  */
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
 sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
   sysinterval_t delta;
@@ -507,6 +930,30 @@ sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp) {
 
   return (sysinterval_t)-1;
 }
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+  sysinterval_t delta;
+
+  chDbgCheckClassI();
+  chDbgAssert(chVTIsArmedI(vtp), "timer not armed");
+
+  /* Timers store their expiration time, no list scan required.*/
+  delta = vtp->dlist.delta - __vt_get_wheel(vtlp)->base;
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    systime_t now = chVTGetSystemTimeX();
+    sysinterval_t nowdelta = chTimeDiffX(vtlp->lasttime, now);
+    if (nowdelta > delta) {
+      return (sysinterval_t)0;
+    }
+    return delta - nowdelta;
+  }
+#else
+  return delta;
+#endif
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
 
 /**
  * @brief   Virtual timers ticker.
@@ -517,6 +964,7 @@ sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp) {
  *
  * @iclass
  */
+#if (CH_CFG_VT_BACKEND == CH_VT_BACKEND_DLIST) || defined(__DOXYGEN__)
 void chVTDoTickI(void) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
 
@@ -537,6 +985,8 @@ void chVTDoTickI(void) {
       (void) ch_dlist_dequeue(&vtp->dlist);
       vtp->dlist.next = NULL;
 
+      __stats_increase_vt_fired();
+
       chSysUnlockFromISR();
       vtp->func(vtp, vtp->par);
       chSysLockFromISR();
@@ -585,6 +1035,8 @@ void chVTDoTickI(void) {
       port_timer_stop_alarm();
     }
 
+    __stats_increase_vt_fired();
+
     /* The callback is invoked outside the kernel critical section, it
        is re-entered on the callback return. Note that "lasttime" can be
        modified within the callback if some timer function is called.*/
@@ -662,6 +1114,149 @@ void chVTDoTickI(void) {
   vt_set_alarm(vtlp, now, vtp->dlist.delta);
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
+#else /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
+void chVTDoTickI(void) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+  vt_wheel_t *wp = __vt_get_wheel(vtlp);
+  sysinterval_t nowdelta, next = (sysinterval_t)0;
+  systime_t now;
+
+  chDbgCheckClassI();
+
+#if CH_CFG_ST_TIMEDELTA == 0
+  vtlp->systime++;
+#endif
+
+  /* Looping through the wheel events, expirations and cascades, falling
+     within the interval between "lasttime" and "now".*/
+  while (true) {
+    ch_delta_list_t *hdrp, fired;
+    unsigned lvl, slot;
+#if CH_CFG_ST_TIMEDELTA > 0
+    systime_t lasttime;
+#endif
+
+    /* Delta between current time and last execution time.*/
+    now = chVTGetSystemTimeX();
+    nowdelta = chTimeDiffX(vtlp->lasttime, now);
+
+    /* Loop break conditions, empty wheel or next event in the future.*/
+    if (wp->summary == 0U) {
+      break;
+    }
+    next = __vt_wheel_next(wp, &lvl, &slot);
+    if (nowdelta < next) {
+      break;
+    }
+
+    /* The wheel base time is moved to the event time.*/
+    wp->base += next;
+    vtlp->lasttime = chTimeAddX(vtlp->lasttime, next);
+#if CH_CFG_ST_TIMEDELTA > 0
+    lasttime = vtlp->lasttime;
+#endif
+
+    /* The slot is going to be emptied.*/
+    hdrp = &wp->slots[lvl][slot];
+    vt_wheel_clear(wp, lvl, slot);
+
+    if (lvl > 0U) {
+      /* Cascade, the slot timers are placed again relative to the new
+         base time, they go in the lower levels.*/
+      while (ch_dlist_notempty(hdrp)) {
+        vt_wheel_insert(wp, (virtual_timer_t *)ch_dlist_remove_first(hdrp));
+      }
+      continue;
+    }
+
+    /* Expiration, the slot timers are moved in a local list because
+       callbacks could re-arm timers in the same slot after a base time
+       change.*/
+    fired.next       = hdrp->next;
+    fired.prev       = hdrp->prev;
+    fired.next->prev = &fired;
+    fired.prev->next = &fired;
+    ch_dlist_init(hdrp);
+
+#if CH_CFG_ST_TIMEDELTA > 0
+    /* If the wheel becomes empty then the alarm is disabled.*/
+    if (wp->summary == 0U) {
+      port_timer_stop_alarm();
+    }
+#endif
+
+    while (ch_dlist_notempty(&fired)) {
+      virtual_timer_t *vtp;
+
+      /* Removing the timer from the list, marking it as not armed.*/
+      vtp = (virtual_timer_t *)ch_dlist_remove_first(&fired);
+      vtp->dlist.next = NULL;
+
+      __stats_increase_vt_fired();
+
+      /* The callback is invoked outside the kernel critical section, it
+         is re-entered on the callback return. Note that "lasttime" can be
+         modified within the callback if some timer function is called.*/
+      chSysUnlockFromISR();
+
+      vtp->func(vtp, vtp->par);
+
+      chSysLockFromISR();
+
+      /* If a reload is defined the timer needs to be restarted.*/
+      if (unlikely(vtp->reload > (sysinterval_t)0)) {
+#if CH_CFG_ST_TIMEDELTA == 0
+        vt_enqueue(vtlp, vtp, vtp->reload);
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+        sysinterval_t delay;
+
+        /* Refreshing the now delta after spending time in the callback for
+           a more accurate detection of too fast reloads.*/
+        now = chVTGetSystemTimeX();
+        nowdelta = chTimeDiffX(lasttime, now);
+
+#if !defined(CH_VT_RFCU_DISABLED)
+        /* Checking if the required reload is feasible.*/
+        if (nowdelta > vtp->reload) {
+          /* System time is already past the deadline, logging the fault
+             and proceeding with a minimum delay.*/
+
+          chDbgAssert(false, "skipped deadline");
+          chRFCUCollectFaultsI(CH_RFCU_VT_SKIPPED_DEADLINE);
+
+          delay = (sysinterval_t)0;
+        }
+        else {
+          /* Enqueuing the timer again using the calculated delta.*/
+          delay = vtp->reload - nowdelta;
+        }
+#else
+        /* Assertions as fallback.*/
+        chDbgAssert(nowdelta <= vtp->reload, "skipped deadline");
+
+        /* Enqueuing the timer again using the calculated delta.*/
+        delay = vtp->reload - nowdelta;
+#endif
+
+        vt_enqueue(vtlp, vtp, delay);
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+      }
+    }
+  }
+
+  /* The "unprocessed nowdelta" time slice is added to the wheel base time,
+     no events fall within it.*/
+  wp->base += nowdelta;
+  vtlp->lasttime = now;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  /* Update alarm time to next wheel event.*/
+  if (wp->summary != 0U) {
+    vt_set_alarm(vtlp, now, next - nowdelta);
+  }
+#endif
+}
+#endif /* CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL */
 
 #if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
 /**
@@ -102,6 +102,8 @@ typedef struct {
  */
 typedef struct elf_load_context {
   vfs_file_node_c           *fnp;
+  const uint8_t             *image;
+  size_t                    image_size;
   const memory_area_t       *map;
 //  uint32_t                  entry;
   elf_secnum_t              sections_num;
@@ -187,6 +189,29 @@ static msg_t vfs_read_exact(vfs_file_node_c *fnp, void *buf, size_t size) {
   return CH_RET_SUCCESS;
 }
 
+static msg_t read_at(elf_load_context_t *ctxp, vfs_offset_t offset,
+                     void *buf, size_t size) {
+  msg_t ret;
+
+  /* Mapped files are accessed directly.*/
+  if (ctxp->image != NULL) {
+    if ((offset < (vfs_offset_t)0) ||
+        ((uint64_t)offset > (uint64_t)ctxp->image_size) ||
+        (size > (ctxp->image_size - (size_t)offset))) {
+      return CH_RET_ENOEXEC;
+    }
+
+    memcpy(buf, &ctxp->image[offset], size);
+
+    return CH_RET_SUCCESS;
+  }
+
+  ret = vfsSetFilePosition(ctxp->fnp, offset, VFS_SEEK_SET);
+  CH_RETURN_ON_ERROR(ret);
+
+  return vfs_read_exact(ctxp->fnp, buf, size);
+}
+
 static msg_t area_is_intersecting(elf_load_context_t *ctxp,
                                  const memory_area_t *map) {
   elf_section_info_t *esip;
@@ -294,9 +319,8 @@ static msg_t allocate_load_section(elf_load_context_t *ctxp,
   }
 
   /* Loading section data.*/
-  ret = vfsSetFilePosition(ctxp->fnp, (vfs_offset_t)shp->sh_offset, VFS_SEEK_SET);
-  CH_RETURN_ON_ERROR(ret);
-  ret = vfs_read_exact(ctxp->fnp, (void *)esip->area.base, esip->area.size);
+  ret = read_at(ctxp, (vfs_offset_t)shp->sh_offset,
+                (void *)esip->area.base, esip->area.size);
   CH_RETURN_ON_ERROR(ret);
 
   ctxp->next++;
@@ -431,6 +455,30 @@ static msg_t reloc_section(elf_load_context_t *ctxp,
     return CH_RET_ENOEXEC;
   }
 
+  /* Mapped files are scanned in place, entries are copied because the
+     image alignment is unknown.*/
+  if (ctxp->image != NULL) {
+    ret = CH_RET_SUCCESS;
+    for (done_size = 0U; done_size < esip->rel_size;
+         done_size += sizeof (elf32_rel_t)) {
+      elf32_rel_t rel;
+
+      ret = read_at(ctxp, esip->rel_off + (vfs_offset_t)done_size,
+                    (void *)&rel, sizeof (elf32_rel_t));
+      CH_BREAK_ON_ERROR(ret);
+      ret = reloc_entry(ctxp, esip, &rel);
+      CH_BREAK_ON_ERROR(ret);
+    }
+    CH_RETURN_ON_ERROR(ret);
+
+    /* A MOVW must be paired with a MOVT.*/
+    if (ctxp->rel_movw_found) {
+      return CH_RET_ENOEXEC;
+    }
+
+    return CH_RET_SUCCESS;
+  }
+
   shbuf = vfs_buffer_take_wait();
   rbuf = (elf32_rel_t *)(void *)shbuf->buf;
 
@@ -479,13 +527,8 @@ static msg_t reloc_section(elf_load_context_t *ctxp,
   return ret;
 }
 
-/*===========================================================================*/
-/* Module exported functions.                                                */
-/*===========================================================================*/
-
-msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
+static msg_t load_elf(elf_load_context_t *ctxp) {
   msg_t ret;
-  elf_load_context_t ctx;
   elf_section_info_t *esip;
 
   /* Large structures not used at same time, the compiler could optimize it
@@ -496,20 +539,10 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
     elf32_section_header_t sh;
   } u;
 
-  /* Load context initialization.*/
+  /* Main header.*/
   {
-    /* Context fully cleared.*/
-    memset((void *)&ctx, 0, sizeof (elf_load_context_t));
-
-    /* Initializing the fixed part of the context.*/
-    ctx.fnp  = fnp;
-    ctx.map  = map;
-    ctx.next = &ctx.allocated[0];
-
     /* Reading the main ELF header.*/
-    ret = vfsSetFilePosition(ctx.fnp, (vfs_offset_t)0, VFS_SEEK_SET);
-    CH_RETURN_ON_ERROR(ret);
-    ret = vfs_read_exact(ctx.fnp, (void *)&u.h, sizeof (elf32_header_t));
+    ret = read_at(ctxp, (vfs_offset_t)0, (void *)&u.h, sizeof (elf32_header_t));
     CH_RETURN_ON_ERROR(ret);
 
     /* Checking for the expected header.*/
@@ -530,24 +563,22 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
     }
 
     /* Storing info required later.*/
-//    ctx.entry        = u.h.e_entry;
-    ctx.sections_num = (unsigned)u.h.e_shnum;
-    ctx.sections_off = (vfs_offset_t)u.h.e_shoff;
+//    ctxp->entry        = u.h.e_entry;
+    ctxp->sections_num = (unsigned)u.h.e_shnum;
+    ctxp->sections_off = (vfs_offset_t)u.h.e_shoff;
   }
 
   /* Loading phase, scanning section headers.*/
   {
     elf_secnum_t i;
 
-    for (i = 0U; i < ctx.sections_num; i++) {
+    for (i = 0U; i < ctxp->sections_num; i++) {
 
       /* Reading the header.*/
-      ret = vfsSetFilePosition(ctx.fnp,
-                               ctx.sections_off + ((vfs_offset_t)i *
-                                                   (vfs_offset_t)sizeof (elf32_section_header_t)),
-                               VFS_SEEK_SET);
-      CH_RETURN_ON_ERROR(ret);
-      ret = vfs_read_exact(ctx.fnp, (void *)&u.sh, sizeof (elf32_section_header_t));
+      ret = read_at(ctxp,
+                    ctxp->sections_off + ((vfs_offset_t)i *
+                                          (vfs_offset_t)sizeof (elf32_section_header_t)),
+                    (void *)&u.sh, sizeof (elf32_section_header_t));
       CH_RETURN_ON_ERROR(ret);
 
       /* Empty sections are not processed.*/
@@ -562,7 +593,7 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
         if ((u.sh.sh_flags & SHF_ALLOC) != 0U) {
 
           /* Allocating and loading, could fail.*/
-          ret = allocate_load_section(&ctx, i, &u.sh);
+          ret = allocate_load_section(ctxp, i, &u.sh);
           CH_RETURN_ON_ERROR(ret);
         }
         break;
@@ -571,7 +602,7 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
         /* Uninitialized data section, we can have more than one, just checking
            address ranges.*/
         if ((u.sh.sh_flags & SHF_ALLOC) != 0U) {
-          ret = allocate_section(&ctx, i, &u.sh);
+          ret = allocate_section(ctxp, i, &u.sh);
           CH_RETURN_ON_ERROR(ret);
         }
         break;
@@ -579,7 +610,7 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
       case SHT_REL:
         if ((u.sh.sh_flags & SHF_INFO_LINK) != 0U) {
 
-          esip = find_allocated_section(&ctx, (elf_secnum_t)u.sh.sh_info);
+          esip = find_allocated_section(ctxp, (elf_secnum_t)u.sh.sh_info);
           if (esip == NULL) {
             /* Ignoring other relocation sections.*/
             break;
@@ -603,9 +634,9 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
   }
 
   /* Relocating all sections with an associated relocation table.*/
-  for (esip = &ctx.allocated[0]; esip < ctx.next; esip++) {
+  for (esip = &ctxp->allocated[0]; esip < ctxp->next; esip++) {
     if (esip->rel_off != (vfs_offset_t)0) {
-      ret = reloc_section(&ctx, esip);
+      ret = reloc_section(ctxp, esip);
       CH_RETURN_ON_ERROR(ret);
     }
   }
@@ -613,6 +644,40 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
   return ret;
 }
 
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
+  elf_load_context_t ctx;
+  bool mapped;
+  msg_t ret;
+
+  /* Context fully cleared.*/
+  memset((void *)&ctx, 0, sizeof (elf_load_context_t));
+
+  /* Initializing the fixed part of the context.*/
+  ctx.fnp  = fnp;
+  ctx.map  = map;
+  ctx.next = &ctx.allocated[0];
+
+  /* Files that can be mapped in memory are parsed in place, without
+     seeking and reading through the file system.*/
+  ret = vfsMapFile(fnp, &ctx.image, &ctx.image_size);
+  mapped = !CH_RET_IS_ERROR(ret);
+  if (!mapped) {
+    ctx.image = NULL;
+  }
+
+  ret = load_elf(&ctx);
+
+  if (mapped) {
+    (void) vfsUnmapFile(fnp);
+  }
+
+  return ret;
+}
+
 msg_t sbElfLoadFile(vfs_driver_c *drvp,
                     const char *path,
                     const memory_area_t *map) {
@@ -10,6 +10,22 @@
 #include "ff.h"
 #include "diskio.h"
 
+/*
+ * When FATFS_USE_BLOCK_CACHE is TRUE then FATFS_HAL_DEVICE is a
+ * BlockCacheDriver layered by the application on top of the SDC or MMC
+ * driver, FatFs sector accesses are then served through the cache.
+ */
+#if !defined(FATFS_USE_BLOCK_CACHE)
+#define FATFS_USE_BLOCK_CACHE FALSE
+#endif
+
+#if FATFS_USE_BLOCK_CACHE
+#include "hal_block_cache.h"
+#if !defined(FATFS_HAL_DEVICE)
+#error "FATFS_USE_BLOCK_CACHE requires FATFS_HAL_DEVICE"
+#endif
+#endif
+
 #if !defined(FATFS_HAL_DEVICE)
 #if HAL_USE_SDC
 #define FATFS_HAL_DEVICE SDCD1
@@ -18,7 +34,9 @@
 #endif
 #endif
 
-#if HAL_USE_MMC_SPI
+#if FATFS_USE_BLOCK_CACHE
+extern BlockCacheDriver FATFS_HAL_DEVICE;
+#elif HAL_USE_MMC_SPI
 extern MMCDriver FATFS_HAL_DEVICE;
 #elif HAL_USE_SDC
 extern SDCDriver FATFS_HAL_DEVICE;
@@ -147,6 +165,12 @@ DRESULT disk_ioctl (
   case 0:
     switch (cmd) {
     case CTRL_SYNC:
+#if FATFS_USE_BLOCK_CACHE
+      /* Writes back the cached sectors.*/
+      if (blkSync(&FATFS_HAL_DEVICE)) {
+        return RES_ERROR;
+      }
+#endif
       return RES_OK;
     case GET_SECTOR_COUNT:
       if (blkGetInfo(&FATFS_HAL_DEVICE, &bdi)) {
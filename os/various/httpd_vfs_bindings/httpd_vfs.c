@@ -107,6 +107,8 @@ void httpd_vfs_init(void) {
 int fs_open_custom(struct fs_file *file, const char *name) {
   vfs_file_node_c *vfnp;
   vfs_stat_t statbuf;
+  const uint8_t *data;
+  size_t size;
   char path[VFS_CFG_PATHLEN_MAX + 1U];
   msg_t ret;
 
@@ -128,10 +130,26 @@ int fs_open_custom(struct fs_file *file, const char *name) {
     return 0;
   }
 
+  file->pextension = (fs_file_extension *)vfnp;
+
+  /* Files that can be mapped in memory are served directly by the server
+     without reading them into its buffers, empty files are read normally
+     because a NULL data pointer marks unmapped files.*/
+  ret = vfsMapFile(vfnp, &data, &size);
+  if (!CH_RET_IS_ERROR(ret)) {
+    if (data != NULL) {
+      file->data = (const char *)data;
+      file->len = (int)size;
+      file->index = (int)size;
+
+      return 1;
+    }
+    (void) vfsUnmapFile(vfnp);
+  }
+
   file->data = NULL;
   file->len = (int)statbuf.size;
   file->index = 0;
-  file->pextension = (fs_file_extension *)vfnp;
 
   return 1;
 }
@@ -139,6 +157,9 @@ int fs_open_custom(struct fs_file *file, const char *name) {
 void fs_close_custom(struct fs_file *file) {
 
   if ((file != NULL) && (file->pextension != NULL)) {
+    if (file->data != NULL) {
+      (void) vfsUnmapFile((vfs_file_node_c *)file->pextension);
+    }
     vfsClose((vfs_node_c *)file->pextension);
     file->pextension = NULL;
   }
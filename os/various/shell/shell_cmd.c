@@ -190,6 +190,47 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_CRIT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void crit_print(BaseSequentialStream *chp, const char *name,
+                       const crit_profile_t *cpp) {
+  unsigned i;
+
+  chprintf(chp, "%s critical zones" SHELL_NEWLINE_STR, name);
+  for (i = 0U; i < (unsigned)CH_STATS_CRIT_BUCKETS; i++) {
+    if (cpp->hist[i] > (ucnt_t)0) {
+      chprintf(chp, "  <2^%-2u cycles: %lu" SHELL_NEWLINE_STR,
+               i, (unsigned long)cpp->hist[i]);
+    }
+  }
+  chprintf(chp, "  site         cycles" SHELL_NEWLINE_STR);
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_TOP; i++) {
+    if (cpp->top[i].worst > (rtcnt_t)0) {
+      chprintf(chp, "  %08lx %10lu" SHELL_NEWLINE_STR,
+               (unsigned long)(uintptr_t)cpp->top[i].site,
+               (unsigned long)cpp->top[i].worst);
+    }
+  }
+}
+
+static void cmd_crit(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static crit_profile_t thd, isr;
+
+  if (argc == 1) {
+    if (!strcmp(argv[0], "reset")) {
+      chStatsResetCritProfiles();
+      return;
+    }
+  }
+  if (argc != 0) {
+    shellUsage(chp, "crit [reset]");
+    return;
+  }
+  chStatsGetCritProfiles(&thd, &isr);
+  crit_print(chp, "thread", &thd);
+  crit_print(chp, "ISR", &isr);
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -528,6 +569,9 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads",   cmd_threads},
 #endif
+#if SHELL_CMD_CRIT_ENABLED == TRUE
+  {"crit",      cmd_crit},
+#endif
 #if SHELL_CMD_FILES_ENABLED == TRUE
   {"cat",       cmd_cat},
   {"cd",        cmd_cd},
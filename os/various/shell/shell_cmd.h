@@ -65,6 +65,10 @@
 #define SHELL_CMD_FILES_ENABLED             FALSE
 #endif
 
+#if !defined(SHELL_CMD_CRIT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_CRIT_ENABLED              FALSE
+#endif
+
 #if !defined(SHELL_CMD_TEST_WA_SIZE) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_WA_SIZE              THD_WORKING_AREA_SIZE(512)
 #endif
@@ -89,6 +93,14 @@
 #error "SHELL_CMD_FILES_ENABLED requires CH_CFG_USE_HEAP"
 #endif
 
+#if SHELL_CMD_CRIT_ENABLED == TRUE
+#if defined(__CHIBIOS_NIL__) || (CH_DBG_STATISTICS == FALSE)
+#error "SHELL_CMD_CRIT_ENABLED requires CH_DBG_STATISTICS_CRIT_SITES"
+#elif CH_DBG_STATISTICS_CRIT_SITES == FALSE
+#error "SHELL_CMD_CRIT_ENABLED requires CH_DBG_STATISTICS_CRIT_SITES"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
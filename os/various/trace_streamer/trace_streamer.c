@@ -0,0 +1,138 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_streamer.c
+ * @brief   Trace streamer code.
+ * @details The streamer thread writes on the configured stream a 16 bytes
+ *          header followed by the trace stream records, all in the target
+ *          byte order:
+ *          - <tt>"CHTR"</tt> magic.
+ *          - Format version, 8 bits.
+ *          - Record size, 8 bits.
+ *          - Byte order mark @p TRS_HEADER_BOM, 16 bits.
+ *          - Time stamps frequency, 32 bits.
+ *          - System tick frequency, 32 bits.
+ *          .
+ *          Name records are followed by the name characters, their number
+ *          is written in the @p arg2 field of the record.
+ *
+ * @addtogroup TRACE_STREAMER
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "trace_streamer.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void trs_write_header(const trace_streamer_config_t *cfg) {
+  uint8_t hdr[16];
+  uint16_t bom = (uint16_t)TRS_HEADER_BOM;
+  uint32_t stfreq = (uint32_t)CH_CFG_ST_FREQUENCY;
+
+  memcpy(&hdr[0], TRS_HEADER_MAGIC, 4U);
+  hdr[4] = (uint8_t)TRS_HEADER_VERSION;
+  hdr[5] = (uint8_t)sizeof (trace_record_t);
+  memcpy(&hdr[6], &bom, sizeof (bom));
+  memcpy(&hdr[8], &cfg->frequency, sizeof (cfg->frequency));
+  memcpy(&hdr[12], &stfreq, sizeof (stfreq));
+  streamWrite(cfg->stream, hdr, sizeof (hdr));
+}
+
+static void trs_write_records(const trace_streamer_config_t *cfg,
+                              const trace_record_t *rp, size_t n) {
+
+  if (n > 0U) {
+    streamWrite(cfg->stream, (const uint8_t *)rp, n * sizeof (trace_record_t));
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace streamer thread function.
+ * @details The thread fetches batches of records from the kernel trace
+ *          stream and writes them on the configured stream, when the trace
+ *          stream is empty the thread sleeps for the configured period.
+ * @note    The thread is meant to run at low priority, events produced
+ *          while it is not able to keep up are dropped by the kernel and
+ *          reported in the stream by @p CH_TRACE_TYPE_LOST records.
+ * @note    The thread activity is traced as well.
+ *
+ * @param[in] p         pointer to a @p trace_streamer_config_t object
+ */
+THD_FUNCTION(trsThread, p) {
+  const trace_streamer_config_t *cfg = p;
+  trace_record_t buf[TRS_CFG_BATCH_SIZE];
+
+  chRegSetThreadName(TRS_THREAD_NAME);
+
+  trs_write_header(cfg);
+  while (!chThdShouldTerminateX()) {
+    size_t i, first, n;
+
+    n = chTraceStreamRead(buf, (size_t)TRS_CFG_BATCH_SIZE);
+    if (n == 0U) {
+      chThdSleep(cfg->period);
+      continue;
+    }
+
+    /* Name records are followed by the name itself, the other records
+       are written in runs.*/
+    first = 0U;
+    for (i = 0U; i < n; i++) {
+      if (buf[i].type == (uint8_t)CH_TRACE_TYPE_NAME) {
+        const char *name = chTraceStreamGetName(buf[i].id);
+        size_t len = name == NULL ? 0U : strlen(name);
+
+        trs_write_records(cfg, &buf[first], i - first);
+        buf[i].arg2 = (uint32_t)len;
+        trs_write_records(cfg, &buf[i], 1U);
+        if (len > 0U) {
+          streamWrite(cfg->stream, (const uint8_t *)name, len);
+        }
+        first = i + 1U;
+      }
+    }
+    trs_write_records(cfg, &buf[first], n - first);
+  }
+}
+
+/** @} */
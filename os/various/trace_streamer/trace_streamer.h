@@ -0,0 +1,114 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_streamer.h
+ * @brief   Trace streamer header.
+ *
+ * @addtogroup TRACE_STREAMER
+ * @{
+ */
+
+#ifndef TRACE_STREAMER_H
+#define TRACE_STREAMER_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Stream header
+ * @{
+ */
+#define TRS_HEADER_MAGIC                    "CHTR"
+#define TRS_HEADER_VERSION                  1U
+#define TRS_HEADER_BOM                      0x0102U
+/** @} */
+
+/**
+ * @brief   Trace streamer thread name.
+ */
+#define TRS_THREAD_NAME                     "trace"
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of records fetched from the trace stream at once.
+ * @note    The records are fetched from within a critical zone, the
+ *          buffer is allocated on the streamer thread stack.
+ */
+#if !defined(TRS_CFG_BATCH_SIZE) || defined(__DOXYGEN__)
+#define TRS_CFG_BATCH_SIZE                  16
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED
+#error "trace streamer requires CH_DBG_TRACE_MASK"
+#endif
+
+#if CH_DBG_TRACE_STREAM == FALSE
+#error "trace streamer requires CH_DBG_TRACE_STREAM"
+#endif
+
+#if TRS_CFG_BATCH_SIZE < 1
+#error "invalid TRS_CFG_BATCH_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace streamer configuration.
+ */
+typedef struct {
+  BaseSequentialStream  *stream;            /**< @brief Output stream.      */
+  uint32_t              frequency;          /**< @brief Time stamps
+                                                 frequency, written in the
+                                                 stream header.             */
+  sysinterval_t         period;             /**< @brief Polling period when
+                                                 the trace stream is
+                                                 empty.                     */
+} trace_streamer_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  THD_FUNCTION(trsThread, p);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* TRACE_STREAMER_H */
+
+/** @} */
@@ -0,0 +1,8 @@
+# Trace streamer files.
+TRSSRC = $(CHIBIOS)/os/various/trace_streamer/trace_streamer.c
+
+TRSINC = $(CHIBIOS)/os/various/trace_streamer
+
+# Shared variables
+ALLCSRC += $(TRSSRC)
+ALLINC  += $(TRSINC)
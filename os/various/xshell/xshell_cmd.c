@@ -337,6 +337,49 @@ static void cmd_threads(xshell_t *xshp, int argc, char *argv[], char *envp[]) {
 }
 #endif
 
+#if (XSHELL_CMD_CRIT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void crit_print(xshell_t *xshp, const char *name,
+                       const crit_profile_t *cpp) {
+  unsigned i;
+
+  chprintf(xshp->stream, "%s critical zones" XSHELL_NEWLINE_STR, name);
+  for (i = 0U; i < (unsigned)CH_STATS_CRIT_BUCKETS; i++) {
+    if (cpp->hist[i] > (ucnt_t)0) {
+      chprintf(xshp->stream, "  <2^%-2u cycles: %lu" XSHELL_NEWLINE_STR,
+               i, (unsigned long)cpp->hist[i]);
+    }
+  }
+  chprintf(xshp->stream, "  site         cycles" XSHELL_NEWLINE_STR);
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_TOP; i++) {
+    if (cpp->top[i].worst > (rtcnt_t)0) {
+      chprintf(xshp->stream, "  %08" PRIxPTR " %10lu" XSHELL_NEWLINE_STR,
+               (uintptr_t)cpp->top[i].site,
+               (unsigned long)cpp->top[i].worst);
+    }
+  }
+}
+
+static void cmd_crit(xshell_t *xshp, int argc, char *argv[], char *envp[]) {
+  static crit_profile_t thd, isr;
+
+  (void)envp;
+
+  if (argc == 2) {
+    if (!strcmp(argv[1], "reset")) {
+      chStatsResetCritProfiles();
+      return;
+    }
+  }
+  if (argc != 1) {
+    xshellUsage(xshp, "[reset]");
+    return;
+  }
+  chStatsGetCritProfiles(&thd, &isr);
+  crit_print(xshp, "thread", &thd);
+  crit_print(xshp, "ISR", &isr);
+}
+#endif
+
 #if (XSHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static void cmd_test(xshell_t *xshp, int argc, char *argv[], char *envp[]) {
 
@@ -852,6 +895,9 @@ const xshell_command_t xshell_local_commands[] = {
 #if XSHELL_CMD_THREADS_ENABLED == TRUE
   {"threads",   cmd_threads},
 #endif
+#if XSHELL_CMD_CRIT_ENABLED == TRUE
+  {"crit",      cmd_crit},
+#endif
 #if XSHELL_CMD_FILES_ENABLED == TRUE
   {"cat",       cmd_cat},
   {"cd",        cmd_cd},
@@ -61,6 +61,10 @@
 #define XSHELL_CMD_TEST_ENABLED             TRUE
 #endif
 
+#if !defined(XSHELL_CMD_CRIT_ENABLED) || defined(__DOXYGEN__)
+#define XSHELL_CMD_CRIT_ENABLED             FALSE
+#endif
+
 #if !defined(XSHELL_CMD_FILES_ENABLED) || defined(__DOXYGEN__)
 #define XSHELL_CMD_FILES_ENABLED            FALSE
 #endif
@@ -97,6 +101,14 @@
 #error "XSHELL_CMD_FILES_ENABLED requires CH_CFG_USE_HEAP"
 #endif
 
+#if XSHELL_CMD_CRIT_ENABLED == TRUE
+#if defined(__CHIBIOS_NIL__) || (CH_DBG_STATISTICS == FALSE)
+#error "XSHELL_CMD_CRIT_ENABLED requires CH_DBG_STATISTICS_CRIT_SITES"
+#elif CH_DBG_STATISTICS_CRIT_SITES == FALSE
+#error "XSHELL_CMD_CRIT_ENABLED requires CH_DBG_STATISTICS_CRIT_SITES"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -139,6 +139,9 @@ struct vfs_littlefs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   random_stream_i * (*getstream)(void *ip);
+  msg_t (*map)(void *ip, const uint8_t **bufp, size_t *np);
+  msg_t (*unmap)(void *ip);
+  msg_t (*sync)(void *ip);
   /* From vfs_littlefs_file_node_c.*/
 };
 
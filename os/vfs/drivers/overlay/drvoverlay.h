@@ -188,7 +188,18 @@ struct vfs_overlay_driver {
   unsigned                  next_driver;
   const char                *names[DRV_CFG_OVERLAY_DRV_MAX];
   vfs_driver_c              *drivers[DRV_CFG_OVERLAY_DRV_MAX];
-  char                      buf[VFS_CFG_PATHLEN_MAX + 1];
+  /**
+   * @brief       Mutex protecting the driver path buffers.
+   * @note        The mutex is held for the whole overlaid driver call,
+   *              renames and operations adding the prefix to paths in
+   *              caller memory are serialized on each overlay instance.
+   */
+  mutex_t                   mtx;
+  /**
+   * @brief       Driver path buffers, used for adding the prefix to paths
+   *              in caller memory and for renames.
+   */
+  vfs_shared_buffer_t       bufs[2];
 };
 /** @} */
 
@@ -145,6 +145,9 @@ struct vfs_rom_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   random_stream_i * (*getstream)(void *ip);
+  msg_t (*map)(void *ip, const uint8_t **bufp, size_t *np);
+  msg_t (*unmap)(void *ip);
+  msg_t (*sync)(void *ip);
   /* From vfs_rom_file_node_c.*/
 };
 
@@ -191,6 +194,28 @@ struct vfs_rom_file_node {
 };
 /** @} */
 
+/**
+ * @brief       Decompressed chunks cache entry.
+ */
+struct vfs_rom_chunk_cache_entry {
+  /**
+   * @brief       Descriptor of the cached chunk, @p NULL if unused.
+   */
+  const vfs_romfs_chunked_desc_t *desc;
+  /**
+   * @brief       Index of the cached chunk.
+   */
+  size_t                    index;
+  /**
+   * @brief       Last access stamp.
+   */
+  uint32_t                  stamp;
+  /**
+   * @brief       Decompressed chunk data.
+   */
+  uint8_t                   data[DRV_CFG_ROM_CHUNK_CACHE_SIZE];
+};
+
 /**
  * @brief       Global state of @p vfs_rom_driver_c.
  */
@@ -211,6 +236,20 @@ struct vfs_rom_driver_static_struct {
    * @brief       Static storage of file nodes.
    */
   vfs_rom_file_node_c       file_nodes[DRV_CFG_ROM_FILE_NODES_NUM];
+#if (DRV_CFG_ROM_ENABLE_COMPRESSION == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief       Mutex protecting the decompressed chunks cache.
+   */
+  mutex_t                   chunks_mtx;
+  /**
+   * @brief       Chunks cache access counter.
+   */
+  uint32_t                  chunks_stamp;
+  /**
+   * @brief       Decompressed chunks cache entries.
+   */
+  struct vfs_rom_chunk_cache_entry chunks[DRV_CFG_ROM_CHUNK_CACHE_NUM];
+#endif /* DRV_CFG_ROM_ENABLE_COMPRESSION == TRUE */
 };
 
 /*===========================================================================*/
@@ -49,6 +49,24 @@
 #define DRV_CFG_ROM_ENABLE_COMPRESSION     FALSE
 #endif
 
+/**
+ * @brief       Number of decompressed chunks cached by the ROMFS drivers.
+ * @details     The cache is shared by all ROMFS drivers, sequential and
+ *              repeated partial reads of a chunk decode it only once.
+ */
+#if !defined(DRV_CFG_ROM_CHUNK_CACHE_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_ROM_CHUNK_CACHE_NUM        2
+#endif
+
+/**
+ * @brief       Size of each decompressed chunks cache buffer.
+ * @note        Chunks of LZ4 files must fit in this size, PackBits
+ *              chunks exceeding it are decoded without caching.
+ */
+#if !defined(DRV_CFG_ROM_CHUNK_CACHE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_ROM_CHUNK_CACHE_SIZE       1024
+#endif
+
 /**
  * @brief       Number of directory nodes pre-allocated in the pool.
  */
@@ -84,6 +102,20 @@
 #error "invalid DRV_CFG_ROM_ENABLE_COMPRESSION value"
 #endif
 
+/* Checks on DRV_CFG_ROM_CHUNK_CACHE_NUM configuration.*/
+#if DRV_CFG_ROM_CHUNK_CACHE_NUM < 1
+#error "invalid DRV_CFG_ROM_CHUNK_CACHE_NUM value"
+#endif
+
+/* Checks on DRV_CFG_ROM_CHUNK_CACHE_SIZE configuration.*/
+#if DRV_CFG_ROM_CHUNK_CACHE_SIZE < 1
+#error "invalid DRV_CFG_ROM_CHUNK_CACHE_SIZE value"
+#endif
+
+#if (DRV_CFG_ROM_ENABLE_COMPRESSION == TRUE) && (CH_CFG_USE_MUTEXES == FALSE)
+#error "ROMFS compression requires CH_CFG_USE_MUTEXES"
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -110,6 +142,20 @@
 #define VFS_ROMFS_FILE_TYPE_COMPRESSED     (2U << 0)
 /** @} */
 
+/**
+ * @name    ROMFS tree flags
+ * @{
+ */
+/**
+ * @brief       The tree is indexed for binary search lookups.
+ * @details     Directories are sorted by path comparing separators lower
+ *              than any other character, so each subtree is contiguous,
+ *              the root directory is the first one. Files are sorted by
+ *              name and the @p next field of directories is valid.
+ */
+#define VFS_ROMFS_TREE_INDEXED             (1U << 0)
+/** @} */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -200,6 +246,11 @@ struct vfs_romfs_dir_desc {
   const char                    *path;
   const vfs_romfs_file_desc_t   *files;
   size_t                        files_num;
+  /**
+   * @brief       Index of the first directory after this directory
+   *              subtree, only used in indexed trees.
+   */
+  size_t                        next;
 };
 
 /**
@@ -208,6 +259,10 @@ struct vfs_romfs_dir_desc {
 struct vfs_romfs_tree {
   const vfs_romfs_dir_desc_t    *dirs;
   size_t                        dirs_num;
+  /**
+   * @brief       Tree flags.
+   */
+  uint32_t                      flags;
 };
 
 /**
@@ -265,6 +320,7 @@ struct vfs_rom_driver {
 extern struct vfs_rom_driver_static_struct vfs_rom_driver_static;
 extern const vfs_romfs_compressed_ops_t vfs_romfs_chunked_stored_ops;
 extern const vfs_romfs_compressed_ops_t vfs_romfs_chunked_packbits_ops;
+extern const vfs_romfs_compressed_ops_t vfs_romfs_chunked_lz4_ops;
 
 #ifdef __cplusplus
 extern "C" {
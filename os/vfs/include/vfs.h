@@ -88,6 +88,8 @@
 #include "vfsbuffers.h"
 #include "vfsnodes.h"
 #include "vfsdrivers.h"
+#include "vfsdcache.h"
+#include "vfsbuffered.h"
 
 /* File System drivers.*/
 #if VFS_CFG_ENABLE_DRV_OVERLAY == TRUE
@@ -153,6 +155,9 @@ extern "C" {
                            vfs_seekmode_t whence);
   vfs_offset_t vfsGetFilePosition(vfs_file_node_c *vfnp);
   random_stream_i *vfsGetFileStream(vfs_file_node_c *vfnp);
+  msg_t vfsMapFile(vfs_file_node_c *vfnp, const uint8_t **bufp, size_t *np);
+  msg_t vfsUnmapFile(vfs_file_node_c *vfnp);
+  msg_t vfsSyncFile(vfs_file_node_c *vfnp);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,115 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    vfs/include/vfsbuffered.h
+ * @brief   VFS header file.
+ * @details VFS buffered file nodes header file.
+ *
+ * @addtogroup VFS_BUFFERED
+ * @{
+ */
+
+#ifndef VFS_BUFFERED_H
+#define VFS_BUFFERED_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the buffered file nodes.
+ */
+#if !defined(VFS_CFG_ENABLE_BUFFERED_FILES) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_BUFFERED_FILES       FALSE
+#endif
+
+/**
+ * @brief   Number of buffered file nodes.
+ */
+#if !defined(VFS_CFG_BUFFERED_FILES_NUM) || defined(__DOXYGEN__)
+#define VFS_CFG_BUFFERED_FILES_NUM          2
+#endif
+
+/**
+ * @brief   Size of the buffer of each buffered file node.
+ * @note    Best performance is obtained using the sector size of the
+ *          underlying storage or a multiple of it, the buffer is kept
+ *          aligned to file offsets multiple of its size.
+ */
+#if !defined(VFS_CFG_BUFFERED_FILE_SIZE) || defined(__DOXYGEN__)
+#define VFS_CFG_BUFFERED_FILE_SIZE          512
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (VFS_CFG_ENABLE_BUFFERED_FILES != FALSE) &&                             \
+    (VFS_CFG_ENABLE_BUFFERED_FILES != TRUE)
+#error "invalid VFS_CFG_ENABLE_BUFFERED_FILES value"
+#endif
+
+#if VFS_CFG_ENABLE_BUFFERED_FILES == TRUE
+#if VFS_CFG_BUFFERED_FILES_NUM < 1
+#error "invalid VFS_CFG_BUFFERED_FILES_NUM value"
+#endif
+
+#if VFS_CFG_BUFFERED_FILE_SIZE < 1
+#error "invalid VFS_CFG_BUFFERED_FILE_SIZE value"
+#endif
+#endif
+
+#if (VFS_CFG_ENABLE_BUFFERED_FILES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void __vfs_buffered_init(void);
+  msg_t vfsBufferFile(vfs_file_node_c *vfnp, vfs_file_node_c **bfnpp);
+  msg_t vfsOpenBufferedFile(const char *path, int flags,
+                            vfs_file_node_c **vfnpp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* VFS_CFG_ENABLE_BUFFERED_FILES == TRUE */
+
+#endif /* VFS_BUFFERED_H */
+
+/** @} */
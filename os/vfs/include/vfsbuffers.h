@@ -71,6 +71,11 @@ extern "C" {
   vfs_shared_buffer_t *vfs_buffer_take_wait(void);
   vfs_shared_buffer_t *vfs_buffer_take_immediate(void);
   void vfs_buffer_release(vfs_shared_buffer_t *shbuf);
+  msg_t vfs_buffer_resolve_path(const char *cwd, const char *path,
+                                sysinterval_t timeout,
+                                vfs_shared_buffer_t **shbufp,
+                                const char **pathp);
+  void vfs_buffer_release_path(vfs_shared_buffer_t *shbuf);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,141 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    vfs/include/vfsdcache.h
+ * @brief   VFS header file.
+ * @details VFS directory entries cache header file.
+ *
+ * @addtogroup VFS_DCACHE
+ * @{
+ */
+
+#ifndef VFS_DCACHE_H
+#define VFS_DCACHE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the directory entries cache.
+ */
+#if !defined(VFS_CFG_ENABLE_DCACHE) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DCACHE               FALSE
+#endif
+
+/**
+ * @brief   Number of directory entries cache entries.
+ */
+#if !defined(VFS_CFG_DCACHE_ENTRIES) || defined(__DOXYGEN__)
+#define VFS_CFG_DCACHE_ENTRIES              32
+#endif
+
+/**
+ * @brief   Maximum length of cached paths.
+ */
+#if !defined(VFS_CFG_DCACHE_PATHLEN_MAX) || defined(__DOXYGEN__)
+#define VFS_CFG_DCACHE_PATHLEN_MAX          47
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (VFS_CFG_ENABLE_DCACHE != FALSE) && (VFS_CFG_ENABLE_DCACHE != TRUE)
+#error "invalid VFS_CFG_ENABLE_DCACHE value"
+#endif
+
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+#if VFS_CFG_DCACHE_ENTRIES < 1
+#error "invalid VFS_CFG_DCACHE_ENTRIES value"
+#endif
+
+#if (VFS_CFG_DCACHE_PATHLEN_MAX < 1) ||                                     \
+    (VFS_CFG_DCACHE_PATHLEN_MAX > VFS_CFG_PATHLEN_MAX)
+#error "invalid VFS_CFG_DCACHE_PATHLEN_MAX value"
+#endif
+
+#if CH_CFG_USE_MUTEXES == FALSE
+#error "VFS directory entries cache requires CH_CFG_USE_MUTEXES"
+#endif
+#endif
+
+#if (VFS_CFG_ENABLE_DCACHE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a directory entries cache statistics structure.
+ */
+typedef struct vfs_dcache_stats {
+  /**
+   * @brief   Lookups answered by the cache.
+   */
+  uint32_t              hits;
+  /**
+   * @brief   Lookups searched in the cache and forwarded to the drivers.
+   */
+  uint32_t              misses;
+  /**
+   * @brief   Entries dropped because of modifying operations.
+   */
+  uint32_t              invalidations;
+  /**
+   * @brief   Entries recycled because the cache was full.
+   */
+  uint32_t              evictions;
+} vfs_dcache_stats_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void __vfs_dcache_init(void);
+  bool vfs_dcache_lookup(vfs_driver_c *drvp, const char *path,
+                         uint32_t *genp);
+  void vfs_dcache_insert(vfs_driver_c *drvp, const char *path, uint32_t gen);
+  void vfs_dcache_invalidate(vfs_driver_c *drvp, const char *path);
+  void vfs_dcache_get_stats(vfs_dcache_stats_t *sp);
+  void vfs_dcache_reset_stats(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* VFS_CFG_ENABLE_DCACHE == TRUE */
+
+#endif /* VFS_DCACHE_H */
+
+/** @} */
@@ -289,6 +289,9 @@ struct vfs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   random_stream_i * (*getstream)(void *ip);
+  msg_t (*map)(void *ip, const uint8_t **bufp, size_t *np);
+  msg_t (*unmap)(void *ip);
+  msg_t (*sync)(void *ip);
 };
 
 /**
@@ -346,6 +349,9 @@ extern "C" {
                               vfs_seekmode_t whence);
   vfs_offset_t __vfsfile_getpos_impl(void *ip);
   random_stream_i *__vfsfile_getstream_impl(void *ip);
+  msg_t __vfsfile_map_impl(void *ip, const uint8_t **bufp, size_t *np);
+  msg_t __vfsfile_unmap_impl(void *ip);
+  msg_t __vfsfile_sync_impl(void *ip);
 #ifdef __cplusplus
 }
 #endif
@@ -497,6 +503,60 @@ static inline random_stream_i *vfsFileGetStream(void *ip) {
 
   return self->vmt->getstream(ip);
 }
+
+/**
+ * @brief       Maps the whole file content in memory.
+ * @details     Drivers storing files in contiguous readable memory return a
+ *              direct pointer to the file data, the file position is not
+ *              affected.
+ * @note        The mapping stays valid until @p vfsFileUnmap() is called, the
+ *              node must not be closed before.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[out]    bufp          Pointer to a variable receiving the file data
+ *                              pointer.
+ * @param[out]    np            Pointer to a variable receiving the file size.
+ * @return                      The operation result.
+ * @retval CH_RET_ENOSYS        If the node cannot be mapped.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t vfsFileMap(void *ip, const uint8_t **bufp, size_t *np) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->map(ip, bufp, np);
+}
+
+/**
+ * @brief       Releases a mapping obtained with @p vfsFileMap().
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t vfsFileUnmap(void *ip) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->unmap(ip);
+}
+
+/**
+ * @brief       Commits cached file data and metadata to the storage.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t vfsFileSync(void *ip) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->sync(ip);
+}
 /** @} */
 
 #endif /* VFSNODES_H */
@@ -46,6 +46,34 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (VFS_CFG_ENABLE_DCACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Caches the outcome of a lookup performed by the root driver.
+ * @note    Only non-existing nodes are cached.
+ * @note    A successful open with @p VO_CREAT could have created the node,
+ *          the path is invalidated, this discards negative entries
+ *          inserted by concurrent lookups.
+ *
+ * @param[in] path      Path of the node.
+ * @param[in] flags     Open flags, zero for lookups not creating nodes.
+ * @param[in] ret       Result of the driver operation.
+ * @param[in] gen       Generation returned by the cache lookup.
+ */
+static void dcache_update(const char *path, int flags, msg_t ret,
+                          uint32_t gen) {
+
+  if ((ret == CH_RET_SUCCESS) && ((flags & VO_CREAT) != 0)) {
+    vfs_dcache_invalidate(vfs_root, path);
+  }
+  else if (ret == CH_RET_ENOENT) {
+    vfs_dcache_insert(vfs_root, path, gen);
+  }
+  else {
+    /* Existing nodes and other errors are not cached.*/
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -60,6 +88,16 @@ void vfsInit(void) {
   /* Shared buffers manager initialization.*/
   __vfs_buffers_init();
 
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  /* Directory entries cache initialization.*/
+  __vfs_dcache_init();
+#endif
+
+#if VFS_CFG_ENABLE_BUFFERED_FILES == TRUE
+  /* Buffered file nodes initialization.*/
+  __vfs_buffered_init();
+#endif
+
 #if VFS_CFG_ENABLE_DRV_OVERLAY == TRUE
   __drv_overlay_init();
 #endif
@@ -122,8 +160,21 @@ msg_t vfsGetCurrentDirectory(char *buf, size_t size) {
  * @api
  */
 msg_t vfsStat(const char *path, vfs_stat_t *sp) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  uint32_t gen;
+  msg_t ret;
 
+  if (vfs_dcache_lookup(vfs_root, path, &gen)) {
+    return CH_RET_ENOENT;
+  }
+
+  ret = vfsDrvStat(vfs_root, path, sp);
+  dcache_update(path, 0, ret, gen);
+
+  return ret;
+#else
   return vfsDrvStat(vfs_root, path, sp);
+#endif
 }
 
 /**
@@ -138,8 +189,21 @@ msg_t vfsStat(const char *path, vfs_stat_t *sp) {
  * @api
  */
 msg_t vfsOpen(const char *path, int flags, vfs_node_c **vnpp) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  uint32_t gen;
+  msg_t ret;
+
+  if (vfs_dcache_lookup(vfs_root, path, &gen) && ((flags & VO_CREAT) == 0)) {
+    return CH_RET_ENOENT;
+  }
 
+  ret = vfsDrvOpen(vfs_root, path, flags, vnpp);
+  dcache_update(path, flags, ret, gen);
+
+  return ret;
+#else
   return vfsDrvOpen(vfs_root, path, flags, vnpp);
+#endif
 }
 
 /**
@@ -153,8 +217,21 @@ msg_t vfsOpen(const char *path, int flags, vfs_node_c **vnpp) {
  * @api
  */
 msg_t vfsOpenDirectory(const char *path, vfs_directory_node_c **vdnpp) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  uint32_t gen;
+  msg_t ret;
+
+  if (vfs_dcache_lookup(vfs_root, path, &gen)) {
+    return CH_RET_ENOENT;
+  }
+
+  ret = vfsDrvOpenDirectory(vfs_root, path, vdnpp);
+  dcache_update(path, 0, ret, gen);
 
+  return ret;
+#else
   return vfsDrvOpenDirectory(vfs_root, path, vdnpp);
+#endif
 }
 
 /**
@@ -169,8 +246,21 @@ msg_t vfsOpenDirectory(const char *path, vfs_directory_node_c **vdnpp) {
  * @api
  */
 msg_t vfsOpenFile(const char *path, int flags, vfs_file_node_c **vfnpp) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  uint32_t gen;
+  msg_t ret;
+
+  if (vfs_dcache_lookup(vfs_root, path, &gen) && ((flags & VO_CREAT) == 0)) {
+    return CH_RET_ENOENT;
+  }
 
+  ret = vfsDrvOpenFile(vfs_root, path, flags, vfnpp);
+  dcache_update(path, flags, ret, gen);
+
+  return ret;
+#else
   return vfsDrvOpenFile(vfs_root, path, flags, vfnpp);
+#endif
 }
 
 /**
@@ -182,8 +272,16 @@ msg_t vfsOpenFile(const char *path, int flags, vfs_file_node_c **vfnpp) {
  * @api
  */
 msg_t vfsUnlink(const char *path) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  msg_t ret;
 
+  ret = vfsDrvUnlink(vfs_root, path);
+  vfs_dcache_invalidate(vfs_root, path);
+
+  return ret;
+#else
   return vfsDrvUnlink(vfs_root, path);
+#endif
 }
 
 /**
@@ -196,8 +294,17 @@ msg_t vfsUnlink(const char *path) {
  * @api
  */
 msg_t vfsRename(const char *oldpath, const char *newpath) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  msg_t ret;
 
+  ret = vfsDrvRename(vfs_root, oldpath, newpath);
+  vfs_dcache_invalidate(vfs_root, oldpath);
+  vfs_dcache_invalidate(vfs_root, newpath);
+
+  return ret;
+#else
   return vfsDrvRename(vfs_root, oldpath, newpath);
+#endif
 }
 
 /**
@@ -210,8 +317,16 @@ msg_t vfsRename(const char *oldpath, const char *newpath) {
  * @api
  */
 msg_t vfsMkdir(const char *path, vfs_mode_t mode) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  msg_t ret;
 
+  ret = vfsDrvMkdir(vfs_root, path, mode);
+  vfs_dcache_invalidate(vfs_root, path);
+
+  return ret;
+#else
   return vfsDrvMkdir(vfs_root, path, mode);
+#endif
 }
 
 /**
@@ -223,8 +338,16 @@ msg_t vfsMkdir(const char *path, vfs_mode_t mode) {
  * @api
  */
 msg_t vfsRmdir(const char *path) {
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  msg_t ret;
 
+  ret = vfsDrvRmdir(vfs_root, path);
+  vfs_dcache_invalidate(vfs_root, path);
+
+  return ret;
+#else
   return vfsDrvRmdir(vfs_root, path);
+#endif
 }
 
 /**
@@ -380,4 +503,59 @@ random_stream_i *vfsGetFileStream(vfs_file_node_c *vfnp) {
   return vfsFileGetStream((void *)vfnp);
 }
 
+/**
+ * @brief   Maps the file content in memory.
+ * @details Files stored in contiguous readable memory, like ROMFS files,
+ *          can be accessed through the returned pointer without copying
+ *          the data. The file position is not affected.
+ * @note    The mapping must be released using @p vfsUnmapFile() before
+ *          closing the node.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[out] bufp     Pointer to a variable receiving the file data pointer.
+ * @param[out] np       Pointer to a variable receiving the file size.
+ * @return              The operation result.
+ * @retval CH_RET_ENOSYS If the driver cannot map the file.
+ *
+ * @api
+ */
+msg_t vfsMapFile(vfs_file_node_c *vfnp, const uint8_t **bufp, size_t *np) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileMap((void *)vfnp, bufp, np);
+}
+
+/**
+ * @brief   Releases a file mapping.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @return              The operation result.
+ *
+ * @api
+ */
+msg_t vfsUnmapFile(vfs_file_node_c *vfnp) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileUnmap((void *)vfnp);
+}
+
+/**
+ * @brief   Commits cached file data to the storage.
+ * @details Data buffered by the node or by the underlying file system is
+ *          written and the file metadata is updated.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @return              The operation result.
+ *
+ * @api
+ */
+msg_t vfsSyncFile(vfs_file_node_c *vfnp) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileSync((void *)vfnp);
+}
+
 /** @} */
@@ -0,0 +1,750 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    vfs/src/vfsbuffered.c
+ * @brief   VFS buffered file nodes code.
+ * @details A buffered file node wraps a file node of any driver and keeps
+ *          a window of the file in a buffer. Small reads are served from
+ *          the window which is refilled reading ahead a whole buffer,
+ *          small writes are collected in the window and written to the
+ *          underlying node in a single operation. The window never
+ *          crosses a file offset multiple of the buffer size so that
+ *          the underlying file system sees sector-aligned accesses.
+ *
+ * @addtogroup VFS_BUFFERED
+ * @{
+ */
+
+#include "vfs.h"
+
+#if (VFS_CFG_ENABLE_BUFFERED_FILES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Buffer size as an offset.
+ */
+#define BUF_SIZE                ((vfs_offset_t)VFS_CFG_BUFFERED_FILE_SIZE)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @class       vfs_buffered_file_node_c
+ * @extends     vfs_file_node_c
+ *
+ * @brief       Buffered file node class.
+ *
+ * @name        Class @p vfs_buffered_file_node_c structures
+ * @{
+ */
+
+/**
+ * @brief       Type of a buffered file node class.
+ */
+typedef struct vfs_buffered_file_node vfs_buffered_file_node_c;
+
+/**
+ * @brief       Class @p vfs_buffered_file_node_c virtual methods table.
+ */
+struct vfs_buffered_file_node_vmt {
+  /* From base_object_c.*/
+  void (*dispose)(void *ip);
+  /* From referenced_object_c.*/
+  void * (*addref)(void *ip);
+  object_references_t (*release)(void *ip);
+  /* From vfs_node_c.*/
+  msg_t (*stat)(void *ip, vfs_stat_t *sp);
+  /* From vfs_file_node_c.*/
+  ssize_t (*read)(void *ip, uint8_t *buf, size_t n);
+  ssize_t (*write)(void *ip, const uint8_t *buf, size_t n);
+  msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
+  vfs_offset_t (*getpos)(void *ip);
+  random_stream_i * (*getstream)(void *ip);
+  msg_t (*map)(void *ip, const uint8_t **bufp, size_t *np);
+  msg_t (*unmap)(void *ip);
+  msg_t (*sync)(void *ip);
+  /* From vfs_buffered_file_node_c.*/
+};
+
+/**
+ * @brief       Structure representing a buffered file node class.
+ */
+struct vfs_buffered_file_node {
+  /**
+   * @brief       Virtual Methods Table.
+   */
+  const struct vfs_buffered_file_node_vmt *vmt;
+  /**
+   * @brief       Number of references to the object.
+   */
+  object_references_t       references;
+  /**
+   * @brief       Driver handling this node.
+   */
+  vfs_driver_c              *driver;
+  /**
+   * @brief       Node mode information.
+   */
+  vfs_mode_t                mode;
+  /**
+   * @brief       Implemented interface @p random_stream_i.
+   */
+  random_stream_i           rstm;
+  /**
+   * @brief       Wrapped file node, owned by this object.
+   */
+  vfs_file_node_c           *inner;
+  /**
+   * @brief       Current file position.
+   */
+  vfs_offset_t              pos;
+  /**
+   * @brief       Known position of the wrapped node.
+   */
+  vfs_offset_t              inner_pos;
+  /**
+   * @brief       File offset of the first buffered byte.
+   */
+  vfs_offset_t              bufpos;
+  /**
+   * @brief       Number of valid bytes in the buffer.
+   */
+  size_t                    buflen;
+  /**
+   * @brief       Start of the buffer range not yet written.
+   */
+  size_t                    dirty_lo;
+  /**
+   * @brief       End of the buffer range not yet written.
+   * @note        The buffer is clean when equal to @p dirty_lo.
+   */
+  size_t                    dirty_hi;
+  /**
+   * @brief       Data buffer.
+   */
+  uint8_t                   buf[VFS_CFG_BUFFERED_FILE_SIZE];
+};
+/** @} */
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   VFS buffered file nodes static data.
+ */
+static struct {
+  /**
+   * @brief   Pool of buffered file nodes.
+   */
+  memory_pool_t                     nodes_pool;
+  /**
+   * @brief   Static storage of buffered file nodes.
+   */
+  vfs_buffered_file_node_c          nodes[VFS_CFG_BUFFERED_FILES_NUM];
+} vfs_buffered_static;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the end of the window starting at the specified offset.
+ *
+ * @param[in] bufpos            File offset of the window start.
+ * @return                      The first offset after the window.
+ */
+static inline vfs_offset_t buffile_window_end(vfs_offset_t bufpos) {
+
+  return bufpos - (bufpos % BUF_SIZE) + BUF_SIZE;
+}
+
+/**
+ * @brief   Moves the wrapped node position.
+ * @note    The wrapped node is not touched if already in position, this
+ *          allows sequential access to non-seekable nodes.
+ *
+ * @param[in,out] self          Pointer to the buffered file node.
+ * @param[in] offset            File offset to be reached.
+ * @return                      The operation result.
+ */
+static msg_t buffile_seek_inner(vfs_buffered_file_node_c *self,
+                                vfs_offset_t offset) {
+  msg_t ret;
+
+  if (self->inner_pos == offset) {
+    return CH_RET_SUCCESS;
+  }
+
+  ret = vfsFileSetPosition((void *)self->inner, offset, VFS_SEEK_SET);
+  if (!CH_RET_IS_ERROR(ret)) {
+    self->inner_pos = offset;
+  }
+
+  return ret;
+}
+
+/**
+ * @brief   Writes the dirty part of the buffer to the wrapped node.
+ * @note    On failure the unwritten data is kept and the operation is
+ *          retried on the next flush.
+ *
+ * @param[in,out] self          Pointer to the buffered file node.
+ * @return                      The operation result.
+ */
+static msg_t buffile_flush(vfs_buffered_file_node_c *self) {
+  ssize_t n;
+  msg_t ret;
+
+  while (self->dirty_hi > self->dirty_lo) {
+    ret = buffile_seek_inner(self, self->bufpos + (vfs_offset_t)self->dirty_lo);
+    CH_RETURN_ON_ERROR(ret);
+
+    n = vfsFileWrite((void *)self->inner,
+                     &self->buf[self->dirty_lo],
+                     self->dirty_hi - self->dirty_lo);
+    if (CH_RET_IS_ERROR(n)) {
+      return (msg_t)n;
+    }
+    if (n == 0) {
+      return CH_RET_ENOSPC;
+    }
+
+    self->inner_pos += (vfs_offset_t)n;
+    self->dirty_lo  += (size_t)n;
+  }
+
+  self->dirty_lo = 0U;
+  self->dirty_hi = 0U;
+
+  return CH_RET_SUCCESS;
+}
+
+/**
+ * @brief   Drops the buffered data.
+ * @pre     The buffer must be clean.
+ *
+ * @param[in,out] self          Pointer to the buffered file node.
+ */
+static void buffile_discard(vfs_buffered_file_node_c *self) {
+
+  self->bufpos = self->pos;
+  self->buflen = 0U;
+}
+
+/*===========================================================================*/
+/* Module class "vfs_buffered_file_node_c" methods.                          */
+/*===========================================================================*/
+
+/**
+ * @name        Methods implementations of vfs_buffered_file_node_c
+ * @{
+ */
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of object finalization.
+ * @details     Pending data is written and the wrapped node is released.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance to be disposed.
+ */
+static void __buffile_dispose_impl(void *ip) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+
+  (void) buffile_flush(self);
+  vfsClose((vfs_node_c *)self->inner);
+
+  __vfsfile_dispose_impl(self);
+  chPoolFree(&vfs_buffered_static.nodes_pool, ip);
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsNodeStat().
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @param[out]    sp            Pointer to a @p vfs_stat_t structure.
+ * @return                      The operation result.
+ */
+static msg_t __buffile_stat_impl(void *ip, vfs_stat_t *sp) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+  msg_t ret;
+
+  ret = buffile_flush(self);
+  CH_RETURN_ON_ERROR(ret);
+
+  return vfsNodeStat((void *)self->inner, sp);
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileRead().
+ * @details     Reads smaller than the buffer are served from the buffer,
+ *              aligned reads of at least a buffer are transferred directly.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @param[out]    buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @return                      The transferred number of bytes or an error.
+ */
+static ssize_t __buffile_read_impl(void *ip, uint8_t *buf, size_t n) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+  size_t done, k;
+  ssize_t r;
+  msg_t ret;
+
+  /* Buffered data is written first, reads are always served from data
+     known to the wrapped node.*/
+  ret = buffile_flush(self);
+  CH_RETURN_ON_ERROR(ret);
+
+  done = 0U;
+  while (n > 0U) {
+    vfs_offset_t start;
+
+    /* Part of the request inside the window.*/
+    if ((self->pos >= self->bufpos) &&
+        (self->pos < self->bufpos + (vfs_offset_t)self->buflen)) {
+      k = self->buflen - (size_t)(self->pos - self->bufpos);
+      if (k > n) {
+        k = n;
+      }
+      memcpy(buf, &self->buf[self->pos - self->bufpos], k);
+      self->pos += (vfs_offset_t)k;
+      buf       += k;
+      done      += k;
+      n         -= k;
+      continue;
+    }
+
+    /* Large aligned requests bypass the buffer.*/
+    if ((n >= VFS_CFG_BUFFERED_FILE_SIZE) && ((self->pos % BUF_SIZE) == 0)) {
+      ret = buffile_seek_inner(self, self->pos);
+      if (CH_RET_IS_ERROR(ret)) {
+        break;
+      }
+      r = vfsFileRead((void *)self->inner, buf, n);
+      if (CH_RET_IS_ERROR(r)) {
+        ret = (msg_t)r;
+        break;
+      }
+      self->inner_pos += (vfs_offset_t)r;
+      self->pos       += (vfs_offset_t)r;
+      done            += (size_t)r;
+      break;
+    }
+
+    /* Reading ahead a whole aligned buffer.*/
+    start = self->pos - (self->pos % BUF_SIZE);
+    ret = buffile_seek_inner(self, start);
+    if (CH_RET_IS_ERROR(ret)) {
+      break;
+    }
+    r = vfsFileRead((void *)self->inner, self->buf,
+                    VFS_CFG_BUFFERED_FILE_SIZE);
+    if (CH_RET_IS_ERROR(r)) {
+      buffile_discard(self);
+      ret = (msg_t)r;
+      break;
+    }
+    self->inner_pos += (vfs_offset_t)r;
+    self->bufpos     = start;
+    self->buflen     = (size_t)r;
+
+    /* End of file.*/
+    if (self->pos >= self->bufpos + (vfs_offset_t)self->buflen) {
+      break;
+    }
+  }
+
+  if ((done == 0U) && CH_RET_IS_ERROR(ret)) {
+    return (ssize_t)ret;
+  }
+
+  return (ssize_t)done;
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileWrite().
+ * @details     Writes smaller than the buffer are collected in the buffer,
+ *              aligned writes of at least a buffer are transferred
+ *              directly.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @param[in]     buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @return                      The transferred number of bytes or an error.
+ */
+static ssize_t __buffile_write_impl(void *ip, const uint8_t *buf, size_t n) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+  size_t done, k, offset;
+  ssize_t r;
+  msg_t ret;
+
+  done = 0U;
+  ret  = CH_RET_SUCCESS;
+  while (n > 0U) {
+
+    /* Part of the request extending or overwriting the window.*/
+    if ((self->pos >= self->bufpos) &&
+        (self->pos <= self->bufpos + (vfs_offset_t)self->buflen) &&
+        (self->pos < buffile_window_end(self->bufpos))) {
+      offset = (size_t)(self->pos - self->bufpos);
+      k = (size_t)(buffile_window_end(self->bufpos) - self->pos);
+      if (k > n) {
+        k = n;
+      }
+      memcpy(&self->buf[offset], buf, k);
+      if (self->dirty_hi == self->dirty_lo) {
+        self->dirty_lo = offset;
+        self->dirty_hi = offset + k;
+      }
+      else {
+        if (offset < self->dirty_lo) {
+          self->dirty_lo = offset;
+        }
+        if (offset + k > self->dirty_hi) {
+          self->dirty_hi = offset + k;
+        }
+      }
+      if (offset + k > self->buflen) {
+        self->buflen = offset + k;
+      }
+      self->pos += (vfs_offset_t)k;
+      buf       += k;
+      done      += k;
+      n         -= k;
+      continue;
+    }
+
+    /* Moving out of the window, the buffered data is written.*/
+    ret = buffile_flush(self);
+    if (CH_RET_IS_ERROR(ret)) {
+      break;
+    }
+
+    /* Large aligned requests bypass the buffer.*/
+    if ((n >= VFS_CFG_BUFFERED_FILE_SIZE) && ((self->pos % BUF_SIZE) == 0)) {
+      ret = buffile_seek_inner(self, self->pos);
+      if (CH_RET_IS_ERROR(ret)) {
+        break;
+      }
+      r = vfsFileWrite((void *)self->inner, buf, n);
+      if (CH_RET_IS_ERROR(r)) {
+        ret = (msg_t)r;
+        break;
+      }
+      self->inner_pos += (vfs_offset_t)r;
+      self->pos       += (vfs_offset_t)r;
+      done            += (size_t)r;
+      buffile_discard(self);
+      break;
+    }
+
+    /* Starting a new window at the current position.*/
+    buffile_discard(self);
+  }
+
+  if ((done == 0U) && CH_RET_IS_ERROR(ret)) {
+    return (ssize_t)ret;
+  }
+
+  return (ssize_t)done;
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileSetPosition().
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @param[in]     offset        Offset to be applied.
+ * @param[in]     whence        Seek mode to be used.
+ * @return                      The operation result.
+ */
+static msg_t __buffile_setpos_impl(void *ip, vfs_offset_t offset,
+                                   vfs_seekmode_t whence) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+  vfs_offset_t pos;
+  msg_t ret;
+
+  switch (whence) {
+  case VFS_SEEK_SET:
+    pos = offset;
+    break;
+  case VFS_SEEK_CUR:
+    pos = self->pos + offset;
+    break;
+  case VFS_SEEK_END:
+    /* The file size is only known to the wrapped node.*/
+    ret = buffile_flush(self);
+    CH_RETURN_ON_ERROR(ret);
+    ret = vfsFileSetPosition((void *)self->inner, offset, VFS_SEEK_END);
+    CH_RETURN_ON_ERROR(ret);
+    pos = vfsFileGetPosition((void *)self->inner);
+    self->inner_pos = pos;
+    break;
+  default:
+    return CH_RET_EINVAL;
+  }
+
+  if (pos < 0) {
+    return CH_RET_EINVAL;
+  }
+
+  self->pos = pos;
+
+  return CH_RET_SUCCESS;
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileGetPosition().
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @return                      The current file position.
+ */
+static vfs_offset_t __buffile_getpos_impl(void *ip) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+
+  return self->pos;
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileMap().
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @param[out]    bufp          Pointer to a variable receiving the file
+ *                              data pointer.
+ * @param[out]    np            Pointer to a variable receiving the file
+ *                              size.
+ * @return                      The operation result.
+ */
+static msg_t __buffile_map_impl(void *ip, const uint8_t **bufp, size_t *np) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+  msg_t ret;
+
+  ret = buffile_flush(self);
+  CH_RETURN_ON_ERROR(ret);
+
+  return vfsFileMap((void *)self->inner, bufp, np);
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileUnmap().
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @return                      The operation result.
+ */
+static msg_t __buffile_unmap_impl(void *ip) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+
+  return vfsFileUnmap((void *)self->inner);
+}
+
+/**
+ * @memberof    vfs_buffered_file_node_c
+ * @protected
+ *
+ * @brief       Override of method @p vfsFileSync().
+ * @details     Buffered data is written then the wrapped node is synced.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_buffered_file_node_c
+ *                              instance.
+ * @return                      The operation result.
+ */
+static msg_t __buffile_sync_impl(void *ip) {
+  vfs_buffered_file_node_c *self = (vfs_buffered_file_node_c *)ip;
+  msg_t ret;
+
+  ret = buffile_flush(self);
+  CH_RETURN_ON_ERROR(ret);
+
+  return vfsFileSync((void *)self->inner);
+}
+/** @} */
+
+/**
+ * @brief       VMT structure of buffered file node class.
+ */
+static const struct vfs_buffered_file_node_vmt __vfs_buffered_file_node_vmt = {
+  .dispose                  = __buffile_dispose_impl,
+  .addref                   = __ro_addref_impl,
+  .release                  = __ro_release_impl,
+  .stat                     = __buffile_stat_impl,
+  .read                     = __buffile_read_impl,
+  .write                    = __buffile_write_impl,
+  .setpos                   = __buffile_setpos_impl,
+  .getpos                   = __buffile_getpos_impl,
+  .getstream                = __vfsfile_getstream_impl,
+  .map                      = __buffile_map_impl,
+  .unmap                    = __buffile_unmap_impl,
+  .sync                     = __buffile_sync_impl
+};
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Buffered file nodes initialization.
+ *
+ * @init
+ */
+void __vfs_buffered_init(void) {
+
+  chPoolObjectInit(&vfs_buffered_static.nodes_pool,
+                   sizeof (vfs_buffered_file_node_c),
+                   NULL);
+  chPoolLoadArray(&vfs_buffered_static.nodes_pool,
+                  &vfs_buffered_static.nodes[0],
+                  VFS_CFG_BUFFERED_FILES_NUM);
+}
+
+/**
+ * @brief   Adds a buffer to a file node.
+ * @details The returned node accesses the file through a buffer, reads
+ *          smaller than the buffer are served reading ahead and writes
+ *          smaller than the buffer are collected and written together.
+ * @note    On success the reference to the original node is taken over
+ *          by the returned node, it is released when the returned node
+ *          is closed.
+ * @note    Buffered data is written when the file position moves out
+ *          of the buffer, on @p vfsSyncFile() and when the node is
+ *          closed. Errors happening while closing are not reported,
+ *          use @p vfsSyncFile() before closing if the outcome matters.
+ * @note    The original node must not be accessed directly while
+ *          wrapped.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object to be
+ *                      wrapped.
+ * @param[out] bfnpp    Pointer to the pointer to the buffered file node.
+ * @return              The operation result.
+ * @retval CH_RET_ENOMEM If no buffered file nodes are available.
+ *
+ * @api
+ */
+msg_t vfsBufferFile(vfs_file_node_c *vfnp, vfs_file_node_c **bfnpp) {
+  vfs_buffered_file_node_c *self;
+  vfs_offset_t pos;
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  self = chPoolAlloc(&vfs_buffered_static.nodes_pool);
+  if (self == NULL) {
+    return CH_RET_ENOMEM;
+  }
+
+  /* Nodes not reporting a position, like streams, are accessed
+     sequentially from the start.*/
+  pos = vfsFileGetPosition((void *)vfnp);
+  if (pos < 0) {
+    pos = 0;
+  }
+
+  self = __vfsfile_objinit_impl(self, &__vfs_buffered_file_node_vmt,
+                                vfnp->driver, vfnp->mode);
+  self->inner     = vfnp;
+  self->pos       = pos;
+  self->inner_pos = pos;
+  self->bufpos    = pos;
+  self->buflen    = 0U;
+  self->dirty_lo  = 0U;
+  self->dirty_hi  = 0U;
+
+  *bfnpp = (vfs_file_node_c *)self;
+
+  return CH_RET_SUCCESS;
+}
+
+/**
+ * @brief   Opens a file using a buffer.
+ * @details The file is opened using @p vfsOpenFile() then wrapped using
+ *          @p vfsBufferFile().
+ * @note    With @p VO_APPEND the initial position is the end of file
+ *          and writes are collected from there, the file must not be
+ *          appended by other openers while in use.
+ *
+ * @param[in] path      Path of the file to be opened.
+ * @param[in] flags     File open flags.
+ * @param[out] vfnpp    Pointer to the pointer to the instantiated
+ *                      @p vfs_file_node_c object.
+ * @return              The operation result.
+ *
+ * @api
+ */
+msg_t vfsOpenBufferedFile(const char *path, int flags,
+                          vfs_file_node_c **vfnpp) {
+  vfs_file_node_c *vfnp;
+  msg_t ret;
+
+  ret = vfsOpenFile(path, flags, &vfnp);
+  CH_RETURN_ON_ERROR(ret);
+
+  if ((flags & VO_APPEND) != 0) {
+    ret = vfsFileSetPosition((void *)vfnp, 0, VFS_SEEK_END);
+  }
+
+  if (!CH_RET_IS_ERROR(ret)) {
+    ret = vfsBufferFile(vfnp, vfnpp);
+  }
+
+  if (CH_RET_IS_ERROR(ret)) {
+    vfsClose((vfs_node_c *)vfnp);
+  }
+
+  return ret;
+}
+
+#endif /* VFS_CFG_ENABLE_BUFFERED_FILES == TRUE */
+
+/** @} */
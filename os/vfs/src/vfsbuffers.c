@@ -111,4 +111,64 @@ void vfs_buffer_release(vfs_shared_buffer_t *shbuf) {
   chGuardedPoolFree(&vfs_buffers_static.buffers_pool, (void *)shbuf);
 }
 
+/**
+ * @brief   Resolves a path into an absolute normalized path.
+ * @details Paths that are already absolute and normalized are returned
+ *          unchanged and no buffer is claimed, any number of threads can
+ *          resolve such paths in parallel. Other paths are combined with
+ *          the current directory and normalized into a buffer claimed
+ *          from the pool.
+ * @note    The buffer pointer returned in @p shbufp must be released
+ *          using @p vfs_buffer_release_path(), also on error.
+ *
+ * @param[in] cwd               Current directory, must be an absolute path.
+ * @param[in] path              Path to be resolved.
+ * @param[in] timeout           Timeout for the buffer claim, usually
+ *                              @p TIME_INFINITE or @p TIME_IMMEDIATE.
+ * @param[out] shbufp           Pointer to the claimed buffer, @p NULL if
+ *                              no buffer has been claimed.
+ * @param[out] pathp            Pointer to the resolved path.
+ * @return                      The operation result.
+ */
+msg_t vfs_buffer_resolve_path(const char *cwd, const char *path,
+                              sysinterval_t timeout,
+                              vfs_shared_buffer_t **shbufp,
+                              const char **pathp) {
+  vfs_shared_buffer_t *shbuf;
+
+  /* Fast path, the path can be used in place.*/
+  if (vfs_path_is_normalized(path, VFS_BUFFER_SIZE)) {
+    *shbufp = NULL;
+    *pathp  = path;
+    return CH_RET_SUCCESS;
+  }
+
+  shbuf = (vfs_shared_buffer_t *)chGuardedPoolAllocTimeout(&vfs_buffers_static.buffers_pool,
+                                                           timeout);
+  *shbufp = shbuf;
+  if (shbuf == NULL) {
+    return CH_RET_ENOMEM;
+  }
+
+  *pathp = shbuf->buf;
+  if (vfs_path_make_absolute(shbuf->buf, path,
+                             VFS_BUFFER_SIZE, cwd) == (size_t)0) {
+    return CH_RET_ENAMETOOLONG;
+  }
+
+  return CH_RET_SUCCESS;
+}
+
+/**
+ * @brief   Releases the buffer claimed by @p vfs_buffer_resolve_path().
+ *
+ * @param[in] shbuf             Buffer to be released or @p NULL.
+ */
+void vfs_buffer_release_path(vfs_shared_buffer_t *shbuf) {
+
+  if (shbuf != NULL) {
+    vfs_buffer_release(shbuf);
+  }
+}
+
 /** @} */
@@ -0,0 +1,466 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    vfs/src/vfsdcache.c
+ * @brief   VFS directory entries cache code.
+ * @details The cache remembers the non-existence of nodes, keyed by
+ *          driver and absolute normalized path. Entries are recycled in
+ *          LRU order. A bit filter keyed on the paths length and on their
+ *          first and last bytes is checked before hashing the path and
+ *          locking the cache, lookups of existing nodes usually cost just
+ *          a @p strlen().
+ *
+ * @addtogroup VFS_DCACHE
+ * @{
+ */
+
+#include "vfs.h"
+
+#if (VFS_CFG_ENABLE_DCACHE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the path field of cache entries.
+ */
+#define DCACHE_PATH_SIZE        (VFS_CFG_DCACHE_PATHLEN_MAX + 1)
+
+/**
+ * @brief   Number of bits in the entries filter.
+ */
+#define DCACHE_FILTER_BITS      256U
+
+/**
+ * @brief   Multiplier used for mixing the filter key.
+ */
+#define DCACHE_FILTER_MIX       0x9E3779B97F4A7C15ULL
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a cache entry.
+ */
+typedef struct vfs_dcache_entry {
+  /**
+   * @brief   LRU list links, must be the first field.
+   */
+  ch_queue_t                        lru;
+  /**
+   * @brief   Owner driver, @p NULL for unused entries.
+   */
+  vfs_driver_c                      *drvp;
+  /**
+   * @brief   Absolute normalized path.
+   */
+  char                              path[DCACHE_PATH_SIZE];
+} vfs_dcache_entry_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   VFS directory entries cache static data.
+ */
+static struct {
+  /**
+   * @brief   Cache mutex.
+   */
+  mutex_t                           mtx;
+  /**
+   * @brief   LRU list, least recently used entries first.
+   */
+  ch_queue_t                        lru;
+  /**
+   * @brief   Generation counter, incremented on invalidations.
+   * @note    Lookups that raced an invalidation are not inserted.
+   */
+  uint32_t                          gen;
+  /**
+   * @brief   Statistics.
+   */
+  vfs_dcache_stats_t                stats;
+  /**
+   * @brief   Filter of the entries paths, read without locking.
+   * @note    A clear bit means that no entry can match, bits of recycled
+   *          entries are cleared on the next rebuild.
+   */
+  uint32_t                          filter[DCACHE_FILTER_BITS / 32U];
+  /**
+   * @brief   Paths hashes, kept apart from the entries for fast scanning.
+   */
+  uint32_t                          hashes[VFS_CFG_DCACHE_ENTRIES];
+  /**
+   * @brief   Cache entries.
+   */
+  vfs_dcache_entry_t                entries[VFS_CFG_DCACHE_ENTRIES];
+} vfs_dcache_static;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Hashes a cacheable path.
+ * @details The path is checked to be normalized like in
+ *          @p vfs_path_is_normalized() while hashing it.
+ *
+ * @param[in] path              Path to be hashed.
+ * @param[out] hashp            Pointer to the calculated hash.
+ * @return                      The cacheability of the path.
+ * @retval false                If the path is not normalized or too long.
+ * @retval true                 If the path can be cached.
+ */
+static bool dcache_hash(const char *path, uint32_t *hashp) {
+  uint32_t hash = 2166136261U;
+  const char *p = path;
+  char c, prev = '\0';
+
+  if (*p != '/') {
+    return false;
+  }
+
+  /* FNV-1a, rejecting empty elements, dot elements and final separators
+     except for root.*/
+  while ((c = *p) != '\0') {
+    if ((prev == '/') && ((c == '/') || (c == '.'))) {
+      return false;
+    }
+    hash = (hash ^ (uint32_t)(uint8_t)c) * 16777619U;
+    prev = c;
+    p++;
+  }
+
+  if (((prev == '/') && (p != path + 1)) ||
+      ((size_t)(p - path) >= (size_t)DCACHE_PATH_SIZE)) {
+    return false;
+  }
+  *hashp = hash;
+
+  return true;
+}
+
+/**
+ * @brief   Searches an entry.
+ *
+ * @param[in] drvp              Pointer to the owner driver.
+ * @param[in] path              Path to be searched.
+ * @param[in] hash              Path hash.
+ * @return                      Pointer to the entry.
+ * @retval NULL                 If the entry is not cached.
+ */
+static vfs_dcache_entry_t *dcache_find(vfs_driver_c *drvp,
+                                       const char *path,
+                                       uint32_t hash) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)VFS_CFG_DCACHE_ENTRIES; i++) {
+    if (vfs_dcache_static.hashes[i] == hash) {
+      vfs_dcache_entry_t *dep = &vfs_dcache_static.entries[i];
+
+      if ((dep->drvp == drvp) && (strcmp(dep->path, path) == 0)) {
+        return dep;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Calculates the filter bit of a path.
+ * @details The key is made of the path length and of its first and last
+ *          eight bytes, paths differing only in the middle share the bit.
+ *
+ * @param[in] path              Path.
+ * @return                      The filter bit index.
+ */
+static uint32_t dcache_filter_bit(const char *path) {
+  size_t n = strlen(path);
+  uint64_t head = 0U, tail = 0U, key;
+
+  if (n < sizeof (uint64_t)) {
+    memcpy(&head, path, n);
+  }
+  else {
+    memcpy(&head, path, sizeof (uint64_t));
+    memcpy(&tail, path + n - sizeof (uint64_t), sizeof (uint64_t));
+  }
+  key = ((head * DCACHE_FILTER_MIX) ^ tail ^ (uint64_t)n) * DCACHE_FILTER_MIX;
+
+  return (uint32_t)(key >> 56) % DCACHE_FILTER_BITS;
+}
+
+/**
+ * @brief   Tests the filter bit of a path.
+ *
+ * @param[in] path              Path to be tested.
+ * @return                      The filter bit state.
+ * @retval false                If no entry can match the path.
+ * @retval true                 If an entry could match the path.
+ */
+static bool dcache_filter_test(const char *path) {
+  uint32_t bit = dcache_filter_bit(path);
+
+  return (vfs_dcache_static.filter[bit / 32U] & (1U << (bit % 32U))) != 0U;
+}
+
+/**
+ * @brief   Sets the filter bit of a cached path.
+ *
+ * @param[in] path              Cached path.
+ */
+static void dcache_filter_set(const char *path) {
+  uint32_t bit = dcache_filter_bit(path);
+
+  vfs_dcache_static.filter[bit / 32U] |= 1U << (bit % 32U);
+}
+
+/**
+ * @brief   Rebuilds the filter from the used entries.
+ * @note    Concurrent lookups could miss an entry during the rebuild, the
+ *          path is then looked up by the driver.
+ */
+static void dcache_filter_rebuild(void) {
+  unsigned i;
+
+  memset(vfs_dcache_static.filter, 0, sizeof (vfs_dcache_static.filter));
+  for (i = 0U; i < (unsigned)VFS_CFG_DCACHE_ENTRIES; i++) {
+    if (vfs_dcache_static.entries[i].drvp != NULL) {
+      dcache_filter_set(vfs_dcache_static.entries[i].path);
+    }
+  }
+}
+
+/**
+ * @brief   Drops an entry, it becomes the first to be recycled.
+ *
+ * @param[in] dep               Pointer to the entry.
+ */
+static void dcache_drop(vfs_dcache_entry_t *dep) {
+
+  dep->drvp = NULL;
+  vfs_dcache_static.hashes[dep - &vfs_dcache_static.entries[0]] = 0U;
+  (void) ch_queue_dequeue(&dep->lru);
+  ch_queue_insert(vfs_dcache_static.lru.next, &dep->lru);
+  vfs_dcache_static.stats.invalidations++;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   VFS directory entries cache initialization.
+ *
+ * @init
+ */
+void __vfs_dcache_init(void) {
+  unsigned i;
+
+  chMtxObjectInit(&vfs_dcache_static.mtx);
+  ch_queue_init(&vfs_dcache_static.lru);
+  vfs_dcache_static.gen = 0U;
+  memset(&vfs_dcache_static.stats, 0, sizeof (vfs_dcache_stats_t));
+  memset(vfs_dcache_static.filter, 0, sizeof (vfs_dcache_static.filter));
+  for (i = 0U; i < (unsigned)VFS_CFG_DCACHE_ENTRIES; i++) {
+    vfs_dcache_static.entries[i].drvp = NULL;
+    vfs_dcache_static.hashes[i] = 0U;
+    ch_queue_insert(&vfs_dcache_static.lru,
+                    &vfs_dcache_static.entries[i].lru);
+  }
+}
+
+/**
+ * @brief   Looks up a path in the cache.
+ * @details The current generation is always returned, if the path is
+ *          not cached it must be passed to @p vfs_dcache_insert() when
+ *          the driver reports a non-existing node.
+ * @note    Lookups rejected by the filter are not counted as misses.
+ *
+ * @param[in] drvp              Pointer to the driver.
+ * @param[in] path              Path to be looked up.
+ * @param[out] genp             Pointer to the cache generation.
+ * @return                      The lookup result.
+ * @retval false                If the path is not cached.
+ * @retval true                 If the path is cached as non-existing.
+ */
+bool vfs_dcache_lookup(vfs_driver_c *drvp, const char *path,
+                       uint32_t *genp) {
+  vfs_dcache_entry_t *dep;
+  uint32_t hash;
+
+  /* Fast path, no entry can match, the generation is read before the
+     driver lookup like under lock.*/
+  if (!dcache_filter_test(path)) {
+    *genp = vfs_dcache_static.gen;
+    return false;
+  }
+
+  if (!dcache_hash(path, &hash)) {
+    *genp = 0U;
+    return false;
+  }
+
+  chMtxLock(&vfs_dcache_static.mtx);
+
+  *genp = vfs_dcache_static.gen;
+  dep = dcache_find(drvp, path, hash);
+  if (dep != NULL) {
+    /* Hit, moving the entry at the end of the LRU list.*/
+    (void) ch_queue_dequeue(&dep->lru);
+    ch_queue_insert(&vfs_dcache_static.lru, &dep->lru);
+    vfs_dcache_static.stats.hits++;
+  }
+  else {
+    vfs_dcache_static.stats.misses++;
+  }
+
+  chMtxUnlock(&vfs_dcache_static.mtx);
+
+  return dep != NULL;
+}
+
+/**
+ * @brief   Inserts a non-existing node in the cache.
+ * @note    Paths that are not normalized or exceed
+ *          @p VFS_CFG_DCACHE_PATHLEN_MAX are not cached.
+ *
+ * @param[in] drvp              Pointer to the driver.
+ * @param[in] path              Path to be cached.
+ * @param[in] gen               Generation returned by the lookup.
+ */
+void vfs_dcache_insert(vfs_driver_c *drvp, const char *path, uint32_t gen) {
+  vfs_dcache_entry_t *dep;
+  uint32_t hash;
+  bool evicted;
+
+  if (!dcache_hash(path, &hash)) {
+    return;
+  }
+
+  chMtxLock(&vfs_dcache_static.mtx);
+
+  /* An invalidation happened after the lookup, the driver result could
+     be stale.*/
+  if (gen == vfs_dcache_static.gen) {
+    dep = dcache_find(drvp, path, hash);
+    if (dep == NULL) {
+      /* Recycling the least recently used entry.*/
+      dep = (vfs_dcache_entry_t *)ch_queue_fifo_remove(&vfs_dcache_static.lru);
+      evicted = dep->drvp != NULL;
+      dep->drvp = drvp;
+      vfs_dcache_static.hashes[dep - &vfs_dcache_static.entries[0]] = hash;
+      strcpy(dep->path, path);
+
+      /* The filter is rebuilt when an entry is recycled, clearing its
+         bit.*/
+      if (evicted) {
+        vfs_dcache_static.stats.evictions++;
+        dcache_filter_rebuild();
+      }
+      else {
+        dcache_filter_set(path);
+      }
+    }
+    else {
+      (void) ch_queue_dequeue(&dep->lru);
+    }
+    ch_queue_insert(&vfs_dcache_static.lru, &dep->lru);
+  }
+
+  chMtxUnlock(&vfs_dcache_static.mtx);
+}
+
+/**
+ * @brief   Invalidates a path and all the paths below it.
+ * @details Paths that are not normalized, or exceeding the cacheable
+ *          length, invalidate all the entries of the driver.
+ *
+ * @param[in] drvp              Pointer to the driver.
+ * @param[in] path              Path to be invalidated or @p NULL for
+ *                              the whole driver.
+ */
+void vfs_dcache_invalidate(vfs_driver_c *drvp, const char *path) {
+  size_t n = 0U;
+  unsigned i;
+
+  if ((path != NULL) && vfs_path_is_normalized(path, DCACHE_PATH_SIZE)) {
+    n = strlen(path);
+
+    /* Root contains everything.*/
+    if (n == 1U) {
+      n = 0U;
+    }
+  }
+
+  chMtxLock(&vfs_dcache_static.mtx);
+
+  vfs_dcache_static.gen++;
+  for (i = 0U; i < (unsigned)VFS_CFG_DCACHE_ENTRIES; i++) {
+    vfs_dcache_entry_t *dep = &vfs_dcache_static.entries[i];
+
+    if (dep->drvp != drvp) {
+      continue;
+    }
+
+    if ((n == 0U) ||
+        ((strncmp(dep->path, path, n) == 0) &&
+         ((dep->path[n] == '\0') || (dep->path[n] == '/')))) {
+      dcache_drop(dep);
+    }
+  }
+  dcache_filter_rebuild();
+
+  chMtxUnlock(&vfs_dcache_static.mtx);
+}
+
+/**
+ * @brief   Returns the cache statistics.
+ *
+ * @param[out] sp               Pointer to a @p vfs_dcache_stats_t structure.
+ */
+void vfs_dcache_get_stats(vfs_dcache_stats_t *sp) {
+
+  chMtxLock(&vfs_dcache_static.mtx);
+  *sp = vfs_dcache_static.stats;
+  chMtxUnlock(&vfs_dcache_static.mtx);
+}
+
+/**
+ * @brief   Resets the cache statistics.
+ */
+void vfs_dcache_reset_stats(void) {
+
+  chMtxLock(&vfs_dcache_static.mtx);
+  memset(&vfs_dcache_static.stats, 0, sizeof (vfs_dcache_stats_t));
+  chMtxUnlock(&vfs_dcache_static.mtx);
+}
+
+#endif /* VFS_CFG_ENABLE_DCACHE == TRUE */
+
+/** @} */
@@ -492,6 +492,57 @@ random_stream_i *__vfsfile_getstream_impl(void *ip) {
 
   return &self->rstm;
 }
+
+/**
+ * @brief       Implementation of method @p vfsFileMap().
+ * @note        This function is meant to be used by derived classes.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[out]    bufp          Pointer to a variable receiving the file data
+ *                              pointer.
+ * @param[out]    np            Pointer to a variable receiving the file size.
+ * @return                      The operation result.
+ * @retval CH_RET_ENOSYS        If the node cannot be mapped.
+ */
+msg_t __vfsfile_map_impl(void *ip, const uint8_t **bufp, size_t *np) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  (void)self;
+  (void)bufp;
+  (void)np;
+
+  return CH_RET_ENOSYS;
+}
+
+/**
+ * @brief       Implementation of method @p vfsFileUnmap().
+ * @note        This function is meant to be used by derived classes.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @return                      The operation result.
+ */
+msg_t __vfsfile_unmap_impl(void *ip) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  (void)self;
+
+  return CH_RET_ENOSYS;
+}
+
+/**
+ * @brief       Implementation of method @p vfsFileSync().
+ * @note        This function is meant to be used by derived classes.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @return                      The operation result.
+ */
+msg_t __vfsfile_sync_impl(void *ip) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  (void)self;
+
+  return CH_RET_SUCCESS;
+}
 /** @} */
 
 /** @} */
@@ -388,6 +388,51 @@ size_t vfs_path_normalize(char *dst, const char *src, size_t size) {
   }
 }
 
+/**
+ * @brief   Checks if a path is already absolute and normalized.
+ * @details A path is considered normalized if it is identical to what
+ *          @p vfs_path_normalize() would produce from it: it begins with
+ *          a separator, has no empty elements, no final separator unless
+ *          it is the root and no elements beginning with a dot.
+ * @note    Elements beginning with a dot are rejected conservatively, such
+ *          paths simply take the normalization path.
+ *
+ * @param[in] path              The path to be checked.
+ * @param[in] size              Size of a buffer able to contain the path.
+ * @return                      The check result.
+ * @retval false                If the path requires normalization or it
+ *                              would overflow a buffer of @p size.
+ * @retval true                 If the path is already normalized.
+ */
+bool vfs_path_is_normalized(const char *path, size_t size) {
+  const char *p = path;
+
+  if (*p != '/') {
+    return false;
+  }
+
+  /* Root is the only path allowed to end with a separator.*/
+  if (*(p + 1) == '\0') {
+    return true;
+  }
+
+  while (*p == '/') {
+    p++;
+
+    /* Empty elements, final separators and dot elements.*/
+    if ((*p == '/') || (*p == '\0') || (*p == '.')) {
+      return false;
+    }
+
+    /* Skipping the element up to the next separator or end-of-string.*/
+    while ((*p != '/') && (*p != '\0')) {
+      p++;
+    }
+  }
+
+  return (size_t)(p - path) < size;
+}
+
 /**
  * @brief   Builds an absolute normalized path.
  *
@@ -51,11 +51,71 @@
 
 /**
  * @brief   Number of shared path buffers.
+ * @details Buffers are only claimed for paths requiring normalization,
+ *          relative paths for example, or for adding an overlay prefix.
+ *          Absolute normalized paths are resolved without buffers, any
+ *          number of threads can resolve such paths in parallel.
  */
 #if !defined(VFS_CFG_PATHBUFS_NUM) || defined(__DOXYGEN__)
 #define VFS_CFG_PATHBUFS_NUM                1
 #endif
 
+/**
+ * @brief   Enables the directory entries cache.
+ * @details The cache remembers which absolute normalized paths do not
+ *          exist, stats and opens of non-existing nodes are answered
+ *          without calling the drivers. Existing nodes are not cached,
+ *          their lookups are filtered without locking the cache.
+ * @note    Only operations performed through the VFS API invalidate the
+ *          cache, drivers modified directly require a call to
+ *          @p vfs_dcache_invalidate().
+ */
+#if !defined(VFS_CFG_ENABLE_DCACHE) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DCACHE               FALSE
+#endif
+
+/**
+ * @brief   Number of directory entries cache entries.
+ */
+#if !defined(VFS_CFG_DCACHE_ENTRIES) || defined(__DOXYGEN__)
+#define VFS_CFG_DCACHE_ENTRIES              32
+#endif
+
+/**
+ * @brief   Maximum length of cached paths.
+ * @note    Longer paths are not cached, each entry takes this amount
+ *          of memory plus about 20 bytes.
+ */
+#if !defined(VFS_CFG_DCACHE_PATHLEN_MAX) || defined(__DOXYGEN__)
+#define VFS_CFG_DCACHE_PATHLEN_MAX          47
+#endif
+
+/**
+ * @brief   Enables the buffered file nodes.
+ * @details Buffered file nodes, created using @p vfsOpenBufferedFile(),
+ *          coalesce small reads and writes into accesses of the buffer
+ *          size to the underlying file system.
+ */
+#if !defined(VFS_CFG_ENABLE_BUFFERED_FILES) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_BUFFERED_FILES       FALSE
+#endif
+
+/**
+ * @brief   Number of buffered file nodes.
+ */
+#if !defined(VFS_CFG_BUFFERED_FILES_NUM) || defined(__DOXYGEN__)
+#define VFS_CFG_BUFFERED_FILES_NUM          2
+#endif
+
+/**
+ * @brief   Size of the buffer of each buffered file node.
+ * @note    It should be the sector size of the underlying storage or a
+ *          multiple of it.
+ */
+#if !defined(VFS_CFG_BUFFERED_FILE_SIZE) || defined(__DOXYGEN__)
+#define VFS_CFG_BUFFERED_FILE_SIZE          512
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -249,6 +309,14 @@
 #define DRV_CFG_ROM_ENABLE_COMPRESSION      FALSE
 #endif
 
+#if !defined(DRV_CFG_ROM_CHUNK_CACHE_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_ROM_CHUNK_CACHE_NUM         2
+#endif
+
+#if !defined(DRV_CFG_ROM_CHUNK_CACHE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_ROM_CHUNK_CACHE_SIZE        1024
+#endif
+
 #if !defined(DRV_CFG_ROM_DIR_NODES_NUM) || defined(__DOXYGEN__)
 #define DRV_CFG_ROM_DIR_NODES_NUM           1
 #endif
@@ -6,10 +6,13 @@ include $(CHIBIOS)/os/common/oop/oop.mk
 # Required files.
 VFSSRC := $(CHIBIOS)/os/vfs/src/vfspaths.c \
           $(CHIBIOS)/os/common/utils/src/packbits.c \
+          $(CHIBIOS)/os/common/utils/src/lz4block.c \
           $(CHIBIOS)/os/vfs/src/vfsparser.c \
           $(CHIBIOS)/os/vfs/src/vfsbuffers.c \
+          $(CHIBIOS)/os/vfs/src/vfsdcache.c \
           $(CHIBIOS)/os/vfs/src/vfsdrivers.c \
           $(CHIBIOS)/os/vfs/src/vfsnodes.c \
+          $(CHIBIOS)/os/vfs/src/vfsbuffered.c \
           $(CHIBIOS)/os/vfs/src/vfs.c \
           $(CHIBIOS)/os/vfs/drivers/tmplfs/drvtmplfs.c \
           $(CHIBIOS)/os/vfs/drivers/chfs/drvchfs.c \
@@ -2,7 +2,8 @@
 TESTSRC += ${CHIBIOS}/test/mfs/source/test/mfs_test_root.c \
            ${CHIBIOS}/test/mfs/source/test/mfs_test_sequence_001.c \
            ${CHIBIOS}/test/mfs/source/test/mfs_test_sequence_002.c \
-           ${CHIBIOS}/test/mfs/source/test/mfs_test_sequence_003.c
+           ${CHIBIOS}/test/mfs/source/test/mfs_test_sequence_003.c \
+           ${CHIBIOS}/test/mfs/source/test/mfs_test_sequence_004.c
 
 # Required include directories
 TESTINC += ${CHIBIOS}/test/mfs/source/test
@@ -27,6 +27,7 @@
 #include "mfs_test_sequence_001.h"
 #include "mfs_test_sequence_002.h"
 #include "mfs_test_sequence_003.h"
+#include "mfs_test_sequence_004.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -53,6 +54,20 @@ extern "C" {
 
 #define TEST_REPORT_HOOK_HEADER test_print_mfs_info();
 
+/* Size of the checkpoint record data, an offset and a size for each
+   record.*/
+#define TEST_CHECKPOINT_SIZE    (sizeof (uint32_t) * 2U * MFS_CFG_MAX_RECORDS)
+
+/* Space taken at the start of each bank, the bank header followed by the
+   checkpoint record if enabled.*/
+#if MFS_CFG_CHECKPOINTS == TRUE
+#define TEST_BANK_OVERHEAD                                                  \
+  (sizeof (mfs_bank_header_t) +                                             \
+   MFS_ALIGN_NEXT(sizeof (mfs_data_header_t) + TEST_CHECKPOINT_SIZE))
+#else
+#define TEST_BANK_OVERHEAD      sizeof (mfs_bank_header_t)
+#endif
+
 extern mfs_nocache_buffer_t __nocache_mfsbuf1;
 extern const MFSConfig mfscfg1;
 extern MFSDriver mfs1;
@@ -37,6 +37,7 @@
  * - @subpage mfs_test_001_005
  * - @subpage mfs_test_001_006
  * - @subpage mfs_test_001_007
+ * - @subpage mfs_test_001_008
  * .
  */
 
@@ -47,6 +48,27 @@
 #include <string.h>
 #include "hal_mfs.h"
 
+#if MFS_CFG_CHECKPOINTS == FALSE
+/* CRC16-CCITT of an erased area, the checkpoint records written by this
+   sequence have their data area left erased.*/
+static uint16_t erased_crc(size_t n) {
+  uint16_t crc = 0xFFFFU;
+
+  while (n > 0U) {
+    unsigned i;
+
+    crc ^= 0xFF00U;
+    for (i = 0U; i < 8U; i++) {
+      crc = (crc & 0x8000U) != 0U ? (uint16_t)((crc << 1) ^ 0x1021U) :
+                                    (uint16_t)(crc << 1);
+    }
+    n--;
+  }
+
+  return crc;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -411,7 +433,7 @@ static void mfs_test_001_005_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -438,7 +460,7 @@ static void mfs_test_001_005_execute(void) {
   test_set_step(2);
   {
     mfs_error_t err;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -534,7 +556,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -598,7 +620,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(4);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -665,7 +687,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(7);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -731,7 +753,7 @@ static void mfs_test_001_007_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
 
@@ -757,10 +779,10 @@ static void mfs_test_001_007_execute(void) {
     mfs_error_t err;
     size_t size;
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
-    mfs_id_t n = ((mfscfg1.bank_size - sizeof (mfs_bank_header_t)) -
+    mfs_id_t n = ((mfscfg1.bank_size - TEST_BANK_OVERHEAD) -
                   (id_max * (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4)))) /
                  sizeof (mfs_data_header_t);
 
@@ -781,7 +803,7 @@ static void mfs_test_001_007_execute(void) {
   {
     mfs_error_t err;
     size_t size;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
 
@@ -805,6 +827,149 @@ static const testcase_t mfs_test_001_007 = {
   mfs_test_001_007_execute
 };
 
+#if (MFS_CFG_CHECKPOINTS == FALSE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_008 [1.8] Skipping checkpoint records
+ *
+ * <h2>Description</h2>
+ * A checkpoint record, as written by builds having MFS_CFG_CHECKPOINTS
+ * enabled, is placed after a record. The checkpoint must be skipped on
+ * mount without truncating the scan or repairing the bank.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_CHECKPOINTS == FALSE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.8.1] Writing a record then a checkpoint record using the low
+ *   level flash API, after remounting the bank is not repaired and the
+ *   checkpoint is skipped.
+ * - [1.8.2] Writing a record after the checkpoint, after remounting
+ *   both records are found, MFS_NO_ERROR is expected.
+ * - [1.8.3] Writing a checkpoint header with an invalid size after the
+ *   last record, after remounting the header is not accepted and the
+ *   bank is repaired, the records are preserved.
+ * .
+ */
+
+static void mfs_test_001_008_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_008_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_008_execute(void) {
+
+  /* [1.8.1] Writing a record then a checkpoint record using the low
+     level flash API, after remounting the bank is not repaired and the
+     checkpoint is skipped.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+    mfs_data_header_t dhdr;
+    flash_offset_t offset;
+
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating the record");
+    offset = mfs1.next_offset;
+    mfsStop(&mfs1);
+
+    dhdr.fields.magic1 = MFS_HEADER_MAGIC_1;
+    dhdr.fields.magic2 = MFS_HEADER_MAGIC_2;
+    dhdr.fields.id     = MFS_CHECKPOINT_ID;
+    dhdr.fields.crc    = erased_crc(TEST_CHECKPOINT_SIZE);
+    dhdr.fields.size   = TEST_CHECKPOINT_SIZE;
+    test_assert(flashProgram(mfscfg1.flashp, offset, sizeof dhdr,
+                             dhdr.hdr8) == FLASH_NO_ERROR,
+                "flash write failed");
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mfs1.current_counter == 1, "bank repaired");
+    test_assert(mfs1.next_offset ==
+                offset + MFS_ALIGN_NEXT(sizeof dhdr + TEST_CHECKPOINT_SIZE),
+                "checkpoint not skipped");
+  }
+  test_end_step(1);
+
+  /* [1.8.2] Writing a record after the checkpoint, after remounting
+     both records are found, MFS_NO_ERROR is expected.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error creating the record");
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mfs1.current_counter == 1, "bank repaired");
+
+    size = sizeof __nocache_mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, __nocache_mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+    test_assert(memcmp(mfs_pattern16, __nocache_mfs_buffer, size) == 0,
+                "wrong record content");
+    size = sizeof __nocache_mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, __nocache_mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern32, "unexpected record length");
+    test_assert(memcmp(mfs_pattern32, __nocache_mfs_buffer, size) == 0,
+                "wrong record content");
+  }
+  test_end_step(2);
+
+  /* [1.8.3] Writing a checkpoint header with an invalid size after the
+     last record, after remounting the header is not accepted and the
+     bank is repaired, the records are preserved.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    mfs_data_header_t dhdr;
+    flash_offset_t offset;
+    size_t size;
+
+    offset = mfs1.next_offset;
+    mfsStop(&mfs1);
+
+    dhdr.fields.magic1 = MFS_HEADER_MAGIC_1;
+    dhdr.fields.magic2 = MFS_HEADER_MAGIC_2;
+    dhdr.fields.id     = MFS_CHECKPOINT_ID;
+    dhdr.fields.crc    = 0xFFFFU;
+    dhdr.fields.size   = 0U;
+    test_assert(flashProgram(mfscfg1.flashp, offset, sizeof dhdr,
+                             dhdr.hdr8) == FLASH_NO_ERROR,
+                "flash write failed");
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_WARN_REPAIR, "unexpected error code");
+    test_assert(mfs1.current_counter == 2, "bank not repaired");
+
+    size = sizeof __nocache_mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, __nocache_mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    size = sizeof __nocache_mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, __nocache_mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t mfs_test_001_008 = {
+  "Skipping checkpoint records",
+  mfs_test_001_008_setup,
+  mfs_test_001_008_teardown,
+  mfs_test_001_008_execute
+};
+#endif /* MFS_CFG_CHECKPOINTS == FALSE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -820,6 +985,9 @@ const testcase_t * const mfs_test_sequence_001_array[] = {
   &mfs_test_001_005,
   &mfs_test_001_006,
   &mfs_test_001_007,
+#if (MFS_CFG_CHECKPOINTS == FALSE) || defined(__DOXYGEN__)
+  &mfs_test_001_008,
+#endif
   NULL
 };
 
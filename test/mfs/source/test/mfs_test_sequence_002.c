@@ -33,6 +33,7 @@
  * - @subpage mfs_test_002_001
  * - @subpage mfs_test_002_002
  * - @subpage mfs_test_002_003
+ * - @subpage mfs_test_002_004
  * .
  */
 
@@ -480,7 +481,7 @@ static void mfs_test_002_003_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (TEST_BANK_OVERHEAD +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -570,6 +571,140 @@ static const testcase_t mfs_test_002_003 = {
   mfs_test_002_003_execute
 };
 
+/**
+ * @page mfs_test_002_004 [2.4] Batched writes within a transaction
+ *
+ * <h2>Description</h2>
+ * Batches of records are written using mfsWriteRecords() within a
+ * transaction, batches not fitting the transaction are rejected as a
+ * whole, the others are committed with the transaction.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Starting a transaction with sufficient pre-allocated
+ *   space, MFS_NO_ERROR is expected.
+ * - [2.4.2] Writing a batch with more records than
+ *   MFS_CFG_TRANSACTION_MAX, MFS_ERR_TRANSACTION_NUM is expected and no
+ *   operation is added to the transaction.
+ * - [2.4.3] Writing a batch larger than the transaction allocated
+ *   space, MFS_ERR_TRANSACTION_SIZE is expected and no operation is
+ *   added to the transaction.
+ * - [2.4.4] Writing records 1, 2 and 3 as a batch and committing the
+ *   transaction, MFS_NO_ERROR is expected.
+ * - [2.4.5] Re-mounting the managed storage and testing outcome,
+ *   records 1, 2 and 3 must contain the batch values.
+ * .
+ */
+
+static void mfs_test_002_004_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_002_004_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_002_004_execute(void) {
+  static mfs_record_write_t records[MFS_CFG_TRANSACTION_MAX + 1];
+  unsigned i;
+
+  /* [2.4.1] Starting a transaction with sufficient pre-allocated
+     space, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    err = mfsStartTransaction(&mfs1, 1024U);
+    test_assert(err == MFS_NO_ERROR, "error starting transaction");
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Writing a batch with more records than
+     MFS_CFG_TRANSACTION_MAX, MFS_ERR_TRANSACTION_NUM is expected and no
+     operation is added to the transaction.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    for (i = 0U; i < MFS_CFG_TRANSACTION_MAX + 1U; i++) {
+      records[i].id     = (mfs_id_t)((i % 3U) + 1U);
+      records[i].size   = sizeof mfs_pattern16;
+      records[i].buffer = mfs_pattern16;
+    }
+    err = mfsWriteRecords(&mfs1, records, MFS_CFG_TRANSACTION_MAX + 1U);
+    test_assert(err == MFS_ERR_TRANSACTION_NUM, "invalid error code");
+    test_assert(mfs1.tr_nops == 0U, "transaction modified");
+  }
+  test_end_step(2);
+
+  /* [2.4.3] Writing a batch larger than the transaction allocated
+     space, MFS_ERR_TRANSACTION_SIZE is expected and no operation is
+     added to the transaction.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    for (i = 0U; i < 3U; i++) {
+      records[i].id     = (mfs_id_t)(i + 1U);
+      records[i].size   = sizeof mfs_pattern512;
+      records[i].buffer = mfs_pattern512;
+    }
+    err = mfsWriteRecords(&mfs1, records, 3U);
+    test_assert(err == MFS_ERR_TRANSACTION_SIZE, "invalid error code");
+    test_assert(mfs1.tr_nops == 0U, "transaction modified");
+  }
+  test_end_step(3);
+
+  /* [2.4.4] Writing records 1, 2 and 3 as a batch and committing the
+     transaction, MFS_NO_ERROR is expected.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+
+    records[0].size   = sizeof mfs_pattern16;
+    records[0].buffer = mfs_pattern16;
+    records[1].size   = sizeof mfs_pattern32;
+    records[1].buffer = mfs_pattern32;
+    records[2].size   = sizeof mfs_pattern10;
+    records[2].buffer = mfs_pattern10;
+    err = mfsWriteRecords(&mfs1, records, 3U);
+    test_assert(err == MFS_NO_ERROR, "error writing the records");
+    test_assert(mfs1.tr_nops == 3U, "unexpected number of operations");
+    err = mfsCommitTransaction(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "error committing transaction");
+  }
+  test_end_step(4);
+
+  /* [2.4.5] Re-mounting the managed storage and testing outcome,
+     records 1, 2 and 3 must contain the batch values.*/
+  test_set_step(5);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "re-start failed");
+
+    for (i = 0U; i < 3U; i++) {
+      size_t size = sizeof __nocache_mfs_buffer;
+
+      err = mfsReadRecord(&mfs1, records[i].id, &size, __nocache_mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record not found");
+      test_assert(size == records[i].size, "unexpected record length");
+      test_assert(memcmp(records[i].buffer, __nocache_mfs_buffer, size) == 0,
+                  "wrong record content");
+    }
+  }
+  test_end_step(5);
+}
+
+static const testcase_t mfs_test_002_004 = {
+  "Batched writes within a transaction",
+  mfs_test_002_004_setup,
+  mfs_test_002_004_teardown,
+  mfs_test_002_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -581,6 +716,7 @@ const testcase_t * const mfs_test_sequence_002_array[] = {
   &mfs_test_002_001,
   &mfs_test_002_002,
   &mfs_test_002_003,
+  &mfs_test_002_004,
   NULL
 };
 
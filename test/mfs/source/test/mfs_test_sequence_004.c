@@ -0,0 +1,627 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page mfs_test_sequence_004 [4] Benchmarks
+ *
+ * File: @ref mfs_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the performance of the most time-consuming
+ * MFS operations. The numbers allow to compare configurations and to
+ * discover performance regressions.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_004_001
+ * - @subpage mfs_test_004_002
+ * - @subpage mfs_test_004_003
+ * - @subpage mfs_test_004_004
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_mfs.h"
+
+#define BENCH_RECORD_SIZE       sizeof (mfs_pattern512)
+#define BENCH_RECORDS_FIT       ((mfscfg1.bank_size / 2U) /                 \
+                                 (BENCH_RECORD_SIZE + sizeof (mfs_data_header_t)))
+#define BENCH_RECORDS_NUM       (BENCH_RECORDS_FIT < MFS_CFG_MAX_RECORDS ?  \
+                                 BENCH_RECORDS_FIT : MFS_CFG_MAX_RECORDS)
+#define BENCH_LATENCY_RECORDS   8U
+#define BENCH_LATENCY_WRITES    ((mfscfg1.bank_size * 3U) /                 \
+                                 (BENCH_RECORD_SIZE + sizeof (mfs_data_header_t)))
+#define BENCH_BATCH_RECORDS     20U
+#define BENCH_BATCH_SIZE        32U
+
+static uint8_t bench_data[BENCH_RECORD_SIZE];
+static uint32_t bench_seq[BENCH_LATENCY_RECORDS];
+
+static mfs_id_t bench_prepare(uint32_t i) {
+  mfs_id_t id = (mfs_id_t)((i % BENCH_LATENCY_RECORDS) + 1U);
+
+  /* Each write has different content, the sequence number is stored at
+     the beginning of the record.*/
+  memcpy(bench_data, mfs_pattern512, BENCH_RECORD_SIZE);
+  memcpy(bench_data, &i, sizeof (i));
+  bench_seq[id - 1U] = i;
+
+  return id;
+}
+
+static void bench_check(void) {
+  uint32_t i;
+
+  for (i = 0; i < BENCH_LATENCY_RECORDS; i++) {
+    mfs_error_t err;
+    size_t size = sizeof __nocache_mfs_buffer;
+
+    (void) bench_prepare(bench_seq[i]);
+    err = mfsReadRecord(&mfs1, (mfs_id_t)(i + 1U), &size, __nocache_mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == BENCH_RECORD_SIZE, "unexpected record length");
+    test_assert(memcmp(bench_data, __nocache_mfs_buffer, size) == 0,
+                "wrong record content");
+  }
+}
+
+static void bench_fill(uint32_t quarters) {
+  uint32_t i, total;
+
+  total = ((mfscfg1.bank_size / 4U) * quarters) /
+          (BENCH_RECORD_SIZE + sizeof (mfs_data_header_t));
+  mfsErase(&mfs1);
+  for (i = 0; i < total; i++) {
+    mfs_error_t err;
+
+    err = mfsWriteRecord(&mfs1, (mfs_id_t)((i % BENCH_RECORDS_NUM) + 1U),
+                         BENCH_RECORD_SIZE, mfs_pattern512);
+    test_assert(err == MFS_NO_ERROR, "error writing the record");
+  }
+}
+
+static void bench_mounts(uint32_t *np) {
+  systime_t start;
+
+  *np = 0;
+  start = osalOsGetSystemTimeX();
+  do {
+    mfs_error_t err;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount error");
+    (*np)++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (osalTimeDiffX(start, osalOsGetSystemTimeX()) < OSAL_S2I(1));
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page mfs_test_004_001 [4.1] Mount time
+ *
+ * <h2>Description</h2>
+ * Half of the storage is filled with records, the number of mounts
+ * performed in one second is measured. Mount time is dominated by the
+ * records scanning and CRC checking.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Erasing the storage and filling half of it with records.
+ * - [4.1.2] Mounting the storage repeatedly for one second.
+ * - [4.1.3] Score is printed.
+ * .
+ */
+
+static void mfs_test_004_001_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_001_teardown(void) {
+  mfsErase(&mfs1);
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_001_execute(void) {
+  uint32_t n;
+
+  /* [4.1.1] Erasing the storage and filling half of it with records.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+    mfs_id_t id;
+
+    for (id = 1; id <= BENCH_RECORDS_NUM; id++) {
+      err = mfsWriteRecord(&mfs1, id, BENCH_RECORD_SIZE, mfs_pattern512);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+  }
+  test_end_step(1);
+
+  /* [4.1.2] Mounting the storage repeatedly for one second.*/
+  test_set_step(2);
+  {
+    systime_t start;
+    mfs_error_t err;
+
+    n = 0;
+    start = osalOsGetSystemTimeX();
+    do {
+      mfsStop(&mfs1);
+      err = mfsStart(&mfs1, &mfscfg1);
+      test_assert(err == MFS_NO_ERROR, "mount error");
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (osalTimeDiffX(start, osalOsGetSystemTimeX()) < OSAL_S2I(1));
+  }
+  test_end_step(2);
+
+  /* [4.1.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Records: ");
+    test_printn(BENCH_RECORDS_NUM);
+    test_print(" x ");
+    test_printn(BENCH_RECORD_SIZE);
+    test_println(" bytes");
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" mounts/S, ");
+    test_printn((n * BENCH_RECORDS_NUM * BENCH_RECORD_SIZE) / 1024U);
+    test_println(" kB/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t mfs_test_004_001 = {
+  "Mount time",
+  mfs_test_004_001_setup,
+  mfs_test_004_001_teardown,
+  mfs_test_004_001_execute
+};
+
+/**
+ * @page mfs_test_004_002 [4.2] Mount time against fill level
+ *
+ * <h2>Description</h2>
+ * The bank is filled with records at increasing levels, older
+ * instances included. The number of mounts performed in one second is
+ * measured without checkpoint, requiring a full records scan, and, if
+ * MFS_CFG_CHECKPOINTS is enabled, after a clean stop which writes a
+ * checkpoint.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Measuring mounts at 1/4, 2/4 and 3/4 fill levels, scores
+ *   are printed.
+ * .
+ */
+
+static void mfs_test_004_002_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_002_teardown(void) {
+  mfsErase(&mfs1);
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_002_execute(void) {
+  uint32_t quarters;
+
+  /* [4.2.1] Measuring mounts at 1/4, 2/4 and 3/4 fill levels, scores
+     are printed.*/
+  test_set_step(1);
+  {
+    for (quarters = 1U; quarters <= 3U; quarters++) {
+      uint32_t nscan;
+#if MFS_CFG_CHECKPOINTS == TRUE
+      uint32_t nckpt;
+#endif
+
+      bench_fill(quarters);
+      bench_mounts(&nscan);
+#if MFS_CFG_CHECKPOINTS == TRUE
+      mfsStop(&mfs1);
+      bench_mounts(&nckpt);
+#endif
+
+      test_print("--- Fill  : ");
+      test_printn(quarters);
+      test_println("/4");
+      test_print("--- Score : ");
+      test_printn(nscan);
+#if MFS_CFG_CHECKPOINTS == TRUE
+      test_print(" mounts/S (scan), ");
+      test_printn(nckpt);
+      test_println(" mounts/S (checkpoint)");
+#else
+      test_println(" mounts/S (scan)");
+#endif
+    }
+  }
+  test_end_step(1);
+}
+
+static const testcase_t mfs_test_004_002 = {
+  "Mount time against fill level",
+  mfs_test_004_002_setup,
+  mfs_test_004_002_teardown,
+  mfs_test_004_002_execute
+};
+
+#if (MFS_CFG_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_004_003 [4.3] Write latency with incremental garbage collection
+ *
+ * <h2>Description</h2>
+ * Records are written repeatedly, first letting writes trigger blocking
+ * garbage collections then performing an incremental garbage
+ * collection step after each write. The maximum write time is measured
+ * in both cases. The records content is checked after the writes, after
+ * a remount and after a remount with a garbage collection in progress.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_INCREMENTAL_GC == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] Writing records without garbage collection steps, the
+ *   maximum write time is measured.
+ * - [4.3.2] Writing records with a garbage collection step after each
+ *   write, the maximum write and step times are measured.
+ * - [4.3.3] Reading back all records, then remounting using mfsStop()
+ *   and mfsStart() and reading back again.
+ * - [4.3.4] Writing records and performing steps until the garbage
+ *   collection is copying records, then remounting and reading back all
+ *   records.
+ * - [4.3.5] Scores are printed.
+ * .
+ */
+
+static void mfs_test_004_003_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_003_teardown(void) {
+  mfsErase(&mfs1);
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_003_execute(void) {
+  sysinterval_t max_blocking, max_incremental, max_step;
+  uint32_t n_gc;
+
+  /* [4.3.1] Writing records without garbage collection steps, the
+     maximum write time is measured.*/
+  test_set_step(1);
+  {
+    uint32_t i;
+
+    max_blocking = 0;
+    n_gc = 0;
+    for (i = 0; i < BENCH_LATENCY_WRITES; i++) {
+      systime_t start;
+      sysinterval_t t;
+      mfs_error_t err;
+      mfs_id_t id;
+
+      id = bench_prepare(i);
+      start = osalOsGetSystemTimeX();
+      err = mfsWriteRecord(&mfs1, id, BENCH_RECORD_SIZE, bench_data);
+      t = osalTimeDiffX(start, osalOsGetSystemTimeX());
+      test_assert(!MFS_IS_ERROR(err), "error writing the record");
+      if (err == MFS_WARN_GC) {
+        n_gc++;
+      }
+      if (t > max_blocking) {
+        max_blocking = t;
+      }
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+  }
+  test_end_step(1);
+
+  /* [4.3.2] Writing records with a garbage collection step after each
+     write, the maximum write and step times are measured.*/
+  test_set_step(2);
+  {
+    uint32_t i;
+
+    max_incremental = 0;
+    max_step = 0;
+    for (i = 0; i < BENCH_LATENCY_WRITES; i++) {
+      systime_t start;
+      sysinterval_t t;
+      mfs_error_t err;
+      mfs_id_t id;
+
+      id = bench_prepare(i);
+      start = osalOsGetSystemTimeX();
+      err = mfsWriteRecord(&mfs1, id, BENCH_RECORD_SIZE, bench_data);
+      t = osalTimeDiffX(start, osalOsGetSystemTimeX());
+      test_assert(err == MFS_NO_ERROR, "unexpected blocking garbage collection");
+      if (t > max_incremental) {
+        max_incremental = t;
+      }
+
+      start = osalOsGetSystemTimeX();
+      err = mfsPerformGarbageCollectionStep(&mfs1);
+      t = osalTimeDiffX(start, osalOsGetSystemTimeX());
+      test_assert(!MFS_IS_ERROR(err), "garbage collection step error");
+      if (t > max_step) {
+        max_step = t;
+      }
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+  }
+  test_end_step(2);
+
+  /* [4.3.3] Reading back all records, then remounting using mfsStop()
+     and mfsStart() and reading back again.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    bench_check();
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount error");
+    bench_check();
+  }
+  test_end_step(3);
+
+  /* [4.3.4] Writing records and performing steps until the garbage
+     collection is copying records, then remounting and reading back all
+     records.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    uint32_t i;
+
+    for (i = BENCH_LATENCY_WRITES * 2U; i < BENCH_LATENCY_WRITES * 4U; i++) {
+      err = mfsWriteRecord(&mfs1, bench_prepare(i),
+                           BENCH_RECORD_SIZE, bench_data);
+      test_assert(err == MFS_NO_ERROR, "unexpected blocking garbage collection");
+      if (mfs1.gc_state == MFS_GC_COPYING) {
+        break;
+      }
+      err = mfsPerformGarbageCollectionStep(&mfs1);
+      test_assert(!MFS_IS_ERROR(err), "garbage collection step error");
+      if (mfs1.gc_state == MFS_GC_COPYING) {
+        break;
+      }
+    }
+    test_assert(mfs1.gc_state == MFS_GC_COPYING, "copying state not reached");
+    err = mfsWriteRecord(&mfs1, bench_prepare(i + 1U),
+                         BENCH_RECORD_SIZE, bench_data);
+    test_assert(!MFS_IS_ERROR(err), "error writing the record");
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(!MFS_IS_ERROR(err), "mount error");
+    test_assert(mfs1.gc_state == MFS_GC_IDLE, "garbage collection in progress");
+    bench_check();
+  }
+  test_end_step(4);
+
+  /* [4.3.5] Scores are printed.*/
+  test_set_step(5);
+  {
+    test_print("--- GCs   : ");
+    test_printn(n_gc);
+    test_println(" blocking");
+    test_print("--- Score : ");
+    test_printn(OSAL_I2MS(max_blocking));
+    test_print(" mS (blocking), ");
+    test_printn(OSAL_I2MS(max_incremental));
+    test_print(" mS (incremental), ");
+    test_printn(OSAL_I2MS(max_step));
+    test_println(" mS (step)");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t mfs_test_004_003 = {
+  "Write latency with incremental garbage collection",
+  mfs_test_004_003_setup,
+  mfs_test_004_003_teardown,
+  mfs_test_004_003_execute
+};
+#endif /* MFS_CFG_INCREMENTAL_GC == TRUE */
+
+/**
+ * @page mfs_test_004_004 [4.4] Batched writes
+ *
+ * <h2>Description</h2>
+ * A set of records is written one record at time and as a batch using
+ * mfsWriteRecords(), the number of sets written in one second is
+ * measured in both cases.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.4.1] Preparing the set of records.
+ * - [4.4.2] Writing the set one record at time for one second.
+ * - [4.4.3] Writing the set as a batch for one second.
+ * - [4.4.4] Mounting again and checking the records content.
+ * - [4.4.5] Scores are printed.
+ * .
+ */
+
+static void mfs_test_004_004_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_004_teardown(void) {
+  mfsErase(&mfs1);
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_004_execute(void) {
+  mfs_record_write_t batch[BENCH_BATCH_RECORDS];
+  uint32_t n_single, n_batch;
+
+  /* [4.4.1] Preparing the set of records.*/
+  test_set_step(1);
+  {
+    uint32_t i;
+
+    for (i = 0; i < BENCH_BATCH_RECORDS; i++) {
+      batch[i].id     = (mfs_id_t)(i + 1U);
+      batch[i].size   = BENCH_BATCH_SIZE;
+      batch[i].buffer = &mfs_pattern512[i * 16U];
+    }
+  }
+  test_end_step(1);
+
+  /* [4.4.2] Writing the set one record at time for one second.*/
+  test_set_step(2);
+  {
+    systime_t start;
+
+    n_single = 0;
+    start = osalOsGetSystemTimeX();
+    do {
+      uint32_t i;
+
+      for (i = 0; i < BENCH_BATCH_RECORDS; i++) {
+        mfs_error_t err;
+
+        err = mfsWriteRecord(&mfs1, batch[i].id, batch[i].size, batch[i].buffer);
+        test_assert(!MFS_IS_ERROR(err), "error writing the record");
+      }
+      n_single++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (osalTimeDiffX(start, osalOsGetSystemTimeX()) < OSAL_S2I(1));
+  }
+  test_end_step(2);
+
+  /* [4.4.3] Writing the set as a batch for one second.*/
+  test_set_step(3);
+  {
+    systime_t start;
+
+    n_batch = 0;
+    start = osalOsGetSystemTimeX();
+    do {
+      mfs_error_t err;
+
+      err = mfsWriteRecords(&mfs1, batch, BENCH_BATCH_RECORDS);
+      test_assert(!MFS_IS_ERROR(err), "error writing the records");
+      n_batch++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (osalTimeDiffX(start, osalOsGetSystemTimeX()) < OSAL_S2I(1));
+  }
+  test_end_step(3);
+
+  /* [4.4.4] Mounting again and checking the records content.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    uint32_t i;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount error");
+    for (i = 0; i < BENCH_BATCH_RECORDS; i++) {
+      size_t size = sizeof __nocache_mfs_buffer;
+
+      err = mfsReadRecord(&mfs1, batch[i].id, &size, __nocache_mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record not found");
+      test_assert(size == BENCH_BATCH_SIZE, "unexpected record length");
+      test_assert(memcmp(batch[i].buffer, __nocache_mfs_buffer, size) == 0,
+                  "wrong record content");
+    }
+  }
+  test_end_step(4);
+
+  /* [4.4.5] Scores are printed.*/
+  test_set_step(5);
+  {
+    test_print("--- Records: ");
+    test_printn(BENCH_BATCH_RECORDS);
+    test_print(" x ");
+    test_printn(BENCH_BATCH_SIZE);
+    test_println(" bytes");
+    test_print("--- Score : ");
+    test_printn(n_single);
+    test_print(" sets/S (single), ");
+    test_printn(n_batch);
+    test_println(" sets/S (batch)");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t mfs_test_004_004 = {
+  "Batched writes",
+  mfs_test_004_004_setup,
+  mfs_test_004_004_teardown,
+  mfs_test_004_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_004_array[] = {
+  &mfs_test_004_001,
+  &mfs_test_004_002,
+#if (MFS_CFG_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_004_003,
+#endif
+  &mfs_test_004_004,
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t mfs_test_sequence_004 = {
+  "Benchmarks",
+  mfs_test_sequence_004_array
+};
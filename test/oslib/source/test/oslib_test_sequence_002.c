@@ -39,6 +39,7 @@
  * - @subpage oslib_test_002_001
  * - @subpage oslib_test_002_002
  * - @subpage oslib_test_002_003
+ * - @subpage oslib_test_002_004
  * .
  */
 
@@ -52,6 +53,7 @@
 
 static msg_t mb_buffer[MB_SIZE];
 static MAILBOX_DECL(mb1, mb_buffer, MB_SIZE);
+static SPSC_MAILBOX_DECL(spmb1, mb_buffer, MB_SIZE);
 
 /****************************************************************************
  * Test cases.
@@ -410,6 +412,126 @@ static const testcase_t oslib_test_002_003 = {
   oslib_test_002_003_execute
 };
 
+/**
+ * @page oslib_test_002_004 [2.4] SPSC mailbox API
+ *
+ * <h2>Description</h2>
+ * The single producer single consumer mailbox API is tested, messages
+ * must be fetched in posting order across the buffer boundary.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Testing the mailbox size and initial state.
+ * - [2.4.2] Testing chSPMBFetchI() and chSPMBFetchTimeout() timeout.
+ * - [2.4.3] Filling the mailbox.
+ * - [2.4.4] Testing chSPMBPostI() and chSPMBPostTimeout() timeout.
+ * - [2.4.5] Fetching part of the messages and posting again across the
+ *   buffer boundary.
+ * - [2.4.6] Emptying the mailbox and testing the messages order.
+ * .
+ */
+
+static void oslib_test_002_004_setup(void) {
+  chSPMBObjectInit(&spmb1, mb_buffer, MB_SIZE);
+}
+
+static void oslib_test_002_004_execute(void) {
+  msg_t msg1, msg2;
+  unsigned i;
+
+  /* [2.4.1] Testing the mailbox size and initial state.*/
+  test_set_step(1);
+  {
+    test_assert(chSPMBGetSizeX(&spmb1) == MB_SIZE, "wrong size");
+    test_assert(chSPMBGetFreeCountX(&spmb1) == MB_SIZE, "not empty");
+    test_assert(chSPMBGetUsedCountX(&spmb1) == 0, "not empty");
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Testing chSPMBFetchI() and chSPMBFetchTimeout() timeout.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    msg1 = chSPMBFetchI(&spmb1, &msg2);
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    msg1 = chSPMBFetchTimeout(&spmb1, &msg2, 1);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(2);
+
+  /* [2.4.3] Filling the mailbox.*/
+  test_set_step(3);
+  {
+    for (i = 0; i < MB_SIZE / 2; i++) {
+      msg1 = chSPMBPostTimeout(&spmb1, 'A' + i, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    for (; i < MB_SIZE; i++) {
+      chSysLock();
+      msg1 = chSPMBPostI(&spmb1, 'A' + i);
+      chSysUnlock();
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    test_assert(chSPMBGetFreeCountX(&spmb1) == 0, "not full");
+    test_assert(chSPMBGetUsedCountX(&spmb1) == MB_SIZE, "not full");
+  }
+  test_end_step(3);
+
+  /* [2.4.4] Testing chSPMBPostI() and chSPMBPostTimeout() timeout.*/
+  test_set_step(4);
+  {
+    chSysLock();
+    msg1 = chSPMBPostI(&spmb1, 'X');
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    msg1 = chSPMBPostTimeout(&spmb1, 'X', 1);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(4);
+
+  /* [2.4.5] Fetching part of the messages and posting again across the
+     buffer boundary.*/
+  test_set_step(5);
+  {
+    for (i = 0; i < MB_SIZE / 2; i++) {
+      chSysLock();
+      msg1 = chSPMBFetchI(&spmb1, &msg2);
+      chSysUnlock();
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    for (i = 0; i < MB_SIZE / 2; i++) {
+      chSysLock();
+      msg1 = chSPMBPostI(&spmb1, 'A' + MB_SIZE + i);
+      chSysUnlock();
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    test_assert(spmb1.wrptr == spmb1.rdptr, "pointers not aligned");
+  }
+  test_end_step(5);
+
+  /* [2.4.6] Emptying the mailbox and testing the messages order.*/
+  test_set_step(6);
+  {
+    for (i = 0; i < MB_SIZE; i++) {
+      msg1 = chSPMBFetchTimeout(&spmb1, &msg2, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    test_assert_sequence("ABCDEF", "wrong get sequence");
+    test_assert(chSPMBGetUsedCountX(&spmb1) == 0, "not empty");
+    test_assert(spmb1.wrcnt == MB_SIZE + MB_SIZE / 2, "wrong counter");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_002_004 = {
+  "SPSC mailbox API",
+  oslib_test_002_004_setup,
+  NULL,
+  oslib_test_002_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -421,6 +543,7 @@ const testcase_t * const oslib_test_sequence_002_array[] = {
   &oslib_test_002_001,
   &oslib_test_002_002,
   &oslib_test_002_003,
+  &oslib_test_002_004,
   NULL
 };
 
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_003_001
  * - @subpage oslib_test_003_002
+ * - @subpage oslib_test_003_003
  * .
  */
 
@@ -356,6 +357,166 @@ static const testcase_t oslib_test_003_002 = {
   oslib_test_003_002_execute
 };
 
+/**
+ * @page oslib_test_003_003 [3.3] Pipes zero-copy API
+ *
+ * <h2>Description</h2>
+ * The reserve/commit and peek/consume API is tested, spans must be
+ * contiguous and never cross the buffer boundary.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Reserving and committing a partial span.
+ * - [3.3.2] Peeking and consuming a partial span.
+ * - [3.3.3] Reserving up to the buffer boundary.
+ * - [3.3.4] Cancelling a reservation.
+ * - [3.3.5] Peeking up to the buffer boundary.
+ * - [3.3.6] Peeking while pipe is empty.
+ * - [3.3.7] Reserving while pipe is full.
+ * - [3.3.8] Reserving while pipe is in reset state.
+ * .
+ */
+
+static void oslib_test_003_003_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_003_execute(void) {
+
+  /* [3.3.1] Reserving and committing a partial span.*/
+  test_set_step(1);
+  {
+    size_t n;
+    uint8_t *p;
+
+    p = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == pipe1.buffer) && (n == PIPE_SIZE), "wrong span");
+    memcpy(p, pipe_pattern, 10);
+    chPipeWriteCommit(&pipe1, 10);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 10),
+                "invalid pipe state");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Peeking and consuming a partial span.*/
+  test_set_step(2);
+  {
+    size_t n;
+    const uint8_t *p;
+
+    p = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == pipe1.buffer) && (n == 10), "wrong span");
+    test_assert(memcmp(pipe_pattern, p, 10) == 0, "content mismatch");
+    chPipeReadConsume(&pipe1, 4);
+    test_assert((pipe1.rdptr == pipe1.buffer + 4) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 6),
+                "invalid pipe state");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Reserving up to the buffer boundary.*/
+  test_set_step(3);
+  {
+    size_t n;
+    uint8_t *p;
+
+    p = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == pipe1.buffer + 10) && (n == PIPE_SIZE - 10),
+                "wrong span");
+    memcpy(p, pipe_pattern + 10, PIPE_SIZE - 10);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer + 4) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == PIPE_SIZE - 4),
+                "invalid pipe state");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Cancelling a reservation.*/
+  test_set_step(4);
+  {
+    size_t n;
+    uint8_t *p;
+
+    p = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == pipe1.buffer) && (n == 4), "wrong span");
+    chPipeWriteCommit(&pipe1, 0);
+    test_assert((pipe1.rdptr == pipe1.buffer + 4) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == PIPE_SIZE - 4),
+                "invalid pipe state");
+  }
+  test_end_step(4);
+
+  /* [3.3.5] Peeking up to the buffer boundary.*/
+  test_set_step(5);
+  {
+    size_t n;
+    const uint8_t *p;
+
+    p = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == pipe1.buffer + 4) && (n == PIPE_SIZE - 4),
+                "wrong span");
+    test_assert(memcmp(pipe_pattern + 4, p, PIPE_SIZE - 4) == 0,
+                "content mismatch");
+    chPipeReadConsume(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+  test_end_step(5);
+
+  /* [3.3.6] Peeking while pipe is empty.*/
+  test_set_step(6);
+  {
+    size_t n;
+    const uint8_t *p;
+
+    p = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == NULL) && (n == 0), "not empty");
+  }
+  test_end_step(6);
+
+  /* [3.3.7] Reserving while pipe is full.*/
+  test_set_step(7);
+  {
+    size_t n;
+    uint8_t *p;
+
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    p = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == NULL) && (n == 0), "not full");
+  }
+  test_end_step(7);
+
+  /* [3.3.8] Reserving while pipe is in reset state.*/
+  test_set_step(8);
+  {
+    size_t n;
+    uint8_t *p;
+
+    chPipeReset(&pipe1);
+    p = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((p == NULL) && (n == 0), "not reset");
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+  test_end_step(8);
+}
+
+static const testcase_t oslib_test_003_003 = {
+  "Pipes zero-copy API",
+  oslib_test_003_003_setup,
+  NULL,
+  oslib_test_003_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -366,6 +527,7 @@ static const testcase_t oslib_test_003_002 = {
 const testcase_t * const oslib_test_sequence_003_array[] = {
   &oslib_test_003_001,
   &oslib_test_003_002,
+  &oslib_test_003_003,
   NULL
 };
 
@@ -37,6 +37,10 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_004_001
+ * - @subpage oslib_test_004_002
+ * - @subpage oslib_test_004_003
+ * - @subpage oslib_test_004_004
+ * - @subpage oslib_test_004_005
  * .
  */
 
@@ -48,9 +52,10 @@
 
 #define JOBS_QUEUE_SIZE 4
 
-static jobs_queue_t jq;
-static job_descriptor_t jobs[JOBS_QUEUE_SIZE];
-static msg_t msg_queue[JOBS_QUEUE_SIZE];
+static jobs_queue_t jq, jq2;
+static job_descriptor_t jobs[JOBS_QUEUE_SIZE], jobs2[JOBS_QUEUE_SIZE];
+static msg_t msg_queue[JOBS_MSGBUF_SIZE(JOBS_QUEUE_SIZE)];
+static msg_t msg_queue2[JOBS_MSGBUF_SIZE(JOBS_QUEUE_SIZE)];
 
 static void job_slow(void *arg) {
 
@@ -58,6 +63,31 @@ static void job_slow(void *arg) {
   chThdSleepMilliseconds(10);
 }
 
+static void job_fast(void *arg) {
+
+  test_emit_token((char)(uintptr_t)arg);
+}
+
+static void post_job(jobs_queue_t *jqp, job_function_t jobfunc,
+                     char token, unsigned prio) {
+  job_descriptor_t *jdp;
+
+  jdp = chJobGet(jqp);
+  jdp->jobfunc = jobfunc;
+  jdp->jobarg  = (void *)(uintptr_t)token;
+  chJobPostPrio(jqp, jdp, prio);
+}
+
+static void dispatch_all(jobs_queue_t *jqp) {
+
+  while (chJobDispatchTimeout(jqp, TIME_IMMEDIATE) == MSG_OK) {
+  }
+}
+
+#if defined(__CHIBIOS_RT__)
+static THD_WORKING_AREA(waWorkers[2], 256);
+#endif
+
 static THD_WORKING_AREA(wa1Thread1, 256);
 static THD_WORKING_AREA(wa2Thread1, 256);
 static THD_FUNCTION(Thread1, arg) {
@@ -166,7 +196,7 @@ static void oslib_test_004_001_execute(void) {
 
     chSysLock();
     cnt = chGuardedPoolGetCounterI(&jq.free);
-    used = chMBGetUsedCountI(&jq.mbx);
+    used = (size_t)chJobGetPendingI(&jq);
     chSysUnlock();
 
     test_assert(cnt == (cnt_t)JOBS_QUEUE_SIZE, "lost descriptors");
@@ -182,6 +212,340 @@ static const testcase_t oslib_test_004_001 = {
   oslib_test_004_001_execute
 };
 
+/**
+ * @page oslib_test_004_002 [4.2] Jobs priorities
+ *
+ * <h2>Description</h2>
+ * Jobs are posted with different priorities while no dispatcher is
+ * running, the dispatching order is verified.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Initializing the Jobs Queue object.
+ * - [4.2.2] Posting a normal job, an high priority job and a job ahead
+ *   of all the others.
+ * - [4.2.3] Dispatching all jobs, the highest priority jobs must be
+ *   executed first.
+ * - [4.2.4] Verifying that all descriptors have been returned.
+ * .
+ */
+
+static void oslib_test_004_002_execute(void) {
+
+  /* [4.2.1] Initializing the Jobs Queue object.*/
+  test_set_step(1);
+  {
+    chJobObjectInit(&jq, JOBS_QUEUE_SIZE, jobs, msg_queue);
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Posting a normal job, an high priority job and a job ahead
+     of all the others.*/
+  test_set_step(2);
+  {
+    job_descriptor_t *jdp;
+    cnt_t n;
+
+    post_job(&jq, job_fast, 'a', JOB_PRIO_NORMAL);
+    post_job(&jq, job_fast, 'b', CH_CFG_JOBS_PRIORITIES - 1);
+    jdp = chJobGet(&jq);
+    jdp->jobfunc = job_fast;
+    jdp->jobarg  = (void *)(uintptr_t)'c';
+    chJobPostAhead(&jq, jdp);
+
+    chSysLock();
+    n = chJobGetPendingI(&jq);
+    chSysUnlock();
+    test_assert(n == (cnt_t)3, "wrong pending jobs");
+  }
+  test_end_step(2);
+
+  /* [4.2.3] Dispatching all jobs, the highest priority jobs must be
+     executed first.*/
+  test_set_step(3);
+  {
+    msg_t msg;
+
+    dispatch_all(&jq);
+    msg = chJobDispatchTimeout(&jq, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+#if CH_CFG_JOBS_PRIORITIES > 1
+    test_assert_sequence("cba", "unexpected tokens");
+#else
+    test_assert_sequence("cab", "unexpected tokens");
+#endif
+  }
+  test_end_step(3);
+
+  /* [4.2.4] Verifying that all descriptors have been returned.*/
+  test_set_step(4);
+  {
+    cnt_t cnt;
+
+    chSysLock();
+    cnt = chGuardedPoolGetCounterI(&jq.free);
+    chSysUnlock();
+
+    test_assert(cnt == (cnt_t)JOBS_QUEUE_SIZE, "lost descriptors");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_004_002 = {
+  "Jobs priorities",
+  NULL,
+  NULL,
+  oslib_test_004_002_execute
+};
+
+/**
+ * @page oslib_test_004_003 [4.3] Jobs stealing
+ *
+ * <h2>Description</h2>
+ * Two Jobs Queues are created, the second is associated to the first as
+ * peer, jobs posted on the first queue are executed by dispatching the
+ * second queue.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] Initializing the Jobs Queue objects.
+ * - [4.3.2] Posting jobs on the first queue and dispatching the second,
+ *   jobs are taken from the peer.
+ * - [4.3.3] Waiting on both queues empty, a timeout is expected.
+ * - [4.3.4] Verifying that all descriptors have been returned to their
+ *   queue.
+ * .
+ */
+
+static void oslib_test_004_003_execute(void) {
+  static jobs_queue_t * const peers[] = {&jq2, &jq};
+
+  /* [4.3.1] Initializing the Jobs Queue objects.*/
+  test_set_step(1);
+  {
+    chJobObjectInit(&jq, JOBS_QUEUE_SIZE, jobs, msg_queue);
+    chJobObjectInit(&jq2, JOBS_QUEUE_SIZE, jobs2, msg_queue2);
+    chJobSetPeers(&jq2, peers, 2U, TIME_MS2I(2));
+  }
+  test_end_step(1);
+
+  /* [4.3.2] Posting jobs on the first queue and dispatching the second,
+     jobs are taken from the peer.*/
+  test_set_step(2);
+  {
+    post_job(&jq, job_fast, 'a', JOB_PRIO_NORMAL);
+    post_job(&jq, job_fast, 'b', JOB_PRIO_NORMAL);
+    post_job(&jq2, job_fast, 'c', JOB_PRIO_NORMAL);
+    dispatch_all(&jq2);
+    test_assert_sequence("cab", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [4.3.3] Waiting on both queues empty, a timeout is expected.*/
+  test_set_step(3);
+  {
+    msg_t msg;
+
+    msg = chJobDispatchTimeout(&jq2, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+  }
+  test_end_step(3);
+
+  /* [4.3.4] Verifying that all descriptors have been returned to their
+     queue.*/
+  test_set_step(4);
+  {
+    cnt_t cnt1, cnt2;
+
+    chSysLock();
+    cnt1 = chGuardedPoolGetCounterI(&jq.free);
+    cnt2 = chGuardedPoolGetCounterI(&jq2.free);
+    chSysUnlock();
+
+    test_assert(cnt1 == (cnt_t)JOBS_QUEUE_SIZE, "lost descriptors");
+    test_assert(cnt2 == (cnt_t)JOBS_QUEUE_SIZE, "lost descriptors");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_004_003 = {
+  "Jobs stealing",
+  NULL,
+  NULL,
+  oslib_test_004_003_execute
+};
+
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_004_004 [4.4] Workers pool
+ *
+ * <h2>Description</h2>
+ * A pool of workers is created, jobs are executed by the workers in
+ * posting order then the workers are stopped.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - defined(__CHIBIOS_RT__)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.4.1] Initializing the Jobs Queue object.
+ * - [4.4.2] Creating the workers pool.
+ * - [4.4.3] Sending jobs with various timings.
+ * - [4.4.4] Sending a null job for each worker and waiting for the
+ *   workers termination.
+ * .
+ */
+
+static void oslib_test_004_004_execute(void) {
+  thread_t *workers[2];
+
+  /* [4.4.1] Initializing the Jobs Queue object.*/
+  test_set_step(1);
+  {
+    chJobObjectInit(&jq, JOBS_QUEUE_SIZE, jobs, msg_queue);
+  }
+  test_end_step(1);
+
+  /* [4.4.2] Creating the workers pool.*/
+  test_set_step(2);
+  {
+    static const jobs_workers_descriptor_t wd = {
+      .name  = "worker",
+      .wbase = waWorkers[0],
+      .wsize = sizeof (waWorkers[0]),
+      .n     = 2U,
+      .prio  = NORMALPRIO - 1,
+      .owner = NULL
+    };
+
+    chJobCreateWorkers(&jq, &wd, workers);
+  }
+  test_end_step(2);
+
+  /* [4.4.3] Sending jobs with various timings.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    for (i = 0; i < 6; i++) {
+      post_job(&jq, job_slow, (char)('a' + i), JOB_PRIO_NORMAL);
+    }
+  }
+  test_end_step(3);
+
+  /* [4.4.4] Sending a null job for each worker and waiting for the
+     workers termination.*/
+  test_set_step(4);
+  {
+    cnt_t cnt;
+
+    post_job(&jq, NULL, '\0', JOB_PRIO_NORMAL);
+    post_job(&jq, NULL, '\0', JOB_PRIO_NORMAL);
+    (void) chThdWait(workers[0]);
+    (void) chThdWait(workers[1]);
+    test_assert_sequence("abcdef", "unexpected tokens");
+
+    chSysLock();
+    cnt = chGuardedPoolGetCounterI(&jq.free);
+    chSysUnlock();
+    test_assert(cnt == (cnt_t)JOBS_QUEUE_SIZE, "lost descriptors");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_004_004 = {
+  "Workers pool",
+  NULL,
+  NULL,
+  oslib_test_004_004_execute
+};
+#endif /* defined(__CHIBIOS_RT__) */
+
+#if (CH_CFG_JOBS_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_004_005 [4.5] Jobs statistics
+ *
+ * <h2>Description</h2>
+ * The queue depth, dispatch and stealing counters are verified.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_JOBS_STATISTICS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.5.1] Initializing the Jobs Queue objects.
+ * - [4.5.2] Posting three jobs, the depth is verified.
+ * - [4.5.3] Dispatching one job locally and two from the peer queue, the
+ *   counters are verified.
+ * - [4.5.4] Resetting the statistics.
+ * .
+ */
+
+static void oslib_test_004_005_execute(void) {
+  static jobs_queue_t * const peers[] = {&jq};
+  jobs_stats_t stats;
+
+  /* [4.5.1] Initializing the Jobs Queue objects.*/
+  test_set_step(1);
+  {
+    chJobObjectInit(&jq, JOBS_QUEUE_SIZE, jobs, msg_queue);
+    chJobObjectInit(&jq2, JOBS_QUEUE_SIZE, jobs2, msg_queue2);
+    chJobSetPeers(&jq2, peers, 1U, TIME_MS2I(2));
+  }
+  test_end_step(1);
+
+  /* [4.5.2] Posting three jobs, the depth is verified.*/
+  test_set_step(2);
+  {
+    post_job(&jq, job_fast, 'a', JOB_PRIO_NORMAL);
+    post_job(&jq, job_fast, 'b', JOB_PRIO_NORMAL);
+    post_job(&jq, job_fast, 'c', JOB_PRIO_NORMAL);
+    chJobGetStats(&jq, &stats);
+    test_assert(stats.depth == (ucnt_t)3, "wrong depth");
+    test_assert(stats.maxdepth == (ucnt_t)3, "wrong max depth");
+    test_assert(stats.dispatched == (ucnt_t)0, "wrong dispatched counter");
+  }
+  test_end_step(2);
+
+  /* [4.5.3] Dispatching one job locally and two from the peer queue, the
+     counters are verified.*/
+  test_set_step(3);
+  {
+    (void) chJobDispatchTimeout(&jq, TIME_IMMEDIATE);
+    dispatch_all(&jq2);
+    test_assert_sequence("abc", "unexpected tokens");
+    chJobGetStats(&jq, &stats);
+    test_assert(stats.depth == (ucnt_t)0, "wrong depth");
+    test_assert(stats.maxdepth == (ucnt_t)3, "wrong max depth");
+    test_assert(stats.dispatched == (ucnt_t)3, "wrong dispatched counter");
+    test_assert(stats.stolen == (ucnt_t)2, "wrong stolen counter");
+    test_assert(stats.cumulative >= (uint64_t)stats.worst, "wrong latency");
+  }
+  test_end_step(3);
+
+  /* [4.5.4] Resetting the statistics.*/
+  test_set_step(4);
+  {
+    chJobResetStats(&jq);
+    chJobGetStats(&jq, &stats);
+    test_assert(stats.maxdepth == (ucnt_t)0, "wrong max depth");
+    test_assert(stats.dispatched == (ucnt_t)0, "wrong dispatched counter");
+    test_assert(stats.stolen == (ucnt_t)0, "wrong stolen counter");
+    test_assert(stats.worst == (rtcnt_t)0, "wrong worst latency");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_004_005 = {
+  "Jobs statistics",
+  NULL,
+  NULL,
+  oslib_test_004_005_execute
+};
+#endif /* CH_CFG_JOBS_STATISTICS == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -191,6 +555,14 @@ static const testcase_t oslib_test_004_001 = {
  */
 const testcase_t * const oslib_test_sequence_004_array[] = {
   &oslib_test_004_001,
+  &oslib_test_004_002,
+  &oslib_test_004_003,
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+  &oslib_test_004_004,
+#endif
+#if (CH_CFG_JOBS_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_004_005,
+#endif
   NULL
 };
 
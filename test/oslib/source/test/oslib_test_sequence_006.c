@@ -37,6 +37,8 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
+ * - @subpage oslib_test_006_003
  * .
  */
 
@@ -88,6 +90,65 @@ static bool obj_write(objects_cache_t *ocp,
   return false;
 }
 
+/* Marks an object as modified and releases it.*/
+static void obj_release_dirty(objects_cache_t *ocp, oc_object_t *objp) {
+
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  objp->obj_flags |= OC_FLAG_LAZYWRITE;
+  chCacheReleaseObject(ocp, objp);
+}
+
+#if (CH_CFG_OBJ_CACHES_STATISTICS == TRUE) && (PORT_SUPPORTS_RT == TRUE)
+#define BENCH_OBJECTS       32
+#define BENCH_KEYS          24
+#define BENCH_ACCESSES      4000
+
+static oc_hash_element_t bench_hash_elements[BENCH_OBJECTS * 2];
+static cached_object_t bench_objects[BENCH_OBJECTS];
+static uint32_t bench_seed;
+static uint32_t bench_writes;
+static uint32_t bench_next_key;
+static bool bench_unordered;
+
+static uint32_t bench_rand(void) {
+
+  bench_seed = (bench_seed * 1103515245U) + 12345U;
+  return bench_seed >> 16;
+}
+
+static bool bench_read(objects_cache_t *ocp,
+                       oc_object_t *objp,
+                       bool async) {
+
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return false;
+}
+
+/* Counts the writes and checks that they come in ascending key order
+   since the last reset of bench_next_key.*/
+static bool bench_write(objects_cache_t *ocp,
+                        oc_object_t *objp,
+                        bool async) {
+
+  if (objp->obj_key < bench_next_key) {
+    bench_unordered = true;
+  }
+  bench_next_key = objp->obj_key + 1U;
+  bench_writes++;
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -287,6 +348,250 @@ static const testcase_t oslib_test_006_001 = {
   oslib_test_006_001_execute
 };
 
+/**
+ * @page oslib_test_006_002 [6.2] Lazy writes flush
+ *
+ * <h2>Description</h2>
+ * Objects of two owners are marked for lazy write then flushed by range
+ * and by owner, writes must happen in ascending key order and the
+ * objects must stay in cache.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Cache initialization.
+ * - [6.2.2] Modifying objects of two owners without writing them.
+ * - [6.2.3] Flushing a keys range of the first owner.
+ * - [6.2.4] Flushing the first owner, only the remaining object is
+ *   written.
+ * - [6.2.5] Flushing the second owner.
+ * - [6.2.6] Checking that flushed objects are still cached.
+ * .
+ */
+
+static void oslib_test_006_002_execute(void) {
+
+  /* [6.2.1] Cache initialization.*/
+  test_set_step(1);
+  {
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_elements,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Modifying objects of two owners without writing them.*/
+  test_set_step(2);
+  {
+    static const uint32_t keys[] = {3U, 1U, 2U};
+    unsigned i;
+
+    for (i = 0; i < sizeof keys / sizeof keys[0]; i++) {
+      obj_release_dirty(&cache1, chCacheGetObject(&cache1, NULL, keys[i]));
+    }
+    obj_release_dirty(&cache1, chCacheGetObject(&cache1, &cache1, 0U));
+
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Flushing a keys range of the first owner.*/
+  test_set_step(3);
+  {
+    bool error;
+
+    error = chCacheFlushRange(&cache1, NULL, 2U, 3U);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("CD", "unexpected tokens");
+  }
+  test_end_step(3);
+
+  /* [6.2.4] Flushing the first owner, only the remaining object is
+     written.*/
+  test_set_step(4);
+  {
+    bool error;
+
+    error = chCacheFlushOwner(&cache1, NULL);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("B", "unexpected tokens");
+
+    error = chCacheFlushOwner(&cache1, NULL);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(4);
+
+  /* [6.2.5] Flushing the second owner.*/
+  test_set_step(5);
+  {
+    bool error;
+
+    error = chCacheFlushOwner(&cache1, &cache1);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("A", "unexpected tokens");
+  }
+  test_end_step(5);
+
+  /* [6.2.6] Checking that flushed objects are still cached.*/
+  test_set_step(6);
+  {
+    uint32_t i;
+
+    for (i = 1U; i < 4U; i++) {
+      oc_object_t *objp = chCacheGetObject(&cache1, NULL, i);
+
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+      test_assert((objp->obj_flags & OC_FLAG_LAZYWRITE) == 0U, "not written");
+
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Lazy writes flush",
+  NULL,
+  NULL,
+  oslib_test_006_002_execute
+};
+
+#if ((CH_CFG_OBJ_CACHES_STATISTICS == TRUE) && (PORT_SUPPORTS_RT == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_006_003 [6.3] Cache hit rate and flush throughput
+ *
+ * <h2>Description</h2>
+ * Two owners access random keys of a working set larger than the
+ * cache, one access in four modifies the object. The hit rate and the
+ * hash slots usage are reported, then all the modified objects are
+ * flushed and the flush time is reported.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_OBJ_CACHES_STATISTICS == TRUE) && (PORT_SUPPORTS_RT == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.3.1] Cache initialization.
+ * - [6.3.2] Running the workload, hits and misses must account for all
+ *   the accesses.
+ * - [6.3.3] Flushing both owners, writes must be in ascending key
+ *   order for each owner.
+ * - [6.3.4] The scores are printed.
+ * .
+ */
+
+static void oslib_test_006_003_execute(void) {
+  oc_stats_t stats;
+  rtcnt_t flush_cycles;
+  uint32_t flushed;
+
+  /* [6.3.1] Cache initialization.*/
+  test_set_step(1);
+  {
+    chCacheObjectInit(&cache1,
+                      BENCH_OBJECTS * 2,
+                      bench_hash_elements,
+                      BENCH_OBJECTS,
+                      sizeof (cached_object_t),
+                      bench_objects,
+                      bench_read,
+                      bench_write);
+  }
+  test_end_step(1);
+
+  /* [6.3.2] Running the workload, hits and misses must account for all
+     the accesses.*/
+  test_set_step(2);
+  {
+    unsigned i;
+
+    bench_seed = 0x5A5A1234U;
+    for (i = 0; i < BENCH_ACCESSES; i++) {
+      void *owner = (bench_rand() & 1U) != 0U ? (void *)&cache1 : NULL;
+      oc_object_t *objp = chCacheGetObject(&cache1, owner,
+                                           bench_rand() % BENCH_KEYS);
+
+      if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+        (void) chCacheReadObject(&cache1, objp, false);
+      }
+      if ((bench_rand() & 3U) == 0U) {
+        obj_release_dirty(&cache1, objp);
+      }
+      else {
+        chCacheReleaseObject(&cache1, objp);
+      }
+    }
+
+    chCacheGetStats(&cache1, &stats);
+    test_assert(stats.hits + stats.misses == BENCH_ACCESSES,
+                "accesses not accounted");
+    test_assert(stats.longest > 0U, "empty hash");
+  }
+  test_end_step(2);
+
+  /* [6.3.3] Flushing both owners, writes must be in ascending key
+     order for each owner.*/
+  test_set_step(3);
+  {
+    rtcnt_t start;
+    bool error;
+
+    bench_writes    = 0U;
+    bench_unordered = false;
+    start = chSysGetRealtimeCounterX();
+    bench_next_key  = 0U;
+    error = chCacheFlushOwner(&cache1, NULL);
+    bench_next_key  = 0U;
+    error = chCacheFlushOwner(&cache1, &cache1) || error;
+    flush_cycles = chSysGetRealtimeCounterX() - start;
+    flushed = bench_writes;
+
+    test_assert(error == false, "returned error");
+    test_assert(bench_unordered == false, "unordered writes");
+    test_assert(chCacheFlushOwner(&cache1, NULL) == false, "returned error");
+    test_assert(bench_writes == flushed, "objects not clean");
+  }
+  test_end_step(3);
+
+  /* [6.3.4] The scores are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Hit rate: ");
+    test_printn((stats.hits * 100U) / (stats.hits + stats.misses));
+    test_print("%, ");
+    test_printn(stats.used);
+    test_print(" slots used, ");
+    test_printn(stats.longest);
+    test_println(" longest chain");
+    test_print("--- Flush: ");
+    test_printn(flushed);
+    test_print(" objects in ");
+    test_printn((uint32_t)flush_cycles);
+    test_println(" cycles");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_006_003 = {
+  "Cache hit rate and flush throughput",
+  NULL,
+  NULL,
+  oslib_test_006_003_execute
+};
+#endif /* (CH_CFG_OBJ_CACHES_STATISTICS == TRUE) && (PORT_SUPPORTS_RT == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -296,6 +601,10 @@ static const testcase_t oslib_test_006_001 = {
  */
 const testcase_t * const oslib_test_sequence_006_array[] = {
   &oslib_test_006_001,
+  &oslib_test_006_002,
+#if ((CH_CFG_OBJ_CACHES_STATISTICS == TRUE) && (PORT_SUPPORTS_RT == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_006_003,
+#endif
   NULL
 };
 
@@ -39,6 +39,7 @@
  * - @subpage oslib_test_007_001
  * - @subpage oslib_test_007_002
  * - @subpage oslib_test_007_003
+ * - @subpage oslib_test_007_004
  * .
  */
 
@@ -49,8 +50,10 @@
  ****************************************************************************/
 
 #define MEMORY_POOL_SIZE 4
+#define MAGAZINE_SIZE 2
 
 static uintptr_t objects[MEMORY_POOL_SIZE];
+static void *batch[MEMORY_POOL_SIZE + 1];
 static MEMORYPOOL_DECL(mp1, sizeof (uintptr_t), PORT_NATURAL_ALIGN, NULL);
 
 #if CH_CFG_USE_SEMAPHORES
@@ -288,6 +291,111 @@ static const testcase_t oslib_test_007_003 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+/**
+ * @page oslib_test_007_004 [7.4] Batches and magazines
+ *
+ * <h2>Description</h2>
+ * The memory pool batch APIs and the magazines built on them are
+ * tested, objects must be conserved across magazine refills, drains
+ * and flushes.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.4.1] Adding the objects to the pool using chPoolLoadArray().
+ * - [7.4.2] Emptying the pool using chPoolAllocBatch(), a larger
+ *   request must be truncated.
+ * - [7.4.3] Returning all the objects using chPoolFreeBatch() then
+ *   emptying the pool again.
+ * - [7.4.4] Allocating all the objects through a magazine, the
+ *   magazine is refilled in batches until the pool is empty.
+ * - [7.4.5] Releasing all the objects through the magazine, the
+ *   excess is drained into the pool.
+ * - [7.4.6] Flushing the magazine, all the objects must be back into
+ *   the pool.
+ * .
+ */
+
+static void oslib_test_007_004_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (uintptr_t), NULL);
+}
+
+static void oslib_test_007_004_execute(void) {
+  pool_magazine_t mg;
+  void *mgobjs[MAGAZINE_SIZE];
+  unsigned i;
+
+  /* [7.4.1] Adding the objects to the pool using chPoolLoadArray().*/
+  test_set_step(1);
+  {
+    chPoolLoadArray(&mp1, objects, MEMORY_POOL_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.4.2] Emptying the pool using chPoolAllocBatch(), a larger
+     request must be truncated.*/
+  test_set_step(2);
+  {
+    test_assert(chPoolAllocBatch(&mp1, batch, MEMORY_POOL_SIZE + 1) == MEMORY_POOL_SIZE,
+                "wrong batch size");
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(2);
+
+  /* [7.4.3] Returning all the objects using chPoolFreeBatch() then
+     emptying the pool again.*/
+  test_set_step(3);
+  {
+    chPoolFreeBatch(&mp1, batch, MEMORY_POOL_SIZE);
+    test_assert(chPoolAllocBatch(&mp1, batch, MEMORY_POOL_SIZE + 1) == MEMORY_POOL_SIZE,
+                "wrong batch size");
+    chPoolFreeBatch(&mp1, batch, MEMORY_POOL_SIZE);
+  }
+  test_end_step(3);
+
+  /* [7.4.4] Allocating all the objects through a magazine, the
+     magazine is refilled in batches until the pool is empty.*/
+  test_set_step(4);
+  {
+    chPoolMagazineObjectInit(&mg, &mp1, mgobjs, MAGAZINE_SIZE);
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      batch[i] = chPoolMagazineAlloc(&mg);
+      test_assert(batch[i] != NULL, "list empty");
+    }
+    test_assert(chPoolMagazineAlloc(&mg) == NULL, "list not empty");
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(4);
+
+  /* [7.4.5] Releasing all the objects through the magazine, the
+     excess is drained into the pool.*/
+  test_set_step(5);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      chPoolMagazineFree(&mg, batch[i]);
+    }
+    test_assert(chPoolMagazineGetCountX(&mg) <= MAGAZINE_SIZE, "magazine overflow");
+    test_assert(chPoolMagazineGetCountX(&mg) > 0U, "magazine empty");
+  }
+  test_end_step(5);
+
+  /* [7.4.6] Flushing the magazine, all the objects must be back into
+     the pool.*/
+  test_set_step(6);
+  {
+    chPoolMagazineFlush(&mg);
+    test_assert(chPoolMagazineGetCountX(&mg) == 0U, "magazine not empty");
+    test_assert(chPoolAllocBatch(&mp1, batch, MEMORY_POOL_SIZE + 1) == MEMORY_POOL_SIZE,
+                "objects lost");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_007_004 = {
+  "Batches and magazines",
+  oslib_test_007_004_setup,
+  NULL,
+  oslib_test_007_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -303,6 +411,7 @@ const testcase_t * const oslib_test_sequence_007_array[] = {
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
   &oslib_test_007_003,
 #endif
+  &oslib_test_007_004,
   NULL
 };
 
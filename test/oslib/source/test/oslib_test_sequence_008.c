@@ -38,6 +38,8 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
+ * - @subpage oslib_test_008_004
  * .
  */
 
@@ -47,12 +49,133 @@
  * Shared code.
  ****************************************************************************/
 
+#include <string.h>
+
 #define ALLOC_SIZE 16
 #define HEAP_SIZE (ALLOC_SIZE * 8)
 
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
 
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+#define TLSF_HEAP_SIZE 4096
+
+static uint8_t tlsf_heap_buffer[TLSF_HEAP_SIZE];
+#endif
+
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) && (PORT_SUPPORTS_RT == TRUE)
+#define BENCH_SLOTS 32
+#define BENCH_OPERATIONS 4000
+
+typedef struct {
+  uint32_t          alloc_cycles;
+  uint32_t          alloc_max;
+  uint32_t          allocs;
+  uint32_t          free_cycles;
+  uint32_t          free_max;
+  uint32_t          frees;
+  uint32_t          failures;
+  size_t            fragments;
+  size_t            largest;
+} heap_bench_t;
+
+static uint32_t bench_seed;
+
+static uint32_t bench_rand(void) {
+
+  bench_seed = (bench_seed * 1103515245U) + 12345U;
+  return bench_seed >> 16;
+}
+
+/* Mixed workload, one allocation in four is a packet-sized block, the
+   others are string-sized blocks.*/
+static void heap_bench(memory_heap_t *heapp, heap_bench_t *hbp) {
+  void *slots[BENCH_SLOTS];
+  unsigned i;
+
+  memset(hbp, 0, sizeof (heap_bench_t));
+  for (i = 0; i < BENCH_SLOTS; i++) {
+    slots[i] = NULL;
+  }
+
+  bench_seed = 0x5A5A1234U;
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    unsigned slot = bench_rand() % BENCH_SLOTS;
+    rtcnt_t start;
+    uint32_t cycles;
+
+    if (slots[slot] == NULL) {
+      size_t size;
+
+      if ((bench_rand() & 3U) == 0U) {
+        size = 64U + (bench_rand() % 192U);
+      }
+      else {
+        size = 4U + (bench_rand() % 36U);
+      }
+
+      start = chSysGetRealtimeCounterX();
+      slots[slot] = chHeapAlloc(heapp, size);
+      cycles = (uint32_t)(chSysGetRealtimeCounterX() - start);
+
+      if (slots[slot] == NULL) {
+        hbp->failures++;
+        continue;
+      }
+      hbp->allocs++;
+      hbp->alloc_cycles += cycles;
+      if (cycles > hbp->alloc_max) {
+        hbp->alloc_max = cycles;
+      }
+    }
+    else {
+      start = chSysGetRealtimeCounterX();
+      chHeapFree(slots[slot]);
+      cycles = (uint32_t)(chSysGetRealtimeCounterX() - start);
+      slots[slot] = NULL;
+
+      hbp->frees++;
+      hbp->free_cycles += cycles;
+      if (cycles > hbp->free_max) {
+        hbp->free_max = cycles;
+      }
+    }
+  }
+
+  hbp->fragments = chHeapStatus(heapp, NULL, &hbp->largest);
+
+  for (i = 0; i < BENCH_SLOTS; i++) {
+    if (slots[i] != NULL) {
+      chHeapFree(slots[i]);
+    }
+  }
+}
+
+static void heap_bench_print(const char *name, heap_bench_t *hbp) {
+
+  test_print("--- ");
+  test_print(name);
+  test_print(": alloc ");
+  test_printn(hbp->alloc_cycles / hbp->allocs);
+  test_print("/");
+  test_printn(hbp->alloc_max);
+  test_print(" free ");
+  test_printn(hbp->free_cycles / hbp->frees);
+  test_print("/");
+  test_printn(hbp->free_max);
+  test_println(" cycles avg/max");
+  test_print("--- ");
+  test_print(name);
+  test_print(": ");
+  test_printn(hbp->failures);
+  test_print(" failures, ");
+  test_printn((uint32_t)hbp->fragments);
+  test_print(" fragments, ");
+  test_printn((uint32_t)hbp->largest);
+  test_println(" bytes largest");
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -296,6 +419,234 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_008_003 [8.3] TLSF allocation and fragmentation
+ *
+ * <h2>Description</h2>
+ * A TLSF heap is tested using series of allocations/deallocations
+ * including aligned allocations. The test expects to find the heap back
+ * to the initial status after each sequence.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP_TLSF == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Testing initial conditions, the heap must not be
+ *   fragmented and one free block present, finally, integrity is
+ *   checked.
+ * - [8.3.2] Trying to allocate an block bigger than available space,
+ *   an error is expected, finally, integrity is checked.
+ * - [8.3.3] Allocating then freeing in the same order and in reverse
+ *   order, blocks must be merged back, finally, integrity is checked.
+ * - [8.3.4] Small fragments handling. Checking the behavior when
+ *   allocating blocks with size not multiple of alignment unit,
+ *   finally, integrity is checked.
+ * - [8.3.5] Aligned allocations, the returned blocks must be aligned
+ *   and the leading fragments returned to the heap, finally, integrity
+ *   is checked.
+ * - [8.3.6] Allocating the whole available space, finally, integrity
+ *   is checked.
+ * - [8.3.7] Testing final conditions. The heap geometry must be the
+ *   same than the one registered at beginning, finally, integrity is
+ *   checked.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  chHeapObjectInitTLSF(&test_heap, tlsf_heap_buffer, sizeof(tlsf_heap_buffer));
+}
+
+static void oslib_test_008_003_execute(void) {
+  void *p1, *p2, *p3;
+  size_t n, sz;
+
+  /* [8.3.1] Testing initial conditions, the heap must not be
+     fragmented and one free block present, finally, integrity is
+     checked.*/
+  test_set_step(1);
+  {
+    test_assert(chHeapStatus(&test_heap, &sz, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Trying to allocate an block bigger than available space,
+     an error is expected, finally, integrity is checked.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, sizeof tlsf_heap_buffer);
+    test_assert(p1 == NULL, "allocation not failed");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Allocating then freeing in the same order and in reverse
+     order, blocks must be merged back, finally, integrity is
+     checked.*/
+  test_set_step(3);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    p2 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    p3 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert((p1 != NULL) && (p2 != NULL) && (p3 != NULL), "allocation failed");
+    chHeapFree(p1);                                 /* Does not merge.*/
+    chHeapFree(p2);                                 /* Merges backward.*/
+    chHeapFree(p3);                                 /* Merges both sides.*/
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    p2 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    p3 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    chHeapFree(p3);                                 /* Merges forward.*/
+    chHeapFree(p2);                                 /* Merges forward.*/
+    chHeapFree(p1);                                 /* Merges forward.*/
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(3);
+
+  /* [8.3.4] Small fragments handling. Checking the behavior when
+     allocating blocks with size not multiple of alignment unit,
+     finally, integrity is checked.*/
+  test_set_step(4);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE + 1);
+    p2 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    chHeapFree(p1);
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 2, "invalid state");
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert((chHeapStatus(&test_heap, &n, NULL) == 1) ||
+                (chHeapStatus(&test_heap, &n, NULL) == 2), "heap fragmented");
+    chHeapFree(p2);
+    chHeapFree(p1);
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(4);
+
+  /* [8.3.5] Aligned allocations, the returned blocks must be aligned
+     and the leading fragments returned to the heap, finally, integrity
+     is checked.*/
+  test_set_step(5);
+  {
+    p1 = chHeapAllocAligned(&test_heap, ALLOC_SIZE, 64U);
+    p2 = chHeapAllocAligned(&test_heap, ALLOC_SIZE, 256U);
+    p3 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert((p1 != NULL) && (p2 != NULL) && (p3 != NULL), "allocation failed");
+    test_assert(MEM_IS_ALIGNED(p1, 64U), "not aligned");
+    test_assert(MEM_IS_ALIGNED(p2, 256U), "not aligned");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+    chHeapFree(p2);
+    chHeapFree(p1);
+    chHeapFree(p3);
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(5);
+
+  /* [8.3.6] Allocating the whole available space, finally, integrity
+     is checked.*/
+  test_set_step(6);
+  {
+    (void)chHeapStatus(&test_heap, &n, NULL);
+    p1 = chHeapAlloc(&test_heap, n);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 0, "not empty");
+    chHeapFree(p1);
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(6);
+
+  /* [8.3.7] Testing final conditions. The heap geometry must be the
+     same than the one registered at beginning, finally, integrity is
+     checked.*/
+  test_set_step(7);
+  {
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(n == sz, "size changed");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(7);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "TLSF allocation and fragmentation",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
+#if ((CH_CFG_USE_HEAP_TLSF == TRUE) && (PORT_SUPPORTS_RT == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_008_004 [8.4] Heaps fragmentation and latency
+ *
+ * <h2>Description</h2>
+ * The same mixed workload of packet-sized and string-sized blocks is
+ * executed on a first-fit heap and on a TLSF heap of the same size.
+ * Allocation and release latencies, failed allocations and the final
+ * fragmentation are reported.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_HEAP_TLSF == TRUE) && (PORT_SUPPORTS_RT == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.4.1] Running the workload on a first-fit heap, the heap must
+ *   be back to the initial state after releasing all blocks.
+ * - [8.4.2] Running the workload on a TLSF heap, the heap must be back
+ *   to the initial state after releasing all blocks.
+ * - [8.4.3] The scores are printed.
+ * .
+ */
+
+static void oslib_test_008_004_execute(void) {
+  heap_bench_t ff, tlsf;
+
+  /* [8.4.1] Running the workload on a first-fit heap, the heap must
+     be back to the initial state after releasing all blocks.*/
+  test_set_step(1);
+  {
+    chHeapObjectInit(&test_heap, tlsf_heap_buffer, sizeof(tlsf_heap_buffer));
+    heap_bench(&test_heap, &ff);
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(1);
+
+  /* [8.4.2] Running the workload on a TLSF heap, the heap must be back
+     to the initial state after releasing all blocks.*/
+  test_set_step(2);
+  {
+    chHeapObjectInitTLSF(&test_heap, tlsf_heap_buffer, sizeof(tlsf_heap_buffer));
+    heap_bench(&test_heap, &tlsf);
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(2);
+
+  /* [8.4.3] The scores are printed.*/
+  test_set_step(3);
+  {
+    heap_bench_print("First-fit", &ff);
+    heap_bench_print("TLSF", &tlsf);
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_008_004 = {
+  "Heaps fragmentation and latency",
+  NULL,
+  NULL,
+  oslib_test_008_004_execute
+};
+#endif /* (CH_CFG_USE_HEAP_TLSF == TRUE) && (PORT_SUPPORTS_RT == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -306,6 +657,12 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_008_003,
+#endif
+#if ((CH_CFG_USE_HEAP_TLSF == TRUE) && (PORT_SUPPORTS_RT == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_008_004,
+#endif
   NULL
 };
 
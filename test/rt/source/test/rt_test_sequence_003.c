@@ -32,6 +32,8 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_003_001
  * - @subpage rt_test_003_002
+ * - @subpage rt_test_003_003
+ * - @subpage rt_test_003_004
  * .
  */
 
@@ -41,6 +43,21 @@
 
 #include "ch.h"
 
+static virtual_timer_t vt1, vt2, vt3;
+
+static void tmo(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+  (void)p;
+}
+
+/* In tick-less mode the system time can advance while arming the timers,
+   a difference of one tick is tolerated.*/
+static bool time_is_near(sysinterval_t a, sysinterval_t b) {
+
+  return (a + (sysinterval_t)1 >= b) && (a <= b + (sysinterval_t)1);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -153,6 +170,165 @@ static const testcase_t rt_test_003_002 = {
   rt_test_003_002_execute
 };
 
+/**
+ * @page rt_test_003_003 [3.3] Virtual timers slack functionality
+ *
+ * <h2>Description</h2>
+ * The alignment of timers armed using @p chVTDoSetWithSlackI() is
+ * tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] A timer is armed with a window including the expiration of an
+ *   already armed timer, the two timers must expire together.
+ * - [3.3.2] A timer is armed with a window not including any expiration,
+ *   the timer must expire at the window end.
+ * - [3.3.3] A timer is armed with a window including the end of the
+ *   previous window, the two timers must expire together.
+ * .
+ */
+
+static void rt_test_003_003_teardown(void) {
+  chSysLock();
+  if (chVTIsArmedI(&vt1)) {
+    chVTDoResetI(&vt1);
+  }
+  if (chVTIsArmedI(&vt2)) {
+    chVTDoResetI(&vt2);
+  }
+  if (chVTIsArmedI(&vt3)) {
+    chVTDoResetI(&vt3);
+  }
+  chSysUnlock();
+}
+
+static void rt_test_003_003_execute(void) {
+
+  /* [3.3.1] A timer is armed with a window including the expiration of an
+     already armed timer, the two timers must expire together.*/
+  test_set_step(1);
+  {
+    sysinterval_t t1, t2;
+
+    chSysLock();
+    chVTDoSetI(&vt1, TIME_MS2I(100), tmo, NULL);
+    chVTDoSetWithSlackI(&vt2, TIME_MS2I(50), TIME_MS2I(100), tmo, NULL);
+    t1 = chVTGetRemainingIntervalI(&vt1);
+    t2 = chVTGetRemainingIntervalI(&vt2);
+    chSysUnlock();
+    test_assert(time_is_near(t2, t1), "not aligned");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] A timer is armed with a window not including any expiration, the
+     timer must expire at the window end.*/
+  test_set_step(2);
+  {
+    sysinterval_t t3;
+
+    chSysLock();
+    chVTDoSetWithSlackI(&vt3, TIME_MS2I(200), TIME_MS2I(20), tmo, NULL);
+    t3 = chVTGetRemainingIntervalI(&vt3);
+    chSysUnlock();
+    test_assert(time_is_near(t3, TIME_MS2I(220)), "not at window end");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] A timer is armed with a window including the end of the previous
+     window, the two timers must expire together.*/
+  test_set_step(3);
+  {
+    sysinterval_t t1, t3;
+
+    chSysLock();
+    chVTDoResetI(&vt1);
+    chVTDoSetWithSlackI(&vt1, TIME_MS2I(210), TIME_MS2I(50), tmo, NULL);
+    t1 = chVTGetRemainingIntervalI(&vt1);
+    t3 = chVTGetRemainingIntervalI(&vt3);
+    chSysUnlock();
+    test_assert(time_is_near(t1, t3), "not aligned");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_003_003 = {
+  "Virtual timers slack functionality",
+  NULL,
+  rt_test_003_003_teardown,
+  rt_test_003_003_execute
+};
+
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_CFG_ST_TIMEDELTA > 0)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_004 [3.4] Virtual timers slack coalescing
+ *
+ * <h2>Description</h2>
+ * A set of timers is armed using @p chVTDoSetWithSlackI() with
+ * overlapping windows, the kernel statistics are used to verify that
+ * the timers are served by fewer alarms than the number of timers
+ * fired.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_STATISTICS == TRUE) && (CH_CFG_ST_TIMEDELTA > 0)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] Eight timers are armed with staggered delays and
+ *   overlapping windows then the thread sleeps until all of them
+ *   fired.
+ * - [3.4.2] All the timers must have fired and the number of alarms
+ *   must be lower than the number of timers fired.
+ * .
+ */
+
+static void rt_test_003_004_execute(void) {
+  static virtual_timer_t vtv[8];
+  ucnt_t alarms, fired;
+  unsigned i;
+
+  /* [3.4.1] Eight timers are armed with staggered delays and
+     overlapping windows then the thread sleeps until all of them
+     fired.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    alarms = currcore->kernel_stats.n_vt_alarms;
+    fired  = currcore->kernel_stats.n_vt_fired;
+    for (i = 0U; i < 8U; i++) {
+      chVTDoSetWithSlackI(&vtv[i], TIME_MS2I(10U + i), TIME_MS2I(20),
+                          tmo, NULL);
+    }
+    chSysUnlock();
+    chThdSleepMilliseconds(50);
+  }
+  test_end_step(1);
+
+  /* [3.4.2] All the timers must have fired and the number of alarms
+     must be lower than the number of timers fired.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    alarms = currcore->kernel_stats.n_vt_alarms - alarms;
+    fired  = currcore->kernel_stats.n_vt_fired - fired;
+    chSysUnlock();
+    for (i = 0U; i < 8U; i++) {
+      test_assert(!chVTIsArmed(&vtv[i]), "timer still armed");
+    }
+    test_assert(fired >= (ucnt_t)8, "timers not fired");
+    test_assert(alarms < fired, "timers not coalesced");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_003_004 = {
+  "Virtual timers slack coalescing",
+  NULL,
+  NULL,
+  rt_test_003_004_execute
+};
+#endif /* (CH_DBG_STATISTICS == TRUE) && (CH_CFG_ST_TIMEDELTA > 0) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -163,6 +339,10 @@ static const testcase_t rt_test_003_002 = {
 const testcase_t * const rt_test_sequence_003_array[] = {
   &rt_test_003_001,
   &rt_test_003_002,
+  &rt_test_003_003,
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_CFG_ST_TIMEDELTA > 0)) || defined(__DOXYGEN__)
+  &rt_test_003_004,
+#endif
   NULL
 };
 
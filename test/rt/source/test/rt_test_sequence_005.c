@@ -34,6 +34,8 @@
  * - @subpage rt_test_005_002
  * - @subpage rt_test_005_003
  * - @subpage rt_test_005_004
+ * - @subpage rt_test_005_005
+ * - @subpage rt_test_005_006
  * .
  */
 
@@ -46,6 +48,70 @@ static THD_FUNCTION(thread, p) {
   test_emit_token(*(char *)p);
 }
 
+#if CH_CFG_USE_EDF == TRUE
+typedef struct {
+  char          token;
+  sysinterval_t deadline;
+  sysinterval_t offset;
+  sysinterval_t busy;
+} edf_job_t;
+
+static systime_t edf_start;
+
+static THD_FUNCTION(edf_thread, p) {
+  const edf_job_t *jp = (const edf_job_t *)p;
+
+  chThdSetDeadline(jp->deadline);
+  chThdSleepUntil(chTimeAddX(edf_start, jp->offset));
+  test_emit_token(jp->token);
+  if (jp->busy > (sysinterval_t)0) {
+    systime_t start = chVTGetSystemTimeX();
+    systime_t end = chTimeAddX(start, jp->busy);
+
+    while (chVTIsSystemTimeWithinX(start, end)) {
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    test_emit_token((char)(jp->token + 1));
+  }
+}
+
+#if CH_DBG_THREADS_PROFILING == TRUE
+typedef struct {
+  sysinterval_t cost;
+  sysinterval_t period;
+  unsigned      jobs;
+} edf_task_t;
+
+static ucnt_t edf_misses;
+
+static THD_FUNCTION(edf_task, p) {
+  const edf_task_t *tsp = (const edf_task_t *)p;
+  thread_t *tp = chThdGetSelfX();
+  unsigned i;
+
+  chThdSleepUntil(edf_start);
+  chThdSetDeadline(tsp->period);
+  for (i = 0U; i < tsp->jobs; i++) {
+    systime_t ticks = chThdGetTicksX(tp);
+
+    /* Consuming the job execution time.*/
+    while (chTimeDiffX(ticks, chThdGetTicksX(tp)) < tsp->cost) {
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    (void) chThdSleepUntilNextPeriod(tsp->period);
+  }
+
+  chSysLock();
+  edf_misses += chThdGetDeadlineMissesX(tp);
+  chSysUnlock();
+}
+#endif
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -339,6 +405,133 @@ static const testcase_t rt_test_005_004 = {
 };
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_005 [5.5] Earliest deadline first ordering
+ *
+ * <h2>Description</h2>
+ * Threads at the EDF priority level are released and the order of
+ * execution is checked against their deadlines.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EDF == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.5.1] Four threads are created in reverse deadline order and
+ *   released at the same time, the execution sequence is tested.
+ * - [5.5.2] A thread is executing when two more threads are released,
+ *   the thread with the earlier deadline preempts it, the thread with
+ *   the later deadline does not.
+ * .
+ */
+
+static void rt_test_005_005_execute(void) {
+
+  /* [5.5.1] Four threads are created in reverse deadline order and
+     released at the same time, the execution sequence is tested.*/
+  test_set_step(1);
+  {
+    static const edf_job_t jobs[4] = {
+      {'D', TIME_MS2I(40), TIME_MS2I(10), (sysinterval_t)0},
+      {'C', TIME_MS2I(30), TIME_MS2I(10), (sysinterval_t)0},
+      {'B', TIME_MS2I(20), TIME_MS2I(10), (sysinterval_t)0},
+      {'A', TIME_MS2I(10), TIME_MS2I(10), (sysinterval_t)0}
+    };
+
+    edf_start = chVTGetSystemTimeX();
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[0]);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[1]);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[2]);
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[3]);
+    test_wait_threads();
+    test_assert_sequence("ABCD", "invalid sequence");
+  }
+  test_end_step(1);
+
+  /* [5.5.2] A thread is executing when two more threads are released,
+     the thread with the earlier deadline preempts it, the thread with
+     the later deadline does not.*/
+  test_set_step(2);
+  {
+    static const edf_job_t jobs[3] = {
+      {'B', TIME_MS2I(50),  TIME_MS2I(10), TIME_MS2I(20)},
+      {'A', TIME_MS2I(25),  TIME_MS2I(20), (sysinterval_t)0},
+      {'D', TIME_MS2I(100), TIME_MS2I(20), (sysinterval_t)0}
+    };
+
+    edf_start = chVTGetSystemTimeX();
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[0]);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[1]);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_thread, (void *)&jobs[2]);
+    test_wait_threads();
+    test_assert_sequence("BACD", "invalid sequence");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_005_005 = {
+  "Earliest deadline first ordering",
+  NULL,
+  NULL,
+  rt_test_005_005_execute
+};
+#endif /* CH_CFG_USE_EDF == TRUE */
+
+#if ((CH_CFG_USE_EDF == TRUE) && (CH_DBG_THREADS_PROFILING == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_006 [5.6] Earliest deadline first schedulability
+ *
+ * <h2>Description</h2>
+ * Two periodic tasks with 90% total utilization are executed at the
+ * EDF priority level, the task set is not schedulable with fixed
+ * priorities but no deadline must be missed under EDF.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_EDF == TRUE) && (CH_DBG_THREADS_PROFILING == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.6.1] Executing a task with cost 20mS and period 50mS and a task
+ *   with cost 35mS and period 70mS for 700mS, no deadline misses are
+ *   expected.
+ * .
+ */
+
+static void rt_test_005_006_execute(void) {
+
+  /* [5.6.1] Executing a task with cost 20mS and period 50mS and a task
+     with cost 35mS and period 70mS for 700mS, no deadline misses are
+     expected.*/
+  test_set_step(1);
+  {
+    static const edf_task_t tasks[2] = {
+      {TIME_MS2I(20), TIME_MS2I(50), 14U},
+      {TIME_MS2I(35), TIME_MS2I(70), 10U}
+    };
+
+    edf_misses = (ucnt_t)0;
+    edf_start = chTimeAddX(test_wait_tick(), TIME_MS2I(10));
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_task, (void *)&tasks[0]);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, CH_CFG_EDF_PRIORITY, edf_task, (void *)&tasks[1]);
+    test_wait_threads();
+    test_assert(edf_misses == (ucnt_t)0, "deadlines missed");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t rt_test_005_006 = {
+  "Earliest deadline first schedulability",
+  NULL,
+  NULL,
+  rt_test_005_006_execute
+};
+#endif /* (CH_CFG_USE_EDF == TRUE) && (CH_DBG_THREADS_PROFILING == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -352,6 +545,12 @@ const testcase_t * const rt_test_sequence_005_array[] = {
   &rt_test_005_003,
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   &rt_test_005_004,
+#endif
+#if (CH_CFG_USE_EDF == TRUE) || defined(__DOXYGEN__)
+  &rt_test_005_005,
+#endif
+#if ((CH_CFG_USE_EDF == TRUE) && (CH_DBG_THREADS_PROFILING == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_005_006,
 #endif
   NULL
 };
@@ -46,6 +46,9 @@
  * - @subpage rt_test_012_010
  * - @subpage rt_test_012_011
  * - @subpage rt_test_012_012
+ * - @subpage rt_test_012_013
+ * - @subpage rt_test_012_014
+ * - @subpage rt_test_012_015
  * .
  */
 
@@ -59,6 +62,9 @@ static semaphore_t sem1;
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
 static mutex_t mtx1;
 #endif
+#if CH_CFG_USE_CONDVARS || defined(__DOXYGEN__)
+static condition_variable_t cv1;
+#endif
 
 static void tmo(virtual_timer_t *vtp, void *param) {
 
@@ -138,6 +144,174 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+/*
+ * Fake threads are laid out in the test buffer, they are only used to
+ * populate the ready list and never executed because their priority is
+ * lower than the test thread priority.
+ */
+#define BMK_READY_MAX       ((unsigned)(sizeof (test_buffer) / sizeof (thread_t)))
+#define BMK_READY_N(n)      (((n) < BMK_READY_MAX) ? (n) : (BMK_READY_MAX - 1U))
+
+NOINLINE static uint32_t ready_loop_test(unsigned nthreads) {
+  thread_t *tps = (thread_t *)(void *)test_buffer;
+  thread_t *tp = &tps[nthreads];
+  systime_t start, end;
+  uint32_t n = 0;
+  unsigned i;
+
+  for (i = 0U; i <= nthreads; i++) {
+    tps[i].hdr.pqueue.prio = LOWPRIO + 1U + (tprio_t)(i & 7U);
+    tps[i].state           = CH_STATE_SUSPENDED;
+    tps[i].owner           = chThdGetSelfX()->owner;
+    tps[i].u.rdymsg        = MSG_OK;
+  }
+  tp->hdr.pqueue.prio = LOWPRIO;
+
+  /* The fake threads are made ready after waiting, the test thread does
+     not sleep until they are removed from the ready list.*/
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  chSysLock();
+  for (i = 0U; i < nthreads; i++) {
+    (void) chSchReadyI(&tps[i]);
+  }
+  chSysUnlock();
+  do {
+    chSysLock();
+    (void) chSchReadyI(tp);
+    (void) ch_sch_ready_dequeue(tp, tp->hdr.pqueue.prio);
+    tp->state = CH_STATE_SUSPENDED;
+    chSysUnlock();
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  chSysLock();
+  for (i = 0U; i < nthreads; i++) {
+    (void) ch_sch_ready_dequeue(&tps[i], tps[i].hdr.pqueue.prio);
+  }
+  chSysUnlock();
+
+  return n;
+}
+
+/*
+ * Background timers are laid out in the test buffer, their delays are
+ * longer than the measurement window so they never fire while measuring.
+ */
+#define BMK_VT_MAX          ((unsigned)(sizeof (test_buffer) / sizeof (virtual_timer_t)))
+#define BMK_VT_N(n)         (((n) < BMK_VT_MAX) ? (n) : (BMK_VT_MAX - 1U))
+
+static sysinterval_t vt_random_delay(uint32_t *seedp) {
+
+  *seedp = (*seedp * 1103515245U) + 12345U;
+  return TIME_MS2I(1500) + (sysinterval_t)((*seedp >> 8) %
+                                           (uint32_t)TIME_MS2I(1000));
+}
+
+NOINLINE static uint32_t vt_loop_test(unsigned ntimers) {
+  virtual_timer_t *vts = (virtual_timer_t *)(void *)test_buffer;
+  virtual_timer_t *vtp = &vts[ntimers];
+  systime_t start, end;
+  uint32_t n = 0, seed = 0x12345678U;
+  unsigned i;
+
+  for (i = 0U; i <= ntimers; i++) {
+    chVTObjectInit(&vts[i]);
+  }
+
+  /* The background timers are armed after waiting, the measurement
+     window ends before the earliest of them.*/
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  chSysLock();
+  for (i = 0U; i < ntimers; i++) {
+    chVTDoSetI(&vts[i], vt_random_delay(&seed), tmo, NULL);
+  }
+  chSysUnlock();
+  do {
+    sysinterval_t delay = vt_random_delay(&seed);
+
+    chSysLock();
+    chVTDoSetI(vtp, delay, tmo, NULL);
+    chVTDoResetI(vtp);
+    chSysUnlock();
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  chSysLock();
+  for (i = 0U; i < ntimers; i++) {
+    chVTResetI(&vts[i]);
+  }
+  chSysUnlock();
+
+  return n;
+}
+
+#if CH_CFG_USE_CONDVARS
+#define BMK_CV_WAITERS      4U
+
+static THD_FUNCTION(bmk_thread9, p) {
+
+  (void)p;
+  chMtxLock(&mtx1);
+  while (!chThdShouldTerminateX()) {
+    (void) chCondWait(&cv1);
+  }
+  chMtxUnlock(&mtx1);
+}
+
+NOINLINE static uint32_t cond_loop_test(bool broadcast, uint32_t *ctxswcp) {
+  systime_t start, end;
+  uint32_t n = 0;
+  unsigned i;
+
+  /* The waiters have higher priority, they are all waiting on the
+     condition variable when the creation loop ends.*/
+  for (i = 0U; i < BMK_CV_WAITERS; i++) {
+    threads[i] = chThdCreateStatic(wa[i], WA_SIZE,
+                                   chThdGetPriorityX() + 1,
+                                   bmk_thread9, NULL);
+  }
+
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+#if CH_DBG_STATISTICS == TRUE
+  *ctxswcp = (uint32_t)currcore->kernel_stats.n_ctxswc;
+#else
+  *ctxswcp = 0U;
+#endif
+  do {
+    chMtxLock(&mtx1);
+    if (broadcast) {
+      chCondBroadcast(&cv1);
+    }
+    else {
+      for (i = 0U; i < BMK_CV_WAITERS; i++) {
+        chCondSignal(&cv1);
+      }
+    }
+    chMtxUnlock(&mtx1);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+#if CH_DBG_STATISTICS == TRUE
+  *ctxswcp = (uint32_t)currcore->kernel_stats.n_ctxswc - *ctxswcp;
+#endif
+
+  test_terminate_threads();
+  chCondBroadcast(&cv1);
+  test_wait_threads();
+
+  return n;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -917,27 +1091,265 @@ static const testcase_t rt_test_012_011 = {
 #endif /* CH_CFG_USE_MUTEXES ==TRUE */
 
 /**
- * @page rt_test_012_012 [12.12] RAM Footprint
+ * @page rt_test_012_012 [12.12] Ready list scaling
  *
  * <h2>Description</h2>
- * The memory size of the various kernel objects is printed.
+ * A thread is made ready and removed from the ready list into a
+ * continuous loop while the ready list contains an increasing number
+ * of higher priority threads.<br> The performance is calculated by
+ * measuring the number of iterations after a second of continuous
+ * operations, the scores allow to evaluate how the ready list
+ * insertion cost scales with the number of ready threads.
  *
  * <h2>Test Steps</h2>
- * - [12.12.1] The size of the system area is printed.
- * - [12.12.2] The size of a thread structure is printed.
- * - [12.12.3] The size of a virtual timer structure is printed.
- * - [12.12.4] The size of a semaphore structure is printed.
- * - [12.12.5] The size of a mutex is printed.
- * - [12.12.6] The size of a condition variable is printed.
- * - [12.12.7] The size of an event source is printed.
- * - [12.12.8] The size of an event listener is printed.
- * - [12.12.9] The size of a mailbox is printed.
+ * - [12.12.1] The ready list contains one thread. A thread is made
+ *   ready and removed continuously in a one-second time window.
+ * - [12.12.2] The ready list contains four threads. A thread is made
+ *   ready and removed continuously in a one-second time window.
+ * - [12.12.3] The ready list contains sixteen threads, or as many as
+ *   the test buffer allows. A thread is made ready and removed
+ *   continuously in a one-second time window.
+ * - [12.12.4] The scores are printed.
  * .
  */
 
 static void rt_test_012_012_execute(void) {
+  uint32_t n1, n2, n3;
+
+  /* [12.12.1] The ready list contains one thread. A thread is made
+     ready and removed continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    n1 = ready_loop_test(BMK_READY_N(1U));
+  }
+  test_end_step(1);
+
+  /* [12.12.2] The ready list contains four threads. A thread is made
+     ready and removed continuously in a one-second time window.*/
+  test_set_step(2);
+  {
+    n2 = ready_loop_test(BMK_READY_N(4U));
+  }
+  test_end_step(2);
+
+  /* [12.12.3] The ready list contains sixteen threads, or as many as
+     the test buffer allows. A thread is made ready and removed
+     continuously in a one-second time window.*/
+  test_set_step(3);
+  {
+    n3 = ready_loop_test(BMK_READY_N(16U));
+  }
+  test_end_step(3);
 
-  /* [12.12.1] The size of the system area is printed.*/
+  /* [12.12.4] The scores are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n1);
+    test_print(" ready/S, ");
+    test_printn(BMK_READY_N(1U));
+    test_println(" threads");
+    test_print("--- Score : ");
+    test_printn(n2);
+    test_print(" ready/S, ");
+    test_printn(BMK_READY_N(4U));
+    test_println(" threads");
+    test_print("--- Score : ");
+    test_printn(n3);
+    test_print(" ready/S, ");
+    test_printn(BMK_READY_N(16U));
+    test_println(" threads");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_012 = {
+  "Ready list scaling",
+  NULL,
+  NULL,
+  rt_test_012_012_execute
+};
+
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_013 [12.13] Condition variables broadcast performance
+ *
+ * <h2>Description</h2>
+ * Four threads with higher priority wait on a condition variable, the
+ * condition variable is signaled with the mutex locked into a
+ * continuous loop, first using a broadcast then signaling the threads
+ * one at a time.<br> The performance is calculated by measuring the
+ * number of iterations after a second of continuous operations. If
+ * kernel statistics are enabled then the context switches per
+ * iteration are also printed, a broadcast moves the threads on the
+ * mutex queue so no thread is woken just to block on the mutex.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_CONDVARS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.13.1] The condition variable is broadcast continuously in a
+ *   one-second time window.
+ * - [12.13.2] The waiting threads are signaled one at a time
+ *   continuously in a one-second time window.
+ * - [12.13.3] The scores are printed.
+ * .
+ */
+
+static void rt_test_012_013_setup(void) {
+  chMtxObjectInit(&mtx1);
+  chCondObjectInit(&cv1);
+}
+
+static void rt_test_012_013_execute(void) {
+  uint32_t n1, n2, sw1, sw2;
+
+  /* [12.13.1] The condition variable is broadcast continuously in a
+     one-second time window.*/
+  test_set_step(1);
+  {
+    n1 = cond_loop_test(true, &sw1);
+  }
+  test_end_step(1);
+
+  /* [12.13.2] The waiting threads are signaled one at a time
+     continuously in a one-second time window.*/
+  test_set_step(2);
+  {
+    n2 = cond_loop_test(false, &sw2);
+  }
+  test_end_step(2);
+
+  /* [12.13.3] The scores are printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n1);
+    test_print(" broadcasts/S");
+#if CH_DBG_STATISTICS == TRUE
+    test_print(", ");
+    test_printn(sw1 / n1);
+    test_print(" ctxswc/broadcast");
+#endif
+    test_println("");
+    test_print("--- Score : ");
+    test_printn(n2);
+    test_print(" signals x");
+    test_printn(BMK_CV_WAITERS);
+    test_print("/S");
+#if CH_DBG_STATISTICS == TRUE
+    test_print(", ");
+    test_printn(sw2 / n2);
+    test_print(" ctxswc/iteration");
+#endif
+    test_println("");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_013 = {
+  "Condition variables broadcast performance",
+  rt_test_012_013_setup,
+  NULL,
+  rt_test_012_013_execute
+};
+#endif /* CH_CFG_USE_CONDVARS == TRUE */
+
+/**
+ * @page rt_test_012_014 [12.14] Virtual Timers scaling
+ *
+ * <h2>Description</h2>
+ * A virtual timer is set and immediately reset into a continuous loop
+ * while an increasing number of other timers is armed.<br> The
+ * performance is calculated by measuring the number of iterations
+ * after a second of continuous operations, the scores allow to
+ * compare how the virtual timers backends scale with the number of
+ * armed timers.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.14.1] Eight timers are armed. A timer is set then reset
+ *   continuously in a one-second time window.
+ * - [12.14.2] Sixty-four timers are armed, or as many as the test
+ *   buffer allows. A timer is set then reset continuously in a
+ *   one-second time window.
+ * - [12.14.3] The scores are printed.
+ * .
+ */
+
+static void rt_test_012_014_execute(void) {
+  uint32_t n1, n2;
+
+  /* [12.14.1] Eight timers are armed. A timer is set then reset
+     continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    n1 = vt_loop_test(BMK_VT_N(8U));
+  }
+  test_end_step(1);
+
+  /* [12.14.2] Sixty-four timers are armed, or as many as the test
+     buffer allows. A timer is set then reset continuously in a
+     one-second time window.*/
+  test_set_step(2);
+  {
+    n2 = vt_loop_test(BMK_VT_N(64U));
+  }
+  test_end_step(2);
+
+  /* [12.14.3] The scores are printed.*/
+  test_set_step(3);
+  {
+#if CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL
+    test_println("--- Backend : timing wheel");
+#else
+    test_println("--- Backend : delta list");
+#endif
+    test_print("--- Score : ");
+    test_printn(n1);
+    test_print(" set+reset/S, ");
+    test_printn(BMK_VT_N(8U));
+    test_println(" timers");
+    test_print("--- Score : ");
+    test_printn(n2);
+    test_print(" set+reset/S, ");
+    test_printn(BMK_VT_N(64U));
+    test_println(" timers");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_014 = {
+  "Virtual Timers scaling",
+  NULL,
+  NULL,
+  rt_test_012_014_execute
+};
+
+/**
+ * @page rt_test_012_015 [12.15] RAM Footprint
+ *
+ * <h2>Description</h2>
+ * The memory size of the various kernel objects is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.15.1] The size of the system area is printed.
+ * - [12.15.2] The size of a thread structure is printed.
+ * - [12.15.3] The size of a virtual timer structure is printed.
+ * - [12.15.4] The size of a semaphore structure is printed.
+ * - [12.15.5] The size of a mutex is printed.
+ * - [12.15.6] The size of a condition variable is printed.
+ * - [12.15.7] The size of an event source is printed.
+ * - [12.15.8] The size of an event listener is printed.
+ * - [12.15.9] The size of a mailbox is printed.
+ * .
+ */
+
+static void rt_test_012_015_execute(void) {
+
+  /* [12.15.1] The size of the system area is printed.*/
   test_set_step(1);
   {
     test_print("--- OS    : ");
@@ -946,7 +1358,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(1);
 
-  /* [12.12.2] The size of a thread structure is printed.*/
+  /* [12.15.2] The size of a thread structure is printed.*/
   test_set_step(2);
   {
     test_print("--- Thread: ");
@@ -955,7 +1367,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(2);
 
-  /* [12.12.3] The size of a virtual timer structure is printed.*/
+  /* [12.15.3] The size of a virtual timer structure is printed.*/
   test_set_step(3);
   {
     test_print("--- Timer : ");
@@ -964,7 +1376,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(3);
 
-  /* [12.12.4] The size of a semaphore structure is printed.*/
+  /* [12.15.4] The size of a semaphore structure is printed.*/
   test_set_step(4);
   {
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
@@ -975,7 +1387,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(4);
 
-  /* [12.12.5] The size of a mutex is printed.*/
+  /* [12.15.5] The size of a mutex is printed.*/
   test_set_step(5);
   {
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
@@ -986,7 +1398,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(5);
 
-  /* [12.12.6] The size of a condition variable is printed.*/
+  /* [12.15.6] The size of a condition variable is printed.*/
   test_set_step(6);
   {
 #if CH_CFG_USE_CONDVARS || defined(__DOXYGEN__)
@@ -997,7 +1409,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(6);
 
-  /* [12.12.7] The size of an event source is printed.*/
+  /* [12.15.7] The size of an event source is printed.*/
   test_set_step(7);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -1008,7 +1420,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(7);
 
-  /* [12.12.8] The size of an event listener is printed.*/
+  /* [12.15.8] The size of an event listener is printed.*/
   test_set_step(8);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -1019,7 +1431,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(8);
 
-  /* [12.12.9] The size of a mailbox is printed.*/
+  /* [12.15.9] The size of a mailbox is printed.*/
   test_set_step(9);
   {
 #if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
@@ -1031,11 +1443,11 @@ static void rt_test_012_012_execute(void) {
   test_end_step(9);
 }
 
-static const testcase_t rt_test_012_012 = {
+static const testcase_t rt_test_012_015 = {
   "RAM Footprint",
   NULL,
   NULL,
-  rt_test_012_012_execute
+  rt_test_012_015_execute
 };
 
 /****************************************************************************
@@ -1070,6 +1482,11 @@ const testcase_t * const rt_test_sequence_012_array[] = {
   &rt_test_012_011,
 #endif
   &rt_test_012_012,
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_013,
+#endif
+  &rt_test_012_014,
+  &rt_test_012_015,
   NULL
 };
 
@@ -177,6 +177,58 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Indexed ready list.
+ * @details If enabled then the ready list is indexed by priority using a
+ *          bitmap, threads are made ready in constant time regardless of
+ *          the number of threads in the ready list.
+ *
+ * @note    The index requires one pointer of RAM for each priority level.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_READY_LIST_BITMAP)
+#define CH_CFG_READY_LIST_BITMAP            FALSE
+#endif
+
+/**
+ * @brief   Earliest deadline first band.
+ * @details If enabled then the ready threads at priority
+ *          @p CH_CFG_EDF_PRIORITY are scheduled by absolute deadline, the
+ *          deadlines are set using @p chThdSetDeadline() and advanced by
+ *          @p chThdSleepUntilNextPeriod(). Threads at other priority levels
+ *          are scheduled as usual.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_EDF)
+#define CH_CFG_USE_EDF                      FALSE
+#endif
+
+/**
+ * @brief   Priority level of the earliest deadline first band.
+ * @note    The value must be a plain number in the range 2..255.
+ *
+ * @note    The default is @p NORMALPRIO + 1.
+ */
+#if !defined(CH_CFG_EDF_PRIORITY)
+#define CH_CFG_EDF_PRIORITY                 129
+#endif
+
+/**
+ * @brief   Virtual timers backend.
+ * @details Selects the data structure used for armed virtual timers,
+ *          @p CH_VT_BACKEND_DLIST for a delta list or
+ *          @p CH_VT_BACKEND_WHEEL for a hierarchical timing wheel with
+ *          constant time timers insertion and removal.
+ *
+ * @note    The timing wheel requires about 32 list headers for each 5 bits
+ *          of @p CH_CFG_INTERVALS_SIZE.
+ * @note    The default is @p CH_VT_BACKEND_DLIST.
+ */
+#if !defined(CH_CFG_VT_BACKEND)
+#define CH_CFG_VT_BACKEND                   CH_VT_BACKEND_DLIST
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -427,6 +479,19 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   TLSF heaps support.
+ * @details If enabled then heaps initialized with @p chHeapObjectInitTLSF()
+ *          use a two levels segregated fit allocator with constant time
+ *          allocation and release.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF)
+#define CH_CFG_USE_HEAP_TLSF                TRUE
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -471,6 +536,18 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Objects Caches statistics.
+ * @details If enabled then the objects caches keep count of hits, misses
+ *          and collisions lists length for each hash table slot.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_OBJ_CACHES.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_STATISTICS)
+#define CH_CFG_OBJ_CACHES_STATISTICS        TRUE
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -493,6 +570,29 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Jobs Queues priority levels.
+ * @details Number of jobs priority levels, each level is a separate FIFO.
+ *
+ * @note    The default is @p 1.
+ * @note    Requires @p CH_CFG_USE_JOBS.
+ */
+#if !defined(CH_CFG_JOBS_PRIORITIES)
+#define CH_CFG_JOBS_PRIORITIES              3
+#endif
+
+/**
+ * @brief   Jobs Queues statistics.
+ * @details If enabled then the jobs queues keep track of the queue depth
+ *          and of the latency between posting and dispatching of jobs.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_JOBS and @p PORT_SUPPORTS_RT.
+ */
+#if !defined(CH_CFG_JOBS_STATISTICS)
+#define CH_CFG_JOBS_STATISTICS              TRUE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -582,6 +682,19 @@
 #define CH_DBG_STATISTICS                   FALSE
 #endif
 
+/**
+ * @brief   Debug option, critical zones profiling.
+ * @details If enabled the statistics module also records the lock site of
+ *          each critical zone and keeps a latency histogram plus a table
+ *          of the worst call sites.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_DBG_STATISTICS.
+ */
+#if !defined(CH_DBG_STATISTICS_CRIT_SITES)
+#define CH_DBG_STATISTICS_CRIT_SITES        FALSE
+#endif
+
 /**
  * @brief   Debug option, system state check.
  * @details If enabled the correct call protocol for system APIs is checked
@@ -635,6 +748,17 @@
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
 
+/**
+ * @brief   Trace stream.
+ * @details If enabled, trace events are also queued as compact binary
+ *          records to be drained by a low priority thread.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_TRACE_STREAM)
+#define CH_DBG_TRACE_STREAM                 FALSE
+#endif
+
 /**
  * @brief   Debug option, stack checks.
  * @details If enabled then a runtime stack check is performed.
@@ -122,6 +122,19 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_CFG_READY_LIST_BITMAP=TRUE"
+test cfg37 "-DCH_CFG_VT_BACKEND=CH_VT_BACKEND_WHEEL"
+test cfg38 "-DCH_CFG_VT_BACKEND=CH_VT_BACKEND_WHEEL -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_CFG_INTERVALS_SIZE=64"
+test cfg39 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE"
+test cfg40 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE -DCH_CFG_VT_BACKEND=CH_VT_BACKEND_WHEEL"
+test cfg41 "-DCH_CFG_USE_HEAP_TLSF=FALSE"
+test cfg42 "-DCH_CFG_OBJ_CACHES_STATISTICS=FALSE"
+test cfg43 "-DCH_CFG_JOBS_PRIORITIES=1 -DCH_CFG_JOBS_STATISTICS=FALSE"
+test cfg44 "-DCH_DBG_STATISTICS=TRUE -DCH_DBG_STATISTICS_CRIT_SITES=TRUE"
+test cfg45 "-DCH_DBG_TRACE_MASK=CH_DBG_TRACE_MASK_ALL -DCH_DBG_TRACE_STREAM=TRUE -DCH_DBG_TRACE_STREAM_SIZE=16"
+test cfg46 "-DCH_CFG_USE_EDF=TRUE"
+test cfg47 "-DCH_CFG_USE_EDF=TRUE -DCH_CFG_READY_LIST_BITMAP=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE"
+test cfg48 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE -DCH_DBG_STATISTICS=TRUE"
 
 rm *log.txt 2> /dev/null
 echo
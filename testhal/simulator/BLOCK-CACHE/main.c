@@ -0,0 +1,326 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "console.h"
+#include "chprintf.h"
+#include "hal_block_cache.h"
+
+/*===========================================================================*/
+/* RAM disk with an emulated SD card cost model.                             */
+/*===========================================================================*/
+
+#define RAMDISK_BLOCKS                      4096U
+
+/* Emulated costs in microseconds, a command overhead, a busy time for
+   writes and a transfer time per block.*/
+#define RAMDISK_CMD_COST                    100U
+#define RAMDISK_BUSY_COST                   400U
+#define RAMDISK_BLOCK_COST                  20U
+
+typedef struct {
+  const struct BaseBlockDeviceVMT *vmt;
+  _base_block_device_data
+  uint8_t               *data;
+  uint32_t              reads;
+  uint32_t              writes;
+  uint32_t              blocks;
+  uint32_t              cost;
+} RamDisk;
+
+static uint8_t disk_direct[RAMDISK_BLOCKS * BCACHE_CFG_BLOCK_SIZE];
+static uint8_t disk_cached[RAMDISK_BLOCKS * BCACHE_CFG_BLOCK_SIZE];
+
+static bool rd_is_inserted(void *instance) {
+
+  (void)instance;
+
+  return true;
+}
+
+static bool rd_is_protected(void *instance) {
+
+  (void)instance;
+
+  return false;
+}
+
+static bool rd_connect(void *instance) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  rdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_disconnect(void *instance) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  rdp->state = BLK_ACTIVE;
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_read(void *instance, uint32_t startblk,
+                    uint8_t *buffer, uint32_t n) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  if ((startblk >= RAMDISK_BLOCKS) || (n > RAMDISK_BLOCKS - startblk)) {
+    return HAL_FAILED;
+  }
+
+  memcpy(buffer, &rdp->data[startblk * BCACHE_CFG_BLOCK_SIZE],
+         n * BCACHE_CFG_BLOCK_SIZE);
+  rdp->reads++;
+  rdp->blocks += n;
+  rdp->cost   += RAMDISK_CMD_COST + (n * RAMDISK_BLOCK_COST);
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_write(void *instance, uint32_t startblk,
+                     const uint8_t *buffer, uint32_t n) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  if ((startblk >= RAMDISK_BLOCKS) || (n > RAMDISK_BLOCKS - startblk)) {
+    return HAL_FAILED;
+  }
+
+  memcpy(&rdp->data[startblk * BCACHE_CFG_BLOCK_SIZE], buffer,
+         n * BCACHE_CFG_BLOCK_SIZE);
+  rdp->writes++;
+  rdp->blocks += n;
+  rdp->cost   += RAMDISK_CMD_COST + RAMDISK_BUSY_COST +
+                 (n * RAMDISK_BLOCK_COST);
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_sync(void *instance) {
+
+  (void)instance;
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_get_info(void *instance, BlockDeviceInfo *bdip) {
+
+  (void)instance;
+
+  bdip->blk_size = BCACHE_CFG_BLOCK_SIZE;
+  bdip->blk_num  = RAMDISK_BLOCKS;
+
+  return HAL_SUCCESS;
+}
+
+static const struct BaseBlockDeviceVMT rd_vmt = {
+  (size_t)0,
+  rd_is_inserted,
+  rd_is_protected,
+  rd_connect,
+  rd_disconnect,
+  rd_read,
+  rd_write,
+  rd_sync,
+  rd_get_info
+};
+
+static void rdObjectInit(RamDisk *rdp, uint8_t *data) {
+
+  rdp->vmt    = &rd_vmt;
+  rdp->state  = BLK_ACTIVE;
+  rdp->data   = data;
+  rdp->reads  = 0U;
+  rdp->writes = 0U;
+  rdp->blocks = 0U;
+  rdp->cost   = 0U;
+  memset(data, 0, RAMDISK_BLOCKS * BCACHE_CFG_BLOCK_SIZE);
+}
+
+/*===========================================================================*/
+/* Block cache.                                                              */
+/*===========================================================================*/
+
+#define CACHE_SETS                          16U
+#define CACHE_WAYS                          4U
+
+static RamDisk rd_direct, rd_cached;
+static BlockCacheDriver bcache;
+static uint8_t cache_buffer[CACHE_WAYS * CACHE_SETS * BCACHE_CFG_BLOCK_SIZE];
+static bcache_line_t cache_lines[CACHE_WAYS * CACHE_SETS];
+
+static const BlockCacheConfig bcache_config = {
+  .blkp     = (BaseBlockDevice *)&rd_cached,
+  .sets     = CACHE_SETS,
+  .ways     = CACHE_WAYS,
+  .buffer   = cache_buffer,
+  .lines    = cache_lines
+};
+
+/*===========================================================================*/
+/* FatFs-like workload.                                                      */
+/*===========================================================================*/
+
+/*
+ * The access pattern of FatFs appending small records to log files and
+ * calling f_sync() after each record. FatFs keeps a single sector window
+ * for FAT and directory sectors, so switching between them re-reads
+ * sectors and writes back the dirty window every time.
+ */
+#define FAT_START                           32U
+#define DIR_START                           256U
+#define DATA_START                          512U
+#define FILES_NUM                           4U
+#define FILE_SECTORS                        512U
+#define CLUSTER_SECTORS                     4U
+#define APPENDS_NUM                         1024U
+
+static uint8_t sector[BCACHE_CFG_BLOCK_SIZE];
+static uint8_t readback[4U * BCACHE_CFG_BLOCK_SIZE];
+
+static void fill(uint32_t block, uint32_t n) {
+
+  memset(sector, (int)((block + n) & 0xFFU), sizeof (sector));
+  sector[0] = (uint8_t)block;
+  sector[1] = (uint8_t)(block >> 8);
+}
+
+static bool workload(BaseBlockDevice *bdp) {
+  uint32_t i, f, pos, data, fat, dir;
+
+  for (i = 0U; i < APPENDS_NUM; i++) {
+    f    = i % FILES_NUM;
+    pos  = i / FILES_NUM;
+    data = DATA_START + (f * FILE_SECTORS) + pos;
+    fat  = FAT_START + ((f * FILE_SECTORS / CLUSTER_SECTORS + pos) / 128U);
+    dir  = DIR_START + (f / 2U);
+
+    /* Partial sector append, the file buffer is loaded then written.*/
+    if (blkRead(bdp, data, sector, 1U)) {
+      return true;
+    }
+    fill(data, i);
+    if (blkWrite(bdp, data, sector, 1U)) {
+      return true;
+    }
+
+    /* Cluster allocation on the first sector of a cluster.*/
+    if ((pos % CLUSTER_SECTORS) == 0U) {
+      if (blkRead(bdp, fat, sector, 1U)) {
+        return true;
+      }
+      fill(fat, i);
+      if (blkWrite(bdp, fat, sector, 1U)) {
+        return true;
+      }
+    }
+
+    /* f_sync() updating the directory entry.*/
+    if (blkRead(bdp, dir, sector, 1U)) {
+      return true;
+    }
+    fill(dir, i);
+    if (blkWrite(bdp, dir, sector, 1U)) {
+      return true;
+    }
+
+    /* Periodic multi-sector read back of a file, bypassing the cache.*/
+    if ((i % 64U) == 63U) {
+      data = DATA_START + (f * FILE_SECTORS);
+      if (blkRead(bdp, data, readback, 4U)) {
+        return true;
+      }
+      for (pos = 0U; pos < 4U; pos++) {
+        if ((readback[pos * BCACHE_CFG_BLOCK_SIZE] != (uint8_t)(data + pos)) ||
+            (readback[pos * BCACHE_CFG_BLOCK_SIZE + 1U] !=
+             (uint8_t)((data + pos) >> 8))) {
+          return true;
+        }
+      }
+    }
+  }
+
+  return blkSync(bdp);
+}
+
+static void report(BaseSequentialStream *chp, const char *name,
+                   const RamDisk *rdp) {
+
+  chprintf(chp, "--- %s: %u reads, %u writes, %u blocks, "
+                "%u ms emulated device time\r\n",
+           name, (unsigned)rdp->reads, (unsigned)rdp->writes,
+           (unsigned)rdp->blocks, (unsigned)(rdp->cost / 1000U));
+}
+
+/*===========================================================================*/
+/* Main and generic code.                                                    */
+/*===========================================================================*/
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  BaseSequentialStream *chp = (BaseSequentialStream *)&CD1;
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  rdObjectInit(&rd_direct, disk_direct);
+  rdObjectInit(&rd_cached, disk_cached);
+  bcacheObjectInit(&bcache);
+  bcacheStart(&bcache, &bcache_config);
+  if (blkConnect(&rd_direct) || blkConnect(&bcache)) {
+    chSysHalt("connect");
+  }
+
+  chprintf(chp, "*** FatFs-like workload, %u appends on %u files, "
+                "cache %ux%u lines\r\n",
+           (unsigned)APPENDS_NUM, (unsigned)FILES_NUM,
+           (unsigned)CACHE_SETS, (unsigned)CACHE_WAYS);
+
+  if (workload((BaseBlockDevice *)&rd_direct)) {
+    chSysHalt("direct");
+  }
+  report(chp, "direct", &rd_direct);
+
+  if (workload((BaseBlockDevice *)&bcache)) {
+    chSysHalt("cached");
+  }
+  report(chp, "cached", &rd_cached);
+  chprintf(chp, "--- cache: %u hits, %u misses\r\n",
+           (unsigned)bcache.stats.hits, (unsigned)bcache.stats.misses);
+
+  chprintf(chp, "--- disk images %s\r\n",
+           memcmp(disk_direct, disk_cached, sizeof (disk_direct)) == 0 ?
+           "match" : "DIFFER");
+
+  exit(0);
+}
@@ -17,4 +17,10 @@
 #ifndef MCUCONF_H
 #define MCUCONF_H
 
+/*
+ * Simulated flash timings.
+ */
+#define SIM_EFL_ERASE_TIME                  2U
+#define SIM_EFL_PROGRAM_COST                5000U
+
 #endif /* MCUCONF_H */
@@ -21,5 +21,7 @@
  * Simulator MFS configuration.
  */
 #define MFS_CFG_MAX_RECORDS                 256
+#define MFS_CFG_CRC_SLICES                  8
+#define MFS_CFG_INCREMENTAL_GC              TRUE
 
 #endif /* MFSCONF_H */
@@ -0,0 +1,214 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "console.h"
+#include "chprintf.h"
+#include "trace_streamer.h"
+
+/*
+ * Usage: ch [trace file] [seconds]
+ *
+ * The trace stream is written in the host file, it can be converted using
+ * tools/trace_streamer/trace2json.py.
+ */
+#define DEFAULT_TRACE_FILE                  "trace.bin"
+#define DEFAULT_SECONDS                     5
+
+/*===========================================================================*/
+/* Host file stream.                                                         */
+/*===========================================================================*/
+
+typedef struct {
+  const struct BaseSequentialStreamVMT *vmt;
+  _base_sequential_stream_data
+  FILE                  *f;
+  size_t                written;
+} HostFileStream;
+
+static size_t fs_write(void *ip, const uint8_t *bp, size_t n) {
+  HostFileStream *fsp = ip;
+
+  n = fwrite(bp, 1, n, fsp->f);
+  fsp->written += n;
+  return n;
+}
+
+static size_t fs_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+static msg_t fs_put(void *ip, uint8_t b) {
+
+  return fs_write(ip, &b, 1) == 1 ? MSG_OK : MSG_RESET;
+}
+
+static msg_t fs_get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT fs_vmt = {
+  (size_t)0, fs_write, fs_read, fs_put, fs_get
+};
+
+static HostFileStream fs = {&fs_vmt, NULL, 0};
+
+/*===========================================================================*/
+/* Workload.                                                                 */
+/*===========================================================================*/
+
+static semaphore_t sem;
+static mutex_t mtx;
+static condition_variable_t cond;
+static unsigned shared;
+
+/*
+ * Periodic producer, signals a semaphore each millisecond.
+ */
+static THD_WORKING_AREA(waProducer, 1024);
+static THD_FUNCTION(Producer, arg) {
+
+  (void)arg;
+  chRegSetThreadName("producer");
+  while (!chThdShouldTerminateX()) {
+    chThdSleepMilliseconds(1);
+    chSemSignal(&sem);
+  }
+}
+
+/*
+ * Consumer, waits on the semaphore then hands over to the workers.
+ */
+static THD_WORKING_AREA(waConsumer, 1024);
+static THD_FUNCTION(Consumer, arg) {
+
+  (void)arg;
+  chRegSetThreadName("consumer");
+  while (!chThdShouldTerminateX()) {
+    if (chSemWaitTimeout(&sem, TIME_MS2I(10)) == MSG_OK) {
+      chMtxLock(&mtx);
+      shared += 8U;
+      chCondBroadcast(&cond);
+      chMtxUnlock(&mtx);
+    }
+  }
+}
+
+/*
+ * Workers, consume the shared counter under a mutex.
+ */
+static THD_WORKING_AREA(waWorker1, 1024);
+static THD_WORKING_AREA(waWorker2, 1024);
+static THD_FUNCTION(Worker, arg) {
+
+  chRegSetThreadName((const char *)arg);
+  while (!chThdShouldTerminateX()) {
+    chMtxLock(&mtx);
+    while (shared == 0U) {
+      if (chCondWaitTimeout(&cond, TIME_MS2I(10)) == MSG_TIMEOUT) {
+        break;
+      }
+    }
+    if (shared > 0U) {
+      shared--;
+    }
+    chMtxUnlock(&mtx);
+    chThdYield();
+  }
+}
+
+/*===========================================================================*/
+/* Main and generic code.                                                    */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(waStreamer, 2048);
+static trace_streamer_config_t trs_config = {
+  .stream       = (BaseSequentialStream *)&fs,
+  .frequency    = 1000000U,     /* Realtime counter is in microseconds.*/
+  .period       = TIME_MS2I(10)
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  BaseSequentialStream *chp = (BaseSequentialStream *)&CD1;
+  const char *path = argc > 1 ? argv[1] : DEFAULT_TRACE_FILE;
+  int seconds = argc > 2 ? atoi(argv[2]) : DEFAULT_SECONDS;
+  thread_t *tps[5];
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  fs.f = fopen(path, "wb");
+  if (fs.f == NULL) {
+    chprintf(chp, "cannot create %s\r\n", path);
+    exit(1);
+  }
+
+  chSemObjectInit(&sem, 0);
+  chMtxObjectInit(&mtx);
+  chCondObjectInit(&cond);
+
+  /* The streamer runs below the workload.*/
+  tps[0] = chThdCreateStatic(waStreamer, sizeof (waStreamer),
+                             NORMALPRIO - 10, trsThread, &trs_config);
+  tps[1] = chThdCreateStatic(waProducer, sizeof (waProducer),
+                             NORMALPRIO + 3, Producer, NULL);
+  tps[2] = chThdCreateStatic(waConsumer, sizeof (waConsumer),
+                             NORMALPRIO + 2, Consumer, NULL);
+  tps[3] = chThdCreateStatic(waWorker1, sizeof (waWorker1),
+                             NORMALPRIO + 1, Worker, "worker1");
+  tps[4] = chThdCreateStatic(waWorker2, sizeof (waWorker2),
+                             NORMALPRIO + 1, Worker, "worker2");
+
+  chprintf(chp, "*** tracing for %d seconds on %s\r\n", seconds, path);
+  chThdSleepSeconds(seconds);
+
+  for (i = 1U; i < 5U; i++) {
+    chThdTerminate(tps[i]);
+    chThdWait(tps[i]);
+  }
+  chThdTerminate(tps[0]);
+  chThdWait(tps[0]);
+  fclose(fs.f);
+
+  chprintf(chp, "--- %u bytes written, %u events dropped\r\n",
+           (unsigned)fs.written, (unsigned)chTraceStreamGetDropsX());
+
+  exit(0);
+}
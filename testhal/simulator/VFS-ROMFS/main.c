@@ -0,0 +1,1078 @@
+/*
+    ChibiOS - Copyright (C) 2006-2026 Giovanni Di Sirio.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "console.h"
+#include "chprintf.h"
+#include "vfs.h"
+#include "packbits.h"
+#include "lz4block.h"
+
+/*===========================================================================*/
+/* ROMFS image.                                                              */
+/*===========================================================================*/
+
+static const uint8_t file_data[] = {
+  'C', 'h', 'i', 'b', 'i', 'O', 'S', '/', 'V', 'F', 'S', '\n'
+};
+
+#define ROM_FILE(n) {                                                       \
+  .name     = (n),                                                          \
+  .mode     = VFS_MODE_S_IRUSR,                                             \
+  .flags    = 0U,                                                           \
+  .size     = (vfs_offset_t)sizeof (file_data),                             \
+  .content  = { .data = file_data }                                         \
+}
+
+static const vfs_romfs_file_desc_t root_files[] = {
+  ROM_FILE("index.html"),
+  ROM_FILE("style.css")
+};
+
+static const vfs_romfs_file_desc_t log_files[] = {
+  ROM_FILE("boot.log"),
+  ROM_FILE("system.log")
+};
+
+static const vfs_romfs_file_desc_t www_files[] = {
+  ROM_FILE("about.html"),
+  ROM_FILE("favicon.ico"),
+  ROM_FILE("main.js")
+};
+
+static const vfs_romfs_dir_desc_t rom_dirs[] = {
+  {.path = "/",     .files = root_files, .files_num = 2U},
+  {.path = "/log",  .files = log_files,  .files_num = 2U},
+  {.path = "/www",  .files = www_files,  .files_num = 3U}
+};
+
+static const vfs_romfs_tree_t rom_tree = {
+  .dirs     = rom_dirs,
+  .dirs_num = 3U
+};
+
+/*===========================================================================*/
+/* Large ROMFS tree, generated at startup.                                   */
+/*===========================================================================*/
+
+#define BIG_TOP_DIRS                        8U
+#define BIG_SUB_DIRS                        8U
+#define BIG_FILES                           56U
+#define BIG_DIRS_NUM                        (1U + (BIG_TOP_DIRS *           \
+                                                   (1U + BIG_SUB_DIRS)))
+#define BIG_FILES_NUM                       (BIG_TOP_DIRS * BIG_SUB_DIRS *  \
+                                             BIG_FILES)
+
+static char big_names[BIG_FILES][8];
+static char big_dir_paths[BIG_DIRS_NUM][8];
+static char big_file_paths[BIG_FILES_NUM][16];
+static vfs_romfs_file_desc_t big_files[BIG_FILES];
+static vfs_romfs_dir_desc_t big_dirs[BIG_DIRS_NUM];
+static vfs_romfs_tree_t big_tree;
+
+/*
+ * Builds a tree of 8 directories containing 8 directories each, all leaf
+ * directories share the same 56 files. Directories are in indexed order.
+ */
+static void big_tree_init(void) {
+  unsigned i, j, k, d, n;
+
+  for (k = 0U; k < BIG_FILES; k++) {
+    chsnprintf(big_names[k], sizeof (big_names[k]), "f%03u.js", k);
+    big_files[k].name    = big_names[k];
+    big_files[k].mode    = VFS_MODE_S_IRUSR;
+    big_files[k].flags   = 0U;
+    big_files[k].size    = (vfs_offset_t)sizeof (file_data);
+    big_files[k].content.data = file_data;
+  }
+
+  strcpy(big_dir_paths[0], "/");
+  big_dirs[0].path      = big_dir_paths[0];
+  big_dirs[0].files     = NULL;
+  big_dirs[0].files_num = 0U;
+  big_dirs[0].next      = BIG_DIRS_NUM;
+  d = 1U;
+  n = 0U;
+  for (i = 0U; i < BIG_TOP_DIRS; i++) {
+    chsnprintf(big_dir_paths[d], sizeof (big_dir_paths[d]), "/t%u", i);
+    big_dirs[d].path      = big_dir_paths[d];
+    big_dirs[d].files     = NULL;
+    big_dirs[d].files_num = 0U;
+    big_dirs[d].next      = d + 1U + BIG_SUB_DIRS;
+    d++;
+    for (j = 0U; j < BIG_SUB_DIRS; j++) {
+      chsnprintf(big_dir_paths[d], sizeof (big_dir_paths[d]),
+                 "/t%u/s%u", i, j);
+      big_dirs[d].path      = big_dir_paths[d];
+      big_dirs[d].files     = big_files;
+      big_dirs[d].files_num = BIG_FILES;
+      big_dirs[d].next      = d + 1U;
+      d++;
+      for (k = 0U; k < BIG_FILES; k++) {
+        chsnprintf(big_file_paths[n], sizeof (big_file_paths[n]),
+                   "/t%u/s%u/%s", i, j, big_names[k]);
+        n++;
+      }
+    }
+  }
+
+  big_tree.dirs     = big_dirs;
+  big_tree.dirs_num = BIG_DIRS_NUM;
+  big_tree.flags    = VFS_ROMFS_TREE_INDEXED;
+}
+
+/*===========================================================================*/
+/* VFS-related.                                                              */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Compressed ROMFS tree, generated at startup.                              */
+/*===========================================================================*/
+
+#define COMP_TEXT_SIZE                      65536U
+#define COMP_CHUNK_SIZE                     1024U
+#define COMP_CHUNKS_NUM                     (COMP_TEXT_SIZE / COMP_CHUNK_SIZE)
+#define COMP_CHUNK_BOUND                    (COMP_CHUNK_SIZE + 32U)
+
+static char comp_text[COMP_TEXT_SIZE];
+static uint32_t comp_stored_offsets[COMP_CHUNKS_NUM + 1U];
+static uint8_t comp_packbits_data[COMP_CHUNKS_NUM * COMP_CHUNK_BOUND];
+static uint32_t comp_packbits_offsets[COMP_CHUNKS_NUM + 1U];
+static uint8_t comp_lz4_data[COMP_CHUNKS_NUM * COMP_CHUNK_BOUND];
+static uint32_t comp_lz4_offsets[COMP_CHUNKS_NUM + 1U];
+static lz4block_workspace_t comp_lz4_workspace;
+static vfs_romfs_chunked_desc_t comp_descs[3];
+static vfs_romfs_file_desc_t comp_files[3];
+static vfs_romfs_dir_desc_t comp_dirs[1];
+static vfs_romfs_tree_t comp_tree;
+
+static const char * const comp_names[3] = {"stored", "packbits", "lz4"};
+static const char * const comp_paths[3] = {"/stored", "/packbits", "/lz4"};
+
+/*
+ * Synthetic web content, markup and scripts with varying identifiers.
+ */
+static void comp_text_init(void) {
+  uint32_t seed = 12345U;
+  size_t pos = 0U;
+
+  while (pos < COMP_TEXT_SIZE) {
+    char line[128];
+    unsigned a, b;
+    int n;
+
+    seed = (seed * 1103515245U) + 12345U;
+    a = (unsigned)(seed >> 16) % 1000U;
+    b = (unsigned)(seed >> 8) % 97U;
+    if ((seed & 0x30000000U) == 0U) {
+      n = chsnprintf(line, sizeof (line),
+                     "function update%u(el, v) { el.style.width = v * %u + "
+                     "'px'; return el; }\n", a, b);
+    }
+    else {
+      n = chsnprintf(line, sizeof (line),
+                     "  <li class=\"item\"><a href=\"/catalog/%u.html\">"
+                     "Item %u</a><span>%u</span></li>\n", a, a, b);
+    }
+    if ((size_t)n > COMP_TEXT_SIZE - pos) {
+      n = (int)(COMP_TEXT_SIZE - pos);
+    }
+    memcpy(&comp_text[pos], line, (size_t)n);
+    pos += (size_t)n;
+  }
+}
+
+static void comp_tree_init(void) {
+  const vfs_romfs_compressed_ops_t *ops[3] = {
+    &vfs_romfs_chunked_stored_ops,
+    &vfs_romfs_chunked_packbits_ops,
+    &vfs_romfs_chunked_lz4_ops
+  };
+  const uint8_t *datas[3] = {
+    (const uint8_t *)comp_text, comp_packbits_data, comp_lz4_data
+  };
+  const uint32_t *offsets[3] = {
+    comp_stored_offsets, comp_packbits_offsets, comp_lz4_offsets
+  };
+  uint32_t pb_pos = 0U, lz_pos = 0U;
+  unsigned i;
+
+  comp_text_init();
+
+  /* Each chunk compressed independently like mkromfs does.*/
+  for (i = 0U; i < COMP_CHUNKS_NUM; i++) {
+    const uint8_t *src = (const uint8_t *)&comp_text[i * COMP_CHUNK_SIZE];
+    size_t size;
+
+    comp_stored_offsets[i] = i * COMP_CHUNK_SIZE;
+    comp_packbits_offsets[i] = pb_pos;
+    comp_lz4_offsets[i] = lz_pos;
+    if (!packbits_encode(src, COMP_CHUNK_SIZE, &comp_packbits_data[pb_pos],
+                         COMP_CHUNK_BOUND, &size)) {
+      chSysHalt("packbits");
+    }
+    pb_pos += (uint32_t)size;
+    if (!lz4block_encode(src, COMP_CHUNK_SIZE, &comp_lz4_data[lz_pos],
+                         COMP_CHUNK_BOUND, &size, &comp_lz4_workspace)) {
+      chSysHalt("lz4");
+    }
+    lz_pos += (uint32_t)size;
+  }
+  comp_stored_offsets[i] = COMP_TEXT_SIZE;
+  comp_packbits_offsets[i] = pb_pos;
+  comp_lz4_offsets[i] = lz_pos;
+
+  for (i = 0U; i < 3U; i++) {
+    comp_descs[i].size       = (vfs_offset_t)COMP_TEXT_SIZE;
+    comp_descs[i].chunk_size = COMP_CHUNK_SIZE;
+    comp_descs[i].chunks_num = COMP_CHUNKS_NUM;
+    comp_descs[i].offsets    = offsets[i];
+    comp_descs[i].data       = datas[i];
+    comp_files[i].name       = &comp_paths[i][1];
+    comp_files[i].mode       = VFS_MODE_S_IRUSR;
+    comp_files[i].flags      = VFS_ROMFS_FILE_TYPE_COMPRESSED;
+    comp_files[i].size       = (vfs_offset_t)COMP_TEXT_SIZE;
+    comp_files[i].content.compressed.ops = ops[i];
+    comp_files[i].content.compressed.arg = &comp_descs[i];
+  }
+
+  /* Names sorted for the indexed lookups.*/
+  comp_dirs[0].path      = "/";
+  comp_dirs[0].files     = comp_files;
+  comp_dirs[0].files_num = 3U;
+  comp_dirs[0].next      = 1U;
+  comp_tree.dirs         = comp_dirs;
+  comp_tree.dirs_num     = 1U;
+  comp_tree.flags        = 0U;
+}
+
+/*===========================================================================*/
+/* RAM file node, counts the accesses reaching the storage.                  */
+/*===========================================================================*/
+
+#define RAM_FILE_SIZE                       32768U
+#define RAM_ACCESS_COST                     100U
+
+static vfs_file_node_c ram_file;
+static uint8_t ram_data[RAM_FILE_SIZE];
+static size_t ram_size;
+static size_t ram_pos;
+static uint32_t ram_reads;
+static uint32_t ram_writes;
+
+/* Emulates the fixed cost of a file system access.*/
+static void ram_access(void) {
+  volatile unsigned i;
+
+  for (i = 0U; i < RAM_ACCESS_COST; i++) {
+  }
+}
+
+static ssize_t ram_read(void *ip, uint8_t *buf, size_t n) {
+
+  (void)ip;
+
+  ram_reads++;
+  ram_access();
+  if (n > ram_size - ram_pos) {
+    n = ram_pos < ram_size ? ram_size - ram_pos : 0U;
+  }
+  memcpy(buf, &ram_data[ram_pos], n);
+  ram_pos += n;
+
+  return (ssize_t)n;
+}
+
+static ssize_t ram_write(void *ip, const uint8_t *buf, size_t n) {
+
+  (void)ip;
+
+  ram_writes++;
+  ram_access();
+  if (n > RAM_FILE_SIZE - ram_pos) {
+    n = RAM_FILE_SIZE - ram_pos;
+  }
+  memcpy(&ram_data[ram_pos], buf, n);
+  ram_pos += n;
+  if (ram_pos > ram_size) {
+    ram_size = ram_pos;
+  }
+
+  return (ssize_t)n;
+}
+
+static msg_t ram_setpos(void *ip, vfs_offset_t offset,
+                        vfs_seekmode_t whence) {
+
+  (void)ip;
+
+  if (whence == VFS_SEEK_CUR) {
+    offset += (vfs_offset_t)ram_pos;
+  }
+  else if (whence == VFS_SEEK_END) {
+    offset += (vfs_offset_t)ram_size;
+  }
+  if ((offset < 0) || (offset > (vfs_offset_t)RAM_FILE_SIZE)) {
+    return CH_RET_EINVAL;
+  }
+  ram_pos = (size_t)offset;
+
+  return CH_RET_SUCCESS;
+}
+
+static vfs_offset_t ram_getpos(void *ip) {
+
+  (void)ip;
+
+  return (vfs_offset_t)ram_pos;
+}
+
+static const struct vfs_file_node_vmt ram_file_vmt = {
+  .dispose                  = __vfsfile_dispose_impl,
+  .addref                   = __ro_addref_impl,
+  .release                  = __ro_release_impl,
+  .stat                     = __vfsnode_stat_impl,
+  .read                     = ram_read,
+  .write                    = ram_write,
+  .setpos                   = ram_setpos,
+  .getpos                   = ram_getpos,
+  .getstream                = __vfsfile_getstream_impl,
+  .map                      = __vfsfile_map_impl,
+  .unmap                    = __vfsfile_unmap_impl,
+  .sync                     = __vfsfile_sync_impl
+};
+
+/* Creates the RAM file empty, optionally with a buffer.*/
+static vfs_file_node_c *ram_file_open(bool buffered) {
+  vfs_file_node_c *fnp;
+
+  ram_size = 0U;
+  ram_pos  = 0U;
+  fnp = __vfsfile_objinit_impl(&ram_file, &ram_file_vmt, NULL,
+                               VFS_MODE_S_IFREG | VFS_MODE_S_IRUSR |
+                               VFS_MODE_S_IWUSR);
+#if VFS_CFG_ENABLE_BUFFERED_FILES == TRUE
+  if (buffered && CH_RET_IS_ERROR(vfsBufferFile(fnp, &fnp))) {
+    chSysHalt("buffer");
+  }
+#else
+  (void)buffered;
+#endif
+
+  return fnp;
+}
+
+/*===========================================================================*/
+/* Recording driver, checks the paths reaching the storage.                  */
+/*===========================================================================*/
+
+static vfs_driver_c rec_driver;
+static char rec_path1[VFS_BUFFER_SIZE];
+static char rec_path2[VFS_BUFFER_SIZE];
+
+/* Path of the only file that can exist, empty if not created, the file
+   is the RAM file node.*/
+static char rec_file[VFS_BUFFER_SIZE];
+
+static msg_t rec_stat(void *ip, const char *path, vfs_stat_t *sp) {
+
+  (void)ip;
+
+  strcpy(rec_path1, path);
+  rec_path2[0] = '\0';
+
+  if (strcmp(path, rec_file) == 0) {
+    sp->mode = VFS_MODE_S_IFREG | VFS_MODE_S_IRUSR | VFS_MODE_S_IWUSR;
+    sp->size = (vfs_offset_t)0;
+    return CH_RET_SUCCESS;
+  }
+
+  return CH_RET_ENOENT;
+}
+
+static msg_t rec_openfile(void *ip, const char *path, int flags,
+                          vfs_file_node_c **vfnpp) {
+
+  (void)ip;
+
+  if (strcmp(path, rec_file) != 0) {
+    if ((flags & VO_CREAT) == 0) {
+      return CH_RET_ENOENT;
+    }
+    strcpy(rec_file, path);
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+    /* Emulates an unrelated invalidation by another thread while the
+       file is being created.*/
+    vfs_dcache_invalidate(&rec_driver, "/other");
+#endif
+  }
+  *vfnpp = ram_file_open(false);
+
+  return CH_RET_SUCCESS;
+}
+
+/* Claims a path buffer like the LittleFS driver does.*/
+static msg_t rec_rename(void *ip, const char *oldpath, const char *newpath) {
+  vfs_shared_buffer_t *shbuf;
+
+  (void)ip;
+
+  shbuf = vfs_buffer_take_immediate();
+  if (shbuf == NULL) {
+    return CH_RET_ENOMEM;
+  }
+  strcpy(rec_path1, oldpath);
+  strcpy(rec_path2, newpath);
+  if (strcmp(oldpath, rec_file) == 0) {
+    strcpy(rec_file, newpath);
+  }
+  vfs_buffer_release(shbuf);
+
+  return CH_RET_SUCCESS;
+}
+
+static const struct vfs_driver_vmt rec_driver_vmt = {
+  .dispose                  = __vfsdrv_dispose_impl,
+  .setcwd                   = __vfsdrv_setcwd_impl,
+  .getcwd                   = __vfsdrv_getcwd_impl,
+  .stat                     = rec_stat,
+  .opendir                  = __vfsdrv_opendir_impl,
+  .openfile                 = rec_openfile,
+  .unlink                   = __vfsdrv_unlink_impl,
+  .rename                   = rec_rename,
+  .mkdir                    = __vfsdrv_mkdir_impl,
+  .rmdir                    = __vfsdrv_rmdir_impl
+};
+
+/* Overlays with prefixes stacked on the recording driver, the outer one
+   is registered as /mnt on the mount overlay.*/
+static vfs_overlay_driver_c inner_overlay_driver;
+static vfs_overlay_driver_c outer_overlay_driver;
+static vfs_overlay_driver_c mnt_overlay_driver;
+
+/* Overlay path translation cases.*/
+static const struct {
+  vfs_driver_c  *drvp;
+  const char    *oldpath;
+  const char    *newpath;
+  const char    *expold;
+  const char    *expnew;
+} ovl_cases[] = {
+  {(vfs_driver_c *)&inner_overlay_driver, "/a", "/b", "/data/a", "/data/b"},
+  {(vfs_driver_c *)&inner_overlay_driver, "a/../c", "./d",
+   "/data/c", "/data/d"},
+  {(vfs_driver_c *)&outer_overlay_driver, "/a", "/b",
+   "/data/sub/a", "/data/sub/b"},
+  {(vfs_driver_c *)&outer_overlay_driver, "x//a", "/x/../b",
+   "/data/sub/x/a", "/data/sub/b"},
+  {(vfs_driver_c *)&mnt_overlay_driver, "/mnt/a", "/mnt/b",
+   "/data/sub/a", "/data/sub/b"},
+  {(vfs_driver_c *)&mnt_overlay_driver, "mnt/./a", "/mnt//b/",
+   "/data/sub/a", "/data/sub/b"},
+  {NULL, NULL, NULL, NULL, NULL}
+};
+
+static void ovl_init(void) {
+  msg_t msg;
+
+  __vfsdrv_objinit_impl(&rec_driver, &rec_driver_vmt);
+  ovldrvObjectInit(&inner_overlay_driver, &rec_driver, "/data");
+  ovldrvObjectInit(&outer_overlay_driver,
+                   (vfs_driver_c *)&inner_overlay_driver, "/sub");
+  ovldrvObjectInit(&mnt_overlay_driver, NULL, NULL);
+  msg = ovldrvRegisterDriver(&mnt_overlay_driver,
+                             (vfs_driver_c *)&outer_overlay_driver, "mnt");
+  if (CH_RET_IS_ERROR(msg)) {
+    chSysHalt("VFS");
+  }
+}
+
+/*
+ * Renames and stats through overlays and nested overlays, the paths
+ * reaching the recording driver must carry all prefixes. A single pool
+ * buffer must be enough for all cases.
+ */
+static bool ovl_test(BaseSequentialStream *chp) {
+  bool pass = true;
+  unsigned i;
+
+  for (i = 0U; ovl_cases[i].drvp != NULL; i++) {
+    vfs_stat_t st;
+    msg_t msg;
+
+    msg = vfsDrvRename(ovl_cases[i].drvp,
+                       ovl_cases[i].oldpath, ovl_cases[i].newpath);
+    if ((msg != CH_RET_SUCCESS) ||
+        (strcmp(rec_path1, ovl_cases[i].expold) != 0) ||
+        (strcmp(rec_path2, ovl_cases[i].expnew) != 0)) {
+      chprintf(chp, "rename %s %s: FAILURE (%d)\r\n",
+               ovl_cases[i].oldpath, ovl_cases[i].newpath, (int)msg);
+      pass = false;
+    }
+
+    msg = vfsDrvStat(ovl_cases[i].drvp, ovl_cases[i].oldpath, &st);
+    if ((msg != CH_RET_ENOENT) ||
+        (strcmp(rec_path1, ovl_cases[i].expold) != 0)) {
+      chprintf(chp, "stat %s: FAILURE (%d)\r\n",
+               ovl_cases[i].oldpath, (int)msg);
+      pass = false;
+    }
+  }
+
+  chprintf(chp, "overlay rename and stat, %u cases: %s\r\n",
+           i, pass ? "SUCCESS" : "FAILURE");
+
+  return pass;
+}
+
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+/*
+ * Creates a file after its non-existence has been cached, the file must
+ * then be found with and without VO_CREAT, also after a rename. The
+ * recording driver is temporarily used as root.
+ */
+static bool dcache_test(BaseSequentialStream *chp) {
+  static const struct {
+    const char  *path;
+    int         flags;
+    msg_t       exp;
+  } steps[] = {
+    {"/new", VO_RDONLY,            CH_RET_ENOENT},
+    {"/new", VO_RDONLY,            CH_RET_ENOENT},
+    {"/new", VO_RDWR | VO_CREAT,   CH_RET_SUCCESS},
+    {"/new", VO_RDONLY,            CH_RET_SUCCESS},
+    {"/ren", VO_RDONLY,            CH_RET_ENOENT},
+    {NULL,   0,                    CH_RET_SUCCESS},
+    {"/ren", VO_RDONLY,            CH_RET_SUCCESS},
+    {"/new", VO_RDONLY,            CH_RET_ENOENT}
+  };
+  vfs_driver_c *root = vfs_root;
+  bool pass = true;
+  unsigned i;
+
+  vfs_root = &rec_driver;
+  rec_file[0] = '\0';
+  for (i = 0U; i < sizeof (steps) / sizeof (steps[0]); i++) {
+    vfs_file_node_c *fnp;
+    vfs_stat_t st;
+    msg_t msg;
+
+    /* A NULL path is the rename step.*/
+    if (steps[i].path == NULL) {
+      msg = vfsRename("/new", "/ren");
+      if (msg != steps[i].exp) {
+        chprintf(chp, "step %u, rename: FAILURE (%d)\r\n", i, (int)msg);
+        pass = false;
+      }
+      continue;
+    }
+
+    msg = vfsOpenFile(steps[i].path, steps[i].flags, &fnp);
+    if (msg == CH_RET_SUCCESS) {
+      vfsClose((vfs_node_c *)fnp);
+    }
+    if (msg != steps[i].exp) {
+      chprintf(chp, "step %u, open %s: FAILURE (%d)\r\n",
+               i, steps[i].path, (int)msg);
+      pass = false;
+    }
+
+    msg = vfsStat(steps[i].path, &st);
+    if (msg != steps[i].exp) {
+      chprintf(chp, "step %u, stat %s: FAILURE (%d)\r\n",
+               i, steps[i].path, (int)msg);
+      pass = false;
+    }
+  }
+  vfs_dcache_invalidate(&rec_driver, NULL);
+  vfs_root = root;
+
+  chprintf(chp, "dcache create, reopen and rename, %u steps: %s\r\n",
+           i, pass ? "SUCCESS" : "FAILURE");
+
+  return pass;
+}
+#endif
+
+/* VFS ROMFS driver objects, mounted as /www and /log.*/
+static vfs_rom_driver_c www_driver;
+static vfs_rom_driver_c log_driver;
+
+/* VFS ROMFS driver object for the large tree, not mounted.*/
+static vfs_rom_driver_c big_driver;
+
+/* VFS ROMFS driver object for the compressed tree, not mounted.*/
+static vfs_rom_driver_c comp_driver;
+
+/* VFS overlay driver object representing the root directory.*/
+static vfs_overlay_driver_c root_overlay_driver;
+
+/* Global pointer to the root VFS driver.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_overlay_driver;
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+#define BENCH_THREADS_MAX                   8U
+#define BENCH_DURATION                      TIME_MS2I(1000)
+
+/* Normalized absolute paths, resolved without shared buffers.*/
+static const char * const abs_paths[] = {
+  "/www/index.html",
+  "/www/www/main.js",
+  "/log/log/boot.log",
+  "/log/style.css",
+  NULL
+};
+
+/* Paths requiring normalization, resolved into shared buffers.*/
+static const char * const rel_paths[] = {
+  "www//index.html",
+  "/www/www/../www/main.js",
+  "log/./log/boot.log",
+  "/log/style.css/",
+  NULL
+};
+
+/* Directories and non-existing nodes.*/
+static const char * const dir_paths[] = {
+  "/www",
+  "/log/log",
+  "/www/missing.html",
+  "/log/www/none.js",
+  NULL
+};
+
+static THD_WORKING_AREA(wa_bench[BENCH_THREADS_MAX], 2048);
+static volatile bool bench_stop;
+
+/*
+ * Benchmark thread, each iteration performs a stat and an open/close
+ * on each path in the list, non-existing nodes must fail both.
+ */
+static THD_FUNCTION(bench_thread, arg) {
+  const char * const *paths = (const char * const *)arg;
+  uint32_t n = 0U;
+
+  while (!bench_stop) {
+    const char * const *pp;
+
+    for (pp = paths; *pp != NULL; pp++) {
+      vfs_stat_t st;
+      vfs_node_c *np;
+      msg_t ret;
+
+      ret = vfsStat(*pp, &st);
+      if (ret == CH_RET_ENOENT) {
+        if (vfsOpen(*pp, VO_RDONLY, &np) != CH_RET_ENOENT) {
+          chSysHalt("bench");
+        }
+      }
+      else {
+        if (CH_RET_IS_ERROR(ret) ||
+            CH_RET_IS_ERROR(vfsOpen(*pp, VO_RDONLY, &np))) {
+          chSysHalt("bench");
+        }
+        vfsClose(np);
+      }
+      n += 2U;
+    }
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+
+  chThdExit((msg_t)n);
+}
+
+/*
+ * Large tree benchmark thread, each iteration opens all files or lists
+ * all directories.
+ */
+static THD_FUNCTION(big_thread, arg) {
+  bool list = (bool)(uintptr_t)arg;
+  uint32_t n = 0U;
+
+  while (!bench_stop) {
+    unsigned i;
+
+    if (list) {
+      for (i = 0U; i < BIG_DIRS_NUM; i++) {
+        vfs_directory_node_c *dnp;
+        vfs_direntry_info_t di;
+        msg_t ret;
+
+        if (CH_RET_IS_ERROR(vfsDrvOpenDirectory((vfs_driver_c *)&big_driver,
+                                                big_dir_paths[i], &dnp))) {
+          chSysHalt("big");
+        }
+        ret = vfsDirReadFirst((void *)dnp, &di);
+        while (ret > (msg_t)0) {
+          ret = vfsDirReadNext((void *)dnp, &di);
+        }
+        vfsClose((vfs_node_c *)dnp);
+        n++;
+#if defined(SIMULATOR)
+        _sim_check_for_interrupts();
+#endif
+      }
+    }
+    else {
+      for (i = 0U; i < BIG_FILES_NUM; i++) {
+        vfs_file_node_c *fnp;
+
+        if (CH_RET_IS_ERROR(vfsDrvOpenFile((vfs_driver_c *)&big_driver,
+                                           big_file_paths[i], VO_RDONLY,
+                                           &fnp))) {
+          chSysHalt("big");
+        }
+        vfsClose((vfs_node_c *)fnp);
+        n++;
+#if defined(SIMULATOR)
+        _sim_check_for_interrupts();
+#endif
+      }
+    }
+  }
+
+  chThdExit((msg_t)n);
+}
+
+static void bench_big(BaseSequentialStream *chp, const char *name,
+                      uint32_t flags) {
+  thread_t *tp;
+  uint32_t opens, lists;
+
+  big_tree.flags = flags;
+
+  bench_stop = false;
+  tp = chThdCreateStatic(wa_bench[0], sizeof (wa_bench[0]),
+                         NORMALPRIO - 1, big_thread, (void *)false);
+  chThdSleep(BENCH_DURATION);
+  bench_stop = true;
+  opens = (uint32_t)chThdWait(tp);
+
+  bench_stop = false;
+  tp = chThdCreateStatic(wa_bench[0], sizeof (wa_bench[0]),
+                         NORMALPRIO - 1, big_thread, (void *)true);
+  chThdSleep(BENCH_DURATION);
+  bench_stop = true;
+  lists = (uint32_t)chThdWait(tp);
+
+  chprintf(chp, "--- %s, %u files: %u opens/s, %u dir listings/s\r\n",
+           name, (unsigned)BIG_FILES_NUM,
+           (unsigned)(((uint64_t)opens * (uint64_t)CH_CFG_ST_FREQUENCY) /
+                      (uint64_t)BENCH_DURATION),
+           (unsigned)(((uint64_t)lists * (uint64_t)CH_CFG_ST_FREQUENCY) /
+                      (uint64_t)BENCH_DURATION));
+}
+
+/*
+ * Compressed files benchmark thread, each iteration reads and checks a
+ * whole file using the specified read size, zero means mapping the file.
+ */
+static THD_FUNCTION(comp_thread, arg) {
+  size_t read_size = (size_t)arg & 0xFFFFU;
+  const char *path = comp_paths[(size_t)arg >> 16];
+  static uint8_t buf[512];
+  uint32_t n = 0U;
+
+  while (!bench_stop) {
+    vfs_file_node_c *fnp;
+    size_t total = 0U;
+
+    if (CH_RET_IS_ERROR(vfsDrvOpenFile((vfs_driver_c *)&comp_driver,
+                                       path, VO_RDONLY, &fnp))) {
+      chSysHalt("comp");
+    }
+    if (read_size == 0U) {
+      const uint8_t *data;
+
+      if (CH_RET_IS_ERROR(vfsMapFile(fnp, &data, &total)) ||
+          (memcmp(data, comp_text, total) != 0)) {
+        chSysHalt("comp map");
+      }
+      (void) vfsUnmapFile(fnp);
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    while (read_size > 0U) {
+      ssize_t ret = vfsReadFile(fnp, buf, read_size);
+
+      if (ret <= (ssize_t)0) {
+        break;
+      }
+      if (memcmp(buf, &comp_text[total], (size_t)ret) != 0) {
+        chSysHalt("comp data");
+      }
+      total += (size_t)ret;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    vfsClose((vfs_node_c *)fnp);
+    if (total != COMP_TEXT_SIZE) {
+      chSysHalt("comp size");
+    }
+    n++;
+  }
+
+  chThdExit((msg_t)n);
+}
+
+static void bench_comp(BaseSequentialStream *chp, unsigned kind) {
+  static const size_t read_sizes[3] = {512U, 64U, 0U};
+  uint32_t rates[3];
+  uint32_t size;
+  unsigned i, n;
+
+  /* Mapping is only possible for stored files.*/
+  n = kind == 0U ? 3U : 2U;
+  for (i = 0U; i < n; i++) {
+    thread_t *tp;
+    uint32_t files;
+
+    bench_stop = false;
+    tp = chThdCreateStatic(wa_bench[0], sizeof (wa_bench[0]),
+                           NORMALPRIO - 1, comp_thread,
+                           (void *)(((size_t)kind << 16) | read_sizes[i]));
+    chThdSleep(BENCH_DURATION);
+    bench_stop = true;
+    files = (uint32_t)chThdWait(tp);
+    rates[i] = (uint32_t)(((uint64_t)files * (uint64_t)COMP_TEXT_SIZE *
+                           (uint64_t)CH_CFG_ST_FREQUENCY) /
+                          ((uint64_t)BENCH_DURATION * 1000000U));
+  }
+
+  size = comp_descs[kind].offsets[COMP_CHUNKS_NUM] +
+         (uint32_t)sizeof (uint32_t) * (COMP_CHUNKS_NUM + 1U);
+  chprintf(chp, "--- %s, %u bytes (%u%%): %u MB/s by 512, "
+                "%u MB/s by 64",
+           comp_names[kind], (unsigned)size,
+           (unsigned)((size * 100U) / COMP_TEXT_SIZE),
+           (unsigned)rates[0], (unsigned)rates[1]);
+  if (n > 2U) {
+    chprintf(chp, ", %u MB/s mapped", (unsigned)rates[2]);
+  }
+  chprintf(chp, "\r\n");
+}
+
+/*
+ * Log file benchmark thread, each iteration fills the RAM file with
+ * formatted lines then reads it back one byte at a time.
+ */
+static THD_FUNCTION(log_thread, arg) {
+  bool buffered = (bool)(arg != NULL);
+  uint32_t n = 0U;
+
+  while (!bench_stop) {
+    vfs_file_node_c *fnp = ram_file_open(buffered);
+    random_stream_i *rsp = vfsGetFileStream(fnp);
+    unsigned line = 0U;
+    size_t total = 0U;
+    uint8_t c;
+
+    while (vfsGetFilePosition(fnp) < (vfs_offset_t)(RAM_FILE_SIZE - 64U)) {
+      chprintf((BaseSequentialStream *)rsp, "%08u: sample %u, state %s\r\n",
+               line, line * 7U, (line & 1U) != 0U ? "on" : "off");
+      line++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    if (CH_RET_IS_ERROR(vfsSyncFile(fnp)) ||
+        CH_RET_IS_ERROR(vfsSetFilePosition(fnp, 0, VFS_SEEK_SET))) {
+      chSysHalt("log sync");
+    }
+    while (vfsReadFile(fnp, &c, 1U) == (ssize_t)1) {
+      if (c != ram_data[total]) {
+        chSysHalt("log data");
+      }
+      total++;
+#if defined(SIMULATOR)
+      if ((total & 63U) == 0U) {
+        _sim_check_for_interrupts();
+      }
+#endif
+    }
+    vfsClose((vfs_node_c *)fnp);
+    if ((total != ram_size) || (ram_size < RAM_FILE_SIZE - 64U)) {
+      chSysHalt("log size");
+    }
+    n++;
+  }
+
+  chThdExit((msg_t)n);
+}
+
+static void bench_log(BaseSequentialStream *chp, bool buffered) {
+  thread_t *tp;
+  uint32_t files;
+
+  ram_reads  = 0U;
+  ram_writes = 0U;
+  bench_stop = false;
+  tp = chThdCreateStatic(wa_bench[0], sizeof (wa_bench[0]),
+                         NORMALPRIO - 1, log_thread,
+                         buffered ? (void *)1 : NULL);
+  chThdSleep(BENCH_DURATION);
+  bench_stop = true;
+  files = (uint32_t)chThdWait(tp);
+  if (files == 0U) {
+    files = 1U;
+  }
+
+  chprintf(chp, "--- %s: %u files/s, %u writes and %u reads per file\r\n",
+           buffered ? "buffered" : "unbuffered",
+           (unsigned)(((uint64_t)files * (uint64_t)CH_CFG_ST_FREQUENCY) /
+                      (uint64_t)BENCH_DURATION),
+           (unsigned)(ram_writes / files), (unsigned)(ram_reads / files));
+}
+
+static void bench(BaseSequentialStream *chp,
+                  const char *name,
+                  const char * const *paths) {
+  unsigned nthreads;
+
+  for (nthreads = 1U; nthreads <= BENCH_THREADS_MAX; nthreads *= 2U) {
+    thread_t *tps[BENCH_THREADS_MAX];
+    uint32_t ops;
+    unsigned i;
+
+    bench_stop = false;
+    for (i = 0U; i < nthreads; i++) {
+      tps[i] = chThdCreateStatic(wa_bench[i], sizeof (wa_bench[i]),
+                                 NORMALPRIO - 1, bench_thread,
+                                 (void *)paths);
+    }
+
+    chThdSleep(BENCH_DURATION);
+    bench_stop = true;
+
+    ops = 0U;
+    for (i = 0U; i < nthreads; i++) {
+      ops += (uint32_t)chThdWait(tps[i]);
+    }
+
+    chprintf(chp, "--- %s, %u thread(s): %u ops/s\r\n",
+             name, nthreads,
+             (unsigned)(((uint64_t)ops * (uint64_t)CH_CFG_ST_FREQUENCY) /
+                        (uint64_t)BENCH_DURATION));
+  }
+}
+
+/*===========================================================================*/
+/* Main and generic code.                                                    */
+/*===========================================================================*/
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  BaseSequentialStream *chp = (BaseSequentialStream *)&CD1;
+  msg_t msg;
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+  vfsInit();
+
+  /* Two independent ROMFS drivers registered on the overlay root.*/
+  romdrvObjectInit(&www_driver, &rom_tree);
+  romdrvObjectInit(&log_driver, &rom_tree);
+  big_tree_init();
+  romdrvObjectInit(&big_driver, &big_tree);
+  comp_tree_init();
+  romdrvObjectInit(&comp_driver, &comp_tree);
+  ovldrvObjectInit(&root_overlay_driver, NULL, NULL);
+  msg = ovldrvRegisterDriver(&root_overlay_driver,
+                             (vfs_driver_c *)&www_driver, "www");
+  if (!CH_RET_IS_ERROR(msg)) {
+    msg = ovldrvRegisterDriver(&root_overlay_driver,
+                               (vfs_driver_c *)&log_driver, "log");
+  }
+  if (CH_RET_IS_ERROR(msg)) {
+    chSysHalt("VFS");
+  }
+
+  chprintf(chp, "*** Overlays and nested overlays, %u path buffer(s)\r\n",
+           (unsigned)VFS_CFG_PATHBUFS_NUM);
+  ovl_init();
+  if (!ovl_test(chp)) {
+    exit(1);
+  }
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  if (!dcache_test(chp)) {
+    exit(1);
+  }
+#endif
+
+  chprintf(chp, "*** VFS open/stat throughput, %u path buffer(s), "
+                "dcache %s\r\n",
+           (unsigned)VFS_CFG_PATHBUFS_NUM,
+           VFS_CFG_ENABLE_DCACHE == TRUE ? "enabled" : "disabled");
+  bench(chp, "normalized paths", abs_paths);
+  bench(chp, "relative paths", rel_paths);
+  bench(chp, "directories and missing nodes", dir_paths);
+
+  chprintf(chp, "*** ROMFS large tree\r\n");
+  bench_big(chp, "linear search", 0U);
+  bench_big(chp, "indexed", VFS_ROMFS_TREE_INDEXED);
+
+  chprintf(chp, "*** ROMFS compressed files, %u bytes of text, "
+                "%u bytes chunks\r\n",
+           (unsigned)COMP_TEXT_SIZE, (unsigned)COMP_CHUNK_SIZE);
+  bench_comp(chp, 0U);
+  bench_comp(chp, 1U);
+  bench_comp(chp, 2U);
+
+  chprintf(chp, "*** %u bytes log file, written using chprintf() and "
+                "read by byte\r\n", (unsigned)RAM_FILE_SIZE);
+  bench_log(chp, false);
+#if VFS_CFG_ENABLE_BUFFERED_FILES == TRUE
+  bench_log(chp, true);
+#endif
+
+#if VFS_CFG_ENABLE_DCACHE == TRUE
+  {
+    vfs_dcache_stats_t stats;
+
+    vfs_dcache_get_stats(&stats);
+    chprintf(chp, "*** dcache: %u hits, %u misses, %u invalidations, "
+                  "%u evictions\r\n",
+             (unsigned)stats.hits, (unsigned)stats.misses,
+             (unsigned)stats.invalidations, (unsigned)stats.evictions);
+  }
+#endif
+
+  exit(0);
+}
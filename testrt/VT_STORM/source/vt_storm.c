@@ -57,6 +57,9 @@ static virtual_timer_t continuous;
 static volatile sysinterval_t delay;
 static volatile bool saturated;
 static uint32_t vtcus;
+#if VT_STORM_CFG_BENCHMARK_TIMERS > 0
+static virtual_timer_t bench[VT_STORM_CFG_BENCHMARK_TIMERS];
+#endif
 
 /*===========================================================================*/
 /* Module local functions.                                                   */
@@ -166,6 +169,61 @@ static void guard_cb(virtual_timer_t *vtp, void *p) {
   (void)p;
 }
 
+#if VT_STORM_CFG_BENCHMARK_TIMERS > 0
+static void bench_cb(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+  (void)p;
+}
+
+static void bench_run(unsigned n) {
+  unsigned i;
+  uint32_t seed = 0x12345678U;
+  rtcnt_t start, cycles, setmax = 0, resetmax = 0;
+  uint64_t settotal = 0, resettotal = 0;
+
+  /* Arming timers with pseudo-random delays between 10mS and 1S, the
+     cost of each insertion is measured separately.*/
+  for (i = 0; i < n; i++) {
+    sysinterval_t interval;
+
+    seed = (seed * 1103515245U) + 12345U;
+    interval = TIME_MS2I(10) + (sysinterval_t)((seed >> 8) %
+                                               (uint32_t)TIME_MS2I(990));
+
+    chSysLock();
+    start = chSysGetRealtimeCounterX();
+    chVTSetI(&bench[i], interval, bench_cb, NULL);
+    cycles = chSysGetRealtimeCounterX() - start;
+    chSysUnlock();
+
+    settotal += (uint64_t)cycles;
+    if (cycles > setmax) {
+      setmax = cycles;
+    }
+  }
+
+  /* Disarming the timers in insertion order.*/
+  for (i = 0; i < n; i++) {
+    chSysLock();
+    start = chSysGetRealtimeCounterX();
+    chVTResetI(&bench[i]);
+    cycles = chSysGetRealtimeCounterX() - start;
+    chSysUnlock();
+
+    resettotal += (uint64_t)cycles;
+    if (cycles > resetmax) {
+      resetmax = cycles;
+    }
+  }
+
+  chprintf(config->out, "*** %4u timers:     set %u/%u, reset %u/%u cycles (avg/max)\r\n",
+           n,
+           (uint32_t)(settotal / (uint64_t)n), (uint32_t)setmax,
+           (uint32_t)(resettotal / (uint64_t)n), (uint32_t)resetmax);
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -213,8 +271,25 @@ void vt_storm_execute(const vt_storm_config_t *cfg) {
   chprintf(cfg->out, "*** Intervals size:   %d bits\r\n", CH_CFG_INTERVALS_SIZE);
   chprintf(cfg->out, "*** SysTick:          %d Hz\r\n", CH_CFG_ST_FREQUENCY);
   chprintf(cfg->out, "*** Initial delta:    %d ticks\r\n", chVTGetCurrentDelta());
+#if CH_CFG_VT_BACKEND == CH_VT_BACKEND_WHEEL
+  chprintf(cfg->out, "*** Timers backend:   timing wheel\r\n");
+#else
+  chprintf(cfg->out, "*** Timers backend:   delta list\r\n");
+#endif
   chprintf(cfg->out, "\r\n");
 
+#if VT_STORM_CFG_BENCHMARK_TIMERS > 0
+  /* Timers insertion and removal benchmark.*/
+  {
+    unsigned n;
+
+    for (n = 10U; n <= (unsigned)VT_STORM_CFG_BENCHMARK_TIMERS; n *= 10U) {
+      bench_run(n);
+    }
+    chprintf(cfg->out, "\r\n");
+  }
+#endif
+
 #if VT_STORM_CFG_HAMMERS
   /* Starting hammer timers.*/
   gptStart(cfg->gpt1p, cfg->gptcfg1p);
@@ -64,6 +64,18 @@
 #if !defined(VT_STORM_CFG_HAMMERS) || defined(__DOXYGEN__)
 #define VT_STORM_CFG_HAMMERS                FALSE
 #endif
+
+/**
+ * @brief   Maximum number of timers in the insertion benchmark.
+ * @details The benchmark arms 10, 100, 1000 timers and so on, up to this
+ *          value, and measures the cost of arming and disarming them, zero
+ *          disables the benchmark.
+ * @note    The timers are statically allocated, larger values require
+ *          enough RAM on the target.
+ */
+#if !defined(VT_STORM_CFG_BENCHMARK_TIMERS) || defined(__DOXYGEN__)
+#define VT_STORM_CFG_BENCHMARK_TIMERS       100
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -74,6 +86,10 @@
 #error "invalid VT_STORM_CFG_MIN_DELAY value"
 #endif
 
+#if (VT_STORM_CFG_BENCHMARK_TIMERS > 0) && (PORT_SUPPORTS_RT == FALSE)
+#error "VT_STORM_CFG_BENCHMARK_TIMERS requires PORT_SUPPORTS_RT"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
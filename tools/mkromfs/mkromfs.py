@@ -65,6 +65,7 @@ class CompressionRule:
 class CompressionSettings:
     default_mode: str
     rules: tuple[CompressionRule, ...]
+    codec: str = "packbits"
 
 
 @dataclass(frozen=True)
@@ -81,8 +82,20 @@ class StaticPayload:
 COMPRESSION_MODES = {"off", "force", "auto"}
 COMPRESSED_KIND_RAW = "raw"
 COMPRESSED_KIND_PACKBITS = "packbits"
+COMPRESSED_KIND_LZ4 = "lz4"
+COMPRESSION_CODECS = {COMPRESSED_KIND_PACKBITS, COMPRESSED_KIND_LZ4}
 PACKBITS_CHUNK_SIZE = 256
 PACKBITS_OPS_SYMBOL = "vfs_romfs_chunked_packbits_ops"
+LZ4_CHUNK_SIZE = 1024
+LZ4_OPS_SYMBOL = "vfs_romfs_chunked_lz4_ops"
+LZ4_MATCH_MIN = 4
+LZ4_LAST_LITERALS = 5
+LZ4_MATCH_LIMIT = 12
+LZ4_HASH_BITS = 10
+COMPRESSED_OPS_SYMBOLS = {
+    COMPRESSED_KIND_PACKBITS: PACKBITS_OPS_SYMBOL,
+    COMPRESSED_KIND_LZ4: LZ4_OPS_SYMBOL,
+}
 
 
 def fail(message: str) -> NoReturn:
@@ -144,6 +157,28 @@ def join_path(dir_path: str, name: str) -> str:
     return dir_path + "/" + name
 
 
+def dir_sort_key(directory: DirEntry) -> tuple[bytes, ...]:
+    # Component-wise order, the same as comparing paths with separators
+    # lower than any other character. Each subtree is contiguous and
+    # follows its root directory.
+    return tuple(
+        element.encode("utf-8")
+        for element in directory.path.split("/")
+        if element
+    )
+
+
+def get_subtree_ends(dirs: list[DirEntry]) -> list[int]:
+    ends: list[int] = []
+    for index, directory in enumerate(dirs):
+        prefix = directory.path.rstrip("/") + "/"
+        end = index + 1
+        while end < len(dirs) and dirs[end].path.startswith(prefix):
+            end += 1
+        ends.append(end)
+    return ends
+
+
 def split_path(path: str) -> tuple[str, str]:
     if path == "/" or not path.startswith("/"):
         fail(f"invalid dynamic file path: {path!r}")
@@ -233,6 +268,16 @@ def load_compression_settings(raw: object) -> CompressionSettings:
     if not isinstance(raw, dict):
         fail("field 'compression' must be an object")
 
+    raw_codec = raw.get("codec", COMPRESSED_KIND_PACKBITS)
+    if not isinstance(raw_codec, str):
+        fail("field 'compression.codec' must be a string")
+    codec = raw_codec.strip().lower()
+    if codec not in COMPRESSION_CODECS:
+        fail(
+            "field 'compression.codec' must be one of: "
+            + ", ".join(sorted(COMPRESSION_CODECS))
+        )
+
     raw_default = raw.get("default")
     if raw_default is None:
         default_mode = "off"
@@ -286,7 +331,7 @@ def load_compression_settings(raw: object) -> CompressionSettings:
             )
         )
 
-    return CompressionSettings(default_mode=default_mode, rules=tuple(rules))
+    return CompressionSettings(default_mode=default_mode, rules=tuple(rules), codec=codec)
 
 
 def compression_rule_matches(rule: CompressionRule, path: str) -> bool:
@@ -360,13 +405,64 @@ def encode_packbits_chunk(data: bytes) -> bytes:
     return bytes(encoded)
 
 
-def encode_packbits_file(data: bytes, chunk_size: int) -> tuple[bytes, tuple[int, ...]]:
+def put_lz4_length(encoded: bytearray, length: int) -> None:
+    while length >= 255:
+        encoded.append(255)
+        length -= 255
+    encoded.append(length)
+
+
+def put_lz4_sequence(encoded: bytearray, literals: bytes, offset: int, match_size: int) -> None:
+    token_match = match_size - LZ4_MATCH_MIN if match_size else 0
+    encoded.append((min(len(literals), 15) << 4) | min(token_match, 15))
+    if len(literals) >= 15:
+        put_lz4_length(encoded, len(literals) - 15)
+    encoded.extend(literals)
+    if match_size == 0:
+        return
+    encoded.extend(offset.to_bytes(2, "little"))
+    if token_match >= 15:
+        put_lz4_length(encoded, token_match - 15)
+
+
+def encode_lz4_chunk(data: bytes) -> bytes:
+    # Greedy encoder producing an LZ4 block, same algorithm as
+    # lz4block_encode() in os/common/utils.
+    encoded = bytearray()
+    table = [0] * (1 << LZ4_HASH_BITS)
+    size = len(data)
+    offset = 0
+    anchor = 0
+
+    while size > LZ4_MATCH_LIMIT and offset <= size - LZ4_MATCH_LIMIT:
+        sequence = int.from_bytes(data[offset:offset + 4], "little")
+        hash_index = ((sequence * 2654435761) & 0xFFFFFFFF) >> (32 - LZ4_HASH_BITS)
+        candidate = table[hash_index]
+        table[hash_index] = offset
+
+        if (candidate < offset and offset - candidate <= 65535 and
+                data[candidate:candidate + 4] == data[offset:offset + 4]):
+            match_size = LZ4_MATCH_MIN
+            while (offset + match_size < size - LZ4_LAST_LITERALS and
+                   data[candidate + match_size] == data[offset + match_size]):
+                match_size += 1
+            put_lz4_sequence(encoded, data[anchor:offset], offset - candidate, match_size)
+            offset += match_size
+            anchor = offset
+        else:
+            offset += 1
+
+    put_lz4_sequence(encoded, data[anchor:], 0, 0)
+    return bytes(encoded)
+
+
+def encode_chunked_file(data: bytes, chunk_size: int, encoder) -> tuple[bytes, tuple[int, ...]]:
     encoded = bytearray()
     offsets = [0]
 
     for offset in range(0, len(data), chunk_size):
         chunk = data[offset:offset + chunk_size]
-        encoded.extend(encode_packbits_chunk(chunk))
+        encoded.extend(encoder(chunk))
         offsets.append(len(encoded))
 
     return bytes(encoded), tuple(offsets)
@@ -392,8 +488,16 @@ def build_static_payload(path: str,
     if file_entry.data is None:
         fail(f"static compression requested for non-static file: {path!r}")
 
-    compressed_data, chunk_offsets = encode_packbits_file(file_entry.data,
-                                                          PACKBITS_CHUNK_SIZE)
+    if settings.codec == COMPRESSED_KIND_LZ4:
+        chunk_size = LZ4_CHUNK_SIZE
+        compressed_data, chunk_offsets = encode_chunked_file(file_entry.data,
+                                                             chunk_size,
+                                                             encode_lz4_chunk)
+    else:
+        chunk_size = PACKBITS_CHUNK_SIZE
+        compressed_data, chunk_offsets = encode_chunked_file(file_entry.data,
+                                                             chunk_size,
+                                                             encode_packbits_chunk)
     if mode == "auto":
         if get_effective_compressed_size(compressed_data, chunk_offsets) >= len(file_entry.data):
             return StaticPayload(
@@ -404,12 +508,12 @@ def build_static_payload(path: str,
             )
 
     return StaticPayload(
-        kind=COMPRESSED_KIND_PACKBITS,
+        kind=settings.codec,
         flags_expr=f"({file_entry.flags}) | VFS_ROMFS_FILE_TYPE_COMPRESSED",
         size_expr=f"(vfs_offset_t){file_entry.size}",
         compressed_data=compressed_data,
         chunk_offsets=chunk_offsets,
-        chunk_size=PACKBITS_CHUNK_SIZE,
+        chunk_size=chunk_size,
     )
 
 
@@ -597,7 +701,9 @@ def merge_dirs(static_dirs: list[DirEntry], manifest: DynamicManifest) -> list[D
 
     result: list[DirEntry] = []
     for directory in static_dirs:
-        files = tuple(sorted(merged[directory.path], key=lambda item: item.name))
+        files = tuple(
+            sorted(merged[directory.path], key=lambda item: item.name.encode("utf-8"))
+        )
         result.append(DirEntry(path=directory.path, files=files))
     return result
 
@@ -680,36 +786,27 @@ def emit_source(
                 lines.append(format_data_array(payload.raw_data or b""))
                 lines.append("};")
                 lines.append("")
-            elif payload.kind == COMPRESSED_KIND_PACKBITS:
+            elif payload.kind in COMPRESSED_OPS_SYMBOLS:
                 offsets_values = payload.chunk_offsets or ()
+                symbol = f"{namespace}_file_{dir_index}_{file_index}_{payload.kind}"
 
-                lines.append(
-                    f"static const uint8_t {namespace}_file_{dir_index}_{file_index}_packbits_data[] = {{"
-                )
+                lines.append(f"static const uint8_t {symbol}_data[] = {{")
                 lines.append(format_data_array(payload.compressed_data or b""))
                 lines.append("};")
                 lines.append("")
-                lines.append(
-                    f"static const uint32_t {namespace}_file_{dir_index}_{file_index}_packbits_offsets[] = {{"
-                )
+                lines.append(f"static const uint32_t {symbol}_offsets[] = {{")
                 lines.append(
                     "  "
                     + ", ".join(f"{value}U" for value in offsets_values)
                 )
                 lines.append("};")
                 lines.append("")
-                lines.append(
-                    f"static const vfs_romfs_chunked_desc_t {namespace}_file_{dir_index}_{file_index}_packbits_desc = {{"
-                )
+                lines.append(f"static const vfs_romfs_chunked_desc_t {symbol}_desc = {{")
                 lines.append(f"  .size = {payload.size_expr},")
                 lines.append(f"  .chunk_size = {payload.chunk_size}U,")
                 lines.append(f"  .chunks_num = {len(offsets_values) - 1}U,")
-                lines.append(
-                    f"  .offsets = {namespace}_file_{dir_index}_{file_index}_packbits_offsets,"
-                )
-                lines.append(
-                    f"  .data = {namespace}_file_{dir_index}_{file_index}_packbits_data,"
-                )
+                lines.append(f"  .offsets = {symbol}_offsets,")
+                lines.append(f"  .data = {symbol}_data,")
                 lines.append("};")
                 lines.append("")
             else:
@@ -732,12 +829,12 @@ def emit_source(
                         lines.append(
                             f"    .content = {{ .data = {namespace}_file_{dir_index}_{file_index}_data }},"
                         )
-                    elif payload.kind == COMPRESSED_KIND_PACKBITS:
+                    elif payload.kind in COMPRESSED_OPS_SYMBOLS:
                         lines.append("    .content = {")
                         lines.append("      .compressed = {")
-                        lines.append(f"        .ops = &{PACKBITS_OPS_SYMBOL},")
+                        lines.append(f"        .ops = &{COMPRESSED_OPS_SYMBOLS[payload.kind]},")
                         lines.append(
-                            f"        .arg = &{namespace}_file_{dir_index}_{file_index}_packbits_desc,"
+                            f"        .arg = &{namespace}_file_{dir_index}_{file_index}_{payload.kind}_desc,"
                         )
                         lines.append("      },")
                         lines.append("    },")
@@ -758,18 +855,21 @@ def emit_source(
         lines.append("};")
         lines.append("")
 
+    subtree_ends = get_subtree_ends(dirs)
     lines.append(f"static const vfs_romfs_dir_desc_t {namespace}_dirs[] = {{")
     for dir_index, directory in enumerate(dirs):
         lines.append("  {")
         lines.append(f"    .path = {escape_c_string(directory.path)},")
         lines.append(f"    .files = {namespace}_dir_{dir_index}_files,")
         lines.append(f"    .files_num = {len(directory.files)}U,")
+        lines.append(f"    .next = {subtree_ends[dir_index]}U,")
         lines.append("  },")
     lines.append("};")
     lines.append("")
     lines.append(f"const vfs_romfs_tree_t {namespace}_romfs = {{")
     lines.append(f"  .dirs = {namespace}_dirs,")
     lines.append(f"  .dirs_num = {len(dirs)}U,")
+    lines.append("  .flags = VFS_ROMFS_TREE_INDEXED,")
     lines.append("};")
     lines.append("")
 
@@ -803,7 +903,7 @@ def main(argv: list[str]) -> int:
     output_dir = Path(args.output_dir).resolve()
     output_dir.mkdir(parents=True, exist_ok=True)
 
-    static_dirs = sorted(scan_dir(input_dir, input_dir), key=lambda item: item.path)
+    static_dirs = sorted(scan_dir(input_dir, input_dir), key=dir_sort_key)
     manifest = load_dynamic_manifest(input_dir)
     dirs = merge_dirs(static_dirs, manifest)
     header_name = f"{namespace}_romfs.h"
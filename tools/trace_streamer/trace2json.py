@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+#
+# ChibiOS trace stream to Chrome/Perfetto JSON converter.
+#
+
+from __future__ import annotations
+
+import argparse
+import json
+import struct
+import sys
+from typing import BinaryIO, NoReturn
+
+
+HEADER_SIZE = 16
+HEADER_MAGIC = b"CHTR"
+HEADER_VERSION = 1
+HEADER_BOM = 0x0102
+
+TYPE_READY = 1
+TYPE_SWITCH = 2
+TYPE_ISR_ENTER = 3
+TYPE_ISR_LEAVE = 4
+TYPE_HALT = 5
+TYPE_USER = 6
+TYPE_TIME = 16
+TYPE_NAME = 17
+TYPE_LOST = 18
+
+ID_NONE = 0
+ID_OVERFLOW = 0xFFFF
+
+# Must match CH_STATE_NAMES in os/rt/include/chschd.h.
+STATE_NAMES = (
+    "READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED", "WTSEM", "WTMTX",
+    "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT", "WTANDEVT", "SNDMSGQ",
+    "SNDMSG", "WTMSG", "FINAL",
+)
+
+PID_THREADS = 1
+PID_ISRS = 2
+
+
+def fail(message: str) -> NoReturn:
+    print(f"trace2json: {message}", file=sys.stderr)
+    sys.exit(1)
+
+
+def state_name(state: int) -> str:
+    if state < len(STATE_NAMES):
+        return STATE_NAMES[state]
+    return str(state)
+
+
+class Converter:
+    """Converts trace stream records in Chrome trace events."""
+
+    def __init__(self, frequency: int) -> None:
+        self.frequency = frequency
+        self.events: list[dict] = []
+        self.names: dict[int, str] = {}
+        self.kinds: dict[int, int] = {}
+        self.high = 0
+        self.origin: int | None = None
+        self.current: int | None = None
+        self.start = 0.0
+        self.records = 0
+        self.lost = 0
+
+    def timestamp(self, stamp: int) -> float:
+        full = (self.high << 32) | stamp
+        if self.origin is None:
+            self.origin = full
+        return (full - self.origin) * 1000000.0 / self.frequency
+
+    def name(self, ident: int) -> str:
+        if ident == ID_OVERFLOW:
+            return "other"
+        name = self.names.get(ident, "")
+        return name if name else f"thread {ident}"
+
+    def close_slice(self, ts: float, state: int | None) -> None:
+        if self.current is None:
+            return
+        event = {
+            "name": self.name(self.current),
+            "ph": "X",
+            "pid": PID_THREADS,
+            "tid": self.current,
+            "ts": self.start,
+            "dur": ts - self.start,
+        }
+        if state is not None:
+            event["args"] = {"state": state_name(state)}
+        self.events.append(event)
+
+    def record(self, rtype: int, state: int, ident: int, arg1: int,
+               arg2: int, stamp: int, name: bytes) -> None:
+        self.records += 1
+        if rtype == TYPE_TIME:
+            self.high = arg1
+            return
+        if rtype == TYPE_NAME:
+            self.names[ident] = name.decode("utf-8", errors="replace")
+            self.kinds[ident] = state
+            return
+
+        ts = self.timestamp(stamp)
+        if rtype == TYPE_SWITCH:
+            self.close_slice(ts, state)
+            self.current = ident
+            self.start = ts
+        elif rtype == TYPE_READY:
+            self.events.append({
+                "name": "ready",
+                "ph": "i",
+                "s": "t",
+                "pid": PID_THREADS,
+                "tid": ident,
+                "ts": ts,
+                "args": {"msg": struct.unpack("<i", struct.pack("<I", arg1))[0]},
+            })
+        elif rtype in (TYPE_ISR_ENTER, TYPE_ISR_LEAVE):
+            self.events.append({
+                "name": self.names.get(ident, f"isr {ident}"),
+                "ph": "B" if rtype == TYPE_ISR_ENTER else "E",
+                "pid": PID_ISRS,
+                "tid": ident,
+                "ts": ts,
+            })
+        elif rtype == TYPE_HALT:
+            self.events.append({
+                "name": "halt: " + self.names.get(ident, ""),
+                "ph": "i",
+                "s": "g",
+                "pid": PID_THREADS,
+                "tid": self.current if self.current is not None else 0,
+                "ts": ts,
+            })
+        elif rtype == TYPE_USER:
+            self.events.append({
+                "name": "user",
+                "ph": "i",
+                "s": "t",
+                "pid": PID_THREADS,
+                "tid": self.current if self.current is not None else 0,
+                "ts": ts,
+                "args": {"up1": f"0x{arg1:08x}", "up2": f"0x{arg2:08x}"},
+            })
+        elif rtype == TYPE_LOST:
+            # The running thread is unknown until the next switch.
+            self.close_slice(ts, None)
+            self.current = None
+            self.lost += arg1
+            self.events.append({
+                "name": "lost",
+                "ph": "i",
+                "s": "g",
+                "pid": PID_THREADS,
+                "tid": 0,
+                "ts": ts,
+                "args": {"events": arg1},
+            })
+
+    def finish(self) -> dict:
+        if self.events:
+            end = max(e["ts"] + e.get("dur", 0.0) for e in self.events)
+            self.close_slice(end, None)
+
+        meta: list[dict] = [
+            {"name": "process_name", "ph": "M", "pid": PID_THREADS,
+             "args": {"name": "Threads"}},
+            {"name": "process_name", "ph": "M", "pid": PID_ISRS,
+             "args": {"name": "ISRs"}},
+        ]
+        for ident in sorted(self.names):
+            pid = PID_ISRS if self.kinds[ident] in (TYPE_ISR_ENTER,
+                                                    TYPE_ISR_LEAVE) else PID_THREADS
+            meta.append({"name": "thread_name", "ph": "M", "pid": pid,
+                         "tid": ident, "args": {"name": self.name(ident)}})
+
+        return {
+            "traceEvents": meta + self.events,
+            "displayTimeUnit": "ns",
+            "otherData": {
+                "records": self.records,
+                "lost_events": self.lost,
+                "frequency": self.frequency,
+            },
+        }
+
+
+def convert(stream: BinaryIO, frequency: int | None) -> dict:
+    header = stream.read(HEADER_SIZE)
+    if len(header) < HEADER_SIZE or header[0:4] != HEADER_MAGIC:
+        fail("not a trace stream")
+    if header[4] != HEADER_VERSION:
+        fail(f"unsupported format version {header[4]}")
+    if struct.unpack("<H", header[6:8])[0] == HEADER_BOM:
+        order = "<"
+    elif struct.unpack(">H", header[6:8])[0] == HEADER_BOM:
+        order = ">"
+    else:
+        fail("invalid byte order mark")
+    recsize = header[5]
+    if recsize < 16:
+        fail(f"invalid record size {recsize}")
+    hdrfreq = struct.unpack(order + "I", header[8:12])[0]
+    frequency = frequency or hdrfreq
+    if frequency == 0:
+        fail("unknown time stamps frequency, use --frequency")
+
+    conv = Converter(frequency)
+    recfmt = order + "BBHIII"
+    while True:
+        data = stream.read(recsize)
+        if len(data) < recsize:
+            break
+        rtype, state, ident, arg1, arg2, stamp = struct.unpack(recfmt, data[:16])
+        name = b""
+        if rtype == TYPE_NAME and arg2 > 0:
+            name = stream.read(arg2)
+            if len(name) < arg2:
+                break
+        conv.record(rtype, state, ident, arg1, arg2, stamp, name)
+
+    return conv.finish()
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        description="Converts a ChibiOS trace stream in Chrome/Perfetto JSON.")
+    parser.add_argument("input", help="binary trace stream file")
+    parser.add_argument("-o", "--output", help="output JSON file, default stdout")
+    parser.add_argument("-f", "--frequency", type=int,
+                        help="time stamps frequency in Hz, overrides the header")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        trace = convert(f, args.frequency)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+    other = trace["otherData"]
+    print(f"trace2json: {other['records']} records, "
+          f"{other['lost_events']} lost events", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()